@@ -18,6 +18,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "cc/core/interface/async_executor_interface.h"
 
@@ -32,6 +33,10 @@ class MockAsyncExecutor : public core::AsyncExecutorInterface {
 
   ExecutionResult Stop() noexcept override { return SuccessExecutionResult(); }
 
+  // The rvalue overloads of the interface forward to the overrides below.
+  using core::AsyncExecutorInterface::Schedule;
+  using core::AsyncExecutorInterface::ScheduleFor;
+
   ExecutionResult Schedule(const AsyncOperation& work,
                            AsyncPriority priority) noexcept override {
     if (schedule_mock) {
@@ -80,9 +85,23 @@ class MockAsyncExecutor : public core::AsyncExecutorInterface {
     return ScheduleFor(work, timestamp, cancellation_callback);
   }
 
+  std::vector<ExecutionResult> ScheduleBatch(
+      absl::Span<AsyncOperation> works,
+      AsyncPriority priority) noexcept override {
+    if (schedule_batch_mock) {
+      return schedule_batch_mock(works, priority);
+    }
+
+    // Goes through the mocks of the single tasks.
+    return core::AsyncExecutorInterface::ScheduleBatch(works, priority);
+  }
+
   std::function<ExecutionResult(const AsyncOperation& work)> schedule_mock;
   std::function<ExecutionResult(const AsyncOperation& work, Timestamp,
                                 std::function<bool()>&)>
       schedule_for_mock;
+  std::function<std::vector<ExecutionResult>(absl::Span<AsyncOperation> works,
+                                             AsyncPriority priority)>
+      schedule_batch_mock;
 };
 }  // namespace google::scp::core::async_executor::mock
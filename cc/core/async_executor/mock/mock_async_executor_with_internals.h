@@ -19,6 +19,7 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "cc/core/async_executor/src/async_executor.h"
 
@@ -107,6 +108,59 @@ class MockAsyncExecutorWithInternals : public core::AsyncExecutor {
                                       affinity);
   }
 
+  // The rvalue overloads forward to the overrides above, so that the work is
+  // wrapped regardless of how it is passed.
+  ExecutionResult Schedule(AsyncOperation&& work,
+                           AsyncPriority priority) noexcept override {
+    return Schedule(work, priority);
+  }
+
+  ExecutionResult Schedule(
+      AsyncOperation&& work, AsyncPriority priority,
+      AsyncExecutorAffinitySetting affinity) noexcept override {
+    return Schedule(work, priority, affinity);
+  }
+
+  ExecutionResult ScheduleFor(AsyncOperation&& work,
+                              Timestamp timestamp) noexcept override {
+    return ScheduleFor(work, timestamp);
+  }
+
+  ExecutionResult ScheduleFor(
+      AsyncOperation&& work, Timestamp timestamp,
+      AsyncExecutorAffinitySetting affinity) noexcept override {
+    return ScheduleFor(work, timestamp, affinity);
+  }
+
+  ExecutionResult ScheduleFor(
+      AsyncOperation&& work, Timestamp timestamp,
+      std::function<bool()>& cancellation_callback) noexcept override {
+    return ScheduleFor(work, timestamp, cancellation_callback);
+  }
+
+  ExecutionResult ScheduleFor(
+      AsyncOperation&& work, Timestamp timestamp,
+      std::function<bool()>& cancellation_callback,
+      AsyncExecutorAffinitySetting affinity) noexcept override {
+    return ScheduleFor(work, timestamp, cancellation_callback, affinity);
+  }
+
+  std::vector<ExecutionResult> ScheduleBatch(
+      absl::Span<AsyncOperation> works,
+      AsyncPriority priority) noexcept override {
+    if (schedule_pre_caller) {
+      for (auto& work : works) {
+        work = AsyncOperation([&, work = std::move(work)]() mutable {
+          if (schedule_pre_caller()) {
+            work();
+          }
+        });
+      }
+    }
+
+    return AsyncExecutor::ScheduleBatch(works, priority);
+  }
+
   std::function<bool()> schedule_pre_caller;
   std::function<bool()> schedule_for_pre_caller;
 };
@@ -0,0 +1,54 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "admission_controller.h"
+
+#include <atomic>
+
+namespace google::scp::core {
+void AdmissionController::OnTaskDequeued(
+    Timestamp enqueue_timestamp, Timestamp dequeue_timestamp) noexcept {
+  // The steady clock of the scheduling thread may be read slightly after the
+  // one of the worker.
+  Timestamp sojourn_time = dequeue_timestamp > enqueue_timestamp
+                               ? dequeue_timestamp - enqueue_timestamp
+                               : 0;
+  last_sojourn_time_.store(sojourn_time, std::memory_order_relaxed);
+
+  if (sojourn_time < static_cast<Timestamp>(
+                         options_.target_sojourn_time.count())) {
+    overloaded_timestamp_ = 0;
+    if (IsOverloaded()) {
+      overloaded_.store(false, std::memory_order_relaxed);
+    }
+    return;
+  }
+
+  if (overloaded_timestamp_ == 0) {
+    overloaded_timestamp_ = dequeue_timestamp + options_.interval.count();
+    return;
+  }
+  if (dequeue_timestamp >= overloaded_timestamp_ && !IsOverloaded()) {
+    overloaded_.store(true, std::memory_order_relaxed);
+  }
+}
+
+void AdmissionController::OnQueueEmpty() noexcept {
+  overloaded_timestamp_ = 0;
+  last_sojourn_time_.store(0, std::memory_order_relaxed);
+  if (IsOverloaded()) {
+    overloaded_.store(false, std::memory_order_relaxed);
+  }
+}
+}  // namespace google::scp::core
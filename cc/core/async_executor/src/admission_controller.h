@@ -0,0 +1,89 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include "cc/core/interface/type_def.h"
+
+namespace google::scp::core {
+/// The settings of the admission control of an executor queue.
+struct AdmissionControlOptions {
+  /// Whether the new normal priority requests are rejected while the queue is
+  /// overloaded, see AsyncExecutorInterface::CheckAdmission. The tasks of the
+  /// admitted requests are never rejected. The sojourn time is tracked either
+  /// way.
+  bool enabled = false;
+  /// The sojourn time the queue may keep without being overloaded.
+  std::chrono::nanoseconds target_sojourn_time = std::chrono::milliseconds(5);
+  /// How long the sojourn time must stay above the target before the queue is
+  /// overloaded. It absorbs the bursts the queue is there for.
+  std::chrono::nanoseconds interval = std::chrono::milliseconds(100);
+};
+
+/**
+ * @brief Tells whether an executor queue is overloaded from the time its tasks
+ * wait in it (their sojourn time), as CoDel does. The queue is overloaded once
+ * the sojourn time stays above the target for a whole interval, i.e. once it
+ * has a standing queue rather than a burst, and stops being overloaded as soon
+ * as a task waits less than the target or the queue is empty. Unlike a queue
+ * length, the sojourn time does not depend on how long the tasks take.
+ *
+ * The sojourn times are recorded by the worker thread of the queue only, while
+ * any thread may check whether the queue is overloaded.
+ */
+class AdmissionController {
+ public:
+  explicit AdmissionController(
+      AdmissionControlOptions options = AdmissionControlOptions())
+      : options_(options) {}
+
+  /**
+   * @brief Records the sojourn time of a task dequeued by the worker thread.
+   *
+   * @param enqueue_timestamp the steady timestamp the task was enqueued at.
+   * @param dequeue_timestamp the steady timestamp the task was dequeued at.
+   */
+  void OnTaskDequeued(Timestamp enqueue_timestamp,
+                      Timestamp dequeue_timestamp) noexcept;
+
+  /// Records that the worker thread found the queue empty.
+  void OnQueueEmpty() noexcept;
+
+  /// Returns whether the new normal priority tasks must be rejected.
+  bool ShouldReject() const noexcept {
+    return options_.enabled && IsOverloaded();
+  }
+
+  /// Returns whether the queue is overloaded.
+  bool IsOverloaded() const noexcept {
+    return overloaded_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the sojourn time of the last dequeued task, in nanoseconds.
+  Timestamp GetLastSojournTime() const noexcept {
+    return last_sojourn_time_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  const AdmissionControlOptions options_;
+  /// When the queue becomes overloaded if the sojourn time stays above the
+  /// target, or 0 while it is below the target. Only used by the worker.
+  Timestamp overloaded_timestamp_ = 0;
+  std::atomic<bool> overloaded_ = false;
+  std::atomic<Timestamp> last_sojourn_time_ = 0;
+};
+}  // namespace google::scp::core
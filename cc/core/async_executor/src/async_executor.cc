@@ -14,13 +14,18 @@
 
 #include "async_executor.h"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <functional>
 #include <memory>
 #include <random>
 #include <thread>
+#include <variant>
+#include <utility>
 #include <vector>
 
+#include "cc/core/common/time_provider/src/time_provider.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/async_executor_interface.h"
 #include "cc/public/core/interface/execution_result.h"
@@ -28,6 +33,7 @@
 #include "error_codes.h"
 #include "typedef.h"
 
+using google::scp::core::common::TimeProvider;
 using std::atomic;
 using std::is_same_v;
 using std::make_shared;
@@ -40,6 +46,39 @@ using std::vector;
 using std::this_thread::get_id;
 
 namespace google::scp::core {
+AsyncExecutor::~AsyncExecutor() {
+  if (queue_size_instrument_) {
+    queue_size_instrument_->RemoveCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &AsyncExecutor::ObserveQueueSizeCallback),
+        this);
+  }
+  if (queue_sojourn_time_instrument_) {
+    queue_sojourn_time_instrument_->RemoveCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &AsyncExecutor::ObserveQueueSojournTimeCallback),
+        this);
+  }
+  if (task_queue_wait_time_instrument_) {
+    task_queue_wait_time_instrument_->RemoveCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &AsyncExecutor::ObserveTaskQueueWaitTimeCallback),
+        this);
+  }
+  if (task_run_time_instrument_) {
+    task_run_time_instrument_->RemoveCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &AsyncExecutor::ObserveTaskRunTimeCallback),
+        this);
+  }
+  if (queue_depth_instrument_) {
+    queue_depth_instrument_->RemoveCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &AsyncExecutor::ObserveQueueDepthCallback),
+        this);
+  }
+}
+
 ExecutionResult AsyncExecutor::Init() noexcept {
   if (thread_count_ <= 0 || thread_count_ > kMaxThreadCount) {
     return FailureExecutionResult(
@@ -51,9 +90,13 @@ ExecutionResult AsyncExecutor::Init() noexcept {
   }
 
   for (size_t i = 0; i < thread_count_; ++i) {
-    // TODO We select the CPU affinity just starting at 0 and working our way
-    // up. Should we instead randomly assign the CPUs?
-    size_t cpu_affinity_number = i % std::thread::hardware_concurrency();
+    // Without given CPUs, we select the CPU affinity just starting at 0 and
+    // working our way up.
+    const auto& cpu_affinity_numbers = options_.cpu_affinity_numbers;
+    size_t cpu_affinity_number =
+        cpu_affinity_numbers.empty()
+            ? i % std::thread::hardware_concurrency()
+            : cpu_affinity_numbers[i % cpu_affinity_numbers.size()];
     urgent_task_executor_pool_.push_back(
         make_shared<SingleThreadPriorityAsyncExecutor>(
             queue_cap_, drop_tasks_on_stop_, cpu_affinity_number));
@@ -61,14 +104,121 @@ ExecutionResult AsyncExecutor::Init() noexcept {
     if (!execution_result.Successful()) {
       return execution_result;
     }
+    if (options_.elastic_pool.enabled) {
+      continue;
+    }
     normal_task_executor_pool_.push_back(make_shared<SingleThreadAsyncExecutor>(
-        queue_cap_, drop_tasks_on_stop_, cpu_affinity_number));
+        queue_cap_, drop_tasks_on_stop_, cpu_affinity_number,
+        options_.admission_control));
     execution_result = normal_task_executor_pool_.back()->Init();
     if (!execution_result.Successful()) {
       return execution_result;
     }
   }
 
+  if (options_.elastic_pool.enabled) {
+    elastic_thread_pool_ = std::make_unique<ElasticThreadPool>(
+        thread_count_, queue_cap_, drop_tasks_on_stop_, options_.elastic_pool,
+        options_.admission_control);
+    RETURN_IF_FAILURE(elastic_thread_pool_->Init());
+  } else if (task_load_balancing_scheme_ ==
+             TaskLoadBalancingScheme::WorkStealing) {
+    // Each normal executor steals from all the others, starting with the next
+    // one so that the victims of idle executors are spread out.
+    for (size_t i = 0; i < thread_count_; ++i) {
+      vector<NormalTaskExecutor*> victims;
+      victims.reserve(thread_count_ - 1);
+      for (size_t j = 1; j < thread_count_; ++j) {
+        victims.push_back(
+            normal_task_executor_pool_.at((i + j) % thread_count_).get());
+      }
+      RETURN_IF_FAILURE(normal_task_executor_pool_.at(i)->EnableWorkStealing(
+          std::move(victims)));
+    }
+  }
+
+  return OtelMetricInit();
+}
+
+ExecutionResult AsyncExecutor::OtelMetricInit() noexcept {
+  if (!metric_router_) {
+    return SuccessExecutionResult();
+  }
+
+  meter_ = metric_router_->GetOrCreateMeter(kAsyncExecutorMeter);
+
+  // The instruments are shared by all the executors, which observe them with
+  // their own name.
+  queue_size_instrument_ = metric_router_->GetOrCreateObservableInstrument(
+      kAsyncExecutorQueueSizeMetric,
+      [&]() -> std::shared_ptr<opentelemetry::metrics::ObservableInstrument> {
+        return meter_->CreateInt64ObservableGauge(
+            kAsyncExecutorQueueSizeMetric,
+            "Number of tasks waiting in the async executor queues.");
+      });
+  queue_size_instrument_->AddCallback(
+      reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+          &AsyncExecutor::ObserveQueueSizeCallback),
+      this);
+
+  queue_sojourn_time_instrument_ =
+      metric_router_->GetOrCreateObservableInstrument(
+          kAsyncExecutorQueueSojournTimeMetric,
+          [&]() -> std::shared_ptr<
+                    opentelemetry::metrics::ObservableInstrument> {
+            return meter_->CreateDoubleObservableGauge(
+                kAsyncExecutorQueueSojournTimeMetric,
+                "Longest time the last tasks waited in the async executor "
+                "queues.",
+                kSecondUnit);
+          });
+  queue_sojourn_time_instrument_->AddCallback(
+      reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+          &AsyncExecutor::ObserveQueueSojournTimeCallback),
+      this);
+
+  task_queue_wait_time_instrument_ =
+      metric_router_->GetOrCreateObservableInstrument(
+          kAsyncExecutorTaskQueueWaitTimeMetric,
+          [&]() -> std::shared_ptr<
+                    opentelemetry::metrics::ObservableInstrument> {
+            return meter_->CreateDoubleObservableGauge(
+                kAsyncExecutorTaskQueueWaitTimeMetric,
+                "Quantiles of the time the tasks waited in the async executor "
+                "queues after they were due.",
+                kSecondUnit);
+          });
+  task_queue_wait_time_instrument_->AddCallback(
+      reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+          &AsyncExecutor::ObserveTaskQueueWaitTimeCallback),
+      this);
+
+  task_run_time_instrument_ = metric_router_->GetOrCreateObservableInstrument(
+      kAsyncExecutorTaskRunTimeMetric,
+      [&]() -> std::shared_ptr<opentelemetry::metrics::ObservableInstrument> {
+        return meter_->CreateDoubleObservableGauge(
+            kAsyncExecutorTaskRunTimeMetric,
+            "Quantiles of the time the async executor tasks ran for.",
+            kSecondUnit);
+      });
+  task_run_time_instrument_->AddCallback(
+      reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+          &AsyncExecutor::ObserveTaskRunTimeCallback),
+      this);
+
+  queue_depth_instrument_ = metric_router_->GetOrCreateObservableInstrument(
+      kAsyncExecutorQueueDepthMetric,
+      [&]() -> std::shared_ptr<opentelemetry::metrics::ObservableInstrument> {
+        return meter_->CreateDoubleObservableGauge(
+            kAsyncExecutorQueueDepthMetric,
+            "Quantiles of the number of tasks waiting in an async executor "
+            "queue when one is dequeued.");
+      });
+  queue_depth_instrument_->AddCallback(
+      reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+          &AsyncExecutor::ObserveQueueDepthCallback),
+      this);
+
   return SuccessExecutionResult();
 }
 
@@ -78,7 +228,8 @@ ExecutionResult AsyncExecutor::Run() noexcept {
   }
 
   if (urgent_task_executor_pool_.size() < thread_count_ ||
-      normal_task_executor_pool_.size() < thread_count_) {
+      (!elastic_thread_pool_ &&
+       normal_task_executor_pool_.size() < thread_count_)) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_INITIALIZED);
   }
 
@@ -88,6 +239,13 @@ ExecutionResult AsyncExecutor::Run() noexcept {
     if (!execution_result.Successful()) {
       return execution_result;
     }
+    if (elastic_thread_pool_) {
+      // The threads of the elastic pool have no affinity.
+      ASSIGN_OR_RETURN(auto urgent_thread_id, urgent_executor->GetThreadId());
+      thread_id_to_executor_map_[urgent_thread_id] = {nullptr,
+                                                      urgent_executor};
+      continue;
+    }
     auto& normal_executor = normal_task_executor_pool_.at(i);
     execution_result = normal_executor->Run();
     if (!execution_result.Successful()) {
@@ -104,6 +262,10 @@ ExecutionResult AsyncExecutor::Run() noexcept {
                                                     urgent_executor};
   }
 
+  if (elastic_thread_pool_) {
+    RETURN_IF_FAILURE(elastic_thread_pool_->Run());
+  }
+
   running_ = true;
 
   return SuccessExecutionResult();
@@ -122,12 +284,18 @@ ExecutionResult AsyncExecutor::Stop() noexcept {
     if (!execution_result.Successful()) {
       return execution_result;
     }
+    if (elastic_thread_pool_) {
+      continue;
+    }
     execution_result = normal_task_executor_pool_.at(i)->Stop();
     if (!execution_result.Successful()) {
       return execution_result;
     }
   }
 
+  if (elastic_thread_pool_) {
+    return elastic_thread_pool_->Stop();
+  }
   return SuccessExecutionResult();
 }
 
@@ -171,6 +339,18 @@ ExecutionResultOr<shared_ptr<TaskExecutorType>> AsyncExecutor::PickTaskExecutor(
     // an executor normally.
   }
 
+  if (task_load_balancing_scheme == TaskLoadBalancingScheme::WorkStealing) {
+    if constexpr (is_same_v<TaskExecutorType, NormalTaskExecutor>) {
+      // Keep the task on the calling executor, where it is cache-hot, and let
+      // the idle executors steal it.
+      auto found_executors = thread_id_to_executor_map_.find(get_id());
+      if (found_executors != thread_id_to_executor_map_.end()) {
+        return found_executors->second.first;
+      }
+    }
+    task_load_balancing_scheme = TaskLoadBalancingScheme::RoundRobinGlobal;
+  }
+
   if (task_load_balancing_scheme ==
       TaskLoadBalancingScheme::RoundRobinPerThread) {
     if (task_executor_pool_type == TaskExecutorPoolType::UrgentPool) {
@@ -222,6 +402,18 @@ ExecutionResult AsyncExecutor::Schedule(const AsyncOperation& work,
 ExecutionResult AsyncExecutor::Schedule(
     const AsyncOperation& work, AsyncPriority priority,
     AsyncExecutorAffinitySetting affinity) noexcept {
+  return AsyncExecutor::Schedule(AsyncOperation(work), priority, affinity);
+}
+
+ExecutionResult AsyncExecutor::Schedule(AsyncOperation&& work,
+                                        AsyncPriority priority) noexcept {
+  return Schedule(std::move(work), priority,
+                  AsyncExecutorAffinitySetting::NonAffinitized);
+}
+
+ExecutionResult AsyncExecutor::Schedule(
+    AsyncOperation&& work, AsyncPriority priority,
+    AsyncExecutorAffinitySetting affinity) noexcept {
   if (!running_) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
   }
@@ -231,17 +423,27 @@ ExecutionResult AsyncExecutor::Schedule(
                      PickTaskExecutor(affinity, urgent_task_executor_pool_,
                                       TaskExecutorPoolType::UrgentPool,
                                       task_load_balancing_scheme_));
-    AsyncTask task(work);  // Creates a task for now
-    return task_executor->ScheduleFor(work, task.GetExecutionTimestamp());
+    // Schedules the task for now.
+    return task_executor->ScheduleFor(
+        std::move(work),
+        TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks());
   }
 
   if (priority == AsyncPriority::Normal || priority == AsyncPriority::High) {
+    if (elastic_thread_pool_) {
+      return elastic_thread_pool_->Schedule(std::move(work), priority);
+    }
     ASSIGN_OR_RETURN(auto task_executor,
                      PickTaskExecutor(affinity, normal_task_executor_pool_,
                                       TaskExecutorPoolType::NotUrgentPool,
                                       task_load_balancing_scheme_));
 
-    return task_executor->Schedule(work, priority);
+    if (task_load_balancing_scheme_ == TaskLoadBalancingScheme::WorkStealing &&
+        priority == AsyncPriority::Normal &&
+        affinity == AsyncExecutorAffinitySetting::NonAffinitized) {
+      return task_executor->ScheduleStealable(std::move(work));
+    }
+    return task_executor->Schedule(std::move(work), priority);
   }
 
   return FailureExecutionResult(
@@ -272,6 +474,35 @@ ExecutionResult AsyncExecutor::ScheduleFor(
     const AsyncOperation& work, Timestamp timestamp,
     TaskCancellationLambda& cancellation_callback,
     AsyncExecutorAffinitySetting affinity) noexcept {
+  return AsyncExecutor::ScheduleFor(AsyncOperation(work), timestamp,
+                                    cancellation_callback, affinity);
+}
+
+ExecutionResult AsyncExecutor::ScheduleFor(AsyncOperation&& work,
+                                           Timestamp timestamp) noexcept {
+  return ScheduleFor(std::move(work), timestamp,
+                     AsyncExecutorAffinitySetting::NonAffinitized);
+}
+
+ExecutionResult AsyncExecutor::ScheduleFor(
+    AsyncOperation&& work, Timestamp timestamp,
+    AsyncExecutorAffinitySetting affinity) noexcept {
+  TaskCancellationLambda cancellation_callback = {};
+  return ScheduleFor(std::move(work), timestamp, cancellation_callback,
+                     affinity);
+}
+
+ExecutionResult AsyncExecutor::ScheduleFor(
+    AsyncOperation&& work, Timestamp timestamp,
+    TaskCancellationLambda& cancellation_callback) noexcept {
+  return ScheduleFor(std::move(work), timestamp, cancellation_callback,
+                     AsyncExecutorAffinitySetting::NonAffinitized);
+}
+
+ExecutionResult AsyncExecutor::ScheduleFor(
+    AsyncOperation&& work, Timestamp timestamp,
+    TaskCancellationLambda& cancellation_callback,
+    AsyncExecutorAffinitySetting affinity) noexcept {
   if (!running_) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
   }
@@ -280,7 +511,209 @@ ExecutionResult AsyncExecutor::ScheduleFor(
                    PickTaskExecutor(affinity, urgent_task_executor_pool_,
                                     TaskExecutorPoolType::UrgentPool,
                                     task_load_balancing_scheme_));
-  return task_executor->ScheduleFor(work, timestamp, cancellation_callback);
+  return task_executor->ScheduleFor(std::move(work), timestamp,
+                                    cancellation_callback);
+}
+
+vector<ExecutionResult> AsyncExecutor::ScheduleBatch(
+    absl::Span<AsyncOperation> works, AsyncPriority priority) noexcept {
+  vector<ExecutionResult> results(works.size(), SuccessExecutionResult());
+  if (!running_) {
+    std::fill(results.begin(), results.end(),
+              FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING));
+    return results;
+  }
+
+  if (priority != AsyncPriority::Normal && priority != AsyncPriority::High &&
+      priority != AsyncPriority::Urgent) {
+    std::fill(results.begin(), results.end(),
+              FailureExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_INVALID_PRIORITY_TYPE));
+    return results;
+  }
+
+  if (elastic_thread_pool_ && priority != AsyncPriority::Urgent) {
+    // The threads of the elastic pool share their queues.
+    for (size_t i = 0; i < works.size(); ++i) {
+      results[i] =
+          elastic_thread_pool_->Schedule(std::move(works[i]), priority);
+    }
+    return results;
+  }
+
+  // The batch is spread across the pool even when work stealing is enabled,
+  // since the runs are not stealable.
+  auto task_load_balancing_scheme =
+      task_load_balancing_scheme_ == TaskLoadBalancingScheme::WorkStealing
+          ? TaskLoadBalancingScheme::RoundRobinGlobal
+          : task_load_balancing_scheme_;
+  size_t run_count = std::min(thread_count_, works.size());
+  for (size_t i = 0; i < run_count; ++i) {
+    size_t begin = works.size() * i / run_count;
+    size_t end = works.size() * (i + 1) / run_count;
+    auto run = works.subspan(begin, end - begin);
+    auto run_results = absl::MakeSpan(results).subspan(begin, end - begin);
+
+    if (priority == AsyncPriority::Urgent) {
+      auto task_executor = PickTaskExecutor(
+          AsyncExecutorAffinitySetting::NonAffinitized,
+          urgent_task_executor_pool_, TaskExecutorPoolType::UrgentPool,
+          task_load_balancing_scheme);
+      if (!task_executor.Successful()) {
+        std::fill(run_results.begin(), run_results.end(),
+                  task_executor.result());
+        continue;
+      }
+      (*task_executor)->ScheduleBatch(run, run_results);
+      continue;
+    }
+
+    auto task_executor = PickTaskExecutor(
+        AsyncExecutorAffinitySetting::NonAffinitized,
+        normal_task_executor_pool_, TaskExecutorPoolType::NotUrgentPool,
+        task_load_balancing_scheme);
+    if (!task_executor.Successful()) {
+      std::fill(run_results.begin(), run_results.end(),
+                task_executor.result());
+      continue;
+    }
+    (*task_executor)->ScheduleBatch(run, priority, run_results);
+  }
+  return results;
+}
+
+ExecutionResult AsyncExecutor::CheckAdmission(
+    AsyncPriority priority) noexcept {
+  if (priority != AsyncPriority::Normal ||
+      !options_.admission_control.enabled) {
+    return SuccessExecutionResult();
+  }
+
+  if (!running_) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
+  }
+
+  if (elastic_thread_pool_) {
+    return elastic_thread_pool_->IsOverloaded()
+               ? FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_OVERLOADED)
+               : SuccessExecutionResult();
+  }
+
+  size_t overloaded_executor_count = std::count_if(
+      normal_task_executor_pool_.begin(), normal_task_executor_pool_.end(),
+      [](const auto& executor) { return executor->IsOverloaded(); });
+  if (overloaded_executor_count * 2 >= normal_task_executor_pool_.size()) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_OVERLOADED);
+  }
+  return SuccessExecutionResult();
+}
+
+void AsyncExecutor::ObserveQueueSizeCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    absl::Nonnull<AsyncExecutor*> self_ptr) {
+  auto observer = std::get<
+      std::shared_ptr<opentelemetry::metrics::ObserverResultT<int64_t>>>(
+      observer_result);
+  int64_t queue_size = 0;
+  for (const auto& executor : self_ptr->normal_task_executor_pool_) {
+    queue_size += static_cast<int64_t>(executor->GetQueueSize());
+  }
+  if (self_ptr->elastic_thread_pool_) {
+    queue_size +=
+        static_cast<int64_t>(self_ptr->elastic_thread_pool_->GetQueueSize());
+  }
+  observer->Observe(queue_size, {{kAsyncExecutorNameLabel,
+                                  self_ptr->options_.name.c_str()}});
+}
+
+void AsyncExecutor::ObserveQueueSojournTimeCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    absl::Nonnull<AsyncExecutor*> self_ptr) {
+  auto observer = std::get<
+      std::shared_ptr<opentelemetry::metrics::ObserverResultT<double>>>(
+      observer_result);
+  Timestamp sojourn_time = 0;
+  for (const auto& executor : self_ptr->normal_task_executor_pool_) {
+    sojourn_time = std::max(sojourn_time, executor->GetLastSojournTime());
+  }
+  if (self_ptr->elastic_thread_pool_) {
+    sojourn_time = std::max(
+        sojourn_time, self_ptr->elastic_thread_pool_->GetLastSojournTime());
+  }
+  observer->Observe(static_cast<double>(sojourn_time) / 1e9,
+                    {{kAsyncExecutorNameLabel,
+                      self_ptr->options_.name.c_str()}});
+}
+
+void AsyncExecutor::ObserveTaskStats(
+    opentelemetry::metrics::ObserverResult observer_result,
+    LogLinearHistogram TaskStats::*histogram, double scale,
+    TaskStatsWindow& window) {
+  static constexpr std::array<const char*, kTaskPoolCount> kPoolNames = {
+      "urgent", "normal", "high"};
+  static constexpr std::array<std::pair<double, const char*>, 3> kQuantiles = {
+      {{0.5, "0.5"}, {0.99, "0.99"}, {0.999, "0.999"}}};
+
+  auto observer = std::get<
+      std::shared_ptr<opentelemetry::metrics::ObserverResultT<double>>>(
+      observer_result);
+  std::array<LogLinearHistogramSnapshot, kTaskPoolCount> snapshots;
+  for (const auto& executor : urgent_task_executor_pool_) {
+    (executor->GetTaskStats().*histogram).AddTo(snapshots[kUrgentTasks]);
+  }
+  for (const auto& executor : normal_task_executor_pool_) {
+    (executor->GetTaskStats(AsyncPriority::Normal).*histogram)
+        .AddTo(snapshots[kNormalTasks]);
+    (executor->GetTaskStats(AsyncPriority::High).*histogram)
+        .AddTo(snapshots[kHighTasks]);
+  }
+  if (elastic_thread_pool_) {
+    for (size_t i = 0; i < elastic_thread_pool_->GetMaxThreadCount(); ++i) {
+      (elastic_thread_pool_->GetTaskStats(i, AsyncPriority::Normal).*histogram)
+          .AddTo(snapshots[kNormalTasks]);
+      (elastic_thread_pool_->GetTaskStats(i, AsyncPriority::High).*histogram)
+          .AddTo(snapshots[kHighTasks]);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(window.mutex);
+  for (size_t pool = 0; pool < kTaskPoolCount; ++pool) {
+    LogLinearHistogramSnapshot interval = snapshots[pool];
+    interval.Subtract(window.snapshots[pool]);
+    window.snapshots[pool] = snapshots[pool];
+    if (interval.GetCount() == 0) {
+      continue;
+    }
+    for (const auto& [quantile, quantile_name] : kQuantiles) {
+      observer->Observe(
+          static_cast<double>(interval.GetValueAtQuantile(quantile)) * scale,
+          {{kAsyncExecutorNameLabel, options_.name.c_str()},
+           {kAsyncExecutorPoolLabel, kPoolNames[pool]},
+           {kAsyncExecutorQuantileLabel, quantile_name}});
+    }
+  }
+}
+
+void AsyncExecutor::ObserveTaskQueueWaitTimeCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    absl::Nonnull<AsyncExecutor*> self_ptr) {
+  self_ptr->ObserveTaskStats(observer_result, &TaskStats::queue_wait_time,
+                             /*scale=*/1e-9,
+                             self_ptr->task_queue_wait_time_window_);
+}
+
+void AsyncExecutor::ObserveTaskRunTimeCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    absl::Nonnull<AsyncExecutor*> self_ptr) {
+  self_ptr->ObserveTaskStats(observer_result, &TaskStats::run_time,
+                             /*scale=*/1e-9, self_ptr->task_run_time_window_);
+}
+
+void AsyncExecutor::ObserveQueueDepthCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    absl::Nonnull<AsyncExecutor*> self_ptr) {
+  self_ptr->ObserveTaskStats(observer_result, &TaskStats::queue_depth,
+                             /*scale=*/1, self_ptr->queue_depth_window_);
 }
 
 absl::flat_hash_map<std::thread::id, absl::Span<const absl::Duration>>
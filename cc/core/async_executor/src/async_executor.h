@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <functional>
@@ -21,19 +22,26 @@
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/base/nullability.h"
 #include "absl/types/span.h"
+#include "cc/core/async_executor/src/admission_controller.h"
 #include "cc/core/async_executor/src/async_task.h"
+#include "cc/core/async_executor/src/elastic_thread_pool.h"
 #include "cc/core/async_executor/src/error_codes.h"
 #include "cc/core/async_executor/src/single_thread_async_executor.h"
 #include "cc/core/async_executor/src/single_thread_priority_async_executor.h"
+#include "cc/core/async_executor/src/task_stats.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/async_executor_interface.h"
+#include "cc/core/telemetry/src/metric/metric_router.h"
 #include "cc/public/core/interface/execution_result.h"
+#include "opentelemetry/metrics/meter.h"
 
 static constexpr char kAsyncExecutor[] = "AsyncExecutor";
 
@@ -54,7 +62,15 @@ enum class TaskLoadBalancingScheme {
   /**
    * @brief Random across the executors
    */
-  Random = 2
+  Random = 2,
+  /**
+   * @brief Round Robin across the executors for the tasks scheduled from other
+   * threads, and to the calling executor for the tasks scheduled from the
+   * executors. The normal priority tasks which are not affinitized may then be
+   * stolen by any idle executor, so that they do not wait behind a long
+   * running task. Urgent tasks are spread Round Robin and never stolen.
+   */
+  WorkStealing = 3
 };
 
 /**
@@ -64,6 +80,23 @@ enum class TaskLoadBalancingScheme {
  */
 enum class TaskExecutorPoolType { UrgentPool = 0, NotUrgentPool = 1 };
 
+/// The optional settings of an AsyncExecutor.
+struct AsyncExecutorOptions {
+  /// The name of the executor in its metrics.
+  std::string name = "default";
+  /// The CPUs to pin the threads to, in turn, e.g. a partition of the
+  /// CpuTopology. All the CPUs are used if empty.
+  std::vector<size_t> cpu_affinity_numbers;
+  /// The admission control of the normal priority requests, from the sojourn
+  /// time of each thread. Only CheckAdmission rejects requests, the tasks
+  /// themselves are always scheduled.
+  AdmissionControlOptions admission_control;
+  /// Runs the normal and high priority tasks on an ElasticThreadPool of at
+  /// least thread_count threads, e.g. for tasks blocking on IO. The urgent
+  /// tasks still run on pinned threads.
+  ElasticThreadPoolOptions elastic_pool;
+};
+
 /*! @copydoc AsyncExecutorInterface
  */
 class AsyncExecutor : public AsyncExecutorInterface {
@@ -79,16 +112,25 @@ class AsyncExecutor : public AsyncExecutorInterface {
    * the tasks during the stop operation.
    * @param task_load_balancing_scheme indicates the type of load balancing
    * scheme to use for the tasks
+   * @param options the optional settings of the executor.
+   * @param metric_router an instance of metric router to export the queue
+   * and task metrics with. They are not exported if it is nullptr.
    */
   AsyncExecutor(size_t thread_count, size_t queue_cap,
                 bool drop_tasks_on_stop = false,
                 TaskLoadBalancingScheme task_load_balancing_scheme =
-                    TaskLoadBalancingScheme::RoundRobinGlobal)
+                    TaskLoadBalancingScheme::RoundRobinGlobal,
+                AsyncExecutorOptions options = AsyncExecutorOptions(),
+                absl::Nullable<MetricRouter*> metric_router = nullptr)
       : running_(false),
         thread_count_(thread_count),
         queue_cap_(queue_cap),
         drop_tasks_on_stop_(drop_tasks_on_stop),
-        task_load_balancing_scheme_(task_load_balancing_scheme) {}
+        task_load_balancing_scheme_(task_load_balancing_scheme),
+        options_(std::move(options)),
+        metric_router_(metric_router) {}
+
+  ~AsyncExecutor() override;
 
   ExecutionResult Init() noexcept override;
 
@@ -119,6 +161,46 @@ class AsyncExecutor : public AsyncExecutorInterface {
       TaskCancellationLambda& cancellation_callback,
       AsyncExecutorAffinitySetting affinity) noexcept override;
 
+  ExecutionResult Schedule(AsyncOperation&& work,
+                           AsyncPriority priority) noexcept override;
+
+  ExecutionResult Schedule(
+      AsyncOperation&& work, AsyncPriority priority,
+      AsyncExecutorAffinitySetting affinity) noexcept override;
+
+  ExecutionResult ScheduleFor(AsyncOperation&& work,
+                              Timestamp timestamp) noexcept override;
+
+  ExecutionResult ScheduleFor(
+      AsyncOperation&& work, Timestamp timestamp,
+      AsyncExecutorAffinitySetting affinity) noexcept override;
+
+  ExecutionResult ScheduleFor(
+      AsyncOperation&& work, Timestamp timestamp,
+      TaskCancellationLambda& cancellation_callback) noexcept override;
+
+  ExecutionResult ScheduleFor(
+      AsyncOperation&& work, Timestamp timestamp,
+      TaskCancellationLambda& cancellation_callback,
+      AsyncExecutorAffinitySetting affinity) noexcept override;
+
+  /**
+   * @brief Splits the batch into contiguous runs of tasks, one per thread of
+   * the pool at most, so that each picked thread gets a single run and is
+   * woken up at most once.
+   */
+  std::vector<ExecutionResult> ScheduleBatch(
+      absl::Span<AsyncOperation> works,
+      AsyncPriority priority) noexcept override;
+
+  /**
+   * @brief Rejects the normal priority operations while at least half of the
+   * threads are overloaded, provided that admission control is enabled. A
+   * single overloaded thread does not reject the requests, since the
+   * operations are spread across the threads.
+   */
+  ExecutionResult CheckAdmission(AsyncPriority priority) noexcept override;
+
   // Returns a map of thread ID to list of scheduling latency. This method
   // should only be used for testing purpose and must not be used in
   // production. The preprocessor macro PBS_ENABLE_BENCHMARKING must be defined.
@@ -136,6 +218,76 @@ class AsyncExecutor : public AsyncExecutorInterface {
       TaskExecutorPoolType task_executor_pool_type,
       TaskLoadBalancingScheme task_load_balancing_scheme);
 
+  /// Sets up the OpenTelemetry instruments of the queues.
+  ExecutionResult OtelMetricInit() noexcept;
+
+  /**
+   * @brief Callback used by OpenTelemetry to observe the number of tasks
+   * waiting in the normal priority queues.
+   *
+   * @param observer_result The result object to report the size with.
+   * @param self_ptr A pointer to the executor.
+   */
+  static void ObserveQueueSizeCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      absl::Nonnull<AsyncExecutor*> self_ptr);
+
+  /**
+   * @brief Callback used by OpenTelemetry to observe the longest sojourn time
+   * of the last normal priority tasks of the threads, in seconds.
+   *
+   * @param observer_result The result object to report the time with.
+   * @param self_ptr A pointer to the executor.
+   */
+  static void ObserveQueueSojournTimeCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      absl::Nonnull<AsyncExecutor*> self_ptr);
+
+  /// The pools of tasks the task metrics are reported for.
+  enum TaskPool : size_t { kUrgentTasks = 0, kNormalTasks, kHighTasks };
+  static constexpr size_t kTaskPoolCount = 3;
+
+  /**
+   * @brief The snapshots of a histogram of the task statistics of the threads
+   * at the last observation, merged per pool. Each observation reports the
+   * quantiles of the tasks recorded since the previous one.
+   */
+  struct TaskStatsWindow {
+    std::mutex mutex;
+    std::array<LogLinearHistogramSnapshot, kTaskPoolCount> snapshots;
+  };
+
+  /**
+   * @brief Observes the quantiles of one histogram of the task statistics of
+   * each pool, over the tasks recorded since the previous observation.
+   *
+   * @param observer_result The result object to report the quantiles with.
+   * @param histogram The histogram of the task statistics to report.
+   * @param scale The factor converting the values to the unit of the metric.
+   * @param window The snapshots of the previous observation.
+   */
+  void ObserveTaskStats(opentelemetry::metrics::ObserverResult observer_result,
+                        LogLinearHistogram TaskStats::*histogram, double scale,
+                        TaskStatsWindow& window);
+
+  /**
+   * @brief Callbacks used by OpenTelemetry to observe the quantiles of the
+   * time the tasks waited in the queues and ran for, in seconds, and of the
+   * number of tasks waiting when one is dequeued.
+   *
+   * @param observer_result The result object to report the quantiles with.
+   * @param self_ptr A pointer to the executor.
+   */
+  static void ObserveTaskQueueWaitTimeCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      absl::Nonnull<AsyncExecutor*> self_ptr);
+  static void ObserveTaskRunTimeCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      absl::Nonnull<AsyncExecutor*> self_ptr);
+  static void ObserveQueueDepthCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      absl::Nonnull<AsyncExecutor*> self_ptr);
+
   /**
    * @brief While it is true, the thread pool will keep listening and
    * picking out work from work queue. While it is false, the thread pool
@@ -152,6 +304,9 @@ class AsyncExecutor : public AsyncExecutorInterface {
   std::vector<std::shared_ptr<UrgentTaskExecutor>> urgent_task_executor_pool_;
   /// Executor pool for normal work.
   std::vector<std::shared_ptr<NormalTaskExecutor>> normal_task_executor_pool_;
+  /// Thread pool for normal work instead of normal_task_executor_pool_, if
+  /// the elastic pool is enabled.
+  std::unique_ptr<ElasticThreadPool> elastic_thread_pool_;
   /// A map of (normal executor and urgent executor) thread IDs and their
   /// corresponding executors (the normal executor and then the urgent executor
   /// with the same affinity).
@@ -161,5 +316,28 @@ class AsyncExecutor : public AsyncExecutorInterface {
   /// Load balancing scheme to distribute incoming tasks on to the thread pool
   /// threads.
   TaskLoadBalancingScheme task_load_balancing_scheme_;
+  /// The optional settings of the executor.
+  const AsyncExecutorOptions options_;
+  /// An instance of metric router which will provide APIs to create metrics.
+  MetricRouter* metric_router_;
+  /// OpenTelemetry Meter used for creating and managing metrics.
+  std::shared_ptr<opentelemetry::metrics::Meter> meter_;
+  /// OpenTelemetry Instrument for the number of tasks in the queues.
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      queue_size_instrument_;
+  /// OpenTelemetry Instrument for the sojourn time of the queues.
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      queue_sojourn_time_instrument_;
+  /// OpenTelemetry Instruments for the task statistics of the threads.
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      task_queue_wait_time_instrument_;
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      task_run_time_instrument_;
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      queue_depth_instrument_;
+  /// The snapshots of the previous observation of each task statistic.
+  TaskStatsWindow task_queue_wait_time_window_;
+  TaskStatsWindow task_run_time_window_;
+  TaskStatsWindow queue_depth_window_;
 };
 }  // namespace google::scp::core
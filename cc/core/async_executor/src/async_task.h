@@ -14,13 +14,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <memory>
-#include <mutex>
-#include <queue>
-#include <thread>
-#include <vector>
+#include <new>
+#include <utility>
 
+#include "cc/core/async_executor/src/async_task_pool.h"
 #include "cc/core/common/time_provider/src/time_provider.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/async_executor_interface.h"
@@ -30,7 +31,8 @@ namespace google::scp::core {
 
 /**
  * @brief  Is used by the async executor to encapsulate the async operations
- * provided by the user.
+ * provided by the user. Tasks are allocated from a ThreadLocalBlockPool, and
+ * are cancelled with an atomic state rather than a lock.
  */
 class AsyncTask {
  public:
@@ -38,15 +40,31 @@ class AsyncTask {
    * @brief Construct a new Async Task object. By default the execution time
    * will be set to the current time.
    *
-   * @param async_operation The async operation to be executed.
+   * @param async_operation The async operation to be executed, moved into the
+   * task.
    */
   AsyncTask(
       AsyncOperation async_operation = AsyncOperation([]() {}),
       Timestamp execution_timestamp =
           common::TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks())
-      : async_operation_(async_operation),
+      : async_operation_(std::move(async_operation)),
         execution_timestamp_(execution_timestamp),
-        is_cancelled_(false) {}
+        state_(State::kPending) {}
+
+  static void* operator new(size_t size) {
+    if (size != sizeof(AsyncTask)) {
+      return ::operator new(size);
+    }
+    return ThreadLocalBlockPool<sizeof(AsyncTask)>::Allocate();
+  }
+
+  static void operator delete(void* task, size_t size) noexcept {
+    if (size != sizeof(AsyncTask)) {
+      ::operator delete(task);
+      return;
+    }
+    ThreadLocalBlockPool<sizeof(AsyncTask)>::Deallocate(task);
+  }
 
 #if defined(PBS_ENABLE_BENCHMARKING)
   absl::Time GetTaskCreationTime() const {
@@ -61,36 +79,36 @@ class AsyncTask {
    */
   Timestamp GetExecutionTimestamp() const { return execution_timestamp_; }
 
-  /// Calls the current task to be executed.
+  /// Calls the current task to be executed, unless it was cancelled.
   void Execute() {
-    cancellation_mutex_.lock();
-    if (is_cancelled_) {
-      cancellation_mutex_.unlock();
+    auto expected_state = State::kPending;
+    if (!state_.compare_exchange_strong(expected_state, State::kExecuted,
+                                        std::memory_order_acq_rel)) {
       return;
     }
     async_operation_();
-    cancellation_mutex_.unlock();
   }
 
-  /// Calls the current task to be cancelled.
+  /**
+   * @brief Calls the current task to be cancelled.
+   *
+   * @return true if the task is cancelled, false if it was already cancelled
+   * or started executing.
+   */
   bool Cancel() {
-    cancellation_mutex_.lock();
-    if (is_cancelled_) {
-      cancellation_mutex_.unlock();
-      return false;
-    }
-
-    is_cancelled_ = true;
-    cancellation_mutex_.unlock();
-    return true;
+    auto expected_state = State::kPending;
+    return state_.compare_exchange_strong(expected_state, State::kCancelled,
+                                          std::memory_order_acq_rel);
   }
 
   bool IsCancelled() {
-    std::unique_lock lock(cancellation_mutex_);
-    return is_cancelled_;
+    return state_.load(std::memory_order_acquire) == State::kCancelled;
   }
 
  private:
+  /// The states of a task, which only leaves kPending once.
+  enum class State : uint8_t { kPending, kExecuted, kCancelled };
+
   /// Async operation to be executed.
   AsyncOperation async_operation_;
 
@@ -100,11 +118,8 @@ class AsyncTask {
    */
   Timestamp execution_timestamp_;
 
-  /// Cancellation mutex
-  std::mutex cancellation_mutex_;
-
-  /// Indicates whether a task was cancelled.
-  bool is_cancelled_;
+  /// Whether the task is pending, executed or cancelled.
+  std::atomic<State> state_;
 };
 
 /// Comparer class for the AsyncTasks
@@ -0,0 +1,137 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+#include "cc/core/async_executor/src/typedef.h"
+
+namespace google::scp::core {
+/**
+ * @brief A per-thread cache of memory blocks of kBlockSize bytes. The blocks
+ * freed by a thread are reused by the next allocations of the same thread
+ * without any synchronization, which suits the tasks the executor threads keep
+ * scheduling and running. Up to kAsyncTaskPoolCapacityPerThread blocks are
+ * cached per thread, the others are returned to the heap.
+ *
+ * @tparam kBlockSize the size of the blocks.
+ */
+template <size_t kBlockSize>
+class ThreadLocalBlockPool {
+ public:
+  static_assert(kBlockSize >= sizeof(void*));
+
+  /// Allocates a block, reusing a cached one if possible.
+  static void* Allocate() {
+    auto& cache = cache_;
+    if (cache.head == nullptr) {
+      return ::operator new(kBlockSize);
+    }
+    auto* block = cache.head;
+    cache.head = block->next;
+    cache.size--;
+    return block;
+  }
+
+  /// Frees a block allocated by any thread, caching it if possible.
+  static void Deallocate(void* block) noexcept {
+    auto& cache = cache_;
+    if (cache.released || cache.size >= kAsyncTaskPoolCapacityPerThread) {
+      ::operator delete(block);
+      return;
+    }
+    // Releases the cached blocks when the thread exits.
+    thread_local CacheReleaser cache_releaser;
+    auto* free_block = static_cast<FreeBlock*>(block);
+    free_block->next = cache.head;
+    cache.head = free_block;
+    cache.size++;
+  }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  /// Trivially destructible, so that it remains usable while the other thread
+  /// local objects are destroyed.
+  struct Cache {
+    FreeBlock* head;
+    size_t size;
+    /// Set once the thread is exiting, after which no block is cached.
+    bool released;
+  };
+
+  struct CacheReleaser {
+    ~CacheReleaser() {
+      auto& cache = cache_;
+      cache.released = true;
+      while (cache.head != nullptr) {
+        auto* block = cache.head;
+        cache.head = block->next;
+        ::operator delete(block);
+      }
+      cache.size = 0;
+    }
+  };
+
+  static constinit thread_local Cache cache_;
+};
+
+template <size_t kBlockSize>
+constinit thread_local typename ThreadLocalBlockPool<kBlockSize>::Cache
+    ThreadLocalBlockPool<kBlockSize>::cache_ = {nullptr, 0, false};
+
+/**
+ * @brief An allocator of single objects from a ThreadLocalBlockPool, e.g. to
+ * allocate a shared object and its control block with std::allocate_shared.
+ * Arrays are allocated from the heap.
+ *
+ * @tparam T the type of the objects.
+ */
+template <class T>
+class PooledAllocator {
+ public:
+  using value_type = T;
+
+  static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+  PooledAllocator() = default;
+
+  template <class U>
+  PooledAllocator(const PooledAllocator<U>&) noexcept {}
+
+  T* allocate(size_t count) {
+    if (count == 1) {
+      return static_cast<T*>(ThreadLocalBlockPool<sizeof(T)>::Allocate());
+    }
+    return static_cast<T*>(::operator new(count * sizeof(T)));
+  }
+
+  void deallocate(T* object, size_t count) noexcept {
+    if (count == 1) {
+      ThreadLocalBlockPool<sizeof(T)>::Deallocate(object);
+      return;
+    }
+    ::operator delete(object);
+  }
+
+  template <class U>
+  bool operator==(const PooledAllocator<U>&) const noexcept {
+    return true;
+  }
+};
+}  // namespace google::scp::core
@@ -0,0 +1,263 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cpu_topology.h"
+
+#include <sched.h>
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "cc/core/common/global_logger/src/global_logger.h"
+#include "cc/core/common/uuid/src/uuid.h"
+
+#include "error_codes.h"
+
+using google::scp::core::common::kZeroUuid;
+using std::optional;
+using std::string;
+using std::string_view;
+using std::vector;
+
+namespace {
+constexpr char kCpuTopology[] = "CpuTopology";
+
+/// Reads the first line of a file, if it exists.
+optional<string> ReadLine(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  string line;
+  if (!file || !std::getline(file, line)) {
+    return std::nullopt;
+  }
+  return line;
+}
+
+optional<size_t> ParseNumber(string_view text) {
+  while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) {
+    text.remove_suffix(1);
+  }
+  size_t number;
+  auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), number);
+  if (error != std::errc() || end != text.data() + text.size()) {
+    return std::nullopt;
+  }
+  return number;
+}
+
+/// Reads a number from a file, or returns the default value.
+size_t ReadNumber(const std::filesystem::path& path, size_t default_value) {
+  auto line = ReadLine(path);
+  if (!line) {
+    return default_value;
+  }
+  return ParseNumber(*line).value_or(default_value);
+}
+}  // namespace
+
+namespace google::scp::core {
+CpuTopology::CpuTopology(vector<CpuInfo> cpus) : cpus_(std::move(cpus)) {
+  std::sort(cpus_.begin(), cpus_.end(),
+            [](const CpuInfo& lhs, const CpuInfo& rhs) {
+              return std::tie(lhs.node, lhs.package, lhs.core, lhs.cpu) <
+                     std::tie(rhs.node, rhs.package, rhs.core, rhs.cpu);
+            });
+}
+
+ExecutionResultOr<vector<size_t>> CpuTopology::ParseCpuList(
+    string_view cpu_list) noexcept {
+  vector<size_t> cpus;
+  for (string_view range : absl::StrSplit(cpu_list, ',', absl::SkipEmpty())) {
+    vector<string_view> bounds = absl::StrSplit(range, '-');
+    auto first = ParseNumber(bounds.front());
+    auto last = ParseNumber(bounds.back());
+    if (bounds.size() > 2 || !first || !last || *first > *last) {
+      return FailureExecutionResult(
+          errors::SC_ASYNC_EXECUTOR_INVALID_CPU_TOPOLOGY);
+    }
+    for (size_t cpu = *first; cpu <= *last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+ExecutionResultOr<CpuTopology> CpuTopology::Load(
+    string_view sysfs_path) noexcept {
+  std::filesystem::path root(sysfs_path);
+  auto online_cpus = ReadLine(root / "cpu" / "online");
+  if (!online_cpus) {
+    auto result =
+        FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_INVALID_CPU_TOPOLOGY);
+    SCP_ERROR(kCpuTopology, kZeroUuid, result,
+              "Cannot read the online CPUs.");
+    return result;
+  }
+  ASSIGN_OR_RETURN(auto cpu_numbers, ParseCpuList(*online_cpus));
+
+  vector<CpuInfo> cpus;
+  cpus.reserve(cpu_numbers.size());
+  for (auto cpu : cpu_numbers) {
+    auto topology_path = root / "cpu" / ("cpu" + std::to_string(cpu)) /
+                         "topology";
+    // Without topology, each CPU is its own core.
+    cpus.push_back(
+        CpuInfo{cpu, ReadNumber(topology_path / "core_id", cpu),
+                ReadNumber(topology_path / "physical_package_id", 0), 0});
+  }
+
+  // Machines without NUMA have no node directory, and a single node.
+  std::error_code error_code;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(root / "node", error_code)) {
+    auto name = entry.path().filename().string();
+    if (name.rfind("node", 0) != 0) {
+      continue;
+    }
+    auto node = ParseNumber(string_view(name).substr(4));
+    auto node_cpus = ReadLine(entry.path() / "cpulist");
+    if (!node || !node_cpus) {
+      continue;
+    }
+    auto node_cpu_numbers = ParseCpuList(*node_cpus);
+    if (!node_cpu_numbers.Successful()) {
+      continue;
+    }
+    for (auto& cpu : cpus) {
+      if (std::find(node_cpu_numbers->begin(), node_cpu_numbers->end(),
+                    cpu.cpu) != node_cpu_numbers->end()) {
+        cpu.node = *node;
+      }
+    }
+  }
+  return CpuTopology(std::move(cpus));
+}
+
+ExecutionResultOr<CpuTopology> CpuTopology::LoadForCurrentProcess() noexcept {
+  ASSIGN_OR_RETURN(auto topology, Load());
+  cpu_set_t allowed_cpus;
+  CPU_ZERO(&allowed_cpus);
+  if (sched_getaffinity(0, sizeof(allowed_cpus), &allowed_cpus) != 0) {
+    return topology;
+  }
+  vector<CpuInfo> cpus;
+  for (const auto& cpu : topology.cpus()) {
+    if (cpu.cpu < CPU_SETSIZE && CPU_ISSET(cpu.cpu, &allowed_cpus)) {
+      cpus.push_back(cpu);
+    }
+  }
+  if (cpus.empty()) {
+    return FailureExecutionResult(
+        errors::SC_ASYNC_EXECUTOR_INVALID_CPU_TOPOLOGY);
+  }
+  return CpuTopology(std::move(cpus));
+}
+
+vector<vector<size_t>> CpuTopology::Partition(
+    const vector<size_t>& weights) const noexcept {
+  vector<vector<size_t>> partitions(weights.size());
+
+  // The CPUs are sorted, so the CPUs of a core are next to each other.
+  vector<vector<size_t>> cores;
+  for (size_t i = 0; i < cpus_.size(); ++i) {
+    if (i == 0 || cpus_[i].node != cpus_[i - 1].node ||
+        cpus_[i].package != cpus_[i - 1].package ||
+        cpus_[i].core != cpus_[i - 1].core) {
+      cores.emplace_back();
+    }
+    cores.back().push_back(cpus_[i].cpu);
+  }
+
+  size_t total_weight = 0;
+  size_t weighted_partition_count = 0;
+  for (auto weight : weights) {
+    total_weight += weight;
+    weighted_partition_count += weight > 0 ? 1 : 0;
+  }
+  if (weighted_partition_count == 0 || cores.empty()) {
+    return partitions;
+  }
+
+  if (cores.size() < weighted_partition_count) {
+    vector<size_t> all_cpus;
+    for (const auto& cpu : cpus_) {
+      all_cpus.push_back(cpu.cpu);
+    }
+    for (size_t i = 0; i < weights.size(); ++i) {
+      if (weights[i] > 0) {
+        partitions[i] = all_cpus;
+      }
+    }
+    return partitions;
+  }
+
+  // Rounds down the proportional core counts, then gives the remaining cores
+  // to the partitions furthest below their share.
+  vector<size_t> core_counts(weights.size(), 0);
+  size_t assigned_core_count = 0;
+  for (size_t i = 0; i < weights.size(); ++i) {
+    if (weights[i] > 0) {
+      core_counts[i] =
+          std::max<size_t>(1, cores.size() * weights[i] / total_weight);
+      assigned_core_count += core_counts[i];
+    }
+  }
+  while (assigned_core_count > cores.size()) {
+    auto largest = std::max_element(core_counts.begin(), core_counts.end());
+    (*largest)--;
+    assigned_core_count--;
+  }
+  while (assigned_core_count < cores.size()) {
+    size_t neediest = 0;
+    double largest_deficit = -1;
+    for (size_t i = 0; i < weights.size(); ++i) {
+      if (weights[i] == 0) {
+        continue;
+      }
+      double deficit =
+          static_cast<double>(cores.size()) * weights[i] / total_weight -
+          core_counts[i];
+      if (deficit > largest_deficit) {
+        largest_deficit = deficit;
+        neediest = i;
+      }
+    }
+    core_counts[neediest]++;
+    assigned_core_count++;
+  }
+
+  size_t next_core = 0;
+  for (size_t i = 0; i < weights.size(); ++i) {
+    for (size_t j = 0; j < core_counts[i]; ++j) {
+      const auto& core_cpus = cores[next_core++];
+      partitions[i].insert(partitions[i].end(), core_cpus.begin(),
+                           core_cpus.end());
+    }
+  }
+
+  SCP_INFO(kCpuTopology, kZeroUuid,
+           absl::StrFormat("Partitioned %d cores of %d CPUs into %d partitions",
+                           cores.size(), cpus_.size(), weights.size()));
+  return partitions;
+}
+}  // namespace google::scp::core
@@ -0,0 +1,96 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cc/public/core/interface/execution_result.h"
+
+namespace google::scp::core {
+/// Describes where a logical CPU is.
+struct CpuInfo {
+  /// The number of the logical CPU, as used for its affinity.
+  size_t cpu;
+  /// The ID of its physical core, unique within its package.
+  size_t core;
+  /// The ID of its physical package (socket).
+  size_t package;
+  /// The NUMA node it belongs to.
+  size_t node;
+};
+
+/**
+ * @brief The logical CPUs of the machine grouped by physical core, package and
+ * NUMA node, as read from sysfs. Used to partition the cores between thread
+ * pools, so that the pools do not pin several threads to the same core while
+ * other cores stay idle. Only threads are placed: memory is not allocated on
+ * the node of the threads that use it.
+ */
+class CpuTopology {
+ public:
+  explicit CpuTopology(std::vector<CpuInfo> cpus);
+
+  /**
+   * @brief Reads the topology of the online CPUs from a sysfs tree.
+   *
+   * @param sysfs_path the path of the system devices, with the cpu and node
+   * directories.
+   * @return ExecutionResultOr<CpuTopology> the topology, or a failure if the
+   * online CPUs cannot be read.
+   */
+  static ExecutionResultOr<CpuTopology> Load(
+      std::string_view sysfs_path = "/sys/devices/system") noexcept;
+
+  /**
+   * @brief Reads the topology of the CPUs the current process may run on.
+   *
+   * @return ExecutionResultOr<CpuTopology> the topology, or a failure if it
+   * cannot be read.
+   */
+  static ExecutionResultOr<CpuTopology> LoadForCurrentProcess() noexcept;
+
+  /**
+   * @brief Parses a CPU list such as "0-3,8,10-11".
+   *
+   * @param cpu_list the CPU list.
+   * @return ExecutionResultOr<std::vector<size_t>> the CPU numbers, in order.
+   */
+  static ExecutionResultOr<std::vector<size_t>> ParseCpuList(
+      std::string_view cpu_list) noexcept;
+
+  /**
+   * @brief Splits the physical cores between partitions in proportion to their
+   * weights. Each partition with a non-zero weight gets at least one core, and
+   * gets contiguous cores in node and package order, along with all their
+   * logical CPUs. If there are fewer cores than such partitions, they all get
+   * every CPU.
+   *
+   * @param weights the weight of each partition.
+   * @return std::vector<std::vector<size_t>> the CPUs of each partition, empty
+   * for the partitions with a zero weight.
+   */
+  std::vector<std::vector<size_t>> Partition(
+      const std::vector<size_t>& weights) const noexcept;
+
+  /// Returns the CPUs, ordered by node, package, core and CPU number.
+  const std::vector<CpuInfo>& cpus() const noexcept { return cpus_; }
+
+ private:
+  std::vector<CpuInfo> cpus_;
+};
+}  // namespace google::scp::core
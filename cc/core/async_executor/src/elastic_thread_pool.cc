@@ -0,0 +1,261 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "elastic_thread_pool.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "cc/core/common/time_provider/src/time_provider.h"
+
+#include "error_codes.h"
+#include "typedef.h"
+
+using google::scp::core::common::TimeProvider;
+using std::lock_guard;
+using std::make_unique;
+using std::mutex;
+using std::thread;
+using std::unique_lock;
+using std::unique_ptr;
+
+namespace google::scp::core {
+ElasticThreadPool::ElasticThreadPool(
+    size_t min_thread_count, size_t queue_cap, bool drop_tasks_on_stop,
+    ElasticThreadPoolOptions options,
+    AdmissionControlOptions admission_control_options)
+    : min_thread_count_(min_thread_count),
+      max_thread_count_(std::max(min_thread_count, options.max_thread_count)),
+      queue_cap_(queue_cap),
+      drop_tasks_on_stop_(drop_tasks_on_stop),
+      options_(options),
+      admission_controller_(admission_control_options) {}
+
+ExecutionResult ElasticThreadPool::Init() noexcept {
+  if (min_thread_count_ <= 0 || max_thread_count_ > kMaxThreadCount) {
+    return FailureExecutionResult(
+        errors::SC_ASYNC_EXECUTOR_INVALID_THREAD_COUNT);
+  }
+
+  if (queue_cap_ <= 0 || queue_cap_ > kMaxQueueCap) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_INVALID_QUEUE_CAP);
+  }
+
+  slots_.clear();
+  for (size_t i = 0; i < max_thread_count_; ++i) {
+    slots_.push_back(make_unique<Slot>());
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult ElasticThreadPool::Run() noexcept {
+  unique_lock<mutex> lock(mutex_);
+  if (is_running_ || thread_count_ > 0) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_ALREADY_RUNNING);
+  }
+
+  if (slots_.empty()) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_INITIALIZED);
+  }
+
+  is_running_ = true;
+  for (size_t i = 0; i < min_thread_count_; ++i) {
+    if (!StartThread()) {
+      break;
+    }
+  }
+  if (max_thread_count_ > min_thread_count_) {
+    supervisor_thread_ = thread([this]() { Supervise(); });
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult ElasticThreadPool::Stop() noexcept {
+  unique_lock<mutex> lock(mutex_);
+  if (!is_running_) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
+  }
+
+  is_running_ = false;
+  if (drop_tasks_on_stop_) {
+    normal_pri_queue_.clear();
+    high_pri_queue_.clear();
+  }
+  task_condition_variable_.notify_all();
+  stop_condition_variable_.notify_all();
+  lock.unlock();
+
+  if (supervisor_thread_.joinable()) {
+    supervisor_thread_.join();
+  }
+
+  // The threads drain the queues before they exit, and the last one signals.
+  lock.lock();
+  stop_condition_variable_.wait(lock, [&]() { return thread_count_ == 0; });
+  return SuccessExecutionResult();
+}
+
+ExecutionResult ElasticThreadPool::Schedule(AsyncOperation&& work,
+                                            AsyncPriority priority) noexcept {
+  if (priority != AsyncPriority::Normal && priority != AsyncPriority::High) {
+    return FailureExecutionResult(
+        errors::SC_ASYNC_EXECUTOR_INVALID_PRIORITY_TYPE);
+  }
+
+  // The task is allocated outside of the lock.
+  auto task = make_unique<AsyncTask>(std::move(work));
+  lock_guard<mutex> lock(mutex_);
+  if (!is_running_) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
+  }
+
+  auto& queue =
+      priority == AsyncPriority::Normal ? normal_pri_queue_ : high_pri_queue_;
+  if (queue.size() >= queue_cap_) {
+    return RetryExecutionResult(errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
+  }
+  queue.push_back(std::move(task));
+  if (idle_thread_count_ > 0) {
+    task_condition_variable_.notify_one();
+  }
+  return SuccessExecutionResult();
+}
+
+size_t ElasticThreadPool::GetThreadCount() const noexcept {
+  lock_guard<mutex> lock(mutex_);
+  return thread_count_;
+}
+
+size_t ElasticThreadPool::GetQueueSize() const noexcept {
+  lock_guard<mutex> lock(mutex_);
+  return normal_pri_queue_.size() + high_pri_queue_.size();
+}
+
+bool ElasticThreadPool::StartThread() noexcept {
+  auto free_slot = std::find_if(slots_.begin(), slots_.end(),
+                                [](const auto& slot) { return !slot->in_use; });
+  if (free_slot == slots_.end()) {
+    return false;
+  }
+
+  Slot& slot = **free_slot;
+  try {
+    thread([this, &slot]() { RunThread(slot); }).detach();
+  } catch (const std::system_error&) {
+    // The pool makes do with the threads it has.
+    return false;
+  }
+  slot.in_use = true;
+  thread_count_++;
+  return true;
+}
+
+void ElasticThreadPool::RunThread(Slot& slot) noexcept {
+  unique_lock<mutex> lock(mutex_);
+  while (true) {
+    if (!high_pri_queue_.empty() || !normal_pri_queue_.empty()) {
+      bool is_high_priority = !high_pri_queue_.empty();
+      auto& queue = is_high_priority ? high_pri_queue_ : normal_pri_queue_;
+      unique_ptr<AsyncTask> task = std::move(queue.front());
+      queue.pop_front();
+      size_t queue_depth = queue.size();
+      Timestamp dequeue_timestamp =
+          TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+      Timestamp enqueue_timestamp = task->GetExecutionTimestamp();
+      // The high priority tasks jump the queue, so their sojourn time does not
+      // tell whether the queue is overloaded.
+      if (!is_high_priority) {
+        admission_controller_.OnTaskDequeued(enqueue_timestamp,
+                                             dequeue_timestamp);
+      }
+      slot.busy_since_timestamp = dequeue_timestamp;
+      lock.unlock();
+
+      task->Execute();
+      task.reset();
+      Timestamp end_timestamp =
+          TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+      (is_high_priority ? slot.high_pri_task_stats : slot.normal_pri_task_stats)
+          .RecordTask(enqueue_timestamp, dequeue_timestamp, end_timestamp,
+                      queue_depth);
+
+      lock.lock();
+      slot.busy_since_timestamp = 0;
+      continue;
+    }
+    admission_controller_.OnQueueEmpty();
+
+    if (!is_running_) {
+      break;
+    }
+
+    idle_thread_count_++;
+    bool has_work = task_condition_variable_.wait_for(
+        lock, options_.idle_timeout, [&]() {
+          return !is_running_ || !high_pri_queue_.empty() ||
+                 !normal_pri_queue_.empty();
+        });
+    idle_thread_count_--;
+    if (!has_work && thread_count_ > min_thread_count_) {
+      break;
+    }
+  }
+
+  slot.in_use = false;
+  thread_count_--;
+  if (thread_count_ == 0) {
+    // Notified with the mutex held, since Stop() may return and destroy the
+    // pool as soon as the mutex is released.
+    stop_condition_variable_.notify_all();
+  }
+}
+
+void ElasticThreadPool::Supervise() noexcept {
+  unique_lock<mutex> lock(mutex_);
+  while (is_running_) {
+    stop_condition_variable_.wait_for(lock, options_.blocked_threshold,
+                                      [&]() { return !is_running_; });
+    if (!is_running_) {
+      break;
+    }
+    if (thread_count_ < max_thread_count_ &&
+        AreAllThreadsBlocked(
+            TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks())) {
+      StartThread();
+    }
+  }
+}
+
+bool ElasticThreadPool::AreAllThreadsBlocked(
+    Timestamp current_timestamp) const noexcept {
+  if (idle_thread_count_ > 0 ||
+      (high_pri_queue_.empty() && normal_pri_queue_.empty())) {
+    return false;
+  }
+  Timestamp blocked_threshold = options_.blocked_threshold.count();
+  for (const auto& slot : slots_) {
+    // A thread between two tasks is not blocked.
+    if (slot->in_use &&
+        (slot->busy_since_timestamp == 0 ||
+         current_timestamp - slot->busy_since_timestamp < blocked_threshold)) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace google::scp::core
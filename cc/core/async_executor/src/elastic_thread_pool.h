@@ -0,0 +1,172 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cc/core/async_executor/src/admission_controller.h"
+#include "cc/core/async_executor/src/async_task.h"
+#include "cc/core/async_executor/src/task_stats.h"
+#include "cc/core/interface/async_executor_interface.h"
+#include "cc/core/interface/service_interface.h"
+
+namespace google::scp::core {
+/// The settings of an ElasticThreadPool.
+struct ElasticThreadPoolOptions {
+  /// Whether the normal and high priority tasks of an AsyncExecutor run on an
+  /// ElasticThreadPool rather than on pinned single thread executors.
+  bool enabled = false;
+  /// The number of threads the pool grows up to. The thread count of the
+  /// AsyncExecutor is the number of threads it keeps.
+  size_t max_thread_count = 0;
+  /// How long all the threads must have been running their current tasks,
+  /// while tasks are waiting, for the pool to add a thread.
+  std::chrono::nanoseconds blocked_threshold = std::chrono::milliseconds(50);
+  /// How long an extra thread may stay idle before it exits.
+  std::chrono::nanoseconds idle_timeout = std::chrono::seconds(30);
+};
+
+/**
+ * @brief A pool of threads sharing the queues of their tasks, sized for tasks
+ * blocking on IO, such as synchronous calls to a database. The pool keeps its
+ * minimum number of threads, adds a thread whenever all of them have been
+ * running their current tasks for longer than the blocked threshold while
+ * tasks are waiting, and lets the extra threads exit once idle for the idle
+ * timeout.
+ *
+ * Unlike SingleThreadAsyncExecutor, the threads are not pinned to CPUs and
+ * the queues are guarded by a mutex, which is cheap next to blocking tasks.
+ */
+class ElasticThreadPool : ServiceInterface {
+ public:
+  /**
+   * @param min_thread_count the number of threads the pool keeps.
+   * @param queue_cap the maximum number of waiting tasks of each priority.
+   * @param drop_tasks_on_stop indicates whether the pool should ignore the
+   * pending tasks when it stops.
+   * @param options the sizing of the pool.
+   * @param admission_control_options the admission control of the normal
+   * priority tasks.
+   */
+  ElasticThreadPool(size_t min_thread_count, size_t queue_cap,
+                    bool drop_tasks_on_stop, ElasticThreadPoolOptions options,
+                    AdmissionControlOptions admission_control_options =
+                        AdmissionControlOptions());
+
+  ExecutionResult Init() noexcept override;
+
+  ExecutionResult Run() noexcept override;
+
+  ExecutionResult Stop() noexcept override;
+
+  /**
+   * @brief Schedules a task to be executed by any thread of the pool.
+   *
+   * @param work the task that needs to be scheduled.
+   * @param priority the priority of the task. Either normal or high.
+   * @return ExecutionResult result of the execution with possible error code.
+   */
+  ExecutionResult Schedule(AsyncOperation&& work,
+                           AsyncPriority priority) noexcept;
+
+  /// Returns the number of running threads.
+  size_t GetThreadCount() const noexcept;
+
+  /// Returns the number of tasks waiting in the queues.
+  size_t GetQueueSize() const noexcept;
+
+  /// Returns whether the normal priority tasks wait too long in the queue.
+  bool IsOverloaded() const noexcept {
+    return admission_controller_.IsOverloaded();
+  }
+
+  /// Returns how long the last normal priority task waited, in nanoseconds.
+  Timestamp GetLastSojournTime() const noexcept {
+    return admission_controller_.GetLastSojournTime();
+  }
+
+  /// Returns the maximum number of threads, i.e. of task statistics.
+  size_t GetMaxThreadCount() const noexcept { return max_thread_count_; }
+
+  /**
+   * @brief Returns the statistics of the tasks of the given priority recorded
+   * by the threads which used the given slot, one of GetMaxThreadCount().
+   */
+  const TaskStats& GetTaskStats(size_t slot_index,
+                                AsyncPriority priority) const noexcept {
+    const auto& slot = slots_[slot_index];
+    return priority == AsyncPriority::High ? slot->high_pri_task_stats
+                                           : slot->normal_pri_task_stats;
+  }
+
+ private:
+  /**
+   * @brief The state of a thread. A slot is reused by the next thread once
+   * its thread exits, so that the task statistics outlive the threads.
+   */
+  struct Slot {
+    /// Whether a thread uses the slot.
+    bool in_use = false;
+    /// When the thread started running its current task, or 0 if it is not
+    /// running any.
+    Timestamp busy_since_timestamp = 0;
+    /// Only recorded by the thread using the slot.
+    TaskStats normal_pri_task_stats;
+    TaskStats high_pri_task_stats;
+  };
+
+  /// Starts a thread on a free slot. Must be called with the mutex held.
+  bool StartThread() noexcept;
+
+  /// Runs the tasks until the pool stops or the thread is idle for too long.
+  void RunThread(Slot& slot) noexcept;
+
+  /// Adds a thread whenever all the threads are blocked.
+  void Supervise() noexcept;
+
+  /// Returns whether all the threads are blocked. Must be called with the
+  /// mutex held.
+  bool AreAllThreadsBlocked(Timestamp current_timestamp) const noexcept;
+
+  const size_t min_thread_count_;
+  const size_t max_thread_count_;
+  const size_t queue_cap_;
+  const bool drop_tasks_on_stop_;
+  const ElasticThreadPoolOptions options_;
+
+  /// Guards all the members below but the task statistics of the slots.
+  mutable std::mutex mutex_;
+  /// Signals the threads that a task is scheduled or that the pool stops.
+  std::condition_variable task_condition_variable_;
+  /// Signals the supervisor and Stop() about the pool stopping.
+  std::condition_variable stop_condition_variable_;
+  bool is_running_ = false;
+  std::deque<std::unique_ptr<AsyncTask>> normal_pri_queue_;
+  std::deque<std::unique_ptr<AsyncTask>> high_pri_queue_;
+  std::vector<std::unique_ptr<Slot>> slots_;
+  size_t thread_count_ = 0;
+  size_t idle_thread_count_ = 0;
+  /// Tracks the sojourn time of the normal priority tasks.
+  AdmissionController admission_controller_;
+  std::thread supervisor_thread_;
+};
+}  // namespace google::scp::core
@@ -61,4 +61,12 @@ DEFINE_ERROR_CODE(SC_ASYNC_EXECUTOR_INVALID_TASK_POOL_TYPE, SC_ASYNC_EXECUTOR,
 DEFINE_ERROR_CODE(SC_ASYNC_EXECUTOR_UNABLE_TO_SET_AFFINITY, SC_ASYNC_EXECUTOR,
                   0x000A, "Setting CPU affinity failed",
                   HttpStatusCode::BAD_REQUEST)
+
+DEFINE_ERROR_CODE(SC_ASYNC_EXECUTOR_INVALID_CPU_TOPOLOGY, SC_ASYNC_EXECUTOR,
+                  0x000B, "The CPU topology cannot be read",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_ASYNC_EXECUTOR_OVERLOADED, SC_ASYNC_EXECUTOR, 0x000C,
+                  "The executor is overloaded",
+                  HttpStatusCode::SERVICE_UNAVAILABLE)
 }  // namespace google::scp::core::errors
@@ -14,27 +14,28 @@
 
 #include "single_thread_async_executor.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include "absl/time/time.h"
 #include "cc/core/async_executor/src/async_executor_utils.h"
 #include "cc/core/async_executor/src/error_codes.h"
 #include "cc/core/async_executor/src/typedef.h"
+#include "cc/core/common/time_provider/src/time_provider.h"
 
 using google::scp::core::common::ConcurrentQueue;
+using google::scp::core::common::TimeProvider;
 using std::make_shared;
 using std::make_unique;
-using std::mutex;
-using std::shared_ptr;
 using std::thread;
-using std::unique_lock;
+using std::unique_ptr;
+using std::vector;
 using std::chrono::milliseconds;
 
-static constexpr size_t kLockWaitTimeInMilliseconds = 5;
-
 namespace google::scp::core {
 ExecutionResult SingleThreadAsyncExecutor::Init() noexcept {
   if (queue_cap_ <= 0 || queue_cap_ > kMaxQueueCap) {
@@ -42,9 +43,9 @@ ExecutionResult SingleThreadAsyncExecutor::Init() noexcept {
   }
 
   normal_pri_queue_ =
-      make_shared<ConcurrentQueue<shared_ptr<AsyncTask>>>(queue_cap_);
+      make_shared<ConcurrentQueue<unique_ptr<AsyncTask>>>(queue_cap_);
   high_pri_queue_ =
-      make_shared<ConcurrentQueue<shared_ptr<AsyncTask>>>(queue_cap_);
+      make_shared<ConcurrentQueue<unique_ptr<AsyncTask>>>(queue_cap_);
   return SuccessExecutionResult();
 };
 
@@ -77,37 +78,142 @@ ExecutionResult SingleThreadAsyncExecutor::Run() noexcept {
 }
 
 void SingleThreadAsyncExecutor::StartWorker() noexcept {
-  unique_lock<mutex> thread_lock(mutex_);
-
   while (true) {
-    condition_variable_.wait_for(
-        thread_lock, milliseconds(kLockWaitTimeInMilliseconds), [&]() {
-          return !is_running_ || high_pri_queue_->Size() > 0 ||
-                 normal_pri_queue_->Size() > 0;
-        });
-
-    if (normal_pri_queue_->Size() == 0 && high_pri_queue_->Size() == 0) {
-      if (!is_running_) {
-        break;
+    // The queues are concurrent, so the tasks are drained without any lock.
+    unique_ptr<AsyncTask> task;
+    bool is_high_priority = false;
+    // A task is dequeued right as the previous one ends, so reading the clock
+    // once per task is enough.
+    Timestamp dequeue_timestamp =
+        TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+    // Once stopped, the worker only drains its own tasks.
+    while (TryDequeueTask(task, /*allow_stealing=*/is_running_,
+                          is_high_priority)) {
+      Timestamp enqueue_timestamp = task->GetExecutionTimestamp();
+      // The high priority tasks jump the queue, so their sojourn time does not
+      // tell whether the queue is overloaded.
+      if (!is_high_priority) {
+        admission_controller_.OnTaskDequeued(enqueue_timestamp,
+                                             dequeue_timestamp);
       }
-      continue;
+      size_t queue_depth = is_high_priority ? high_pri_queue_->Size()
+                                            : GetNormalPriorityQueueSize();
+#if defined(PBS_ENABLE_BENCHMARKING)
+      scheduling_latency_for_testing_.push_back(absl::Now() -
+                                                task->GetTaskCreationTime());
+#endif
+      task->Execute();
+      // Releases what the task captured before the worker possibly waits.
+      task.reset();
+      Timestamp end_timestamp =
+          TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+      (is_high_priority ? high_pri_task_stats_ : normal_pri_task_stats_)
+          .RecordTask(enqueue_timestamp, dequeue_timestamp, end_timestamp,
+                      queue_depth);
+      dequeue_timestamp = end_timestamp;
     }
+    admission_controller_.OnQueueEmpty();
 
-    shared_ptr<AsyncTask> task;
-    // The priority is with the high pri tasks.
-    if (!high_pri_queue_->TryDequeue(task).Successful() &&
-        !normal_pri_queue_->TryDequeue(task).Successful()) {
-      continue;
+    if (!is_running_) {
+      break;
     }
-#if defined(PBS_ENABLE_BENCHMARKING)
-    scheduling_latency_for_testing_.push_back(absl::Now() -
-                                              task->GetTaskCreationTime());
-#endif
 
-    thread_lock.unlock();
-    task->Execute();
-    thread_lock.lock();
+    // The wakeup count is read before the worker is marked idle, so that a
+    // wakeup after the checks below makes the wait return immediately. The
+    // fence pairs with the one in WakeUpIfIdle: either the scheduling thread
+    // sees the worker idle, or the worker sees the scheduled task.
+    uint32_t wakeup_count = wakeup_count_.load(std::memory_order_acquire);
+    is_idle_ = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (is_running_ && !steal_requested_ && !HasPendingTasks()) {
+      wakeup_count_.wait(wakeup_count, std::memory_order_acquire);
+    }
+    is_idle_ = false;
+    steal_requested_ = false;
+  }
+}
+
+bool SingleThreadAsyncExecutor::HasPendingTasks() noexcept {
+  if (high_pri_queue_->Size() > 0 || normal_pri_queue_->Size() > 0) {
+    return true;
   }
+  if (!local_deque_) {
+    return false;
+  }
+  if (stealable_queue_->Size() > 0) {
+    return true;
+  }
+  for (auto* victim : victims_) {
+    if (victim->stealable_queue_->Size() > 0 ||
+        victim->local_deque_->Size() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void SingleThreadAsyncExecutor::WakeUp() noexcept {
+  wakeup_count_.fetch_add(1, std::memory_order_release);
+  wakeup_count_.notify_one();
+}
+
+void SingleThreadAsyncExecutor::WakeUpIfIdle() noexcept {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (is_idle_.load(std::memory_order_relaxed)) {
+    WakeUp();
+  }
+}
+
+bool SingleThreadAsyncExecutor::TryDequeueTask(
+    unique_ptr<AsyncTask>& task, bool allow_stealing,
+    bool& is_high_priority) noexcept {
+  // The priority is with the high pri tasks.
+  is_high_priority = high_pri_queue_->TryDequeue(task).Successful();
+  if (is_high_priority) {
+    return true;
+  }
+  if (!local_deque_) {
+    return normal_pri_queue_->TryDequeue(task).Successful();
+  }
+
+  // The local deque is popped first for locality, except every
+  // kWorkStealingFifoCheckInterval tasks to let the FIFO queues make progress.
+  if (++dequeued_task_count_ % kWorkStealingFifoCheckInterval == 0 &&
+      (normal_pri_queue_->TryDequeue(task).Successful() ||
+       stealable_queue_->TryDequeue(task).Successful())) {
+    return true;
+  }
+  if ((task = local_deque_->Pop())) {
+    return true;
+  }
+  if (normal_pri_queue_->TryDequeue(task).Successful() ||
+      stealable_queue_->TryDequeue(task).Successful()) {
+    return true;
+  }
+  if (!allow_stealing) {
+    return false;
+  }
+
+  for (size_t i = 0; i < victims_.size(); ++i) {
+    auto* victim = victims_[next_victim_to_steal_];
+    next_victim_to_steal_ = (next_victim_to_steal_ + 1) % victims_.size();
+    task = victim->TryStealTask();
+    if (task) {
+      return true;
+    }
+  }
+  return false;
+}
+
+unique_ptr<AsyncTask> SingleThreadAsyncExecutor::TryStealTask() noexcept {
+  unique_ptr<AsyncTask> task;
+  if (!local_deque_) {
+    return task;
+  }
+  if (stealable_queue_->TryDequeue(task).Successful()) {
+    return task;
+  }
+  return local_deque_->Steal();
 }
 
 ExecutionResult SingleThreadAsyncExecutor::Stop() noexcept {
@@ -115,17 +221,19 @@ ExecutionResult SingleThreadAsyncExecutor::Stop() noexcept {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
   }
 
-  unique_lock<mutex> thread_lock(mutex_);
   is_running_ = false;
 
   if (drop_tasks_on_stop_) {
-    shared_ptr<AsyncTask> task;
+    unique_ptr<AsyncTask> task;
     while (normal_pri_queue_->TryDequeue(task).Successful()) {}
     while (high_pri_queue_->TryDequeue(task).Successful()) {}
+    if (local_deque_) {
+      while (stealable_queue_->TryDequeue(task).Successful()) {}
+      while (local_deque_->Steal()) {}
+    }
   }
 
-  condition_variable_.notify_all();
-  thread_lock.unlock();
+  WakeUp();
 
   // To ensure stop can happen cleanly, it is required to wait for the thread to
   // start and exit gracefully. If stop happens before the starting the thread,
@@ -140,6 +248,11 @@ ExecutionResult SingleThreadAsyncExecutor::Stop() noexcept {
 
 ExecutionResult SingleThreadAsyncExecutor::Schedule(
     const AsyncOperation& work, AsyncPriority priority) noexcept {
+  return Schedule(AsyncOperation(work), priority);
+}
+
+ExecutionResult SingleThreadAsyncExecutor::Schedule(
+    AsyncOperation&& work, AsyncPriority priority) noexcept {
   if (!is_running_) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
   }
@@ -149,22 +262,143 @@ ExecutionResult SingleThreadAsyncExecutor::Schedule(
         errors::SC_ASYNC_EXECUTOR_INVALID_PRIORITY_TYPE);
   }
 
-  auto task = make_shared<AsyncTask>(work);
+  auto task = make_unique<AsyncTask>(std::move(work));
   ExecutionResult execution_result;
   if (priority == AsyncPriority::Normal) {
-    execution_result = normal_pri_queue_->TryEnqueue(task);
+    execution_result = normal_pri_queue_->TryEnqueue(std::move(task));
   } else {
-    execution_result = high_pri_queue_->TryEnqueue(task);
+    execution_result = high_pri_queue_->TryEnqueue(std::move(task));
   }
 
   if (!execution_result.Successful()) {
     return RetryExecutionResult(errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
   }
 
-  condition_variable_.notify_one();
+  WakeUpIfIdle();
   return SuccessExecutionResult();
 };
 
+void SingleThreadAsyncExecutor::ScheduleBatch(
+    absl::Span<AsyncOperation> works, AsyncPriority priority,
+    absl::Span<ExecutionResult> results) noexcept {
+  if (!is_running_) {
+    std::fill(results.begin(), results.end(),
+              FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING));
+    return;
+  }
+
+  if (priority != AsyncPriority::Normal && priority != AsyncPriority::High) {
+    std::fill(results.begin(), results.end(),
+              FailureExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_INVALID_PRIORITY_TYPE));
+    return;
+  }
+
+  auto& queue =
+      priority == AsyncPriority::Normal ? normal_pri_queue_ : high_pri_queue_;
+  bool any_task_enqueued = false;
+  for (size_t i = 0; i < works.size(); ++i) {
+    if (!queue->TryEnqueue(make_unique<AsyncTask>(std::move(works[i])))
+             .Successful()) {
+      results[i] =
+          RetryExecutionResult(errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
+      continue;
+    }
+    results[i] = SuccessExecutionResult();
+    any_task_enqueued = true;
+  }
+
+  // The worker thread drains the whole batch once woken up.
+  if (any_task_enqueued) {
+    WakeUpIfIdle();
+  }
+}
+
+ExecutionResult SingleThreadAsyncExecutor::EnableWorkStealing(
+    vector<SingleThreadAsyncExecutor*> victims) noexcept {
+  if (is_running_) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_ALREADY_RUNNING);
+  }
+
+  if (queue_cap_ <= 0 || queue_cap_ > kMaxQueueCap) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_INVALID_QUEUE_CAP);
+  }
+
+  stealable_queue_ =
+      make_shared<ConcurrentQueue<unique_ptr<AsyncTask>>>(queue_cap_);
+  local_deque_ = make_unique<WorkStealingDeque<AsyncTask>>(
+      kWorkStealingLocalDequeCapacity);
+  victims_ = std::move(victims);
+  return SuccessExecutionResult();
+}
+
+ExecutionResult SingleThreadAsyncExecutor::ScheduleStealable(
+    const AsyncOperation& work) noexcept {
+  return ScheduleStealable(AsyncOperation(work));
+}
+
+ExecutionResult SingleThreadAsyncExecutor::ScheduleStealable(
+    AsyncOperation&& work) noexcept {
+  if (!local_deque_) {
+    return Schedule(std::move(work), AsyncPriority::Normal);
+  }
+
+  if (!is_running_) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
+  }
+
+  auto task = make_unique<AsyncTask>(std::move(work));
+  if (std::this_thread::get_id() == working_thread_id_ &&
+      local_deque_->Push(task)) {
+    // The worker is busy running the caller, so only a victim can run the
+    // task sooner.
+    WakeUpIdleVictim();
+    return SuccessExecutionResult();
+  }
+
+  if (!stealable_queue_->TryEnqueue(std::move(task)).Successful()) {
+    return RetryExecutionResult(errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
+  }
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (is_idle_.load(std::memory_order_relaxed)) {
+    WakeUp();
+  } else {
+    WakeUpIdleVictim();
+  }
+  return SuccessExecutionResult();
+}
+
+void SingleThreadAsyncExecutor::WakeUpIdleVictim() noexcept {
+  // Pairs with the fence of the victims before they check for tasks to steal.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  size_t start_index =
+      next_victim_to_wake_.fetch_add(1, std::memory_order_relaxed);
+  for (size_t i = 0; i < victims_.size(); ++i) {
+    auto* victim = victims_[(start_index + i) % victims_.size()];
+    if (victim->is_idle_.load(std::memory_order_relaxed)) {
+      victim->steal_requested_ = true;
+      victim->WakeUp();
+      return;
+    }
+  }
+}
+
+size_t SingleThreadAsyncExecutor::GetQueueSize() const noexcept {
+  if (!normal_pri_queue_ || !high_pri_queue_) {
+    return 0;
+  }
+  return GetNormalPriorityQueueSize() + high_pri_queue_->Size();
+}
+
+size_t SingleThreadAsyncExecutor::GetNormalPriorityQueueSize() const noexcept {
+  size_t queue_size = normal_pri_queue_->Size();
+  if (local_deque_) {
+    queue_size += stealable_queue_->Size() + local_deque_->Size();
+  }
+  return queue_size;
+}
+
 ExecutionResultOr<thread::id> SingleThreadAsyncExecutor::GetThreadId() const {
 #if !defined(PBS_ENABLE_BENCHMARKING)
   if (!is_running_.load()) {
@@ -15,15 +15,18 @@
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
+#include <cstdint>
 #include <memory>
-#include <mutex>
 #include <optional>
+#include <thread>
 #include <vector>
 
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "cc/core/async_executor/src/admission_controller.h"
 #include "cc/core/async_executor/src/async_task.h"
+#include "cc/core/async_executor/src/task_stats.h"
+#include "cc/core/async_executor/src/work_stealing_deque.h"
 #include "cc/core/common/concurrent_queue/src/concurrent_queue.h"
 #include "cc/core/interface/async_executor_interface.h"
 
@@ -36,13 +39,19 @@ class SingleThreadAsyncExecutor : ServiceInterface {
  public:
   explicit SingleThreadAsyncExecutor(
       size_t queue_cap, bool drop_tasks_on_stop = false,
-      std::optional<size_t> affinity_cpu_number = std::nullopt)
+      std::optional<size_t> affinity_cpu_number = std::nullopt,
+      AdmissionControlOptions admission_control_options =
+          AdmissionControlOptions())
       : is_running_(false),
         worker_thread_started_(false),
         worker_thread_stopped_(false),
+        is_idle_(false),
+        steal_requested_(false),
+        next_victim_to_wake_(0),
         queue_cap_(queue_cap),
         drop_tasks_on_stop_(drop_tasks_on_stop),
-        affinity_cpu_number_(affinity_cpu_number) {
+        affinity_cpu_number_(affinity_cpu_number),
+        admission_controller_(admission_control_options) {
 #if defined(PBS_ENABLE_BENCHMARKING)
     scheduling_latency_for_testing_.reserve(300000);
 #endif
@@ -64,12 +73,76 @@ class SingleThreadAsyncExecutor : ServiceInterface {
   ExecutionResult Schedule(const AsyncOperation& work,
                            AsyncPriority priority) noexcept;
 
+  /// Same as above but moves the work into the task.
+  ExecutionResult Schedule(AsyncOperation&& work,
+                           AsyncPriority priority) noexcept;
+
+  /**
+   * @brief Schedules a batch of tasks with the same priority, waking up the
+   * worker thread at most once.
+   *
+   * @param works the tasks that need to be scheduled. They are moved from.
+   * @param priority the priority of the tasks. Either normal or high.
+   * @param results the result of the admission of each task.
+   */
+  void ScheduleBatch(absl::Span<AsyncOperation> works, AsyncPriority priority,
+                     absl::Span<ExecutionResult> results) noexcept;
+
+  /**
+   * @brief Lets the executor run the stealable tasks of the given executors
+   * whenever it has no task of its own, and lets them run its own stealable
+   * tasks. Must be called before Run(). The victims must outlive the worker
+   * thread of this executor.
+   *
+   * @param victims the executors to steal tasks from.
+   * @return ExecutionResult result of the execution with possible error code.
+   */
+  ExecutionResult EnableWorkStealing(
+      std::vector<SingleThreadAsyncExecutor*> victims) noexcept;
+
+  /**
+   * @brief Schedules a normal priority task that may be executed by this
+   * executor or stolen by any of its victims. A task scheduled from the worker
+   * thread of this executor is pushed to its local deque, which the worker
+   * pops in LIFO order, and is otherwise queued in FIFO order. If work stealing
+   * is not enabled, this is the same as Schedule(work, AsyncPriority::Normal).
+   *
+   * @param work the task that needs to be scheduled.
+   * @return ExecutionResult result of the execution with possible error code.
+   */
+  ExecutionResult ScheduleStealable(const AsyncOperation& work) noexcept;
+
+  /// Same as above but moves the work into the task.
+  ExecutionResult ScheduleStealable(AsyncOperation&& work) noexcept;
+
   /**
    * @brief Returns the ID of the spawned thread object to enable looking it up
    * via thread IDs later. Will only be populated after Run() is called.
    */
   ExecutionResultOr<std::thread::id> GetThreadId() const;
 
+  /// Returns whether the normal priority tasks wait too long in the queue.
+  bool IsOverloaded() const noexcept {
+    return admission_controller_.IsOverloaded();
+  }
+
+  /// Returns the number of tasks waiting in the queues, approximately.
+  size_t GetQueueSize() const noexcept;
+
+  /// Returns how long the last normal priority task waited, in nanoseconds.
+  Timestamp GetLastSojournTime() const noexcept {
+    return admission_controller_.GetLastSojournTime();
+  }
+
+  /**
+   * @brief Returns the statistics of the tasks of the given priority, recorded
+   * by the worker thread. Either normal or high.
+   */
+  const TaskStats& GetTaskStats(AsyncPriority priority) const noexcept {
+    return priority == AsyncPriority::High ? high_pri_task_stats_
+                                           : normal_pri_task_stats_;
+  }
+
   /**
    * @brief Returns the scheduling latencies for all AsyncOperation scheduled by
    * this executor. This method should only be called after Stop() is called and
@@ -88,6 +161,39 @@ class SingleThreadAsyncExecutor : ServiceInterface {
   /// Starts the internal worker thread.
   void StartWorker() noexcept;
 
+  /// Returns the number of normal priority tasks waiting, approximately.
+  size_t GetNormalPriorityQueueSize() const noexcept;
+
+  /**
+   * @brief Dequeues the next task to execute, stealing one from the victims if
+   * the executor has none of its own. Must be called from the worker thread.
+   *
+   * @param task the dequeued task.
+   * @param allow_stealing whether to steal tasks from the victims.
+   * @param is_high_priority set to whether the task has a high priority.
+   * @return true if a task was dequeued.
+   */
+  bool TryDequeueTask(std::unique_ptr<AsyncTask>& task, bool allow_stealing,
+                      bool& is_high_priority) noexcept;
+
+  /// Takes the oldest stealable task of this executor, if any.
+  std::unique_ptr<AsyncTask> TryStealTask() noexcept;
+
+  /// Wakes up one idle victim, if any, to steal the stealable tasks.
+  void WakeUpIdleVictim() noexcept;
+
+  /**
+   * @brief Returns whether the worker thread has tasks to run, including the
+   * tasks it can steal.
+   */
+  bool HasPendingTasks() noexcept;
+
+  /// Wakes up the worker thread.
+  void WakeUp() noexcept;
+
+  /// Wakes up the worker thread if it is idle, after a task is scheduled.
+  void WakeUpIfIdle() noexcept;
+
   /**
    * @brief While it is true, the running thread will keep listening and
    * picking out work from work queue. While it is false, the thread will try to
@@ -98,32 +204,54 @@ class SingleThreadAsyncExecutor : ServiceInterface {
   std::atomic<bool> worker_thread_started_;
   /// Indicates whether the worker thread stopped.
   std::atomic<bool> worker_thread_stopped_;
+  /// Indicates whether the worker thread is waiting for tasks. Scheduling a
+  /// task only wakes up the worker thread if it is set.
+  std::atomic<bool> is_idle_;
+  /// Indicates whether the worker thread is woken up to steal tasks.
+  std::atomic<bool> steal_requested_;
+  /// The index of the next victim to look at when waking up an idle victim.
+  std::atomic<size_t> next_victim_to_wake_;
   /// The maximum length of the work queue.
   size_t queue_cap_;
   /// Indicates whether the async executor should ignore the pending tasks.
   bool drop_tasks_on_stop_;
   /// An optional CPU to have an affinity for.
   std::optional<size_t> affinity_cpu_number_;
+  /// Tracks the sojourn time of the normal priority tasks.
+  AdmissionController admission_controller_;
+  /// The statistics of the normal priority tasks, stolen ones included.
+  TaskStats normal_pri_task_stats_;
+  /// The statistics of the high priority tasks.
+  TaskStats high_pri_task_stats_;
   /// Queue for accepting the incoming normal priority tasks.
-  std::shared_ptr<common::ConcurrentQueue<std::shared_ptr<AsyncTask>>>
+  std::shared_ptr<common::ConcurrentQueue<std::unique_ptr<AsyncTask>>>
       normal_pri_queue_;
   /// Queue for accepting the incoming high priority tasks.
-  std::shared_ptr<common::ConcurrentQueue<std::shared_ptr<AsyncTask>>>
+  std::shared_ptr<common::ConcurrentQueue<std::unique_ptr<AsyncTask>>>
       high_pri_queue_;
+  /// Queue for accepting the incoming stealable tasks from other threads. Only
+  /// set if work stealing is enabled.
+  std::shared_ptr<common::ConcurrentQueue<std::unique_ptr<AsyncTask>>>
+      stealable_queue_;
+  /// Deque for the stealable tasks scheduled by the worker thread itself. Only
+  /// set if work stealing is enabled.
+  std::unique_ptr<WorkStealingDeque<AsyncTask>> local_deque_;
+  /// The executors to steal tasks from, tried in turn starting at
+  /// next_victim_to_steal_.
+  std::vector<SingleThreadAsyncExecutor*> victims_;
+  /// The index of the next victim to steal a task from.
+  size_t next_victim_to_steal_ = 0;
+  /// The number of tasks dequeued by the worker thread.
+  uint64_t dequeued_task_count_ = 0;
   /// A unique pointer to the working thread.
   std::unique_ptr<std::thread> working_thread_;
   /// The ID of the working_thread_.
   std::thread::id working_thread_id_;
   /**
-   * @brief Used in combination with the condition variable for signaling the
-   * thread that an element is pushed to the queue.
-   */
-  std::mutex mutex_;
-  /**
-   * @brief Used in combination with the mutex for signaling the thread that an
-   * element is pushed to the queue.
+   * @brief Incremented to wake up the worker thread, which waits on it while
+   * idle. Unlike a condition variable, waking up an idle worker takes no lock.
    */
-  std::condition_variable condition_variable_;
+  std::atomic<uint32_t> wakeup_count_ = 0;
 
 #if defined(PBS_ENABLE_BENCHMARKING)
   std::vector<absl::Duration> scheduling_latency_for_testing_;
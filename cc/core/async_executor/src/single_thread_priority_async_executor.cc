@@ -14,30 +14,33 @@
 
 #include "single_thread_priority_async_executor.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <functional>
 #include <memory>
-#include <queue>
 #include <thread>
 #include <vector>
 
 #include "cc/core/common/time_provider/src/time_provider.h"
 
 #include "async_executor_utils.h"
+#include "async_task_pool.h"
 #include "error_codes.h"
 #include "typedef.h"
 
+using google::scp::core::common::ConcurrentQueue;
 using google::scp::core::common::TimeProvider;
 using std::function;
+using std::lock_guard;
 using std::make_shared;
 using std::make_unique;
 using std::mutex;
-using std::priority_queue;
 using std::shared_ptr;
 using std::thread;
 using std::unique_lock;
 using std::vector;
+using std::weak_ptr;
 using std::chrono::milliseconds;
 using std::chrono::nanoseconds;
 
@@ -47,9 +50,10 @@ ExecutionResult SingleThreadPriorityAsyncExecutor::Init() noexcept {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_INVALID_QUEUE_CAP);
   }
 
-  queue_ = make_shared<
-      priority_queue<shared_ptr<AsyncTask>, vector<shared_ptr<AsyncTask>>,
-                     AsyncTaskCompareGreater>>();
+  scheduled_tasks_ = make_shared<ScheduledTasks>(
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks());
+  ready_queue_ =
+      make_shared<ConcurrentQueue<shared_ptr<AsyncTask>>>(queue_cap_);
   return SuccessExecutionResult();
 };
 
@@ -58,10 +62,9 @@ ExecutionResult SingleThreadPriorityAsyncExecutor::Run() noexcept {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_ALREADY_RUNNING);
   }
 
-  if (!queue_) {
+  if (!scheduled_tasks_ || !ready_queue_) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_INITIALIZED);
   }
-
   is_running_ = true;
   working_thread_ = make_unique<thread>(
       [affinity_cpu_number =
@@ -82,53 +85,85 @@ ExecutionResult SingleThreadPriorityAsyncExecutor::Run() noexcept {
 }
 
 void SingleThreadPriorityAsyncExecutor::StartWorker() noexcept {
-  unique_lock<mutex> thread_lock(mutex_);
-  auto wait_timeout_duration_ns = kInfiniteWaitDurationNs;
+  auto& timer_wheel = scheduled_tasks_->timer_wheel;
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  unique_lock<mutex> thread_lock(scheduled_tasks_->mutex);
 
   while (true) {
-    condition_variable_.wait_for(thread_lock, wait_timeout_duration_ns, [&]() {
-      Timestamp current_timestamp =
-          TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
-
-      return !is_running_ || update_wait_time_ ||
-             current_timestamp > next_scheduled_task_timestamp_;
-    });
+    Timestamp current_timestamp =
+        TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+    timer_wheel.PopExpired(current_timestamp, expired_tasks);
+    // Only the tasks for now queued so far are executed in this round, so that
+    // a steady flow of them does not delay the tasks scheduled for later.
+    size_t ready_task_count = ready_queue_->Size();
 
-    if (update_wait_time_) {
-      update_wait_time_ = false;
+    if (!expired_tasks.empty() || ready_task_count > 0) {
+      thread_lock.unlock();
+      // Each task starts right as the previous one ends, so reading the clock
+      // once per task is enough.
+      Timestamp start_timestamp = current_timestamp;
+      auto execute_task = [&](shared_ptr<AsyncTask>& task) {
+        Timestamp due_timestamp = task->GetExecutionTimestamp();
+        size_t queue_depth = scheduled_tasks_->pending_task_count.load(
+            std::memory_order_relaxed);
+        task->Execute();
+        task.reset();
+        Timestamp end_timestamp =
+            TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+        task_stats_.RecordTask(due_timestamp, start_timestamp, end_timestamp,
+                               queue_depth);
+        start_timestamp = end_timestamp;
+      };
+
+      for (auto& task : expired_tasks) {
+        execute_task(task);
+      }
+      scheduled_tasks_->pending_task_count -= expired_tasks.size();
+      expired_tasks.clear();
+
+      shared_ptr<AsyncTask> task;
+      for (size_t i = 0; i < ready_task_count &&
+                         ready_queue_->TryDequeue(task).Successful();
+           ++i) {
+        execute_task(task);
+        scheduled_tasks_->pending_task_count--;
+      }
+      thread_lock.lock();
+      continue;
     }
 
-    // Discard any cancelled tasks on top of the queue as an optimization to
-    // avoid waiting for the future to arrive on an already cancelled task
-    while (!queue_->empty() && queue_->top()->IsCancelled()) {
-      queue_->pop();
+    if (!is_running_ && timer_wheel.Size() == 0) {
+      break;
     }
 
-    if (queue_->size() == 0) {
-      if (!is_running_) {
-        break;
-      }
-      next_scheduled_task_timestamp_ = UINT64_MAX;
-      wait_timeout_duration_ns = kInfiniteWaitDurationNs;
-      continue;
+    next_scheduled_task_timestamp_ = timer_wheel.NextUpdateTimestamp();
+    auto wait_timeout_duration_ns = kInfiniteWaitDurationNs;
+    if (next_scheduled_task_timestamp_ != UINT64_MAX) {
+      wait_timeout_duration_ns = nanoseconds(
+          next_scheduled_task_timestamp_ -
+          std::min(current_timestamp, next_scheduled_task_timestamp_.load()));
     }
 
-    Timestamp current_timestamp =
-        TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+    // The fence pairs with the one in ScheduleFor: either the scheduling thread
+    // sees the worker idle, or the worker sees the task scheduled for now.
+    bool was_running = is_running_;
+    is_idle_ = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    condition_variable_.wait_for(thread_lock, wait_timeout_duration_ns, [&]() {
+      return update_wait_time_ || is_running_ != was_running ||
+             ready_queue_->Size() > 0;
+    });
+    is_idle_ = false;
+    update_wait_time_ = false;
+  }
+}
 
-    next_scheduled_task_timestamp_ = queue_->top()->GetExecutionTimestamp();
-    wait_timeout_duration_ns = nanoseconds(0);
-    if (current_timestamp < next_scheduled_task_timestamp_) {
-      wait_timeout_duration_ns =
-          nanoseconds(next_scheduled_task_timestamp_ - current_timestamp);
-    } else {
-      auto top = queue_->top();
-      queue_->pop();
-      thread_lock.unlock();
-      top->Execute();
-      thread_lock.lock();
-    }
+bool SingleThreadPriorityAsyncExecutor::TryReservePendingTask() noexcept {
+  if (scheduled_tasks_->pending_task_count.fetch_add(1) >= queue_cap_) {
+    scheduled_tasks_->pending_task_count--;
+    return false;
   }
+  return true;
 }
 
 ExecutionResult SingleThreadPriorityAsyncExecutor::Stop() noexcept {
@@ -136,12 +171,16 @@ ExecutionResult SingleThreadPriorityAsyncExecutor::Stop() noexcept {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
   }
 
-  unique_lock<mutex> thread_lock(mutex_);
+  unique_lock<mutex> thread_lock(scheduled_tasks_->mutex);
   is_running_ = false;
 
   if (drop_tasks_on_stop_) {
-    while (queue_->size() > 0) {
-      queue_->pop();
+    scheduled_tasks_->pending_task_count -=
+        scheduled_tasks_->timer_wheel.Size();
+    scheduled_tasks_->timer_wheel.Clear();
+    shared_ptr<AsyncTask> task;
+    while (ready_queue_->TryDequeue(task).Successful()) {
+      scheduled_tasks_->pending_task_count--;
     }
   }
 
@@ -161,36 +200,121 @@ ExecutionResult SingleThreadPriorityAsyncExecutor::Stop() noexcept {
 
 ExecutionResult SingleThreadPriorityAsyncExecutor::ScheduleFor(
     const AsyncOperation& work, Timestamp timestamp) noexcept {
-  function<bool()> cancellation_callback = []() { return false; };
-  return ScheduleFor(work, timestamp, cancellation_callback);
+  return ScheduleFor(AsyncOperation(work), timestamp);
 };
 
 ExecutionResult SingleThreadPriorityAsyncExecutor::ScheduleFor(
     const AsyncOperation& work, Timestamp timestamp,
     function<bool()>& cancellation_callback) noexcept {
+  return ScheduleFor(AsyncOperation(work), timestamp, cancellation_callback);
+};
+
+ExecutionResult SingleThreadPriorityAsyncExecutor::ScheduleFor(
+    AsyncOperation&& work, Timestamp timestamp) noexcept {
+  function<bool()> cancellation_callback = []() { return false; };
+  return ScheduleFor(std::move(work), timestamp, cancellation_callback);
+};
+
+ExecutionResult SingleThreadPriorityAsyncExecutor::ScheduleFor(
+    AsyncOperation&& work, Timestamp timestamp,
+    function<bool()>& cancellation_callback) noexcept {
   if (!is_running_) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
   }
 
-  unique_lock<mutex> thread_lock(mutex_);
-
-  if (queue_->size() >= queue_cap_) {
+  if (!TryReservePendingTask()) {
     return RetryExecutionResult(errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
   }
 
-  auto task = make_shared<AsyncTask>(work, timestamp);
-  cancellation_callback = [task]() mutable { return task->Cancel(); };
-  queue_->push(task);
+  // The task and its control block share a single pooled allocation.
+  auto task = std::allocate_shared<AsyncTask>(PooledAllocator<AsyncTask>(),
+                                              std::move(work), timestamp);
+  if (timestamp <=
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks()) {
+    // Tasks for now bypass the timer wheel, and only take the mutex to signal
+    // an idle worker thread.
+    cancellation_callback = [task]() mutable { return task->Cancel(); };
+    if (!ready_queue_->TryEnqueue(std::move(task)).Successful()) {
+      scheduled_tasks_->pending_task_count--;
+      return RetryExecutionResult(
+          errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (is_idle_.load(std::memory_order_relaxed)) {
+      lock_guard<mutex> lock(scheduled_tasks_->mutex);
+      condition_variable_.notify_one();
+    }
+    return SuccessExecutionResult();
+  }
+
+  lock_guard<mutex> lock(scheduled_tasks_->mutex);
+  auto handle = scheduled_tasks_->timer_wheel.Insert(task);
+  // Cancelling removes the task from the timer wheel right away, so that it
+  // neither holds its captures nor counts towards the queue cap until its
+  // timestamp.
+  cancellation_callback = [task, handle,
+                           weak_scheduled_tasks = weak_ptr<ScheduledTasks>(
+                               scheduled_tasks_)]() mutable {
+    if (!task->Cancel()) {
+      return false;
+    }
+    if (auto scheduled_tasks = weak_scheduled_tasks.lock()) {
+      lock_guard<mutex> lock(scheduled_tasks->mutex);
+      if (scheduled_tasks->timer_wheel.Remove(handle)) {
+        scheduled_tasks->pending_task_count--;
+      }
+    }
+    return true;
+  };
 
   if (timestamp < next_scheduled_task_timestamp_.load()) {
     next_scheduled_task_timestamp_ = timestamp;
     update_wait_time_ = true;
+    condition_variable_.notify_one();
   }
-
-  condition_variable_.notify_one();
   return SuccessExecutionResult();
 };
 
+void SingleThreadPriorityAsyncExecutor::ScheduleBatch(
+    absl::Span<AsyncOperation> works,
+    absl::Span<ExecutionResult> results) noexcept {
+  if (!is_running_) {
+    std::fill(results.begin(), results.end(),
+              FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING));
+    return;
+  }
+
+  auto timestamp = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  bool any_task_enqueued = false;
+  for (size_t i = 0; i < works.size(); ++i) {
+    if (!TryReservePendingTask()) {
+      results[i] =
+          RetryExecutionResult(errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
+      continue;
+    }
+    auto task = std::allocate_shared<AsyncTask>(PooledAllocator<AsyncTask>(),
+                                                std::move(works[i]), timestamp);
+    if (!ready_queue_->TryEnqueue(std::move(task)).Successful()) {
+      scheduled_tasks_->pending_task_count--;
+      results[i] =
+          RetryExecutionResult(errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
+      continue;
+    }
+    results[i] = SuccessExecutionResult();
+    any_task_enqueued = true;
+  }
+
+  if (!any_task_enqueued) {
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (is_idle_.load(std::memory_order_relaxed)) {
+    lock_guard<mutex> lock(scheduled_tasks_->mutex);
+    condition_variable_.notify_one();
+  }
+}
+
 ExecutionResultOr<thread::id> SingleThreadPriorityAsyncExecutor::GetThreadId()
     const {
   if (!is_running_.load()) {
@@ -19,17 +19,22 @@
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <queue>
+#include <thread>
 #include <vector>
 
+#include "absl/types/span.h"
+#include "cc/core/common/concurrent_queue/src/concurrent_queue.h"
 #include "cc/core/interface/async_executor_interface.h"
 
 #include "async_task.h"
+#include "task_stats.h"
+#include "timer_wheel.h"
 
 namespace google::scp::core {
 /**
  * @brief A single threaded priority async executor. This executor will have one
- * thread working with one priority queue.
+ * thread working with a timer wheel of the tasks scheduled for later, and a
+ * queue of the tasks scheduled for now, which bypass the timer wheel.
  */
 class SingleThreadPriorityAsyncExecutor : ServiceInterface {
  public:
@@ -40,6 +45,7 @@ class SingleThreadPriorityAsyncExecutor : ServiceInterface {
         worker_thread_started_(false),
         worker_thread_stopped_(false),
         update_wait_time_(false),
+        is_idle_(false),
         next_scheduled_task_timestamp_(UINT64_MAX),
         queue_cap_(queue_cap),
         drop_tasks_on_stop_(drop_tasks_on_stop),
@@ -63,7 +69,9 @@ class SingleThreadPriorityAsyncExecutor : ServiceInterface {
                               Timestamp timestamp) noexcept;
 
   /**
-   * @brief Schedules a task to be executed at a certain time.
+   * @brief Schedules a task to be executed at a certain time. Tasks scheduled
+   * for later are executed within a TimerWheel tick of their timestamp, and
+   * are removed from the executor as soon as they are cancelled.
    *
    * @param work The task that needs to be scheduled.
    * @param timestamp The timestamp to the task to be executed.
@@ -75,16 +83,55 @@ class SingleThreadPriorityAsyncExecutor : ServiceInterface {
       const AsyncOperation& work, Timestamp timestamp,
       std::function<bool()>& cancellation_callback) noexcept;
 
+  /// Same as the overloads above but move the work into the task.
+  ExecutionResult ScheduleFor(AsyncOperation&& work,
+                              Timestamp timestamp) noexcept;
+
+  ExecutionResult ScheduleFor(
+      AsyncOperation&& work, Timestamp timestamp,
+      std::function<bool()>& cancellation_callback) noexcept;
+
+  /**
+   * @brief Schedules a batch of tasks to be executed right away, signaling the
+   * worker thread at most once.
+   *
+   * @param works The tasks that need to be scheduled. They are moved from.
+   * @param results The result of the admission of each task.
+   */
+  void ScheduleBatch(absl::Span<AsyncOperation> works,
+                     absl::Span<ExecutionResult> results) noexcept;
+
   /**
    * @brief Returns the ID of the spawned thread object to enable looking it up
    * via thread IDs later. Will only be populated after Run() is called.
    */
   ExecutionResultOr<std::thread::id> GetThreadId() const;
 
+  /// Returns the statistics of the tasks, recorded by the worker thread.
+  const TaskStats& GetTaskStats() const noexcept { return task_stats_; }
+
  private:
+  /**
+   * @brief The tasks scheduled for later. They are shared with the
+   * cancellation callbacks of the tasks, which may outlive the executor.
+   */
+  struct ScheduledTasks {
+    explicit ScheduledTasks(Timestamp current_timestamp)
+        : timer_wheel(current_timestamp), pending_task_count(0) {}
+
+    /// Guards the timer wheel.
+    std::mutex mutex;
+    TimerWheel timer_wheel;
+    /// The number of tasks not executed yet, including the tasks for now.
+    std::atomic<size_t> pending_task_count;
+  };
+
   /// Starts the internal worker thread.
   void StartWorker() noexcept;
 
+  /// Counts a new pending task, unless the queue cap is reached.
+  bool TryReservePendingTask() noexcept;
+
   /**
    * @brief While it is true, the running thread will keep listening and
    * picking out work from work queue. While it is false, the thread will try to
@@ -97,6 +144,9 @@ class SingleThreadPriorityAsyncExecutor : ServiceInterface {
   std::atomic<bool> worker_thread_stopped_;
   /// Indicates whether the wait time needs to be updated.
   std::atomic<bool> update_wait_time_;
+  /// Indicates whether the worker thread is waiting. Scheduling a task for now
+  /// only takes the mutex to signal the worker thread if it is set.
+  std::atomic<bool> is_idle_;
   /**
    * @brief The next scheduled task timestamp. This value helps with signaling
    * the thread at the next time of execution and prevents spin waiting.
@@ -112,20 +162,17 @@ class SingleThreadPriorityAsyncExecutor : ServiceInterface {
   std::unique_ptr<std::thread> working_thread_;
   /// The ID of the working_thread_.
   std::thread::id working_thread_id_;
-  /// Queue for accepting the incoming tasks.
-  std::shared_ptr<std::priority_queue<std::shared_ptr<AsyncTask>,
-                                      std::vector<std::shared_ptr<AsyncTask>>,
-                                      AsyncTaskCompareGreater>>
-      queue_;
-  /**
-   * @brief Used in combination with the condition variable for signaling the
-   * thread that an element is pushed to the queue.
-   */
-  std::mutex mutex_;
+  /// The tasks scheduled for later.
+  std::shared_ptr<ScheduledTasks> scheduled_tasks_;
+  /// Queue for accepting the incoming tasks scheduled for now.
+  std::shared_ptr<common::ConcurrentQueue<std::shared_ptr<AsyncTask>>>
+      ready_queue_;
   /**
-   * @brief Used in combination with the mutex for signaling the thread that an
-   * element is pushed to the queue.
+   * @brief Used in combination with the mutex of scheduled_tasks_ for
+   * signaling the thread that a task is scheduled.
    */
   std::condition_variable condition_variable_;
+  /// The statistics of the tasks, both for now and for later.
+  TaskStats task_stats_;
 };
 }  // namespace google::scp::core
@@ -0,0 +1,71 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "task_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace google::scp::core {
+void LogLinearHistogramSnapshot::Add(
+    const LogLinearHistogramSnapshot& other) noexcept {
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    counts[i] += other.counts[i];
+  }
+}
+
+void LogLinearHistogramSnapshot::Subtract(
+    const LogLinearHistogramSnapshot& earlier) noexcept {
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    // The counts only grow, but the snapshots of the buckets are not taken at
+    // the same instant.
+    counts[i] -= std::min(counts[i], earlier.counts[i]);
+  }
+}
+
+uint64_t LogLinearHistogramSnapshot::GetCount() const noexcept {
+  uint64_t count = 0;
+  for (auto bucket_count : counts) {
+    count += bucket_count;
+  }
+  return count;
+}
+
+uint64_t LogLinearHistogramSnapshot::GetValueAtQuantile(
+    double quantile) const noexcept {
+  uint64_t count = GetCount();
+  if (count == 0) {
+    return 0;
+  }
+  // The rank of the value, starting at 1.
+  auto rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) *
+                                         static_cast<double>(count))));
+  uint64_t seen_count = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen_count += counts[i];
+    if (seen_count >= rank) {
+      return GetBucketValue(i);
+    }
+  }
+  return GetBucketValue(kBucketCount - 1);
+}
+
+void LogLinearHistogram::AddTo(
+    LogLinearHistogramSnapshot& snapshot) const noexcept {
+  for (size_t i = 0; i < LogLinearHistogramSnapshot::kBucketCount; ++i) {
+    snapshot.counts[i] += counts_[i].load(std::memory_order_relaxed);
+  }
+}
+}  // namespace google::scp::core
@@ -0,0 +1,132 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "cc/core/interface/type_def.h"
+
+namespace google::scp::core {
+/**
+ * @brief A histogram with log-linear buckets, as HdrHistogram has: each power
+ * of two is split in kSubBucketCount buckets, so that a value is known within
+ * 1/kSubBucketCount of itself whatever its magnitude, and the values below
+ * kSubBucketCount are exact. Values above kMaxValue are counted as kMaxValue.
+ */
+class LogLinearHistogramSnapshot {
+ public:
+  static constexpr size_t kSubBucketBits = 3;
+  static constexpr size_t kSubBucketCount = 1 << kSubBucketBits;
+  /// About 18 minutes for nanoseconds.
+  static constexpr uint64_t kMaxValue = (uint64_t{1} << 40) - 1;
+  static constexpr size_t kBucketCount =
+      (std::bit_width(kMaxValue) - kSubBucketBits + 1) * kSubBucketCount;
+
+  /// Returns the bucket counting the value.
+  static constexpr size_t GetBucketIndex(uint64_t value) noexcept {
+    if (value > kMaxValue) {
+      value = kMaxValue;
+    }
+    size_t shift = std::bit_width(value) > kSubBucketBits + 1
+                       ? std::bit_width(value) - kSubBucketBits - 1
+                       : 0;
+    return shift * kSubBucketCount + (value >> shift);
+  }
+
+  /// Returns the middle of the values counted by the bucket.
+  static constexpr uint64_t GetBucketValue(size_t bucket_index) noexcept {
+    if (bucket_index < 2 * kSubBucketCount) {
+      return bucket_index;
+    }
+    size_t shift = bucket_index / kSubBucketCount - 1;
+    uint64_t lowest_value =
+        (kSubBucketCount + bucket_index % kSubBucketCount) << shift;
+    return lowest_value + (uint64_t{1} << (shift - 1));
+  }
+
+  /// Adds the counts of the other snapshot.
+  void Add(const LogLinearHistogramSnapshot& other) noexcept;
+
+  /// Removes the counts of an earlier snapshot of the same histograms.
+  void Subtract(const LogLinearHistogramSnapshot& earlier) noexcept;
+
+  /// Returns the number of values counted.
+  uint64_t GetCount() const noexcept;
+
+  /**
+   * @brief Returns the value at the quantile, e.g. 0.99 for the 99th
+   * percentile, or 0 if no value is counted.
+   */
+  uint64_t GetValueAtQuantile(double quantile) const noexcept;
+
+  std::array<uint64_t, kBucketCount> counts = {};
+};
+
+/**
+ * @brief A LogLinearHistogramSnapshot recorded by a single thread, e.g. the
+ * worker thread of an executor, and read by any thread. Recording takes no
+ * read-modify-write instruction, and never touches memory shared with other
+ * writers.
+ */
+class LogLinearHistogram {
+ public:
+  /// Counts the value. Must only be called by the recording thread.
+  void Record(uint64_t value) noexcept {
+    auto& count = counts_[LogLinearHistogramSnapshot::GetBucketIndex(value)];
+    count.store(count.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+  }
+
+  /// Adds the current counts to the snapshot. May be called by any thread.
+  void AddTo(LogLinearHistogramSnapshot& snapshot) const noexcept;
+
+ private:
+  std::array<std::atomic<uint64_t>, LogLinearHistogramSnapshot::kBucketCount>
+      counts_ = {};
+};
+
+/// The statistics of the tasks of an executor queue.
+struct TaskStats {
+  /// How long the tasks wait in the queue after they are due, in nanoseconds.
+  LogLinearHistogram queue_wait_time;
+  /// How long the tasks run for, in nanoseconds.
+  LogLinearHistogram run_time;
+  /// How many tasks are waiting in the queue when one is dequeued.
+  LogLinearHistogram queue_depth;
+
+  /**
+   * @brief Records a task run by the worker thread.
+   *
+   * @param due_timestamp the steady timestamp the task was due at.
+   * @param dequeue_timestamp the steady timestamp the task was dequeued at.
+   * @param end_timestamp the steady timestamp the task finished at.
+   * @param depth the number of tasks waiting when the task was dequeued.
+   */
+  void RecordTask(Timestamp due_timestamp, Timestamp dequeue_timestamp,
+                  Timestamp end_timestamp, size_t depth) noexcept {
+    queue_wait_time.Record(dequeue_timestamp > due_timestamp
+                               ? dequeue_timestamp - due_timestamp
+                               : 0);
+    run_time.Record(end_timestamp > dequeue_timestamp
+                        ? end_timestamp - dequeue_timestamp
+                        : 0);
+    queue_depth.Record(depth);
+  }
+};
+}  // namespace google::scp::core
@@ -0,0 +1,210 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <optional>
+#include <vector>
+
+using std::shared_ptr;
+using std::vector;
+
+namespace google::scp::core {
+TimerWheel::TimerWheel(Timestamp current_timestamp)
+    : current_tick_(current_timestamp >> kTickShift), size_(0) {
+  for (auto& level_heads : slot_heads_) {
+    level_heads.fill(kInvalidIndex);
+  }
+  occupied_slots_.fill(0);
+}
+
+TimerWheel::Handle TimerWheel::Insert(shared_ptr<AsyncTask> task) {
+  uint32_t index;
+  if (free_indices_.empty()) {
+    index = entries_.size();
+    entries_.emplace_back();
+  } else {
+    index = free_indices_.back();
+    free_indices_.pop_back();
+  }
+
+  auto& entry = entries_[index];
+  // A task which is already due expires on the next tick.
+  entry.tick =
+      std::max(task->GetExecutionTimestamp() >> kTickShift, current_tick_);
+  entry.task = std::move(task);
+  entry.in_use = true;
+  Link(index);
+  size_++;
+  return Handle{index, entry.generation};
+}
+
+bool TimerWheel::Remove(const Handle& handle) {
+  if (handle.index >= entries_.size()) {
+    return false;
+  }
+  auto& entry = entries_[handle.index];
+  if (!entry.in_use || entry.generation != handle.generation) {
+    return false;
+  }
+  Free(handle.index);
+  return true;
+}
+
+void TimerWheel::PopExpired(Timestamp current_timestamp,
+                            vector<shared_ptr<AsyncTask>>& expired_tasks) {
+  uint64_t tick = current_timestamp >> kTickShift;
+  size_t first_expired_index = expired_tasks.size();
+  while (auto event = NextEvent()) {
+    if (event->level == 0) {
+      // The tasks of a tick expire once the tick is over.
+      if (event->tick >= tick) {
+        break;
+      }
+      current_tick_ = event->tick;
+      auto index = slot_heads_[0][event->slot];
+      while (index != kInvalidIndex) {
+        auto next_index = entries_[index].next;
+        expired_tasks.push_back(std::move(entries_[index].task));
+        Free(index);
+        index = next_index;
+      }
+      continue;
+    }
+
+    if (event->tick > tick) {
+      break;
+    }
+    // The tasks of the slot move to lower levels, relative to the new tick.
+    current_tick_ = event->tick;
+    auto index = slot_heads_[event->level][event->slot];
+    slot_heads_[event->level][event->slot] = kInvalidIndex;
+    occupied_slots_[event->level] &= ~(uint64_t{1} << event->slot);
+    while (index != kInvalidIndex) {
+      auto next_index = entries_[index].next;
+      Link(index);
+      index = next_index;
+    }
+  }
+  // Moving up to the next event keeps all the tasks at their level.
+  current_tick_ = std::max(current_tick_, tick);
+  if (auto event = NextEvent()) {
+    current_tick_ = std::min(current_tick_, event->tick);
+  }
+
+  std::stable_sort(expired_tasks.begin() + first_expired_index,
+                   expired_tasks.end(),
+                   [](const shared_ptr<AsyncTask>& lhs,
+                      const shared_ptr<AsyncTask>& rhs) {
+                     return lhs->GetExecutionTimestamp() <
+                            rhs->GetExecutionTimestamp();
+                   });
+}
+
+Timestamp TimerWheel::NextUpdateTimestamp() const {
+  auto event = NextEvent();
+  if (!event) {
+    return UINT64_MAX;
+  }
+  // Tasks expire at the end of their tick, but move down at its start.
+  uint64_t tick = event->level == 0 ? event->tick + 1 : event->tick;
+  if (tick > (UINT64_MAX >> kTickShift)) {
+    return UINT64_MAX;
+  }
+  return tick << kTickShift;
+}
+
+void TimerWheel::Clear() {
+  for (uint32_t index = 0; index < entries_.size(); ++index) {
+    if (entries_[index].in_use) {
+      Free(index);
+    }
+  }
+}
+
+void TimerWheel::Link(uint32_t index) {
+  auto& entry = entries_[index];
+  // The level is given by the highest group of kSlotBits bits in which the
+  // tick differs from the current tick, so that the task is moved down when
+  // the current tick reaches its slot.
+  uint64_t differing_bits = entry.tick ^ current_tick_;
+  uint64_t level = differing_bits == 0
+                       ? 0
+                       : (std::bit_width(differing_bits) - 1) / kSlotBits;
+  uint64_t slot = (entry.tick >> (level * kSlotBits)) & (kSlotCount - 1);
+  entry.level = level;
+  entry.slot = slot;
+  entry.previous = kInvalidIndex;
+  entry.next = slot_heads_[level][slot];
+  if (entry.next != kInvalidIndex) {
+    entries_[entry.next].previous = index;
+  }
+  slot_heads_[level][slot] = index;
+  occupied_slots_[level] |= uint64_t{1} << slot;
+}
+
+void TimerWheel::Unlink(uint32_t index) {
+  auto& entry = entries_[index];
+  if (entry.previous != kInvalidIndex) {
+    entries_[entry.previous].next = entry.next;
+  } else {
+    slot_heads_[entry.level][entry.slot] = entry.next;
+    if (entry.next == kInvalidIndex) {
+      occupied_slots_[entry.level] &= ~(uint64_t{1} << entry.slot);
+    }
+  }
+  if (entry.next != kInvalidIndex) {
+    entries_[entry.next].previous = entry.previous;
+  }
+}
+
+void TimerWheel::Free(uint32_t index) {
+  Unlink(index);
+  auto& entry = entries_[index];
+  entry.task.reset();
+  entry.in_use = false;
+  // Invalidates the handles of the task.
+  entry.generation++;
+  free_indices_.push_back(index);
+  size_--;
+}
+
+std::optional<TimerWheel::Event> TimerWheel::NextEvent() const {
+  for (uint64_t level = 0; level < kLevelCount; ++level) {
+    uint64_t current_slot =
+        (current_tick_ >> (level * kSlotBits)) & (kSlotCount - 1);
+    // Tasks at the lowest level may expire at the current tick, while the
+    // tasks of the higher levels are always in later slots.
+    uint64_t first_slot = level == 0 ? current_slot : current_slot + 1;
+    if (first_slot >= kSlotCount) {
+      continue;
+    }
+    uint64_t slots = occupied_slots_[level] >> first_slot;
+    if (slots == 0) {
+      continue;
+    }
+    uint64_t slot = first_slot + std::countr_zero(slots);
+    uint64_t upper_bits_shift = (level + 1) * kSlotBits;
+    uint64_t upper_bits =
+        upper_bits_shift >= 64
+            ? 0
+            : (current_tick_ >> upper_bits_shift) << upper_bits_shift;
+    return Event{upper_bits | (slot << (level * kSlotBits)), level, slot};
+  }
+  return std::nullopt;
+}
+}  // namespace google::scp::core
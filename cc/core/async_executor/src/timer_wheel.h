@@ -0,0 +1,152 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "cc/core/async_executor/src/async_task.h"
+#include "cc/core/interface/async_executor_interface.h"
+
+namespace google::scp::core {
+/**
+ * @brief A hierarchical timing wheel of AsyncTasks, which inserts and removes
+ * tasks in constant time. Time is divided in ticks of 2^kTickShift
+ * nanoseconds, and a task expires once the tick of its execution timestamp is
+ * over, i.e. up to one tick after its execution timestamp.
+ *
+ * Each of the kLevelCount levels has kSlotCount slots, the slots of a level
+ * spanning kSlotCount times the slots of the level below. A task is stored at
+ * the level of the highest slot index in which its tick differs from the
+ * current tick, and is moved down a level each time the current tick reaches
+ * its slot, until it expires from the lowest level.
+ *
+ * This class is not thread-safe.
+ */
+class TimerWheel {
+ public:
+  /// Identifies an inserted task, to remove it.
+  struct Handle {
+    uint32_t index;
+    uint32_t generation;
+  };
+
+  /// A tick lasts 2^kTickShift nanoseconds, i.e. about a millisecond.
+  static constexpr uint64_t kTickShift = 20;
+  /// The number of bits of a tick indexing the slots of a level.
+  static constexpr uint64_t kSlotBits = 6;
+  static constexpr uint64_t kSlotCount = 1 << kSlotBits;
+  /// Enough levels for the ticks of any timestamp.
+  static constexpr uint64_t kLevelCount = 8;
+
+  /**
+   * @brief Construct a new Timer Wheel object.
+   *
+   * @param current_timestamp the timestamp to start the wheel at. Tasks
+   * inserted with an earlier execution timestamp expire on the next tick.
+   */
+  explicit TimerWheel(Timestamp current_timestamp);
+
+  /**
+   * @brief Inserts a task to expire at its execution timestamp.
+   *
+   * @param task the task to insert.
+   * @return Handle the handle to remove the task with.
+   */
+  Handle Insert(std::shared_ptr<AsyncTask> task);
+
+  /**
+   * @brief Removes a task which has not expired yet.
+   *
+   * @param handle the handle returned when inserting the task.
+   * @return true if the task was removed, false if it already expired or was
+   * removed.
+   */
+  bool Remove(const Handle& handle);
+
+  /**
+   * @brief Removes the tasks which expired at the given timestamp and appends
+   * them to expired_tasks, in the order of their execution timestamps.
+   *
+   * @param current_timestamp the current timestamp, which must not decrease
+   * between calls.
+   * @param expired_tasks the vector to append the expired tasks to.
+   */
+  void PopExpired(Timestamp current_timestamp,
+                  std::vector<std::shared_ptr<AsyncTask>>& expired_tasks);
+
+  /**
+   * @brief Returns the timestamp at which PopExpired must be called next, at
+   * which a task expires or tasks need to move down a level. Returns
+   * UINT64_MAX if the wheel is empty.
+   */
+  Timestamp NextUpdateTimestamp() const;
+
+  /// Returns the number of tasks in the wheel.
+  size_t Size() const { return size_; }
+
+  /// Removes all the tasks.
+  void Clear();
+
+ private:
+  static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+  struct Entry {
+    std::shared_ptr<AsyncTask> task;
+    uint64_t tick = 0;
+    uint32_t previous = kInvalidIndex;
+    uint32_t next = kInvalidIndex;
+    uint32_t generation = 0;
+    uint8_t level = 0;
+    uint8_t slot = 0;
+    bool in_use = false;
+  };
+
+  /// The next tick at which a task expires or needs to move down a level.
+  struct Event {
+    uint64_t tick;
+    uint64_t level;
+    uint64_t slot;
+  };
+
+  /// Links the entry into the slot of its tick relative to current_tick_.
+  void Link(uint32_t index);
+
+  /// Unlinks the entry from its slot.
+  void Unlink(uint32_t index);
+
+  /// Unlinks the entry and makes it available to later insertions.
+  void Free(uint32_t index);
+
+  /// Returns the next event, if there is any task.
+  std::optional<Event> NextEvent() const;
+
+  /// The entries, linked in lists of the tasks of each slot.
+  std::vector<Entry> entries_;
+  /// The indices of the entries not in use.
+  std::vector<uint32_t> free_indices_;
+  /// The index of the first entry of each slot of each level.
+  std::array<std::array<uint32_t, kSlotCount>, kLevelCount> slot_heads_;
+  /// For each level, the bitmap of the slots which have entries.
+  std::array<uint64_t, kLevelCount> occupied_slots_;
+  /// The tick up to which the wheel was advanced.
+  uint64_t current_tick_;
+  /// The number of tasks in the wheel.
+  size_t size_;
+};
+}  // namespace google::scp::core
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 
 namespace google::scp::core {
 // TODO: Make the following configurable.
@@ -26,6 +27,17 @@ static constexpr size_t kMaxThreadCount = 10000;
 static const size_t kMaxQueueCap = UINT_MAX;
 /// The sleep interval for shutting down threads in miliseconds.
 static const size_t kSleepDurationMs = 10;
+/// The maximum number of tasks in the local deque of a work stealing worker.
+static constexpr size_t kWorkStealingLocalDequeCapacity = 1024;
+/**
+ * @brief The number of tasks a work stealing worker dequeues between two
+ * checks of its FIFO queues ahead of its LIFO local deque, so that the tasks
+ * scheduled from other threads are not starved by the tasks its own tasks keep
+ * scheduling.
+ */
+static constexpr uint64_t kWorkStealingFifoCheckInterval = 61;
+/// The maximum number of freed task blocks each thread keeps for reuse.
+static constexpr size_t kAsyncTaskPoolCapacityPerThread = 1024;
 /// Indicates an infinite wait time.
 static constexpr std::chrono::nanoseconds kInfiniteWaitDurationNs =
     std::chrono::duration_cast<std::chrono::nanoseconds>(
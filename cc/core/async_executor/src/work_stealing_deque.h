@@ -0,0 +1,155 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace google::scp::core {
+/**
+ * @brief A bounded Chase-Lev work-stealing deque. The owner thread pushes and
+ * pops elements at the bottom (LIFO) while any other thread steals elements
+ * from the top (FIFO).
+ *
+ * Push and Pop must only be called by the owner thread. Steal is thread-safe.
+ * The memory orderings follow "Correct and Efficient Work-Stealing for Weak
+ * Memory Models" (Lê et al., PPoPP 2013). The buffer does not grow, so that
+ * stealers never read a buffer that is being freed; Push fails instead when
+ * the deque is full.
+ *
+ * @tparam T the type of the elements, owned by the deque while queued.
+ */
+template <class T>
+class WorkStealingDeque {
+ public:
+  /**
+   * @brief Construct a new Work Stealing Deque object.
+   * @param capacity the maximum number of elements, rounded up to a power of
+   * two.
+   */
+  explicit WorkStealingDeque(size_t capacity)
+      : top_(0), bottom_(0), buffer_(RoundUpToPowerOfTwo(capacity)) {
+    mask_ = buffer_.size() - 1;
+  }
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  ~WorkStealingDeque() {
+    while (Steal()) {}
+  }
+
+  /**
+   * @brief Pushes an element at the bottom of the deque. Must only be called
+   * by the owner thread.
+   * @param element the element to be pushed. It is left untouched if the deque
+   * is full.
+   * @return true if the element was pushed.
+   */
+  bool Push(std::unique_ptr<T>& element) noexcept {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<int64_t>(buffer_.size())) {
+      return false;
+    }
+    buffer_[bottom & mask_].store(element.release(), std::memory_order_relaxed);
+    // Publishes the element to the stealers, which acquire bottom_.
+    bottom_.store(bottom + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Pops the most recently pushed element. Must only be called by the
+   * owner thread.
+   * @return std::unique_ptr<T> the element, or nullptr if the deque is empty.
+   */
+  std::unique_ptr<T> Pop() noexcept {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      // Empty.
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    T* element = buffer_[bottom & mask_].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // The last element, which a stealer may be taking at the same time.
+      if (!top_.compare_exchange_strong(top, top + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        element = nullptr;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return std::unique_ptr<T>(element);
+  }
+
+  /**
+   * @brief Steals the least recently pushed element. This function is
+   * thread-safe.
+   * @return std::unique_ptr<T> the element, or nullptr if the deque is empty or
+   * another thread took the element first.
+   */
+  std::unique_ptr<T> Steal() noexcept {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+
+    T* element = buffer_[top & mask_].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return std::unique_ptr<T>(element);
+  }
+
+  /**
+   * @brief Provides the number of elements in the deque. Due to the nature of
+   * the concurrent deque, this value will be approximate.
+   * @return size_t number of elements in the deque.
+   */
+  size_t Size() const noexcept {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    return bottom > top ? bottom - top : 0;
+  }
+
+ private:
+  static size_t RoundUpToPowerOfTwo(size_t capacity) {
+    size_t rounded_capacity = 1;
+    while (rounded_capacity < capacity) {
+      rounded_capacity <<= 1;
+    }
+    return rounded_capacity;
+  }
+
+  /// Index of the oldest element, advanced by stealers and the last Pop.
+  alignas(64) std::atomic<int64_t> top_;
+  /// Index past the newest element, only written by the owner.
+  alignas(64) std::atomic<int64_t> bottom_;
+  /// Ring buffer of the elements.
+  std::vector<std::atomic<T*>> buffer_;
+  /// buffer_.size() - 1, to index the ring buffer.
+  int64_t mask_;
+};
+}  // namespace google::scp::core
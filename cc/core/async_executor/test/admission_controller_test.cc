@@ -0,0 +1,90 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cc/core/async_executor/src/admission_controller.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using std::chrono::milliseconds;
+
+namespace google::scp::core::test {
+namespace {
+constexpr Timestamp kMillisecond = 1000000;
+
+AdmissionControlOptions EnabledOptions() {
+  AdmissionControlOptions options;
+  options.enabled = true;
+  options.target_sojourn_time = milliseconds(5);
+  options.interval = milliseconds(100);
+  return options;
+}
+}  // namespace
+
+TEST(AdmissionControllerTest, IsNotOverloadedByABurst) {
+  AdmissionController admission_controller(EnabledOptions());
+  Timestamp now = 1000 * kMillisecond;
+  for (int i = 0; i < 10; ++i) {
+    now += 5 * kMillisecond;
+    admission_controller.OnTaskDequeued(now - 20 * kMillisecond, now);
+  }
+  EXPECT_FALSE(admission_controller.IsOverloaded());
+  EXPECT_EQ(admission_controller.GetLastSojournTime(), 20 * kMillisecond);
+
+  // A single task under the target restarts the interval.
+  admission_controller.OnTaskDequeued(now, now + kMillisecond);
+  now += 60 * kMillisecond;
+  admission_controller.OnTaskDequeued(now - 20 * kMillisecond, now);
+  EXPECT_FALSE(admission_controller.IsOverloaded());
+}
+
+TEST(AdmissionControllerTest, IsOverloadedByAStandingQueue) {
+  AdmissionController admission_controller(EnabledOptions());
+  Timestamp now = 1000 * kMillisecond;
+  for (int i = 0; i <= 20; ++i) {
+    admission_controller.OnTaskDequeued(now - 20 * kMillisecond, now);
+    now += 5 * kMillisecond;
+  }
+  EXPECT_TRUE(admission_controller.IsOverloaded());
+  EXPECT_TRUE(admission_controller.ShouldReject());
+
+  // The overload ends as soon as a task waits less than the target.
+  admission_controller.OnTaskDequeued(now - kMillisecond, now);
+  EXPECT_FALSE(admission_controller.IsOverloaded());
+}
+
+TEST(AdmissionControllerTest, OverloadEndsWhenTheQueueIsEmpty) {
+  AdmissionController admission_controller(EnabledOptions());
+  Timestamp now = 1000 * kMillisecond;
+  admission_controller.OnTaskDequeued(now - 20 * kMillisecond, now);
+  now += 200 * kMillisecond;
+  admission_controller.OnTaskDequeued(now - 20 * kMillisecond, now);
+  ASSERT_TRUE(admission_controller.IsOverloaded());
+
+  admission_controller.OnQueueEmpty();
+  EXPECT_FALSE(admission_controller.IsOverloaded());
+  EXPECT_EQ(admission_controller.GetLastSojournTime(), 0);
+}
+
+TEST(AdmissionControllerTest, OnlyRejectsWhenEnabled) {
+  AdmissionController admission_controller;
+  Timestamp now = 1000 * kMillisecond;
+  admission_controller.OnTaskDequeued(now - 20 * kMillisecond, now);
+  now += 200 * kMillisecond;
+  admission_controller.OnTaskDequeued(now - 20 * kMillisecond, now);
+  EXPECT_TRUE(admission_controller.IsOverloaded());
+  EXPECT_FALSE(admission_controller.ShouldReject());
+}
+}  // namespace google::scp::core::test
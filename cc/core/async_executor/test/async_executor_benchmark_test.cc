@@ -12,7 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <sys/resource.h>
+
+#include <atomic>
 #include <cmath>
+#include <memory>
 #include <string>
 #include <thread>
 
@@ -20,6 +24,7 @@
 
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
+#include "absl/time/clock.h"
 #include "cc/core/async_executor/src/async_executor.h"
 
 namespace google::scp::core {
@@ -39,7 +44,8 @@ class ExecutorFixture : public benchmark::Fixture {
  public:
   void SetUp(benchmark::State& state) {
     executor_ = std::make_unique<AsyncExecutor>(
-        std::thread::hardware_concurrency(), 1000);
+        thread_count_, 1000, /*drop_tasks_on_stop=*/false,
+        task_load_balancing_scheme_);
     executor_->Init();
     executor_->Run();
   }
@@ -52,6 +58,9 @@ class ExecutorFixture : public benchmark::Fixture {
       all_latencies.insert(all_latencies.end(), latencies.begin(),
                            latencies.end());
     }
+    if (all_latencies.empty()) {
+      return;
+    }
     std::sort(all_latencies.begin(), all_latencies.end());
 
     state.counters[absl::StrCat("p50")] =
@@ -61,8 +70,62 @@ class ExecutorFixture : public benchmark::Fixture {
   }
 
   std::unique_ptr<AsyncExecutor> executor_;
+  size_t thread_count_ = std::thread::hardware_concurrency();
+  TaskLoadBalancingScheme task_load_balancing_scheme_ =
+      TaskLoadBalancingScheme::RoundRobinGlobal;
 };
 
+// The blocking tasks sleep, so the executors of the fixtures below have a fixed
+// number of threads regardless of the number of CPUs.
+constexpr size_t kBlockingTasksThreadCount = 8;
+
+class RoundRobinGlobalFixture : public ExecutorFixture {
+ public:
+  RoundRobinGlobalFixture() { thread_count_ = kBlockingTasksThreadCount; }
+};
+
+class WorkStealingFixture : public ExecutorFixture {
+ public:
+  WorkStealingFixture() {
+    thread_count_ = kBlockingTasksThreadCount;
+    task_load_balancing_scheme_ = TaskLoadBalancingScheme::WorkStealing;
+  }
+};
+
+// Schedules short tasks of which one in kBlockingTaskInterval blocks its
+// executor for a millisecond, like a slow callback would.
+void ScheduleWithBlockingTasks(benchmark::State& state,
+                               AsyncExecutor& executor) {
+  constexpr int kBlockingTaskInterval = 64;
+  for (const auto& _ : state) {
+    absl::BlockingCounter counter(state.range(0));
+    for (int i = 0; i < state.range(0); ++i) {
+      AsyncOperation operation = AsyncOperation([&counter, i]() {
+        if (i % kBlockingTaskInterval == 0) {
+          absl::SleepFor(absl::Milliseconds(1));
+        }
+        counter.DecrementCount();
+      });
+      ExecutionResult result =
+          executor.Schedule(operation, AsyncPriority::Normal);
+      while (!result.Successful()) {
+        // The queue of the picked executor is full.
+        std::this_thread::yield();
+        result = executor.Schedule(operation, AsyncPriority::Normal);
+      }
+    }
+    counter.Wait();
+  }
+}
+
+// Returns the CPU time used by the process so far.
+absl::Duration GetProcessCpuTime() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return absl::DurationFromTimeval(usage.ru_utime) +
+         absl::DurationFromTimeval(usage.ru_stime);
+}
+
 BENCHMARK_DEFINE_F(ExecutorFixture, Schedule)(benchmark::State& state) {
   for (const auto& _ : state) {
     absl::BlockingCounter counter(state.range(0));
@@ -87,8 +150,105 @@ BENCHMARK_DEFINE_F(ExecutorFixture, Schedule)(benchmark::State& state) {
   }
 }
 
+BENCHMARK_DEFINE_F(RoundRobinGlobalFixture, ScheduleWithBlockingTasks)
+(benchmark::State& state) {
+  ScheduleWithBlockingTasks(state, *executor_);
+}
+
+BENCHMARK_DEFINE_F(WorkStealingFixture, ScheduleWithBlockingTasks)
+(benchmark::State& state) {
+  ScheduleWithBlockingTasks(state, *executor_);
+}
+
+// Schedules tasks which do nothing, so that only the overhead of the executor
+// is measured.
+BENCHMARK_DEFINE_F(RoundRobinGlobalFixture, ScheduleNoOpTasks)
+(benchmark::State& state) {
+  for (const auto& _ : state) {
+    absl::BlockingCounter counter(state.range(0));
+    AsyncOperation operation =
+        AsyncOperation([&counter]() { counter.DecrementCount(); });
+    for (int i = 0; i < state.range(0); ++i) {
+      while (!executor_->Schedule(operation, AsyncPriority::Normal)
+                  .Successful()) {
+        // The queue of the picked executor is full.
+        std::this_thread::yield();
+      }
+    }
+    counter.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Schedules the next task of a chain, which captures the state of the chain
+// like the callbacks of asynchronous operations capture their context.
+void ScheduleChainedTask(AsyncExecutor& executor,
+                         std::shared_ptr<std::atomic<int64_t>> remaining_tasks,
+                         absl::BlockingCounter& counter) {
+  auto task = [&executor, remaining_tasks, &counter]() {
+    if (--*remaining_tasks == 0) {
+      counter.DecrementCount();
+      return;
+    }
+    ScheduleChainedTask(executor, remaining_tasks, counter);
+  };
+  while (!executor.Schedule(AsyncOperation(task), AsyncPriority::High)
+              .Successful()) {
+    // The queue of the picked executor is full.
+    std::this_thread::yield();
+  }
+}
+
+// Runs chains of tasks which each schedule the next task of their chain from
+// the executor, so that the tasks are mostly created and freed by the threads
+// of the executor.
+BENCHMARK_DEFINE_F(RoundRobinGlobalFixture, ScheduleChainedTasks)
+(benchmark::State& state) {
+  constexpr int kChainCount = 64;
+  for (const auto& _ : state) {
+    absl::BlockingCounter counter(kChainCount);
+    for (int i = 0; i < kChainCount; ++i) {
+      ScheduleChainedTask(
+          *executor_,
+          std::make_shared<std::atomic<int64_t>>(state.range(0)), counter);
+    }
+    counter.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kChainCount * state.range(0));
+}
+
+// Measures the CPU time used per second by the threads of an executor without
+// any task.
+BENCHMARK_DEFINE_F(RoundRobinGlobalFixture, Idle)(benchmark::State& state) {
+  absl::Duration idle_cpu_time;
+  absl::Duration idle_time;
+  for (const auto& _ : state) {
+    absl::Duration start_cpu_time = GetProcessCpuTime();
+    absl::Time start_time = absl::Now();
+    absl::SleepFor(absl::Milliseconds(100));
+    idle_cpu_time += GetProcessCpuTime() - start_cpu_time;
+    idle_time += absl::Now() - start_time;
+  }
+  state.counters["idle_cpu_us_per_s"] =
+      absl::ToDoubleMicroseconds(idle_cpu_time) /
+      absl::ToDoubleSeconds(idle_time);
+}
+
 // Register the function as a benchmark.
 BENCHMARK_REGISTER_F(ExecutorFixture, Schedule)->Range(1, 1 << 19);
+BENCHMARK_REGISTER_F(RoundRobinGlobalFixture, ScheduleWithBlockingTasks)
+    ->Range(64, 1 << 14);
+BENCHMARK_REGISTER_F(WorkStealingFixture, ScheduleWithBlockingTasks)
+    ->Range(64, 1 << 14);
+BENCHMARK_REGISTER_F(RoundRobinGlobalFixture, ScheduleNoOpTasks)
+    ->Range(64, 1 << 14)
+    ->UseRealTime();
+BENCHMARK_REGISTER_F(RoundRobinGlobalFixture, ScheduleChainedTasks)
+    ->Range(16, 1 << 10)
+    ->UseRealTime();
+BENCHMARK_REGISTER_F(RoundRobinGlobalFixture, Idle)
+    ->Iterations(10)
+    ->Unit(benchmark::kMillisecond);
 
 }  // namespace
 }  // namespace google::scp::core
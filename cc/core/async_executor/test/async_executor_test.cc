@@ -20,8 +20,10 @@
 #include <chrono>
 #include <functional>
 #include <mutex>
+#include <set>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "cc/core/async_executor/mock/mock_async_executor_with_internals.h"
 #include "cc/core/async_executor/src/error_codes.h"
@@ -427,6 +429,237 @@ TEST(AsyncExecutorTests, FinishWorkWhenStopInMiddle) {
   EXPECT_EQ(normal_count, queue_cap);
 }
 
+TEST(AsyncExecutorTests, WorkStealingRunsTasksQueuedBehindBlockingTask) {
+  int queue_cap = 10;
+  AsyncExecutor executor(2, queue_cap, /*drop_tasks_on_stop=*/false,
+                         TaskLoadBalancingScheme::WorkStealing);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<bool> unblock(false);
+  executor.Schedule(
+      [&]() {
+        EXPECT_SUCCESS(WaitUntilOrReturn([&]() { return unblock.load(); }));
+      },
+      AsyncPriority::Normal);
+  // Half of the tasks are queued behind the blocking task, and are only run if
+  // the other executor steals them.
+  atomic<int> count(0);
+  for (int i = 0; i < queue_cap; i++) {
+    executor.Schedule([&]() { count++; }, AsyncPriority::Normal);
+  }
+  WaitUntil([&]() { return count == queue_cap; });
+  EXPECT_EQ(count, queue_cap);
+
+  unblock = true;
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, WorkStealingKeepsAffinitizedTasksOnCallingExecutor) {
+  AsyncExecutor executor(2, 10, /*drop_tasks_on_stop=*/false,
+                         TaskLoadBalancingScheme::WorkStealing);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  constexpr int kTaskCount = 3;
+  atomic<int> stolen_count(0);
+  atomic<int> affinitized_count(0);
+  executor.Schedule(
+      [&]() {
+        auto thread_id = std::this_thread::get_id();
+        for (int i = 0; i < kTaskCount; i++) {
+          executor.Schedule(
+              [&, thread_id]() {
+                // This executor is blocked, so the task must be stolen.
+                EXPECT_NE(std::this_thread::get_id(), thread_id);
+                stolen_count++;
+              },
+              AsyncPriority::Normal);
+          executor.Schedule(
+              [&, thread_id]() {
+                EXPECT_EQ(std::this_thread::get_id(), thread_id);
+                affinitized_count++;
+              },
+              AsyncPriority::Normal,
+              AsyncExecutorAffinitySetting::AffinitizedToCallingAsyncExecutor);
+        }
+        EXPECT_SUCCESS(
+            WaitUntilOrReturn([&]() { return stolen_count == kTaskCount; }));
+        EXPECT_EQ(affinitized_count, 0);
+      },
+      AsyncPriority::Normal);
+
+  WaitUntil([&]() {
+    return stolen_count == kTaskCount && affinitized_count == kTaskCount;
+  });
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, ScheduleBatchSpreadsTasksAcrossThreads) {
+  constexpr size_t kThreadCount = 4;
+  AsyncExecutor executor(kThreadCount, 100);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  for (auto priority : {AsyncPriority::Normal, AsyncPriority::Urgent}) {
+    constexpr int kTaskCount = 40;
+    mutex thread_ids_mutex;
+    std::set<std::thread::id> thread_ids;
+    atomic<int> count(0);
+    vector<AsyncOperation> works;
+    for (int i = 0; i < kTaskCount; i++) {
+      works.push_back(AsyncOperation([&]() {
+        {
+          unique_lock lock(thread_ids_mutex);
+          thread_ids.insert(std::this_thread::get_id());
+        }
+        count++;
+      }));
+    }
+
+    auto results = executor.ScheduleBatch(absl::MakeSpan(works), priority);
+    ASSERT_EQ(results.size(), kTaskCount);
+    for (const auto& result : results) {
+      EXPECT_SUCCESS(result);
+    }
+    WaitUntil([&]() { return count == kTaskCount; });
+    unique_lock lock(thread_ids_mutex);
+    EXPECT_EQ(thread_ids.size(), kThreadCount);
+  }
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, ScheduleBatchReturnsTheResultOfEachTask) {
+  constexpr int kQueueCap = 2;
+  AsyncExecutor executor(1, kQueueCap);
+  vector<AsyncOperation> works(kQueueCap + 2, AsyncOperation([]() {}));
+  for (const auto& result :
+       executor.ScheduleBatch(absl::MakeSpan(works), AsyncPriority::Normal)) {
+    EXPECT_THAT(result, ResultIs(FailureExecutionResult(
+                            errors::SC_ASYNC_EXECUTOR_NOT_RUNNING)));
+  }
+
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+  atomic<bool> blocking_task_started(false);
+  atomic<bool> blocking_task_released(false);
+  executor.Schedule(
+      [&]() {
+        blocking_task_started = true;
+        EXPECT_SUCCESS(WaitUntilOrReturn(
+            [&]() { return blocking_task_released.load(); }));
+      },
+      AsyncPriority::Normal);
+  WaitUntil([&]() { return blocking_task_started.load(); });
+
+  atomic<int> count(0);
+  works.assign(kQueueCap + 2, AsyncOperation([&]() { count++; }));
+  auto results =
+      executor.ScheduleBatch(absl::MakeSpan(works), AsyncPriority::High);
+  ASSERT_EQ(results.size(), kQueueCap + 2);
+  for (int i = 0; i < kQueueCap + 2; i++) {
+    if (i < kQueueCap) {
+      EXPECT_SUCCESS(results[i]);
+    } else {
+      EXPECT_THAT(results[i],
+                  ResultIs(RetryExecutionResult(
+                      errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP)));
+    }
+  }
+
+  blocking_task_released = true;
+  WaitUntil([&]() { return count == kQueueCap; });
+  EXPECT_SUCCESS(executor.Stop());
+  EXPECT_EQ(count, kQueueCap);
+}
+
+TEST(AsyncExecutorTests, ElasticPoolRunsBlockingTasksBeyondThreadCount) {
+  AsyncExecutorOptions options;
+  options.elastic_pool.enabled = true;
+  options.elastic_pool.max_thread_count = 3;
+  options.elastic_pool.blocked_threshold = std::chrono::milliseconds(5);
+  AsyncExecutor executor(1, 10, /*drop_tasks_on_stop=*/false,
+                         TaskLoadBalancingScheme::RoundRobinGlobal, options);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<bool> released(false);
+  atomic<int> running_count(0);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_SUCCESS(executor.Schedule(
+        [&]() {
+          running_count++;
+          WaitUntil([&]() { return released.load(); });
+        },
+        AsyncPriority::Normal));
+  }
+  vector<AsyncOperation> works;
+  works.push_back([&]() {
+    running_count++;
+    WaitUntil([&]() { return released.load(); });
+  });
+  EXPECT_SUCCESS(executor.ScheduleBatch(absl::MakeSpan(works),
+                                        AsyncPriority::High)[0]);
+  // All the blocked tasks run at once on the grown pool, and the urgent tasks
+  // still run on their own thread.
+  WaitUntil([&]() { return running_count.load() == 3; });
+  atomic<bool> urgent_task_ran(false);
+  EXPECT_SUCCESS(executor.Schedule([&]() { urgent_task_ran = true; },
+                                   AsyncPriority::Urgent));
+  WaitUntil([&]() { return urgent_task_ran.load(); });
+
+  released = true;
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, CheckAdmissionRejectsRequestsWhileOverloaded) {
+  AsyncExecutorOptions options;
+  options.admission_control.enabled = true;
+  options.admission_control.target_sojourn_time = std::chrono::milliseconds(1);
+  options.admission_control.interval = nanoseconds(0);
+  AsyncExecutor executor(1, 10, /*drop_tasks_on_stop=*/false,
+                         TaskLoadBalancingScheme::RoundRobinGlobal, options);
+  EXPECT_THAT(
+      executor.CheckAdmission(AsyncPriority::Normal),
+      ResultIs(FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING)));
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+  EXPECT_SUCCESS(executor.CheckAdmission(AsyncPriority::Normal));
+
+  // The tasks wait behind the first one long enough for the queue to be
+  // overloaded when the last one runs.
+  atomic<bool> first_task_released(false);
+  atomic<bool> last_task_running(false);
+  atomic<bool> last_task_released(false);
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() { WaitUntil([&]() { return first_task_released.load(); }); },
+      AsyncPriority::Normal));
+  EXPECT_SUCCESS(executor.Schedule([]() {}, AsyncPriority::Normal));
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        last_task_running = true;
+        WaitUntil([&]() { return last_task_released.load(); });
+      },
+      AsyncPriority::Normal));
+  sleep_for(std::chrono::milliseconds(10));
+  first_task_released = true;
+  WaitUntil([&]() { return last_task_running.load(); });
+
+  EXPECT_THAT(
+      executor.CheckAdmission(AsyncPriority::Normal),
+      ResultIs(FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_OVERLOADED)));
+  // Only new requests are rejected, not the tasks of admitted ones.
+  EXPECT_SUCCESS(executor.Schedule([]() {}, AsyncPriority::Normal));
+  EXPECT_SUCCESS(executor.CheckAdmission(AsyncPriority::High));
+  EXPECT_SUCCESS(executor.Schedule([]() {}, AsyncPriority::Urgent));
+
+  last_task_released = true;
+  WaitUntil([&]() {
+    return executor.CheckAdmission(AsyncPriority::Normal).Successful();
+  });
+  EXPECT_SUCCESS(executor.Stop());
+}
+
 class AsyncExecutorAccessor : public AsyncExecutor {
  public:
   explicit AsyncExecutorAccessor(size_t thread_count = 1)
@@ -16,9 +16,15 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <thread>
+
+#include "cc/core/async_executor/src/async_task_pool.h"
 #include "cc/core/common/time_provider/src/time_provider.h"
 
 using google::scp::core::common::TimeProvider;
+using std::make_unique;
+using std::thread;
 
 namespace google::scp::core::test {
 TEST(AsyncTaskTests, BasicTests) {
@@ -31,4 +37,48 @@ TEST(AsyncTaskTests, BasicTests) {
   AsyncTask async_task1(func, 1234);
   EXPECT_EQ(async_task1.GetExecutionTimestamp(), 1234);
 }
+
+TEST(AsyncTaskTests, CancelledTaskIsNotExecuted) {
+  int count = 0;
+  AsyncTask async_task([&]() { count++; });
+  EXPECT_FALSE(async_task.IsCancelled());
+  EXPECT_TRUE(async_task.Cancel());
+  EXPECT_FALSE(async_task.Cancel());
+  EXPECT_TRUE(async_task.IsCancelled());
+
+  async_task.Execute();
+  EXPECT_EQ(count, 0);
+}
+
+TEST(AsyncTaskTests, ExecutedTaskCannotBeCancelled) {
+  int count = 0;
+  AsyncTask async_task([&]() { count++; });
+  async_task.Execute();
+  EXPECT_EQ(count, 1);
+  EXPECT_FALSE(async_task.Cancel());
+  EXPECT_FALSE(async_task.IsCancelled());
+}
+
+TEST(AsyncTaskTests, FreedTasksAreReusedByTheSameThread) {
+  auto async_task = make_unique<AsyncTask>();
+  auto* address = async_task.get();
+  async_task.reset();
+  EXPECT_EQ(make_unique<AsyncTask>().get(), address);
+
+  // A task freed by another thread is reused by that thread.
+  async_task = make_unique<AsyncTask>();
+  address = async_task.get();
+  thread([&]() {
+    async_task.reset();
+    EXPECT_EQ(make_unique<AsyncTask>().get(), address);
+  }).join();
+}
+
+TEST(AsyncTaskTests, SharedTasksArePooled) {
+  PooledAllocator<AsyncTask> allocator;
+  auto async_task = std::allocate_shared<AsyncTask>(allocator);
+  auto* address = async_task.get();
+  async_task.reset();
+  EXPECT_EQ(std::allocate_shared<AsyncTask>(allocator).get(), address);
+}
 }  // namespace google::scp::core::test
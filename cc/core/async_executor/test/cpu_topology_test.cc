@@ -0,0 +1,145 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cc/core/async_executor/src/cpu_topology.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "cc/core/async_executor/src/error_codes.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+using std::string;
+using std::vector;
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace google::scp::core::test {
+namespace {
+
+void WriteFile(const std::filesystem::path& path, const string& content) {
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream(path) << content << "\n";
+}
+
+class CpuTopologyTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    sysfs_path_ = std::filesystem::path(testing::TempDir()) /
+                  testing::UnitTest::GetInstance()->current_test_info()->name();
+    std::filesystem::remove_all(sysfs_path_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(sysfs_path_); }
+
+  // Two nodes with a package of four cores each, with two hyperthreads per
+  // core. The first hyperthreads are numbered before the second ones.
+  void WriteTwoNodeTopology() {
+    WriteFile(sysfs_path_ / "cpu" / "online", "0-15");
+    for (size_t cpu = 0; cpu < 16; ++cpu) {
+      auto topology_path =
+          sysfs_path_ / "cpu" / ("cpu" + std::to_string(cpu)) / "topology";
+      WriteFile(topology_path / "core_id", std::to_string(cpu % 4));
+      WriteFile(topology_path / "physical_package_id",
+                std::to_string((cpu / 4) % 2));
+    }
+    WriteFile(sysfs_path_ / "node" / "node0" / "cpulist", "0-3,8-11");
+    WriteFile(sysfs_path_ / "node" / "node1" / "cpulist", "4-7,12-15");
+  }
+
+  std::filesystem::path sysfs_path_;
+};
+
+}  // namespace
+
+TEST(CpuTopologyParseTest, ParsesCpuLists) {
+  EXPECT_THAT(CpuTopology::ParseCpuList("0-3,8,10-11\n"),
+              IsSuccessfulAndHolds(ElementsAre(0, 1, 2, 3, 8, 10, 11)));
+  EXPECT_THAT(CpuTopology::ParseCpuList(""), IsSuccessfulAndHolds(IsEmpty()));
+  for (auto cpu_list : {"a", "3-1", "1-2-3", "1,-2"}) {
+    EXPECT_THAT(CpuTopology::ParseCpuList(cpu_list).result(),
+                ResultIs(FailureExecutionResult(
+                    errors::SC_ASYNC_EXECUTOR_INVALID_CPU_TOPOLOGY)));
+  }
+}
+
+TEST_F(CpuTopologyTest, LoadsCoresPackagesAndNodes) {
+  WriteTwoNodeTopology();
+  auto topology = CpuTopology::Load(sysfs_path_.string());
+  ASSERT_SUCCESS(topology.result());
+
+  vector<size_t> cpus;
+  for (const auto& cpu : topology->cpus()) {
+    EXPECT_EQ(cpu.node, cpu.package);
+    cpus.push_back(cpu.cpu);
+  }
+  // The hyperthreads of each core are next to each other.
+  EXPECT_THAT(cpus, ElementsAre(0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14,
+                                7, 15));
+}
+
+TEST_F(CpuTopologyTest, LoadsWithoutTopologyOrNodes) {
+  WriteFile(sysfs_path_ / "cpu" / "online", "0-2");
+  auto topology = CpuTopology::Load(sysfs_path_.string());
+  ASSERT_SUCCESS(topology.result());
+  ASSERT_EQ(topology->cpus().size(), 3);
+  for (const auto& cpu : topology->cpus()) {
+    EXPECT_EQ(cpu.core, cpu.cpu);
+    EXPECT_EQ(cpu.package, 0);
+    EXPECT_EQ(cpu.node, 0);
+  }
+
+  EXPECT_THAT(CpuTopology::Load((sysfs_path_ / "missing").string()).result(),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_INVALID_CPU_TOPOLOGY)));
+}
+
+TEST_F(CpuTopologyTest, PartitionsCoresInProportionToWeights) {
+  WriteTwoNodeTopology();
+  auto topology = CpuTopology::Load(sysfs_path_.string());
+  ASSERT_SUCCESS(topology.result());
+
+  auto partitions = topology->Partition({1, 2, 1, 0});
+  ASSERT_EQ(partitions.size(), 4);
+  EXPECT_THAT(partitions[0], ElementsAre(0, 8, 1, 9));
+  EXPECT_THAT(partitions[1], ElementsAre(2, 10, 3, 11, 4, 12, 5, 13));
+  EXPECT_THAT(partitions[2], ElementsAre(6, 14, 7, 15));
+  EXPECT_THAT(partitions[3], IsEmpty());
+
+  // Every partition gets a core, even with a small weight.
+  partitions = topology->Partition({100, 1});
+  EXPECT_EQ(partitions[0].size(), 14);
+  EXPECT_THAT(partitions[1], ElementsAre(7, 15));
+
+  // The rounding leftovers are given out so that all the cores are used.
+  partitions = topology->Partition({1, 1, 1});
+  EXPECT_EQ(partitions[0].size() + partitions[1].size() + partitions[2].size(),
+            16);
+}
+
+TEST(CpuTopologyPartitionTest, SharesAllCpusWhenThereAreTooFewCores) {
+  CpuTopology topology({{.cpu = 0, .core = 0, .package = 0, .node = 0},
+                        {.cpu = 1, .core = 0, .package = 0, .node = 0}});
+  auto partitions = topology.Partition({1, 1, 0});
+  EXPECT_THAT(partitions[0], ElementsAre(0, 1));
+  EXPECT_THAT(partitions[1], ElementsAre(0, 1));
+  EXPECT_THAT(partitions[2], IsEmpty());
+}
+
+}  // namespace google::scp::core::test
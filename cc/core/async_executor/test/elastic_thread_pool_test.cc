@@ -0,0 +1,143 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cc/core/async_executor/src/elastic_thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "cc/core/async_executor/src/error_codes.h"
+#include "cc/core/test/utils/conditional_wait.h"
+#include "cc/public/core/interface/execution_result.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+using std::atomic;
+using std::chrono::milliseconds;
+
+namespace google::scp::core::test {
+namespace {
+ElasticThreadPoolOptions FastOptions(size_t max_thread_count) {
+  ElasticThreadPoolOptions options;
+  options.enabled = true;
+  options.max_thread_count = max_thread_count;
+  options.blocked_threshold = milliseconds(5);
+  options.idle_timeout = milliseconds(50);
+  return options;
+}
+}  // namespace
+
+TEST(ElasticThreadPoolTest, CannotRunBeforeInit) {
+  ElasticThreadPool pool(1, 10, /*drop_tasks_on_stop=*/false, FastOptions(2));
+  EXPECT_THAT(pool.Run(), ResultIs(FailureExecutionResult(
+                              errors::SC_ASYNC_EXECUTOR_NOT_INITIALIZED)));
+  EXPECT_THAT(pool.Schedule([]() {}, AsyncPriority::Normal),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_NOT_RUNNING)));
+}
+
+TEST(ElasticThreadPoolTest, GrowsWhileBlockedAndShrinksWhenIdle) {
+  ElasticThreadPool pool(1, 100, /*drop_tasks_on_stop=*/false,
+                         FastOptions(4));
+  EXPECT_SUCCESS(pool.Init());
+  EXPECT_SUCCESS(pool.Run());
+  WaitUntil([&]() { return pool.GetThreadCount() == 1; });
+
+  // Each task blocks its thread, so the pool grows up to its maximum to run
+  // the waiting ones.
+  atomic<bool> released = false;
+  atomic<int> running_count = 0;
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_SUCCESS(pool.Schedule(
+        [&]() {
+          running_count++;
+          WaitUntil([&]() { return released.load(); });
+        },
+        AsyncPriority::Normal));
+  }
+  WaitUntil([&]() { return running_count.load() == 4; });
+  EXPECT_EQ(pool.GetThreadCount(), 4);
+  EXPECT_EQ(pool.GetQueueSize(), 2);
+
+  released = true;
+  WaitUntil([&]() { return running_count.load() == 6; });
+  WaitUntil([&]() { return pool.GetThreadCount() == 1; });
+  EXPECT_SUCCESS(pool.Stop());
+}
+
+TEST(ElasticThreadPoolTest, DoesNotGrowForShortTasks) {
+  ElasticThreadPool pool(2, 1000, /*drop_tasks_on_stop=*/false,
+                         FastOptions(8));
+  EXPECT_SUCCESS(pool.Init());
+  EXPECT_SUCCESS(pool.Run());
+
+  atomic<int> count = 0;
+  for (int i = 0; i < 500; ++i) {
+    EXPECT_SUCCESS(pool.Schedule([&]() { count++; }, AsyncPriority::Normal));
+  }
+  WaitUntil([&]() { return count.load() == 500; });
+  EXPECT_EQ(pool.GetThreadCount(), 2);
+  EXPECT_SUCCESS(pool.Stop());
+}
+
+TEST(ElasticThreadPoolTest, RejectsTasksBeyondTheQueueCap) {
+  ElasticThreadPool pool(1, 1, /*drop_tasks_on_stop=*/false, FastOptions(1));
+  EXPECT_SUCCESS(pool.Init());
+  EXPECT_SUCCESS(pool.Run());
+
+  atomic<bool> running = false;
+  atomic<bool> released = false;
+  EXPECT_SUCCESS(pool.Schedule(
+      [&]() {
+        running = true;
+        WaitUntil([&]() { return released.load(); });
+      },
+      AsyncPriority::Normal));
+  WaitUntil([&]() { return running.load(); });
+  EXPECT_SUCCESS(pool.Schedule([]() {}, AsyncPriority::Normal));
+  EXPECT_THAT(pool.Schedule([]() {}, AsyncPriority::Normal),
+              ResultIs(RetryExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP)));
+  // Each priority has its own queue.
+  EXPECT_SUCCESS(pool.Schedule([]() {}, AsyncPriority::High));
+  EXPECT_THAT(pool.Schedule([]() {}, AsyncPriority::Urgent),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_INVALID_PRIORITY_TYPE)));
+
+  released = true;
+  EXPECT_SUCCESS(pool.Stop());
+}
+
+TEST(ElasticThreadPoolTest, StopRunsThePendingTasks) {
+  ElasticThreadPool pool(1, 100, /*drop_tasks_on_stop=*/false,
+                         FastOptions(1));
+  EXPECT_SUCCESS(pool.Init());
+  EXPECT_SUCCESS(pool.Run());
+
+  atomic<int> count = 0;
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_SUCCESS(pool.Schedule(
+        [&]() {
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+          count++;
+        },
+        AsyncPriority::High));
+  }
+  EXPECT_SUCCESS(pool.Stop());
+  EXPECT_EQ(count.load(), 50);
+  EXPECT_EQ(pool.GetThreadCount(), 0);
+}
+}  // namespace google::scp::core::test
@@ -38,6 +38,7 @@ using std::make_shared;
 using std::string;
 using std::chrono::duration_cast;
 using std::chrono::high_resolution_clock;
+using std::chrono::milliseconds;
 using std::chrono::nanoseconds;
 using std::chrono::seconds;
 using testing::Values;
@@ -137,6 +138,87 @@ TEST(SingleThreadAsyncExecutorTests, ExceedingQueueCapSchedule) {
   executor.Stop();
 }
 
+TEST(SingleThreadAsyncExecutorTests,
+     TracksOverloadWithoutRejectingNormalPriorityTasks) {
+  AdmissionControlOptions admission_control_options;
+  admission_control_options.enabled = true;
+  admission_control_options.target_sojourn_time = milliseconds(1);
+  admission_control_options.interval = nanoseconds(0);
+  SingleThreadAsyncExecutor executor(10, /*drop_tasks_on_stop=*/false,
+                                     std::nullopt, admission_control_options);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  // The tasks wait behind the first one long enough for the queue to be
+  // overloaded when the last one runs.
+  atomic<bool> first_task_released = false;
+  atomic<bool> last_task_running = false;
+  atomic<bool> last_task_released = false;
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() { WaitUntil([&]() { return first_task_released.load(); }); },
+      AsyncPriority::Normal));
+  EXPECT_SUCCESS(executor.Schedule([]() {}, AsyncPriority::Normal));
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        last_task_running = true;
+        WaitUntil([&]() { return last_task_released.load(); });
+      },
+      AsyncPriority::Normal));
+  std::this_thread::sleep_for(milliseconds(10));
+  first_task_released = true;
+  WaitUntil([&]() { return last_task_running.load(); });
+
+  EXPECT_TRUE(executor.IsOverloaded());
+  EXPECT_GE(executor.GetLastSojournTime(), 1000000);
+  // The follow-up tasks of the admitted requests are still run.
+  EXPECT_SUCCESS(executor.Schedule([]() {}, AsyncPriority::Normal));
+  EXPECT_SUCCESS(executor.Schedule([]() {}, AsyncPriority::High));
+
+  // The overload ends once the queue is drained.
+  last_task_released = true;
+  WaitUntil([&]() { return !executor.IsOverloaded(); });
+  EXPECT_SUCCESS(executor.Schedule([]() {}, AsyncPriority::Normal));
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(SingleThreadAsyncExecutorTests, RecordsTaskStatsPerPriority) {
+  SingleThreadAsyncExecutor executor(10);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  // The tasks queued behind the first one wait for it.
+  atomic<bool> first_task_running = false;
+  atomic<bool> first_task_released = false;
+  atomic<int> count = 0;
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        first_task_running = true;
+        WaitUntil([&]() { return first_task_released.load(); });
+        count++;
+      },
+      AsyncPriority::Normal));
+  WaitUntil([&]() { return first_task_running.load(); });
+  EXPECT_SUCCESS(executor.Schedule([&]() { count++; }, AsyncPriority::Normal));
+  EXPECT_SUCCESS(executor.Schedule([&]() { count++; }, AsyncPriority::High));
+  std::this_thread::sleep_for(milliseconds(5));
+  first_task_released = true;
+  WaitUntil([&]() { return count.load() == 3; });
+  EXPECT_SUCCESS(executor.Stop());
+
+  LogLinearHistogramSnapshot run_time;
+  executor.GetTaskStats(AsyncPriority::Normal).run_time.AddTo(run_time);
+  EXPECT_EQ(run_time.GetCount(), 2);
+  EXPECT_GE(run_time.GetValueAtQuantile(1), 4000000);
+  LogLinearHistogramSnapshot queue_wait_time;
+  executor.GetTaskStats(AsyncPriority::High)
+      .queue_wait_time.AddTo(queue_wait_time);
+  EXPECT_EQ(queue_wait_time.GetCount(), 1);
+  EXPECT_GE(queue_wait_time.GetValueAtQuantile(1), 4000000);
+  LogLinearHistogramSnapshot queue_depth;
+  executor.GetTaskStats(AsyncPriority::Normal).queue_depth.AddTo(queue_depth);
+  EXPECT_EQ(queue_depth.GetValueAtQuantile(0), 0);
+}
+
 TEST(SingleThreadAsyncExecutorTests, CountWorkSingleThread) {
   int queue_cap = 10;
   SingleThreadAsyncExecutor executor(queue_cap);
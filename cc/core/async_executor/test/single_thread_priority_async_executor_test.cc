@@ -308,4 +308,58 @@ TEST(SingleThreadPriorityAsyncExecutorTests,
   EXPECT_SUCCESS(executor.Stop());
 }
 
+TEST(SingleThreadPriorityAsyncExecutorTests,
+     CancelledTasksDoNotCountTowardsQueueCap) {
+  int queue_cap = 2;
+  SingleThreadPriorityAsyncExecutor executor(queue_cap);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  auto far_ahead_timestamp =
+      (TimeProvider::GetSteadyTimestampInNanoseconds() + hours(24)).count();
+  for (int i = 0; i < 10 * queue_cap; i++) {
+    function<bool()> cancellation_callback;
+    EXPECT_SUCCESS(executor.ScheduleFor([&]() { EXPECT_EQ(true, false); },
+                                        far_ahead_timestamp,
+                                        cancellation_callback));
+    EXPECT_EQ(cancellation_callback(), true);
+    EXPECT_EQ(cancellation_callback(), false);
+  }
+
+  // Tasks for now still run while tasks for later are pending.
+  atomic<int> count(0);
+  function<bool()> cancellation_callback;
+  EXPECT_SUCCESS(executor.ScheduleFor([&]() { EXPECT_EQ(true, false); },
+                                      far_ahead_timestamp,
+                                      cancellation_callback));
+  EXPECT_SUCCESS(executor.ScheduleFor(
+      [&]() { count++; },
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks()));
+  WaitUntil([&]() { return count.load() == 1; });
+  EXPECT_EQ(cancellation_callback(), true);
+
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(SingleThreadPriorityAsyncExecutorTests, RecordsTaskStats) {
+  SingleThreadPriorityAsyncExecutor executor(10);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> count(0);
+  auto now = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  EXPECT_SUCCESS(executor.ScheduleFor([&]() { count++; }, now));
+  EXPECT_SUCCESS(executor.ScheduleFor(
+      [&]() { count++; }, now + milliseconds(5) / nanoseconds(1)));
+  WaitUntil([&]() { return count.load() == 2; });
+  EXPECT_SUCCESS(executor.Stop());
+
+  LogLinearHistogramSnapshot queue_wait_time;
+  executor.GetTaskStats().queue_wait_time.AddTo(queue_wait_time);
+  EXPECT_EQ(queue_wait_time.GetCount(), 2);
+  LogLinearHistogramSnapshot run_time;
+  executor.GetTaskStats().run_time.AddTo(run_time);
+  EXPECT_EQ(run_time.GetCount(), 2);
+}
+
 }  // namespace google::scp::core::test
@@ -0,0 +1,104 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cc/core/async_executor/src/task_stats.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+namespace google::scp::core::test {
+namespace {
+LogLinearHistogramSnapshot Snapshot(const LogLinearHistogram& histogram) {
+  LogLinearHistogramSnapshot snapshot;
+  histogram.AddTo(snapshot);
+  return snapshot;
+}
+}  // namespace
+
+TEST(LogLinearHistogramTest, BucketsKeepTheRelativeError) {
+  constexpr double kMaxRelativeError =
+      1.0 / LogLinearHistogramSnapshot::kSubBucketCount;
+  for (uint64_t value = 0;
+       value < 2 * LogLinearHistogramSnapshot::kSubBucketCount; ++value) {
+    EXPECT_EQ(LogLinearHistogramSnapshot::GetBucketValue(
+                  LogLinearHistogramSnapshot::GetBucketIndex(value)),
+              value);
+  }
+  size_t previous_index = 0;
+  for (uint64_t value = 20; value <= LogLinearHistogramSnapshot::kMaxValue;
+       value += value / 7) {
+    size_t index = LogLinearHistogramSnapshot::GetBucketIndex(value);
+    EXPECT_GE(index, previous_index);
+    EXPECT_LT(index, LogLinearHistogramSnapshot::kBucketCount);
+    auto bucket_value = LogLinearHistogramSnapshot::GetBucketValue(index);
+    EXPECT_LE(static_cast<double>(bucket_value > value ? bucket_value - value
+                                                       : value - bucket_value),
+              kMaxRelativeError * static_cast<double>(value))
+        << value;
+    previous_index = index;
+  }
+  EXPECT_EQ(LogLinearHistogramSnapshot::GetBucketIndex(UINT64_MAX),
+            LogLinearHistogramSnapshot::kBucketCount - 1);
+}
+
+TEST(LogLinearHistogramTest, ReturnsTheQuantiles) {
+  LogLinearHistogram histogram;
+  EXPECT_EQ(Snapshot(histogram).GetValueAtQuantile(0.5), 0);
+
+  for (uint64_t value = 1; value <= 1000; ++value) {
+    histogram.Record(value);
+  }
+  auto snapshot = Snapshot(histogram);
+  EXPECT_EQ(snapshot.GetCount(), 1000);
+  EXPECT_NEAR(snapshot.GetValueAtQuantile(0.5), 500, 500 / 8);
+  EXPECT_NEAR(snapshot.GetValueAtQuantile(0.99), 990, 990 / 8);
+  EXPECT_EQ(snapshot.GetValueAtQuantile(0), 1);
+}
+
+TEST(LogLinearHistogramTest, SnapshotsAreMergedAndSubtracted) {
+  LogLinearHistogram first_histogram;
+  LogLinearHistogram second_histogram;
+  first_histogram.Record(10);
+  second_histogram.Record(10);
+  LogLinearHistogramSnapshot earlier;
+  first_histogram.AddTo(earlier);
+  second_histogram.AddTo(earlier);
+  EXPECT_EQ(earlier.GetCount(), 2);
+
+  second_histogram.Record(1000000);
+  LogLinearHistogramSnapshot later = Snapshot(first_histogram);
+  later.Add(Snapshot(second_histogram));
+  later.Subtract(earlier);
+  EXPECT_EQ(later.GetCount(), 1);
+  EXPECT_NEAR(later.GetValueAtQuantile(0.5), 1000000, 1000000 / 8);
+}
+
+TEST(TaskStatsTest, RecordsTheTask) {
+  TaskStats task_stats;
+  task_stats.RecordTask(/*due_timestamp=*/100, /*dequeue_timestamp=*/110,
+                        /*end_timestamp=*/115, /*depth=*/3);
+  // A task dequeued before it was due did not wait.
+  task_stats.RecordTask(/*due_timestamp=*/200, /*dequeue_timestamp=*/150,
+                        /*end_timestamp=*/151, /*depth=*/0);
+
+  auto queue_wait_time = Snapshot(task_stats.queue_wait_time);
+  EXPECT_EQ(queue_wait_time.GetValueAtQuantile(0.5), 0);
+  EXPECT_EQ(queue_wait_time.GetValueAtQuantile(1), 10);
+  auto run_time = Snapshot(task_stats.run_time);
+  EXPECT_EQ(run_time.GetValueAtQuantile(0.5), 1);
+  EXPECT_EQ(run_time.GetValueAtQuantile(1), 5);
+  EXPECT_EQ(Snapshot(task_stats.queue_depth).GetValueAtQuantile(1), 3);
+}
+}  // namespace google::scp::core::test
@@ -0,0 +1,175 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cc/core/async_executor/src/timer_wheel.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "cc/core/async_executor/src/async_task.h"
+
+using std::make_shared;
+using std::mt19937_64;
+using std::shared_ptr;
+using std::uniform_int_distribution;
+using std::vector;
+using std::chrono::hours;
+using std::chrono::nanoseconds;
+
+namespace google::scp::core::test {
+namespace {
+
+constexpr Timestamp kTick = Timestamp{1} << TimerWheel::kTickShift;
+constexpr Timestamp kStartTimestamp = 12345 * kTick + 678;
+
+shared_ptr<AsyncTask> MakeTask(Timestamp timestamp) {
+  return make_shared<AsyncTask>([]() {}, timestamp);
+}
+
+}  // namespace
+
+TEST(TimerWheelTest, ExpiresTaskOnceItsTickIsOver) {
+  TimerWheel timer_wheel(kStartTimestamp);
+  auto task = MakeTask(kStartTimestamp + 5 * kTick);
+  timer_wheel.Insert(task);
+  EXPECT_EQ(timer_wheel.Size(), 1);
+
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  timer_wheel.PopExpired(task->GetExecutionTimestamp(), expired_tasks);
+  EXPECT_TRUE(expired_tasks.empty());
+  EXPECT_GT(timer_wheel.NextUpdateTimestamp(), task->GetExecutionTimestamp());
+  EXPECT_LE(timer_wheel.NextUpdateTimestamp(),
+            task->GetExecutionTimestamp() + kTick);
+
+  timer_wheel.PopExpired(timer_wheel.NextUpdateTimestamp(), expired_tasks);
+  ASSERT_EQ(expired_tasks.size(), 1);
+  EXPECT_EQ(expired_tasks[0], task);
+  EXPECT_EQ(timer_wheel.Size(), 0);
+  EXPECT_EQ(timer_wheel.NextUpdateTimestamp(), UINT64_MAX);
+}
+
+TEST(TimerWheelTest, ExpiresPastTasksOnNextTick) {
+  TimerWheel timer_wheel(kStartTimestamp);
+  timer_wheel.Insert(MakeTask(0));
+  timer_wheel.Insert(MakeTask(kStartTimestamp - kTick));
+
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  timer_wheel.PopExpired(kStartTimestamp + kTick, expired_tasks);
+  ASSERT_EQ(expired_tasks.size(), 2);
+  EXPECT_EQ(expired_tasks[0]->GetExecutionTimestamp(), 0);
+}
+
+TEST(TimerWheelTest, ExpiresTasksOfAllLevelsInOrderWithinATick) {
+  TimerWheel timer_wheel(kStartTimestamp);
+  mt19937_64 random(42);
+  uniform_int_distribution<Timestamp> delay(
+      0, nanoseconds(hours(24 * 365)).count());
+  constexpr size_t kTaskCount = 10000;
+  for (size_t i = 0; i < kTaskCount; ++i) {
+    // Mixes delays of all magnitudes.
+    timer_wheel.Insert(
+        MakeTask(kStartTimestamp + (delay(random) >> (random() % 64))));
+  }
+
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  size_t expired_task_count = 0;
+  Timestamp previous_timestamp = 0;
+  while (timer_wheel.Size() > 0) {
+    auto current_timestamp = timer_wheel.NextUpdateTimestamp();
+    ASSERT_NE(current_timestamp, UINT64_MAX);
+    timer_wheel.PopExpired(current_timestamp, expired_tasks);
+    for (const auto& task : expired_tasks) {
+      EXPECT_LT(task->GetExecutionTimestamp(), current_timestamp);
+      EXPECT_GE(task->GetExecutionTimestamp() + kTick, current_timestamp);
+      EXPECT_GE(task->GetExecutionTimestamp(), previous_timestamp);
+      previous_timestamp = task->GetExecutionTimestamp();
+    }
+    expired_task_count += expired_tasks.size();
+    expired_tasks.clear();
+  }
+  EXPECT_EQ(expired_task_count, kTaskCount);
+}
+
+TEST(TimerWheelTest, ExpiresDueTasksWhenPolledAtAnyTime) {
+  TimerWheel timer_wheel(kStartTimestamp);
+  mt19937_64 random(42);
+  uniform_int_distribution<Timestamp> delay(0, 100000 * kTick);
+  uniform_int_distribution<Timestamp> poll_interval(0, 3000 * kTick);
+  constexpr size_t kTaskCount = 10000;
+  for (size_t i = 0; i < kTaskCount; ++i) {
+    timer_wheel.Insert(MakeTask(kStartTimestamp + delay(random)));
+  }
+
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  size_t expired_task_count = 0;
+  auto current_timestamp = kStartTimestamp;
+  while (timer_wheel.Size() > 0) {
+    current_timestamp += poll_interval(random);
+    timer_wheel.PopExpired(current_timestamp, expired_tasks);
+    for (const auto& task : expired_tasks) {
+      EXPECT_LT(task->GetExecutionTimestamp(), current_timestamp);
+    }
+    // No due task is left behind.
+    EXPECT_GT(timer_wheel.NextUpdateTimestamp(), current_timestamp);
+    expired_task_count += expired_tasks.size();
+    expired_tasks.clear();
+  }
+  EXPECT_EQ(expired_task_count, kTaskCount);
+}
+
+TEST(TimerWheelTest, RemovesTasksRightAway) {
+  TimerWheel timer_wheel(kStartTimestamp);
+  auto far_ahead_timestamp = kStartTimestamp + nanoseconds(hours(24)).count();
+  auto handle = timer_wheel.Insert(MakeTask(far_ahead_timestamp));
+  auto other_handle = timer_wheel.Insert(MakeTask(kStartTimestamp + kTick));
+
+  EXPECT_TRUE(timer_wheel.Remove(handle));
+  EXPECT_FALSE(timer_wheel.Remove(handle));
+  EXPECT_EQ(timer_wheel.Size(), 1);
+
+  // The entry of the removed task is reused without reviving its handle.
+  timer_wheel.Insert(MakeTask(far_ahead_timestamp));
+  EXPECT_FALSE(timer_wheel.Remove(handle));
+  EXPECT_EQ(timer_wheel.Size(), 2);
+
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  timer_wheel.PopExpired(kStartTimestamp + 2 * kTick, expired_tasks);
+  EXPECT_EQ(expired_tasks.size(), 1);
+  EXPECT_FALSE(timer_wheel.Remove(other_handle));
+
+  timer_wheel.Clear();
+  EXPECT_EQ(timer_wheel.Size(), 0);
+  EXPECT_EQ(timer_wheel.NextUpdateTimestamp(), UINT64_MAX);
+}
+
+TEST(TimerWheelTest, SkipsIdleTimeAtOnce) {
+  TimerWheel timer_wheel(kStartTimestamp);
+  auto far_ahead_timestamp = kStartTimestamp + nanoseconds(hours(24)).count();
+  timer_wheel.Insert(MakeTask(far_ahead_timestamp));
+
+  // Only a few updates are needed to move the task down the levels.
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  size_t update_count = 0;
+  while (expired_tasks.empty()) {
+    timer_wheel.PopExpired(timer_wheel.NextUpdateTimestamp(), expired_tasks);
+    update_count++;
+  }
+  EXPECT_LE(update_count, TimerWheel::kLevelCount);
+}
+
+}  // namespace google::scp::core::test
@@ -0,0 +1,150 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cc/core/async_executor/src/work_stealing_deque.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using std::atomic;
+using std::make_unique;
+using std::thread;
+using std::vector;
+
+namespace google::scp::core::test {
+namespace {
+
+/// Counts its live instances.
+struct CountedElement {
+  explicit CountedElement(atomic<int>& live_count) : live_count(live_count) {
+    live_count++;
+  }
+
+  ~CountedElement() { live_count--; }
+
+  atomic<int>& live_count;
+};
+
+}  // namespace
+
+TEST(WorkStealingDequeTest, PopsInLifoOrder) {
+  WorkStealingDeque<int> deque(4);
+  for (int i = 0; i < 3; i++) {
+    auto element = make_unique<int>(i);
+    EXPECT_TRUE(deque.Push(element));
+  }
+  EXPECT_EQ(deque.Size(), 3);
+
+  for (int i = 2; i >= 0; i--) {
+    auto element = deque.Pop();
+    ASSERT_NE(element, nullptr);
+    EXPECT_EQ(*element, i);
+  }
+  EXPECT_EQ(deque.Pop(), nullptr);
+  EXPECT_EQ(deque.Size(), 0);
+}
+
+TEST(WorkStealingDequeTest, StealsInFifoOrder) {
+  WorkStealingDeque<int> deque(4);
+  for (int i = 0; i < 3; i++) {
+    auto element = make_unique<int>(i);
+    EXPECT_TRUE(deque.Push(element));
+  }
+
+  for (int i = 0; i < 3; i++) {
+    auto element = deque.Steal();
+    ASSERT_NE(element, nullptr);
+    EXPECT_EQ(*element, i);
+  }
+  EXPECT_EQ(deque.Steal(), nullptr);
+}
+
+TEST(WorkStealingDequeTest, CannotPushWhenFull) {
+  WorkStealingDeque<int> deque(3);
+  for (int i = 0; i < 4; i++) {
+    auto element = make_unique<int>(i);
+    EXPECT_TRUE(deque.Push(element));
+  }
+
+  auto element = make_unique<int>(4);
+  EXPECT_FALSE(deque.Push(element));
+  ASSERT_NE(element, nullptr);
+  EXPECT_EQ(*element, 4);
+
+  EXPECT_EQ(*deque.Steal(), 0);
+  EXPECT_TRUE(deque.Push(element));
+  EXPECT_EQ(*deque.Pop(), 4);
+}
+
+TEST(WorkStealingDequeTest, DeletesRemainingElementsOnDestruction) {
+  atomic<int> live_count(0);
+  {
+    WorkStealingDeque<CountedElement> deque(4);
+    for (int i = 0; i < 3; i++) {
+      auto element = make_unique<CountedElement>(live_count);
+      EXPECT_TRUE(deque.Push(element));
+    }
+    EXPECT_EQ(live_count, 3);
+  }
+  EXPECT_EQ(live_count, 0);
+}
+
+TEST(WorkStealingDequeTest, ConcurrentPopAndStealTakeEachElementOnce) {
+  constexpr int kElementCount = 100000;
+  constexpr int kStealerCount = 3;
+  WorkStealingDeque<int> deque(64);
+  vector<atomic<int>> taken_counts(kElementCount);
+  atomic<bool> done_pushing(false);
+
+  vector<thread> stealers;
+  for (int i = 0; i < kStealerCount; i++) {
+    stealers.emplace_back([&]() {
+      while (!done_pushing || deque.Size() > 0) {
+        if (auto element = deque.Steal()) {
+          taken_counts[*element]++;
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < kElementCount; i++) {
+    auto element = make_unique<int>(i);
+    while (!deque.Push(element)) {
+      if (auto popped = deque.Pop()) {
+        taken_counts[*popped]++;
+      }
+    }
+    if (i % 3 == 0) {
+      if (auto popped = deque.Pop()) {
+        taken_counts[*popped]++;
+      }
+    }
+  }
+  done_pushing = true;
+  for (auto& stealer : stealers) {
+    stealer.join();
+  }
+  while (auto popped = deque.Pop()) {
+    taken_counts[*popped]++;
+  }
+
+  for (int i = 0; i < kElementCount; i++) {
+    EXPECT_EQ(taken_counts[i], 1) << i;
+  }
+}
+}  // namespace google::scp::core::test
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "cc/public/core/interface/execution_result.h"
+#include "oneapi/tbb/concurrent_hash_map.h"
+
+#include "error_codes.h"
+
+namespace google::scp::core::common {
+/**
+ * @brief ShardedConcurrentMap has the interface of ConcurrentMap, but splits
+ * its entries across shards, each one a hash map guarded by its own mutex.
+ * The shard of a key is picked by its hash, so that the threads operating on
+ * different keys rarely contend, and no operation but Keys() touches any state
+ * shared by all the keys. Suits the maps with short lived entries, inserted
+ * and erased at a high rate by many threads.
+ *
+ * @tparam TCompare provides hash() and equal() for the keys, as for
+ * ConcurrentMap.
+ * @tparam kShardCountBits the log2 of the number of shards.
+ */
+template <class TKey, class TValue,
+          typename TCompare = oneapi::tbb::tbb_hash_compare<TKey>,
+          size_t kShardCountBits = 6>
+class ShardedConcurrentMap {
+  static_assert(kShardCountBits > 0 && kShardCountBits < 16);
+
+ public:
+  static constexpr size_t kShardCount = size_t{1} << kShardCountBits;
+
+  /// @copydoc ConcurrentMap::Insert
+  ExecutionResult Insert(std::pair<TKey, TValue> key_value, TValue& out_value) {
+    auto& shard = GetShard(key_value.first);
+    std::lock_guard lock(shard.mutex);
+    auto [it, inserted] = shard.map.insert(std::move(key_value));
+    out_value = it->second;
+    if (!inserted) {
+      return FailureExecutionResult(
+          errors::SC_CONCURRENT_MAP_ENTRY_ALREADY_EXISTS);
+    }
+    shard.size.store(shard.map.size(), std::memory_order_relaxed);
+    return SuccessExecutionResult();
+  }
+
+  /// @copydoc ConcurrentMap::Find
+  ExecutionResult Find(const TKey& key, TValue& out_value) {
+    auto& shard = GetShard(key);
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+      return FailureExecutionResult(
+          errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST);
+    }
+    out_value = it->second;
+    return SuccessExecutionResult();
+  }
+
+  /// @copydoc ConcurrentMap::Erase
+  ExecutionResult Erase(const TKey& key) {
+    // The value is destroyed outside of the lock, since it may be the last
+    // reference to an object that takes long to destroy.
+    TValue erased_value;
+    auto& shard = GetShard(key);
+    {
+      std::lock_guard lock(shard.mutex);
+      auto it = shard.map.find(key);
+      if (it == shard.map.end()) {
+        return FailureExecutionResult(
+            errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST);
+      }
+      erased_value = std::move(it->second);
+      shard.map.erase(it);
+      shard.size.store(shard.map.size(), std::memory_order_relaxed);
+    }
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Gets all the keys in the map. The shards are locked in turn, so the
+   * keys are not a snapshot of the whole map at a single instant.
+   *
+   * @param keys A vector of the keys to be filled in once looked up.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  ExecutionResult Keys(std::vector<TKey>& keys) {
+    keys.clear();
+    for (auto& shard : shards_) {
+      std::lock_guard lock(shard.mutex);
+      for (const auto& [key, value] : shard.map) {
+        keys.push_back(key);
+      }
+    }
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Returns the current size of the map, summed from the sizes of the
+   * shards without locking them.
+   *
+   * @return size_t
+   */
+  size_t Size() const {
+    size_t size = 0;
+    for (const auto& shard : shards_) {
+      size += shard.size.load(std::memory_order_relaxed);
+    }
+    return size;
+  }
+
+ private:
+  struct Hash {
+    size_t operator()(const TKey& key) const { return TCompare().hash(key); }
+  };
+
+  struct Equal {
+    bool operator()(const TKey& left, const TKey& right) const {
+      return TCompare().equal(left, right);
+    }
+  };
+
+  /// Aligned to its own cache lines, so that the shards do not false share.
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    absl::flat_hash_map<TKey, TValue, Hash, Equal> map;
+    /// The size of the map, readable without the mutex.
+    std::atomic<size_t> size = 0;
+  };
+
+  Shard& GetShard(const TKey& key) {
+    // The hash is multiplied by the golden ratio and its top bits are taken,
+    // so that the shard does not depend on the low bits the hash map relies
+    // on.
+    uint64_t hash = static_cast<uint64_t>(TCompare().hash(key));
+    return shards_[(hash * 0x9E3779B97F4A7C15ULL) >> (64 - kShardCountBits)];
+  }
+
+  std::array<Shard, kShardCount> shards_;
+};
+}  // namespace google::scp::core::common
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/common/concurrent_map/src/sharded_concurrent_map.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/test/scp_test_base.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::test::ResultIs;
+using google::scp::core::test::ScpTestBase;
+using std::make_pair;
+using std::vector;
+
+namespace google::scp::core::common::test {
+
+class ShardedConcurrentMapTests : public ScpTestBase {};
+
+TEST_F(ShardedConcurrentMapTests, InsertFindAndErase) {
+  ShardedConcurrentMap<int, int> map;
+
+  int value = 0;
+  EXPECT_SUCCESS(map.Insert(make_pair(1, 10), value));
+  EXPECT_EQ(value, 10);
+  EXPECT_THAT(map.Insert(make_pair(1, 20), value),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_MAP_ENTRY_ALREADY_EXISTS)));
+  EXPECT_EQ(value, 10);
+  EXPECT_EQ(map.Size(), 1);
+
+  value = 0;
+  EXPECT_SUCCESS(map.Find(1, value));
+  EXPECT_EQ(value, 10);
+
+  EXPECT_SUCCESS(map.Erase(1));
+  EXPECT_EQ(map.Size(), 0);
+  EXPECT_THAT(map.Find(1, value),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST)));
+  EXPECT_THAT(map.Erase(1),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST)));
+}
+
+TEST_F(ShardedConcurrentMapTests, ErasesTheValue) {
+  ShardedConcurrentMap<Uuid, std::shared_ptr<int>, UuidCompare> map;
+  auto key = Uuid::GenerateUuid();
+  auto value = std::make_shared<int>(1);
+  std::shared_ptr<int> out_value;
+  EXPECT_SUCCESS(map.Insert(make_pair(key, value), out_value));
+  EXPECT_EQ(value.use_count(), 3);
+
+  out_value.reset();
+  EXPECT_SUCCESS(map.Erase(key));
+  EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST_F(ShardedConcurrentMapTests, SpreadsTheKeysAcrossTheShards) {
+  ShardedConcurrentMap<Uuid, int, UuidCompare> map;
+  constexpr size_t kThreadCount = 8;
+  constexpr size_t kKeysPerThread = 1000;
+
+  vector<vector<Uuid>> keys_of_threads(kThreadCount);
+  for (auto& thread_keys : keys_of_threads) {
+    for (size_t i = 0; i < kKeysPerThread; ++i) {
+      thread_keys.push_back(Uuid::GenerateUuid());
+    }
+  }
+  vector<std::thread> threads;
+  for (auto& thread_keys : keys_of_threads) {
+    threads.emplace_back([&map, &thread_keys]() {
+      for (const auto& key : thread_keys) {
+        int value = 0;
+        EXPECT_SUCCESS(map.Insert(make_pair(key, 1), value));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(map.Size(), kThreadCount * kKeysPerThread);
+
+  vector<Uuid> keys;
+  EXPECT_SUCCESS(map.Keys(keys));
+  EXPECT_EQ(keys.size(), kThreadCount * kKeysPerThread);
+
+  threads.clear();
+  for (auto& thread_keys : keys_of_threads) {
+    threads.emplace_back([&map, &thread_keys]() {
+      for (const auto& key : thread_keys) {
+        EXPECT_SUCCESS(map.Erase(key));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(map.Size(), 0);
+}
+}  // namespace google::scp::core::common::test
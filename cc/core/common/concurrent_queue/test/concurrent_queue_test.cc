@@ -19,6 +19,7 @@
 #include <gtest/gtest.h>
 
 #include <atomic>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -65,6 +66,20 @@ TEST_F(ConcurrentQueueTests, ErrorOnNoElement) {
                           errors::SC_CONCURRENT_QUEUE_CANNOT_DEQUEUE)));
 }
 
+TEST_F(ConcurrentQueueTests, MoveOnlyElements) {
+  ConcurrentQueue<std::unique_ptr<int>> queue(1);
+
+  EXPECT_SUCCESS(queue.TryEnqueue(std::make_unique<int>(1)));
+  EXPECT_THAT(queue.TryEnqueue(std::make_unique<int>(2)),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_QUEUE_CANNOT_ENQUEUE)));
+
+  std::unique_ptr<int> element;
+  EXPECT_SUCCESS(queue.TryDequeue(element));
+  ASSERT_NE(element, nullptr);
+  EXPECT_EQ(*element, 1);
+}
+
 TEST_F(ConcurrentQueueTests, MultiThreadedEnqueue) {
   ConcurrentQueue<int> queue(100);
 
@@ -0,0 +1,226 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <memory>
+#include <utility>
+
+#include "cc/core/interface/async_context.h"
+#include "cc/core/interface/async_executor_interface.h"
+#include "cc/core/interface/http_client_interface.h"
+#include "cc/core/interface/http_types.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace google::scp::core {
+/**
+ * @brief Moves the awaiting coroutine to a thread of an executor. The
+ * coroutine goes on on the current thread if the executor does not take it.
+ * Returned by ScheduleOn().
+ */
+class ScheduleAwaitable {
+ public:
+  ScheduleAwaitable(AsyncExecutorInterface& executor,
+                    AsyncPriority priority) noexcept
+      : executor_(executor), priority_(priority) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  bool await_suspend(std::coroutine_handle<> handle) noexcept {
+    // The coroutine may be resumed, and this awaitable destroyed, before
+    // Schedule returns.
+    auto result =
+        executor_.Schedule([handle]() { handle.resume(); }, priority_);
+    if (!result.Successful()) {
+      result_ = result;
+      return false;
+    }
+    return true;
+  }
+
+  /// Returns the result of the scheduling.
+  ExecutionResult await_resume() const noexcept { return result_; }
+
+ private:
+  AsyncExecutorInterface& executor_;
+  const AsyncPriority priority_;
+  ExecutionResult result_ = SuccessExecutionResult();
+};
+
+/**
+ * @brief Runs an AsyncContext based operation from a coroutine, which is
+ * resumed with the result of the context once the operation finishes it.
+ * Returned by AwaitAsyncContext().
+ *
+ * The callback of the context is replaced by one which only holds a pointer to
+ * this awaitable, so that it does not allocate. The result and the response
+ * the operation finishes a copy of the context with are kept aside, and only
+ * copied back into the awaited context once the coroutine is resumed, since
+ * the operation may finish before start returns.
+ *
+ * If the operation finishes the context before it returns, the coroutine goes
+ * on on the current thread. Otherwise it is resumed on the thread finishing the
+ * context, or on the resume executor if there is one.
+ *
+ * @tparam TRequest the request type of the context.
+ * @tparam TResponse the response type of the context.
+ * @tparam Start a callable starting the operation with the context.
+ */
+template <class TRequest, class TResponse, class Start>
+class AsyncContextAwaitable {
+ public:
+  AsyncContextAwaitable(AsyncContext<TRequest, TResponse>& context,
+                        Start start,
+                        AsyncExecutorInterface* resume_executor = nullptr,
+                        AsyncPriority resume_priority =
+                            AsyncPriority::High) noexcept
+      : context_(context),
+        start_(std::move(start)),
+        resume_executor_(resume_executor),
+        resume_priority_(resume_priority) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  bool await_suspend(std::coroutine_handle<> handle) noexcept {
+    handle_ = handle;
+    context_.callback = [this](AsyncContext<TRequest, TResponse>&
+                                   finished_context) {
+      OnContextFinished(finished_context);
+    };
+    auto result = start_(context_);
+    if (!result.Successful()) {
+      // The operation does not finish the context when it fails to start.
+      context_.result = result;
+      return false;
+    }
+    // Whichever of this thread and the operation comes last resumes the
+    // coroutine.
+    return !finished_.exchange(true, std::memory_order_acq_rel);
+  }
+
+  /// Returns the result of the context.
+  ExecutionResult await_resume() noexcept {
+    if (finished_copy_) {
+      context_.result = finished_result_;
+      context_.response = std::move(finished_response_);
+    }
+    return context_.result;
+  }
+
+ private:
+  void OnContextFinished(
+      AsyncContext<TRequest, TResponse>& finished_context) noexcept {
+    // The awaited context is not written here: await_suspend may still be
+    // using it.
+    if (&finished_context != &context_) {
+      finished_result_ = finished_context.result;
+      finished_response_ = finished_context.response;
+      finished_copy_ = true;
+    }
+    if (!finished_.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+
+    auto handle = handle_;
+    if (resume_executor_ != nullptr &&
+        resume_executor_
+            ->Schedule([handle]() { handle.resume(); }, resume_priority_)
+            .Successful()) {
+      return;
+    }
+    handle.resume();
+  }
+
+  AsyncContext<TRequest, TResponse>& context_;
+  Start start_;
+  AsyncExecutorInterface* resume_executor_;
+  AsyncPriority resume_priority_;
+  std::coroutine_handle<> handle_;
+  /// The outcome of the operation when it finishes a copy of the context. Read
+  /// once the exchange of finished_ orders them before the resumption.
+  ExecutionResult finished_result_;
+  std::shared_ptr<TResponse> finished_response_;
+  bool finished_copy_ = false;
+  /// Set by the first of await_suspend and the callback to be done.
+  std::atomic<bool> finished_ = false;
+};
+
+/**
+ * @brief Moves the awaiting coroutine to a thread of the executor.
+ *
+ * @param executor the executor to resume the coroutine on.
+ * @param priority the priority of the coroutine on the executor.
+ * @return ScheduleAwaitable an awaitable of the result of the scheduling.
+ */
+inline ScheduleAwaitable ScheduleOn(
+    AsyncExecutorInterface& executor,
+    AsyncPriority priority = AsyncPriority::Normal) noexcept {
+  return ScheduleAwaitable(executor, priority);
+}
+
+/**
+ * @brief Awaits an AsyncContext based operation.
+ *
+ * @param context the context of the operation. It must outlive the awaiting.
+ * @param start starts the operation with the context, and returns whether it
+ * started.
+ * @return AsyncContextAwaitable an awaitable of the result of the context.
+ */
+template <class TRequest, class TResponse, class Start>
+AsyncContextAwaitable<TRequest, TResponse, Start> AwaitAsyncContext(
+    AsyncContext<TRequest, TResponse>& context, Start start) noexcept {
+  return AsyncContextAwaitable<TRequest, TResponse, Start>(context,
+                                                           std::move(start));
+}
+
+/**
+ * @brief Awaits an AsyncContext based operation, and resumes the coroutine on
+ * a thread of the executor if the operation finishes the context after
+ * starting, e.g. to leave the threads of the IO executor.
+ *
+ * @param context the context of the operation. It must outlive the awaiting.
+ * @param start starts the operation with the context, and returns whether it
+ * started.
+ * @param executor the executor to resume the coroutine on.
+ * @param priority the priority of the coroutine on the executor.
+ * @return AsyncContextAwaitable an awaitable of the result of the context.
+ */
+template <class TRequest, class TResponse, class Start>
+AsyncContextAwaitable<TRequest, TResponse, Start> AwaitAsyncContext(
+    AsyncContext<TRequest, TResponse>& context, Start start,
+    AsyncExecutorInterface& executor,
+    AsyncPriority priority = AsyncPriority::High) noexcept {
+  return AsyncContextAwaitable<TRequest, TResponse, Start>(
+      context, std::move(start), &executor, priority);
+}
+
+/**
+ * @brief Awaits HttpClientInterface::PerformRequest.
+ *
+ * @param http_client the client to perform the request with.
+ * @param context the context of the request. It must outlive the awaiting.
+ * @return an awaitable of the result of the request.
+ */
+inline auto AwaitPerformRequest(
+    HttpClientInterface& http_client,
+    AsyncContext<HttpRequest, HttpResponse>& context) noexcept {
+  return AwaitAsyncContext(
+      context, [&http_client](
+                   AsyncContext<HttpRequest, HttpResponse>& request_context) {
+        return http_client.PerformRequest(request_context);
+      });
+}
+}  // namespace google::scp::core
@@ -0,0 +1,173 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace google::scp::core {
+template <class T>
+class Task;
+
+namespace internal {
+/// The part of the promise of a Task which does not depend on its value.
+class TaskPromiseBase {
+ public:
+  /// Resumes the awaiting coroutine, if any, once the task is done. A detached
+  /// task destroys itself instead.
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <class Promise>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<Promise> handle) noexcept {
+      auto continuation = handle.promise().continuation_;
+      if (handle.promise().detached_) {
+        handle.destroy();
+      }
+      return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+  /// The tasks start when they are awaited or detached.
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+
+  /// The code of this repository does not throw.
+  void unhandled_exception() const noexcept { std::terminate(); }
+
+ private:
+  template <class T>
+  friend class core::Task;
+
+  /// The coroutine awaiting the task.
+  std::coroutine_handle<> continuation_;
+  /// Whether nothing awaits the task, which then destroys itself when done.
+  bool detached_ = false;
+};
+
+template <class T>
+class TaskPromise : public TaskPromiseBase {
+ public:
+  Task<T> get_return_object() noexcept;
+
+  template <class U>
+  void return_value(U&& value) noexcept {
+    value_.emplace(std::forward<U>(value));
+  }
+
+  T TakeValue() noexcept { return std::move(*value_); }
+
+ private:
+  std::optional<T> value_;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+ public:
+  Task<void> get_return_object() noexcept;
+
+  void return_void() const noexcept {}
+
+  void TakeValue() const noexcept {}
+};
+}  // namespace internal
+
+/**
+ * @brief The result of a coroutine which runs an asynchronous operation, e.g.
+ * a chain of AsyncContext based calls written with co_await instead of
+ * callbacks.
+ *
+ * A task starts when it is awaited, and then runs on the thread of its awaiter
+ * until it suspends. Once done, it resumes its awaiter directly, without going
+ * through an executor and without any allocation. A task which nothing awaits,
+ * e.g. the one handling a request, is started with Detach().
+ *
+ * @tparam T the type of the value of the coroutine, e.g. ExecutionResult.
+ */
+template <class T = void>
+class [[nodiscard]] Task {
+ public:
+  using promise_type = internal::TaskPromise<T>;
+
+  Task(Task&& other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      if (handle_) {
+        handle_.destroy();
+      }
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+  ~Task() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  /**
+   * @brief Starts the task without awaiting it. The task destroys itself once
+   * done, so it must own everything it uses until then.
+   */
+  void Detach() && noexcept {
+    auto handle = std::exchange(handle_, nullptr);
+    handle.promise().detached_ = true;
+    handle.resume();
+  }
+
+  bool await_ready() const noexcept { return false; }
+
+  /// Starts the task, which resumes the awaiting coroutine once done.
+  std::coroutine_handle<> await_suspend(
+      std::coroutine_handle<> continuation) noexcept {
+    handle_.promise().continuation_ = continuation;
+    return handle_;
+  }
+
+  T await_resume() noexcept { return handle_.promise().TakeValue(); }
+
+ private:
+  friend promise_type;
+
+  explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+      : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+namespace internal {
+template <class T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+  return Task<void>(
+      std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+}  // namespace internal
+}  // namespace google::scp::core
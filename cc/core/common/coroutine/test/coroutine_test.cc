@@ -0,0 +1,189 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "cc/core/async_executor/src/async_executor.h"
+#include "cc/core/common/coroutine/src/awaitables.h"
+#include "cc/core/common/coroutine/src/task.h"
+#include "cc/core/interface/async_context.h"
+#include "cc/core/test/utils/conditional_wait.h"
+#include "cc/public/core/interface/execution_result.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+using std::atomic;
+using std::make_shared;
+using std::string;
+using std::thread;
+
+namespace google::scp::core::test {
+namespace {
+using StringContext = AsyncContext<string, string>;
+
+/// Finishes the context with the request repeated twice.
+ExecutionResult Repeat(StringContext context) {
+  context.response = make_shared<string>(*context.request + *context.request);
+  context.result = SuccessExecutionResult();
+  context.Finish();
+  return SuccessExecutionResult();
+}
+
+Task<ExecutionResultOr<string>> RepeatTwice(string text) {
+  StringContext context;
+  context.request = make_shared<string>(std::move(text));
+  if (auto result = co_await AwaitAsyncContext(context, Repeat);
+      !result.Successful()) {
+    co_return result;
+  }
+  context.request = context.response;
+  if (auto result = co_await AwaitAsyncContext(context, Repeat);
+      !result.Successful()) {
+    co_return result;
+  }
+  co_return *context.response;
+}
+
+Task<> RepeatTwiceAndSignal(string text, bool& done) {
+  auto repeated_text = co_await RepeatTwice(std::move(text));
+  EXPECT_THAT(repeated_text, IsSuccessfulAndHolds("abababab"));
+  done = true;
+}
+
+/// Leaves the context to be finished by the test.
+Task<> AwaitPendingContext(StringContext& pending_context,
+                           thread::id& resuming_thread_id,
+                           atomic<bool>& done) {
+  StringContext context;
+  context.request = make_shared<string>("a");
+  auto result = co_await AwaitAsyncContext(context, [&](StringContext& ctx) {
+    pending_context = ctx;
+    return SuccessExecutionResult();
+  });
+  EXPECT_THAT(result, ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+  resuming_thread_id = std::this_thread::get_id();
+  done = true;
+}
+
+/// Finishes a copy of the context on another thread before start returns.
+Task<> AwaitContextFinishedDuringStart(bool& done) {
+  StringContext context;
+  context.request = make_shared<string>("a");
+  EXPECT_SUCCESS(co_await AwaitAsyncContext(context, [](StringContext& ctx) {
+    thread finishing_thread(Repeat, ctx);
+    finishing_thread.join();
+    return SuccessExecutionResult();
+  }));
+  EXPECT_EQ(*context.response, "aa");
+  done = true;
+}
+
+Task<> FailToStart(bool& done) {
+  StringContext context;
+  auto result = co_await AwaitAsyncContext(context, [](StringContext&) {
+    return RetryExecutionResult(SC_UNKNOWN);
+  });
+  EXPECT_THAT(result, ResultIs(RetryExecutionResult(SC_UNKNOWN)));
+  done = true;
+}
+
+Task<> MoveToExecutor(AsyncExecutorInterface& executor,
+                      thread::id& executor_thread_id, atomic<bool>& done) {
+  EXPECT_SUCCESS(co_await ScheduleOn(executor, AsyncPriority::High));
+  executor_thread_id = std::this_thread::get_id();
+
+  // The task comes back to the executor once the context is finished.
+  thread finishing_thread;
+  StringContext context;
+  context.request = make_shared<string>("a");
+  EXPECT_SUCCESS(co_await AwaitAsyncContext(
+      context,
+      [&](StringContext& ctx) {
+        finishing_thread = thread(Repeat, ctx);
+        return SuccessExecutionResult();
+      },
+      executor));
+  EXPECT_EQ(*context.response, "aa");
+  EXPECT_EQ(std::this_thread::get_id(), executor_thread_id);
+  finishing_thread.join();
+  done = true;
+}
+
+Task<> FailToSchedule(AsyncExecutorInterface& executor, bool& done) {
+  EXPECT_THAT(
+      co_await ScheduleOn(executor),
+      ResultIs(FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING)));
+  done = true;
+}
+}  // namespace
+
+TEST(CoroutineTest, TasksAwaitOperationsFinishingInline) {
+  bool done = false;
+  RepeatTwiceAndSignal("ab", done).Detach();
+  // Nothing suspended, so the task ran to the end on this thread.
+  EXPECT_TRUE(done);
+}
+
+TEST(CoroutineTest, TasksAreResumedByTheThreadFinishingTheContext) {
+  StringContext pending_context;
+  thread::id resuming_thread_id;
+  atomic<bool> done = false;
+  AwaitPendingContext(pending_context, resuming_thread_id, done).Detach();
+  EXPECT_FALSE(done);
+
+  thread finishing_thread([&]() {
+    pending_context.result = FailureExecutionResult(SC_UNKNOWN);
+    pending_context.Finish();
+  });
+  WaitUntil([&]() { return done.load(); });
+  EXPECT_EQ(resuming_thread_id, finishing_thread.get_id());
+  finishing_thread.join();
+}
+
+TEST(CoroutineTest, TasksGetTheOutcomeOfContextsFinishedDuringStart) {
+  bool done = false;
+  AwaitContextFinishedDuringStart(done).Detach();
+  EXPECT_TRUE(done);
+}
+
+TEST(CoroutineTest, TasksGoOnWhenTheOperationDoesNotStart) {
+  bool done = false;
+  FailToStart(done).Detach();
+  EXPECT_TRUE(done);
+}
+
+TEST(CoroutineTest, TasksMoveToTheExecutor) {
+  AsyncExecutor executor(1, 10);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+  thread::id executor_thread_id;
+  atomic<bool> done = false;
+  MoveToExecutor(executor, executor_thread_id, done).Detach();
+
+  WaitUntil([&]() { return done.load(); });
+  EXPECT_NE(executor_thread_id, std::this_thread::get_id());
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(CoroutineTest, TasksGoOnWhenTheExecutorDoesNotTakeThem) {
+  AsyncExecutor executor(1, 10);
+  bool done = false;
+  FailToSchedule(executor, done).Detach();
+  EXPECT_TRUE(done);
+}
+}  // namespace google::scp::core::test
@@ -70,6 +70,10 @@ class MockConfigProvider : public ConfigProviderInterface {
 
   ExecutionResult Get(const ConfigKey& key,
                       std::list<std::string>& out) noexcept override {
+    if (auto it = string_list_config_map_.find(key);
+        it != string_list_config_map_.end()) {
+      out = it->second;
+    }
     return SuccessExecutionResult();
   }
 
@@ -120,11 +124,17 @@ class MockConfigProvider : public ConfigProviderInterface {
     double_config_map_[key] = value;
   }
 
+  void SetStringList(const ConfigKey& key,
+                     const std::list<std::string>& value) {
+    string_list_config_map_[key] = value;
+  }
+
  private:
   std::map<ConfigKey, std::string> string_config_map_;
   std::map<ConfigKey, size_t> size_t_config_map_;
   std::map<ConfigKey, int32_t> int32_t_config_map_;
   std::map<ConfigKey, bool> bool_config_map_;
   std::map<ConfigKey, double> double_config_map_;
+  std::map<ConfigKey, std::list<std::string>> string_list_config_map_;
 };
 }  // namespace google::scp::core::config_provider::mock
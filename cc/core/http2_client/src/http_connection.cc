@@ -53,6 +53,7 @@ using ::boost::system::error_code;
 using ::google::scp::core::common::kZeroUuid;
 using ::google::scp::core::common::ToString;
 using ::google::scp::core::common::Uuid;
+using ::google::scp::core::utils::BytesBufferGenerator;
 using ::google::scp::core::utils::GetEscapedUriWithQuery;
 using ::nghttp2::asio_http2::header_map;
 using ::nghttp2::asio_http2::client::configure_tls_context;
@@ -450,19 +451,16 @@ void HttpConnection::SendHttpRequest(
     }
   }
 
-  // TODO: handle large data, avoid copy
-  std::string body;
-  if (http_context.request->body.length > 0) {
-    body = {http_context.request->body.bytes->begin(),
-            http_context.request->body.bytes->end()};
-  }
+  // The body is streamed from its buffer into the data frames, without
+  // copying it into a string first.
+  BytesBufferGenerator body_generator(http_context.request->body);
 
   RecordClientRequestBodySize(http_context);
 
   // Erase the header if it is already present.
   headers.erase(kContentLengthHeader);
   headers.insert({std::string(kContentLengthHeader),
-                  {std::to_string(body.length()), false}});
+                  {std::to_string(body_generator.GetLength()), false}});
 
   // Erase the header if it is already present.
   headers.erase(kClientActivityIdHeader);
@@ -484,7 +482,18 @@ void HttpConnection::SendHttpRequest(
   error_code ec;
   std::chrono::time_point<std::chrono::steady_clock> submit_request_time =
       std::chrono::steady_clock::now();
-  auto http_request = session_->submit(ec, method, uri.value(), body, headers);
+  auto http_request = session_->submit(
+      ec, method, uri.value(),
+      [generator = std::move(body_generator)](
+          uint8_t* data, size_t length, uint32_t* data_flags) mutable {
+        bool is_last = false;
+        auto read_length = generator.Read(data, length, is_last);
+        if (is_last) {
+          *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+        }
+        return static_cast<ssize_t>(read_length);
+      },
+      headers);
   if (ec) {
     if (!pending_network_calls_.Erase(request_id).Successful()) {
       return;
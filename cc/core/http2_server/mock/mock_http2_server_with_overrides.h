@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "cc/core/http2_server/src/http2_server.h"
 
@@ -84,9 +85,13 @@ class MockHttp2ServerWithOverrides : public core::Http2Server {
     return resource_handlers_;
   }
 
-  common::ConcurrentMap<common::Uuid,
-                        std::shared_ptr<Http2SynchronizationContext>,
-                        common::UuidCompare>&
+  const std::vector<std::unique_ptr<Http2Route>>& GetRoutes() {
+    return routes_;
+  }
+
+  common::ShardedConcurrentMap<common::Uuid,
+                               std::shared_ptr<Http2SynchronizationContext>,
+                               common::UuidCompare>&
   GetActiveRequests() {
     return active_requests_;
   }
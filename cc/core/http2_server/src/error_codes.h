@@ -65,4 +65,9 @@ DEFINE_ERROR_CODE(SC_HTTP2_SERVER_FAILED_TO_RESOLVE_ROUTE, SC_HTTP2_SERVER,
 DEFINE_ERROR_CODE(SC_HTTP2_SERVER_FAILED_TO_ROUTE, SC_HTTP2_SERVER, 0x000B,
                   "Http2Server failed to route the request.",
                   HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(SC_HTTP2_SERVER_REQUEST_BODY_MEMORY_EXHAUSTED,
+                  SC_HTTP2_SERVER, 0x000C,
+                  "Http2Server ran out of memory for the request bodies.",
+                  HttpStatusCode::SERVICE_UNAVAILABLE)
 }  // namespace google::scp::core::errors
@@ -18,24 +18,25 @@
 
 #include <algorithm>
 #include <memory>
+#include <new>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "cc/public/core/interface/execution_result.h"
 
+#include "error_codes.h"
 #include "http2_utils.h"
 
 using google::scp::core::http2_server::Http2Utils;
 using std::bind;
-using std::copy;
 using std::make_shared;
 using std::string;
 using std::vector;
 using std::placeholders::_1;
 using std::placeholders::_2;
 
-static constexpr size_t kMaxRequestBodySize = 1 * 1024 * 1024 * 1024;  // 100MB
+static constexpr size_t kMaxRequestBodySize = 1 * 1024 * 1024 * 1024;  // 1GB
 
 namespace google::scp::core {
 
@@ -86,11 +87,44 @@ void NgHttp2Request::OnRequestBodyDataChunkReceived(
     callback(execution_result);
     return;
   }
+  // Only the received bytes are kept in the buffer, even if it was sized
+  // upfront.
+  body.bytes->resize(body.length);
+  auto execution_result = ReserveBody(body.length + length);
+  if (!execution_result.Successful()) {
+    callback(execution_result);
+    return;
+  }
   // Otherwise, copy in data.
-  copy(data, data + length, body.bytes->begin() + body.length);
+  body.bytes->insert(body.bytes->end(), data, data + length);
   body.length += length;
 }
 
+ExecutionResult NgHttp2Request::ReserveBody(size_t min_capacity) noexcept {
+  if (min_capacity <= body.bytes->capacity()) {
+    return SuccessExecutionResult();
+  }
+  // body.capacity is the content length of the request.
+  size_t capacity = std::min(
+      body.capacity, std::max(min_capacity, 2 * body.bytes->capacity()));
+  if (!body_buffer_pool_) {
+    try {
+      body.bytes->reserve(capacity);
+    } catch (const std::bad_alloc&) {
+      return FailureExecutionResult(
+          errors::SC_HTTP2_SERVER_REQUEST_BODY_MEMORY_EXHAUSTED);
+    }
+    return SuccessExecutionResult();
+  }
+
+  // The received bytes move to a larger buffer, and the previous one returns
+  // to the pool.
+  ASSIGN_OR_RETURN(auto bytes, body_buffer_pool_->Acquire(capacity));
+  bytes->assign(body.bytes->begin(), body.bytes->end());
+  body.bytes = std::move(bytes);
+  return SuccessExecutionResult();
+}
+
 ExecutionResult NgHttp2Request::UnwrapNgHttp2Request() noexcept {
   auto execution_result = ReadUri();
   if (!execution_result.Successful()) {
@@ -119,7 +153,9 @@ ExecutionResult NgHttp2Request::UnwrapNgHttp2Request() noexcept {
           core::errors::SC_HTTP2_SERVER_INVALID_HEADER);
     }
   }
-  body.bytes = make_shared<vector<Byte>>(content_length);
+  // The body buffer is only allocated as the data arrives, so that the
+  // clients not sending the body they announced do not hold any memory.
+  body.bytes = make_shared<vector<Byte>>();
   body.length = 0;
   body.capacity = content_length;
   return SuccessExecutionResult();
@@ -21,10 +21,12 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <utility>
 
 #include <nghttp2/asio_http2_server.h>
 
 #include "cc/core/common/uuid/src/uuid.h"
+#include "cc/core/http2_server/src/request_body_buffer_pool.h"
 #include "cc/core/interface/http_server_interface.h"
 
 namespace google::scp::core {
@@ -34,9 +36,17 @@ namespace google::scp::core {
  */
 class NgHttp2Request : public HttpRequest {
  public:
+  /**
+   * @param ng2_request the nghttp2 request to wrap.
+   * @param body_buffer_pool the pool of the body buffers. If null, the body
+   * is read into a buffer allocated for the request only.
+   */
   explicit NgHttp2Request(
-      const nghttp2::asio_http2::server::request& ng2_request)
-      : id(common::Uuid::GenerateUuid()), ng2_request_(ng2_request) {}
+      const nghttp2::asio_http2::server::request& ng2_request,
+      std::shared_ptr<RequestBodyBufferPool> body_buffer_pool = nullptr)
+      : id(common::Uuid::GenerateUuid()),
+        ng2_request_(ng2_request),
+        body_buffer_pool_(std::move(body_buffer_pool)) {}
 
   using RequestBodyDataReceivedCallback = std::function<void(ExecutionResult)>;
 
@@ -99,9 +109,22 @@ class NgHttp2Request : public HttpRequest {
       const uint8_t* bytes, std::size_t length,
       const RequestBodyDataReceivedCallback& callback) noexcept;
 
+  /**
+   * @brief Grows the body buffer to hold at least the given number of bytes.
+   * The buffer grows geometrically as the data arrives, up to the content
+   * length of the request, rather than being allocated upfront.
+   *
+   * @param min_capacity The number of bytes the buffer must hold.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  ExecutionResult ReserveBody(size_t min_capacity) noexcept;
+
  private:
   /// A ref to the original ng2_request.
   const nghttp2::asio_http2::server::request& ng2_request_;
+
+  /// The pool of the body buffers, if any.
+  std::shared_ptr<RequestBodyBufferPool> body_buffer_pool_;
 };
 
 }  // namespace google::scp::core
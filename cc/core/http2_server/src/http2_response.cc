@@ -22,6 +22,7 @@
 
 #include <boost/exception/diagnostic_information.hpp>
 
+#include "cc/core/utils/src/http.h"
 #include "cc/public/core/interface/execution_result.h"
 
 using nghttp2::asio_http2::header_map;
@@ -61,12 +62,20 @@ void NgHttp2Response::Send() noexcept {
     response_headers.insert({header, ng_header_val});
   }
   try {
-    ng2_response_.write_head(static_cast<int>(code), response_headers);
-    if (body.length > 0) {
-      ng2_response_.end(body.ToString());
-    } else {
-      ng2_response_.end("");
-    }
+    ng2_response_.write_head(static_cast<int>(code),
+                             std::move(response_headers));
+    // The body is streamed from its buffer into the data frames, without
+    // copying it into a string first.
+    ng2_response_.end(
+        [generator = utils::BytesBufferGenerator(body)](
+            uint8_t* data, size_t length, uint32_t* data_flags) mutable {
+          bool is_last = false;
+          auto read_length = generator.Read(data, length, is_last);
+          if (is_last) {
+            *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+          }
+          return static_cast<ssize_t>(read_length);
+        });
   } catch (const boost::exception& ex) {
     // TODO: handle this
     std::string info = boost::diagnostic_information(ex);
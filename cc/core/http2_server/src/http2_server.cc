@@ -16,6 +16,7 @@
 
 #include "cc/core/http2_server/src/http2_server.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <set>
@@ -27,6 +28,7 @@
 #include <nlohmann/json.hpp>
 
 #include "absl/strings/str_cat.h"
+#include "cc/core/async_executor/src/async_executor_utils.h"
 #include "cc/core/common/concurrent_map/src/error_codes.h"
 #include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/http2_server/src/error_codes.h"
@@ -116,6 +118,16 @@ bool UseAwsAuthorizationProxy(
   return json_token.contains(kAmzDate);
 }
 
+// Returns the value of the first request header with the given name, or null.
+const std::string* FindRequestHeader(const NgHttp2Request& request,
+                                     const char* name) {
+  if (!request.headers) {
+    return nullptr;
+  }
+  auto it = request.headers->find(name);
+  return it == request.headers->end() ? nullptr : &it->second;
+}
+
 /*
  * @brief Sets up the synchronization context by retrieving it from the active
  * requests map (or creating if it doesn't exist). It assigns the handler,
@@ -134,7 +146,7 @@ bool UseAwsAuthorizationProxy(
 ExecutionResult SetSyncContext(
     const AsyncContext<NgHttp2Request, NgHttp2Response>& http2_context,
     const HttpHandler& http_handler,
-    common::ConcurrentMap<
+    common::ShardedConcurrentMap<
         common::Uuid, std::shared_ptr<Http2Server::Http2SynchronizationContext>,
         common::UuidCompare>& active_requests,
     std::shared_ptr<Http2Server::Http2SynchronizationContext>& sync_context) {
@@ -298,13 +310,37 @@ ExecutionResult Http2Server::Run() noexcept {
     return execution_result;
   }
 
+  // The handlers cannot change while the server runs, so each path is bound
+  // to its frozen route and the requests are dispatched without locks.
   for (const auto& path : paths) {
-    // TODO: here we are binding a universal handler, and the real
-    // handler is looked up again inside it. Ideally, we can do the look up
-    // here, and pass the result to std::bind(), to save runtime cost.
-    http2_server_.handle(
-        path, std::bind(&Http2Server::OnHttp2Request, this,
-                        std::placeholders::_1, std::placeholders::_2));
+    std::shared_ptr<ConcurrentMap<HttpMethod, HttpHandler>> method_handlers;
+    RETURN_IF_FAILURE(resource_handlers_.Find(path, method_handlers));
+    std::vector<HttpMethod> methods;
+    RETURN_IF_FAILURE(method_handlers->Keys(methods));
+
+    auto route_it =
+        std::find_if(routes_.begin(), routes_.end(),
+                     [&](const auto& route) { return route->path == path; });
+    bool is_new_route = route_it == routes_.end();
+    if (is_new_route) {
+      routes_.push_back(std::make_unique<Http2Route>());
+      routes_.back()->path = path;
+    }
+    Http2Route& route = is_new_route ? *routes_.back() : **route_it;
+    for (auto method : methods) {
+      auto method_index = static_cast<size_t>(method);
+      if (method_index < route.handlers.size()) {
+        RETURN_IF_FAILURE(
+            method_handlers->Find(method, route.handlers[method_index]));
+      }
+    }
+
+    if (is_new_route) {
+      http2_server_.handle(path, [this, &route](const request& request,
+                                                const response& response) {
+        OnHttp2Request(request, response, route);
+      });
+    }
   }
 
   http2_server_.read_timeout(
@@ -328,6 +364,18 @@ ExecutionResult Http2Server::Run() noexcept {
         core::errors::SC_HTTP2_SERVER_INITIALIZATION_FAILED);
   }
 
+  // Each IO service is run by a single thread, which pins itself.
+  if (!io_thread_cpu_affinity_numbers_.empty()) {
+    const auto& io_services = http2_server_.io_services();
+    for (size_t i = 0; i < io_services.size(); ++i) {
+      auto cpu_affinity_number = io_thread_cpu_affinity_numbers_
+          [i % io_thread_cpu_affinity_numbers_.size()];
+      io_services[i]->post([cpu_affinity_number]() {
+        AsyncExecutorUtils::SetAffinity(cpu_affinity_number);
+      });
+    }
+  }
+
   return SuccessExecutionResult();
 }
 
@@ -375,12 +423,14 @@ ExecutionResult Http2Server::RegisterResourceHandler(
 }
 
 void Http2Server::OnHttp2Request(const request& request,
-                                 const response& response) noexcept {
+                                 const response& response,
+                                 Http2Route& route) noexcept {
   // Measure the entry time to track request-response latency
   std::chrono::time_point<std::chrono::steady_clock> entry_time =
       std::chrono::steady_clock::now();
   auto parent_activity_id = Uuid::GenerateUuid();
-  auto http2Request = std::make_shared<NgHttp2Request>(request);
+  auto http2Request =
+      std::make_shared<NgHttp2Request>(request, body_buffer_pool_);
   auto request_endpoint_type = RequestTargetEndpointType::Local;
 
   // This is the entry point of a Http2Request.
@@ -416,27 +466,31 @@ void Http2Server::OnHttp2Request(const request& request,
     return;
   }
 
-  // Check if path is registered
-  std::shared_ptr<ConcurrentMap<HttpMethod, HttpHandler>> resource_handler;
-  execution_result = resource_handlers_.Find(
-      http2_context.request->handler_path, resource_handler);
-  if (!execution_result.Successful()) {
-    http2_context.result = execution_result;
+  // Check if there is a handler for the specific method. The path is checked
+  // as well, since nghttp2 dispatches the subpaths of a path ending with '/'
+  // to its route.
+  auto method_index = static_cast<size_t>(http2_context.request->method);
+  if (http2_context.request->handler_path != route.path ||
+      method_index >= route.handlers.size() || !route.handlers[method_index]) {
+    http2_context.result = FailureExecutionResult(
+        errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST);
     http2_context.Finish();
     return;
   }
 
-  // Check if there is an active handler for the specific method.
-  HttpHandler http_handler;
-  execution_result =
-      resource_handler->Find(http2_context.request->method, http_handler);
+  // Rejects the request before its body is read or its authorization is
+  // checked, while the executor cannot keep up with the admitted requests.
+  execution_result = async_executor_->CheckAdmission(AsyncPriority::Normal);
   if (!execution_result.Successful()) {
+    SCP_DEBUG_CONTEXT(kHttp2Server, http2_context,
+                      "[OnHttp2Request] Rejecting the request since the "
+                      "executor is overloaded.");
     http2_context.result = execution_result;
     http2_context.Finish();
     return;
   }
 
-  return HandleHttp2Request(http2_context, http_handler);
+  return HandleHttp2Request(http2_context, route.handlers[method_index]);
 }
 
 void Http2Server::HandleHttp2Request(
@@ -672,33 +726,52 @@ void Http2Server::OnHttp2Cleanup(
   active_requests_.Erase(sync_context.http2_context.request->id);
 }
 
-absl::flat_hash_map<absl::string_view, std::string>
+std::shared_ptr<const OtelMetricLabelsCache::Labels>
 Http2Server::GetOtelMetricLabels(
     const AsyncContext<NgHttp2Request, NgHttp2Response>& http_context) {
-  absl::flat_hash_map<std::string_view, std::string> labels = {
-      {kServerAddress, host_address_},
-      {kServerPort, port_},
-      {kHttpRoute, http_context.request->handler_path},
-      {kHttpRequestMethod,
-       utils::HttpMethodToString(http_context.request->method)},
-      {kPbsClaimedIdentityLabel,
-       utils::GetClaimedIdentityOrUnknownValue(http_context)},
-      {kScpHttpRequestClientVersionLabel,
-       utils::GetUserAgentOrUnknownValue(http_context)}};
-
+  // The key holds the raw values the labels are derived from, so that a cache
+  // hit neither copies the labels nor parses the user agent.
+  const std::string* claimed_identity =
+      FindRequestHeader(*http_context.request, kClaimedIdentityHeader);
+  const std::string* user_agent =
+      FindRequestHeader(*http_context.request, kUserAgentHeader);
+  const std::string* auth_domain =
+      http_context.request->auth_context.authorized_domain.get();
+
+  std::string key;
+  OtelMetricLabelsCache::AppendToKey(&http_context.request->handler_path, key);
+  absl::StrAppend(&key, static_cast<int>(http_context.request->method), ";");
   if (http_context.response != nullptr) {
-    labels.try_emplace(
-        kHttpResponseStatusCode,
-        std::to_string(static_cast<int>(http_context.response->code)));
-  }
-
-  if (std::string* auth_domain =
-          http_context.request->auth_context.authorized_domain.get();
-      auth_domain != nullptr) {
-    labels.try_emplace(kPbsAuthDomainLabel, *auth_domain);
-  }
+    absl::StrAppend(&key, static_cast<int>(http_context.response->code));
+  }
+  key.append(";");
+  OtelMetricLabelsCache::AppendToKey(claimed_identity, key);
+  OtelMetricLabelsCache::AppendToKey(user_agent, key);
+  OtelMetricLabelsCache::AppendToKey(auth_domain, key);
+
+  return otel_metric_labels_cache_.GetOrBuild(key, [&]() {
+    OtelMetricLabelsCache::Labels labels = {
+        {kServerAddress, host_address_},
+        {kServerPort, port_},
+        {kHttpRoute, http_context.request->handler_path},
+        {kHttpRequestMethod,
+         utils::HttpMethodToString(http_context.request->method)},
+        {kPbsClaimedIdentityLabel,
+         utils::GetClaimedIdentityOrUnknownValue(http_context)},
+        {kScpHttpRequestClientVersionLabel,
+         utils::GetUserAgentOrUnknownValue(http_context)}};
+
+    if (http_context.response != nullptr) {
+      labels.try_emplace(
+          kHttpResponseStatusCode,
+          std::to_string(static_cast<int>(http_context.response->code)));
+    }
 
-  return labels;
+    if (auth_domain != nullptr) {
+      labels.try_emplace(kPbsAuthDomainLabel, *auth_domain);
+    }
+    return labels;
+  });
 }
 
 void Http2Server::RecordServerLatency(
@@ -711,11 +784,11 @@ void Http2Server::RecordServerLatency(
       std::chrono::steady_clock::now() - sync_context.entry_time;
   double latency_s = latency / std::chrono::seconds(1);
 
-  absl::flat_hash_map<absl::string_view, std::string> labels =
+  std::shared_ptr<const OtelMetricLabelsCache::Labels> labels =
       GetOtelMetricLabels(sync_context.http2_context);
 
   opentelemetry::context::Context context;
-  server_request_duration_->Record(latency_s, labels, context);
+  server_request_duration_->Record(latency_s, *labels, context);
 }
 
 void Http2Server::RecordRequestBodySize(
@@ -724,11 +797,11 @@ void Http2Server::RecordRequestBodySize(
     return;
   }
 
-  absl::flat_hash_map<absl::string_view, std::string> labels =
+  std::shared_ptr<const OtelMetricLabelsCache::Labels> labels =
       GetOtelMetricLabels(http_context);
 
   opentelemetry::context::Context context;
-  server_request_body_size_->Record(http_context.request->body.length, labels,
+  server_request_body_size_->Record(http_context.request->body.length, *labels,
                                     context);
 }
 
@@ -738,12 +811,12 @@ void Http2Server::RecordResponseBodySize(
     return;
   }
 
-  absl::flat_hash_map<absl::string_view, std::string> labels =
+  std::shared_ptr<const OtelMetricLabelsCache::Labels> labels =
       GetOtelMetricLabels(http_context);
 
   opentelemetry::context::Context context;
-  server_response_body_size_->Record(http_context.response->body.length, labels,
-                                     context);
+  server_response_body_size_->Record(http_context.response->body.length,
+                                     *labels, context);
 }
 
 void Http2Server::ObserveActiveRequestsCallback(
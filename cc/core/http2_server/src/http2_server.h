@@ -16,19 +16,24 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <memory>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <nghttp2/asio_http2_server.h>
 
 #include "cc/core/common/concurrent_map/src/concurrent_map.h"
+#include "cc/core/common/concurrent_map/src/sharded_concurrent_map.h"
 #include "cc/core/common/operation_dispatcher/src/operation_dispatcher.h"
 #include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/http2_server/src/http2_request.h"
 #include "cc/core/http2_server/src/http2_response.h"
+#include "cc/core/http2_server/src/otel_metric_labels_cache.h"
+#include "cc/core/http2_server/src/request_body_buffer_pool.h"
 #include "cc/core/interface/async_executor_interface.h"
 #include "cc/core/interface/authorization_proxy_interface.h"
 #include "cc/core/interface/config_provider_interface.h"
@@ -57,11 +62,16 @@ class Http2ServerOptions {
       common::RetryStrategyOptions retry_strategy_options =
           common::RetryStrategyOptions(common::RetryStrategyType::Exponential,
                                        kHttpServerRetryStrategyDelayInMs,
-                                       kDefaultRetryStrategyMaxRetries))
+                                       kDefaultRetryStrategyMaxRetries),
+      std::vector<size_t> io_thread_cpu_affinity_numbers = {},
+      size_t request_body_memory_budget_bytes = 0)
       : use_tls(use_tls),
         private_key_file(std::move(private_key_file)),
         certificate_chain_file(std::move(certificate_chain_file)),
-        retry_strategy_options(retry_strategy_options) {}
+        retry_strategy_options(retry_strategy_options),
+        io_thread_cpu_affinity_numbers(
+            std::move(io_thread_cpu_affinity_numbers)),
+        request_body_memory_budget_bytes(request_body_memory_budget_bytes) {}
 
   /// Whether to use TLS.
   const bool use_tls;
@@ -71,6 +81,13 @@ class Http2ServerOptions {
   const std::shared_ptr<std::string> certificate_chain_file;
   /// Retry strategy options.
   const common::RetryStrategyOptions retry_strategy_options;
+  /// The CPUs to pin the IO threads to, in turn. The IO threads are not pinned
+  /// if empty.
+  const std::vector<size_t> io_thread_cpu_affinity_numbers;
+  /// The memory the bodies of the requests in flight may take altogether. The
+  /// requests whose bodies do not fit fail with a service unavailable status.
+  /// Unbounded if 0.
+  const size_t request_body_memory_budget_bytes = 0;
 
  private:
   static constexpr TimeDuration kHttpServerRetryStrategyDelayInMs = 31;
@@ -105,6 +122,10 @@ class Http2Server : public HttpServerInterface {
         private_key_file_(*options.private_key_file),
         certificate_chain_file_(*options.certificate_chain_file),
         tls_context_(boost::asio::ssl::context::sslv23),
+        io_thread_cpu_affinity_numbers_(
+            options.io_thread_cpu_affinity_numbers),
+        body_buffer_pool_(std::make_shared<RequestBodyBufferPool>(
+            options.request_body_memory_budget_bytes)),
         metric_router_(metric_router) {}
 
   ~Http2Server();
@@ -152,6 +173,20 @@ class Http2Server : public HttpServerInterface {
     Remote,
   };
 
+  /**
+   * @brief The handlers of a registered path. The routes are frozen by Run()
+   * and bound to their paths in nghttp2, so that a request is dispatched to
+   * its handler without any lookup in a shared map.
+   */
+  struct Http2Route {
+    /// The registered path.
+    std::string path;
+    /// The handlers indexed by HttpMethod. Empty for the methods that have no
+    /// handler registered.
+    std::array<HttpHandler, static_cast<size_t>(HttpMethod::PUT) + 1>
+        handlers;
+  };
+
  protected:
   /**
    * @brief Handles the incoming nghttp2 native request and response. This is
@@ -163,10 +198,12 @@ class Http2Server : public HttpServerInterface {
    *
    * @param request The nghttp2 server request object.
    * @param response The nghttp2 server response object.
+   * @param route The route bound to the path the request was dispatched on.
    */
   virtual void OnHttp2Request(
       const nghttp2::asio_http2::server::request& request,
-      const nghttp2::asio_http2::server::response& response) noexcept;
+      const nghttp2::asio_http2::server::response& response,
+      Http2Route& route) noexcept;
 
   /**
    * @brief Is called when the http request is completed and a response needs to
@@ -260,10 +297,16 @@ class Http2Server : public HttpServerInterface {
       std::shared_ptr<common::ConcurrentMap<HttpMethod, HttpHandler>>>
       resource_handlers_;
 
-  // Registry of all the active requests.
-  common::ConcurrentMap<common::Uuid,
-                        std::shared_ptr<Http2SynchronizationContext>,
-                        common::UuidCompare>
+  // The routes frozen from the registered handlers by Run(). Only modified
+  // while the server is not running, and never shrinks since nghttp2 keeps
+  // the routes bound to their paths.
+  std::vector<std::unique_ptr<Http2Route>> routes_;
+
+  // Registry of all the active requests, sharded by request ID since the
+  // requests are inserted, looked up and erased by all the IO threads.
+  common::ShardedConcurrentMap<common::Uuid,
+                               std::shared_ptr<Http2SynchronizationContext>,
+                               common::UuidCompare>
       active_requests_;
 
   // Indicates whether the http server is running.
@@ -298,6 +341,12 @@ class Http2Server : public HttpServerInterface {
   // The TLS context of the server.
   boost::asio::ssl::context tls_context_;
 
+  // The CPUs to pin the IO threads to, in turn.
+  std::vector<size_t> io_thread_cpu_affinity_numbers_;
+
+  // The pool of the request body buffers.
+  std::shared_ptr<RequestBodyBufferPool> body_buffer_pool_;
+
  private:
   /**
    * Initializes the OpenTelemetry metrics collection system. This function
@@ -356,14 +405,15 @@ class Http2Server : public HttpServerInterface {
       Http2Server* self_ptr);
 
   /**
-   * Sets the OpenTelemetry labels
+   * Gets the OpenTelemetry labels of the request, from the cache of the label
+   * sets when they were already built for the same values.
    *
    * @param http_context The http context containing the request and response
    * objects.
    *
    * @return OpenTelemetry labels.
    */
-  absl::flat_hash_map<absl::string_view, std::string> GetOtelMetricLabels(
+  std::shared_ptr<const OtelMetricLabelsCache::Labels> GetOtelMetricLabels(
       const AsyncContext<NgHttp2Request, NgHttp2Response>& http_context);
 
   // An instance of metric router which will provide APIs to create metrics.
@@ -387,6 +437,9 @@ class Http2Server : public HttpServerInterface {
   // OpenTelemetry Instrument for measuring response body size (uncompressed).
   std::shared_ptr<opentelemetry::metrics::Histogram<uint64_t>>
       server_response_body_size_;
+
+  // The label sets shared by the recordings of the per-request metrics.
+  OtelMetricLabelsCache otel_metric_labels_cache_;
 };
 
 }  // namespace google::scp::core
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/http2_server/src/otel_metric_labels_cache.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/hash/hash.h"
+#include "absl/strings/str_cat.h"
+
+namespace google::scp::core {
+std::shared_ptr<const OtelMetricLabelsCache::Labels>
+OtelMetricLabelsCache::GetOrBuild(absl::string_view key,
+                                  absl::FunctionRef<Labels()> build_labels) {
+  Shard& shard = shards_[absl::HashOf(key) % kShardCount];
+  {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    if (auto it = shard.labels.find(key); it != shard.labels.end()) {
+      return it->second;
+    }
+  }
+
+  // The labels are built outside of the lock, so a concurrent miss on the same
+  // key may build them twice; the first inserted is kept.
+  auto labels = std::make_shared<const Labels>(build_labels());
+  absl::MutexLock lock(&shard.mutex);
+  if (auto it = shard.labels.find(key); it != shard.labels.end()) {
+    return it->second;
+  }
+  // The label sets in use are shared with their callers, so clearing a full
+  // shard only costs the next request of each of its keys a rebuild.
+  if (shard.labels.size() >= max_entries_per_shard_) {
+    shard.labels.clear();
+  }
+  shard.labels.emplace(key, labels);
+  return labels;
+}
+
+size_t OtelMetricLabelsCache::Size() const {
+  size_t size = 0;
+  for (const Shard& shard : shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    size += shard.labels.size();
+  }
+  return size;
+}
+
+void OtelMetricLabelsCache::AppendToKey(const std::string* value,
+                                        std::string& key) {
+  if (value == nullptr) {
+    key.append("-;");
+    return;
+  }
+  absl::StrAppend(&key, value->size(), ":", *value, ";");
+}
+}  // namespace google::scp::core
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace google::scp::core {
+/**
+ * @brief Interns the OpenTelemetry label sets of the per-request metrics, so
+ * that the requests sharing the same labels record them from a single map
+ * instead of building their own.
+ *
+ * The label sets are cached under a key made of the values they are built
+ * from. Since some of these values come from the request headers, the number
+ * of cached label sets is bounded: the keys are split across shards by their
+ * hash, and a shard is cleared once full, so that the new keys, e.g. of a new
+ * client version, get cached again. The shards are guarded by their own
+ * mutexes, which the hits only take for reading.
+ */
+class OtelMetricLabelsCache {
+ public:
+  using Labels = absl::flat_hash_map<absl::string_view, std::string>;
+
+  /// The default number of label sets kept.
+  static constexpr size_t kDefaultMaxEntries = 1024;
+  static constexpr size_t kShardCount = 16;
+
+  /// Keeps up to max_entries label sets, rounded up to a multiple of
+  /// kShardCount.
+  explicit OtelMetricLabelsCache(size_t max_entries = kDefaultMaxEntries)
+      : max_entries_per_shard_(std::max<size_t>(
+            1, (max_entries + kShardCount - 1) / kShardCount)) {}
+
+  /**
+   * @brief Gets the label set cached under the given key, or builds it.
+   *
+   * @param key identifies the label set. Two calls with the same key must
+   * build the same labels.
+   * @param build_labels builds the label set on a cache miss.
+   * @return std::shared_ptr<const Labels> the label set.
+   */
+  std::shared_ptr<const Labels> GetOrBuild(
+      absl::string_view key, absl::FunctionRef<Labels()> build_labels);
+
+  /// Returns the number of label sets kept. The shards are locked in turn.
+  size_t Size() const;
+
+  /**
+   * @brief Appends a value the labels are built from, or its absence, to a
+   * key. The length prefix keeps the neighbouring values from being confused.
+   *
+   * @param value the value, or null if absent.
+   * @param key the key to append to.
+   */
+  static void AppendToKey(const std::string* value, std::string& key);
+
+ private:
+  /// Aligned to its own cache lines, so that the shards do not false share.
+  struct alignas(64) Shard {
+    mutable absl::Mutex mutex;
+    absl::flat_hash_map<std::string, std::shared_ptr<const Labels>> labels
+        ABSL_GUARDED_BY(mutex);
+  };
+
+  const size_t max_entries_per_shard_;
+  std::array<Shard, kShardCount> shards_;
+};
+}  // namespace google::scp::core
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/http2_server/src/request_body_buffer_pool.h"
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "cc/core/http2_server/src/error_codes.h"
+
+namespace google::scp::core {
+namespace {
+constexpr size_t kMinPooledCapacity =
+    size_t{1} << RequestBodyBufferPool::kMinSizeClassBits;
+constexpr size_t kMaxPooledCapacity =
+    size_t{1} << RequestBodyBufferPool::kMaxSizeClassBits;
+}  // namespace
+
+ExecutionResultOr<std::shared_ptr<std::vector<Byte>>>
+RequestBodyBufferPool::Acquire(size_t min_capacity) noexcept {
+  // The capacities above the largest size class are not rounded up, since
+  // their buffers are not kept.
+  size_t capacity = min_capacity <= kMaxPooledCapacity
+                        ? std::bit_ceil(std::max(min_capacity,
+                                                 kMinPooledCapacity))
+                        : min_capacity;
+  if (!TryCharge(capacity)) {
+    return FailureExecutionResult(
+        errors::SC_HTTP2_SERVER_REQUEST_BODY_MEMORY_EXHAUSTED);
+  }
+
+  std::unique_ptr<std::vector<Byte>> buffer;
+  if (capacity <= kMaxPooledCapacity) {
+    auto& size_class = size_classes_[std::bit_width(capacity) - 1 -
+                                     kMinSizeClassBits];
+    std::lock_guard lock(size_class.mutex);
+    if (!size_class.buffers.empty()) {
+      buffer = std::move(size_class.buffers.back());
+      size_class.buffers.pop_back();
+    }
+  }
+
+  try {
+    if (!buffer) {
+      buffer = std::make_unique<std::vector<Byte>>();
+      buffer->reserve(capacity);
+    }
+  } catch (const std::bad_alloc&) {
+    bytes_in_use_.fetch_sub(capacity, std::memory_order_relaxed);
+    return FailureExecutionResult(
+        errors::SC_HTTP2_SERVER_REQUEST_BODY_MEMORY_EXHAUSTED);
+  }
+
+  try {
+    return std::shared_ptr<std::vector<Byte>>(
+        buffer.release(), [pool = shared_from_this(), capacity](
+                              std::vector<Byte>* buffer) {
+          pool->Release(buffer, capacity);
+        });
+  } catch (const std::bad_alloc&) {
+    // The buffer has already been released by the deleter.
+    return FailureExecutionResult(
+        errors::SC_HTTP2_SERVER_REQUEST_BODY_MEMORY_EXHAUSTED);
+  }
+}
+
+bool RequestBodyBufferPool::TryCharge(size_t bytes) noexcept {
+  if (memory_budget_bytes_ == 0) {
+    bytes_in_use_.fetch_add(bytes, std::memory_order_relaxed);
+    return true;
+  }
+  size_t bytes_in_use = bytes_in_use_.load(std::memory_order_relaxed);
+  do {
+    if (bytes > memory_budget_bytes_ - std::min(bytes_in_use,
+                                                memory_budget_bytes_)) {
+      return false;
+    }
+  } while (!bytes_in_use_.compare_exchange_weak(bytes_in_use,
+                                                bytes_in_use + bytes,
+                                                std::memory_order_relaxed));
+  return true;
+}
+
+void RequestBodyBufferPool::Release(std::vector<Byte>* buffer,
+                                    size_t charged_bytes) noexcept {
+  std::unique_ptr<std::vector<Byte>> owned_buffer(buffer);
+  bytes_in_use_.fetch_sub(charged_bytes, std::memory_order_relaxed);
+
+  // Only the buffers still having the capacity of their size class are kept.
+  size_t capacity = owned_buffer->capacity();
+  if (capacity < kMinPooledCapacity || capacity > kMaxPooledCapacity ||
+      !std::has_single_bit(capacity)) {
+    return;
+  }
+  owned_buffer->clear();
+  auto& size_class =
+      size_classes_[std::bit_width(capacity) - 1 - kMinSizeClassBits];
+  std::lock_guard lock(size_class.mutex);
+  if ((size_class.buffers.size() + 1) * capacity <=
+      kMaxPooledBytesPerSizeClass) {
+    try {
+      size_class.buffers.push_back(std::move(owned_buffer));
+    } catch (const std::bad_alloc&) {
+      // The buffer is freed instead.
+    }
+  }
+}
+}  // namespace google::scp::core
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cc/core/interface/type_def.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace google::scp::core {
+/**
+ * @brief Provides the buffers of the request bodies of an Http2Server, and
+ * bounds the memory they use.
+ *
+ * The buffers are reserved but not zero-initialized. Their capacities are
+ * rounded up to a power of two size class, and the released buffers of the
+ * smaller classes are kept for the next requests. All the buffers in use
+ * count against the memory budget, so that the clients sending large bodies
+ * cannot make the server run out of memory.
+ */
+class RequestBodyBufferPool
+    : public std::enable_shared_from_this<RequestBodyBufferPool> {
+ public:
+  /// The smallest size class.
+  static constexpr size_t kMinSizeClassBits = 12;
+  /// The largest size class whose released buffers are kept.
+  static constexpr size_t kMaxSizeClassBits = 20;
+  /// The bytes of the released buffers kept for each size class.
+  static constexpr size_t kMaxPooledBytesPerSizeClass = 8 * 1024 * 1024;
+
+  /**
+   * @param memory_budget_bytes the bytes the buffers in use may take
+   * altogether. Unbounded if 0.
+   */
+  explicit RequestBodyBufferPool(size_t memory_budget_bytes = 0)
+      : memory_budget_bytes_(memory_budget_bytes) {}
+
+  /**
+   * @brief Acquires an empty buffer with at least the given capacity. The
+   * buffer returns to the pool, and its bytes to the budget, once its last
+   * reference is released.
+   *
+   * @param min_capacity the capacity the buffer needs.
+   * @return ExecutionResultOr<std::shared_ptr<std::vector<Byte>>> the buffer,
+   * or SC_HTTP2_SERVER_REQUEST_BODY_MEMORY_EXHAUSTED if it would exceed the
+   * budget.
+   */
+  ExecutionResultOr<std::shared_ptr<std::vector<Byte>>> Acquire(
+      size_t min_capacity) noexcept;
+
+  /// Returns the bytes of the buffers in use.
+  size_t GetBytesInUse() const noexcept {
+    return bytes_in_use_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kSizeClassCount =
+      kMaxSizeClassBits - kMinSizeClassBits + 1;
+
+  /// The released buffers of a size class.
+  struct SizeClass {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<std::vector<Byte>>> buffers;
+  };
+
+  /// Takes the given bytes from the budget, if it has enough of them left.
+  bool TryCharge(size_t bytes) noexcept;
+
+  /// Returns the buffer to its size class, or frees it.
+  void Release(std::vector<Byte>* buffer, size_t charged_bytes) noexcept;
+
+  const size_t memory_budget_bytes_;
+  std::atomic<size_t> bytes_in_use_ = 0;
+  std::array<SizeClass, kSizeClassCount> size_classes_;
+};
+}  // namespace google::scp::core
@@ -169,6 +169,47 @@ TEST_F(Http2ServerTest, RegisterHandlers) {
           errors::SC_CONCURRENT_MAP_ENTRY_ALREADY_EXISTS)));
 }
 
+TEST_F(Http2ServerTest, RunFreezesTheRegisteredHandlersIntoRoutes) {
+  std::string host_address("localhost");
+  std::string port("0");
+
+  std::shared_ptr<AuthorizationProxyInterface> mock_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  std::shared_ptr<AuthorizationProxyInterface> mock_aws_authorization_proxy =
+      std::make_shared<MockAuthorizationProxy>();
+  std::shared_ptr<AsyncExecutorInterface> async_executor =
+      std::make_shared<MockAsyncExecutor>();
+  MockHttp2ServerWithOverrides http_server(
+      host_address, port, async_executor, mock_authorization_proxy,
+      mock_aws_authorization_proxy, mock_config_provider_,
+      metric_router_.get());
+
+  std::string path("/test/path");
+  std::string other_path("/test/other_path");
+  HttpHandler callback = [](AsyncContext<HttpRequest, HttpResponse>&) {
+    return SuccessExecutionResult();
+  };
+  EXPECT_SUCCESS(
+      http_server.RegisterResourceHandler(HttpMethod::GET, path, callback));
+  EXPECT_SUCCESS(
+      http_server.RegisterResourceHandler(HttpMethod::POST, path, callback));
+  EXPECT_SUCCESS(http_server.RegisterResourceHandler(HttpMethod::POST,
+                                                     other_path, callback));
+  EXPECT_TRUE(http_server.GetRoutes().empty());
+
+  EXPECT_SUCCESS(http_server.Run());
+  const auto& routes = http_server.GetRoutes();
+  ASSERT_EQ(routes.size(), 2);
+  for (const auto& route : routes) {
+    const auto& handlers = route->handlers;
+    EXPECT_TRUE(handlers[static_cast<size_t>(HttpMethod::POST)]);
+    EXPECT_FALSE(handlers[static_cast<size_t>(HttpMethod::PUT)]);
+    EXPECT_EQ(static_cast<bool>(handlers[static_cast<size_t>(HttpMethod::GET)]),
+              route->path == path);
+  }
+  EXPECT_SUCCESS(http_server.Stop());
+}
+
 TEST_F(Http2ServerTest, HandleHttp2Request) {
   std::string host_address("localhost");
   std::string port("0");
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/http2_server/src/otel_metric_labels_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+
+namespace google::scp::core::test {
+namespace {
+
+TEST(OtelMetricLabelsCacheTest, BuildsTheLabelsOncePerKey) {
+  OtelMetricLabelsCache cache;
+  int build_count = 0;
+  auto build_labels = [&build_count]() {
+    ++build_count;
+    return OtelMetricLabelsCache::Labels{{"route", "/v1/transactions"}};
+  };
+
+  auto labels = cache.GetOrBuild("key", build_labels);
+  auto cached_labels = cache.GetOrBuild("key", build_labels);
+  EXPECT_EQ(build_count, 1);
+  EXPECT_EQ(labels, cached_labels);
+  EXPECT_EQ(labels->at("route"), "/v1/transactions");
+
+  auto other_labels = cache.GetOrBuild("other_key", build_labels);
+  EXPECT_EQ(build_count, 2);
+  EXPECT_NE(labels, other_labels);
+  EXPECT_EQ(cache.Size(), 2);
+}
+
+TEST(OtelMetricLabelsCacheTest, CachesNewKeysOnceFull) {
+  constexpr size_t kMaxEntries = 2 * OtelMetricLabelsCache::kShardCount;
+  OtelMetricLabelsCache cache(kMaxEntries);
+  size_t build_count = 0;
+  auto build_labels = [&build_count]() {
+    ++build_count;
+    return OtelMetricLabelsCache::Labels{{"route", "/v1/transactions"}};
+  };
+
+  for (size_t i = 0; i < 4 * kMaxEntries; ++i) {
+    cache.GetOrBuild(absl::StrCat("key", i), build_labels);
+  }
+  EXPECT_EQ(build_count, 4 * kMaxEntries);
+  EXPECT_LE(cache.Size(), kMaxEntries);
+
+  auto labels = cache.GetOrBuild("new_key", build_labels);
+  EXPECT_EQ(labels->at("route"), "/v1/transactions");
+  EXPECT_EQ(cache.GetOrBuild("new_key", build_labels), labels);
+  EXPECT_EQ(build_count, 4 * kMaxEntries + 1);
+}
+
+TEST(OtelMetricLabelsCacheTest, KeysDoNotConfuseNeighbouringValues) {
+  const std::string a = "a";
+  const std::string a_b = "a;b";
+  const std::string b = "b";
+  const std::string empty;
+
+  std::string key;
+  OtelMetricLabelsCache::AppendToKey(&a_b, key);
+  OtelMetricLabelsCache::AppendToKey(nullptr, key);
+  std::string other_key;
+  OtelMetricLabelsCache::AppendToKey(&a, other_key);
+  OtelMetricLabelsCache::AppendToKey(&b, other_key);
+  EXPECT_NE(key, other_key);
+
+  std::string absent_key;
+  OtelMetricLabelsCache::AppendToKey(nullptr, absent_key);
+  std::string empty_key;
+  OtelMetricLabelsCache::AppendToKey(&empty, empty_key);
+  EXPECT_NE(absent_key, empty_key);
+}
+
+}  // namespace
+}  // namespace google::scp::core::test
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cc/core/http2_server/src/request_body_buffer_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "cc/core/http2_server/src/error_codes.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+namespace google::scp::core::test {
+namespace {
+
+TEST(RequestBodyBufferPoolTest, RoundsTheCapacitiesUpToTheSizeClasses) {
+  auto pool = std::make_shared<RequestBodyBufferPool>();
+  auto small_buffer = pool->Acquire(10);
+  ASSERT_SUCCESS(small_buffer);
+  EXPECT_TRUE((*small_buffer)->empty());
+  EXPECT_EQ((*small_buffer)->capacity(), 4096);
+
+  auto buffer = pool->Acquire(5000);
+  ASSERT_SUCCESS(buffer);
+  EXPECT_EQ((*buffer)->capacity(), 8192);
+  EXPECT_EQ(pool->GetBytesInUse(), 4096 + 8192);
+
+  // The buffers above the largest size class have the exact capacity.
+  auto large_buffer = pool->Acquire(3 * 1024 * 1024 + 1);
+  ASSERT_SUCCESS(large_buffer);
+  EXPECT_EQ((*large_buffer)->capacity(), 3 * 1024 * 1024 + 1);
+
+  small_buffer->reset();
+  buffer->reset();
+  large_buffer->reset();
+  EXPECT_EQ(pool->GetBytesInUse(), 0);
+}
+
+TEST(RequestBodyBufferPoolTest, ReusesTheReleasedBuffers) {
+  auto pool = std::make_shared<RequestBodyBufferPool>();
+  auto buffer = pool->Acquire(100);
+  ASSERT_SUCCESS(buffer);
+  (*buffer)->assign(100, 1);
+  const auto* data = (*buffer)->data();
+  buffer->reset();
+
+  auto reused_buffer = pool->Acquire(200);
+  ASSERT_SUCCESS(reused_buffer);
+  EXPECT_EQ((*reused_buffer)->data(), data);
+  EXPECT_TRUE((*reused_buffer)->empty());
+}
+
+TEST(RequestBodyBufferPoolTest, EnforcesTheMemoryBudget) {
+  auto pool = std::make_shared<RequestBodyBufferPool>(16 * 1024);
+  auto buffer = pool->Acquire(8 * 1024);
+  ASSERT_SUCCESS(buffer);
+  auto other_buffer = pool->Acquire(4 * 1024);
+  ASSERT_SUCCESS(other_buffer);
+  EXPECT_THAT(pool->Acquire(8 * 1024),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_HTTP2_SERVER_REQUEST_BODY_MEMORY_EXHAUSTED)));
+  EXPECT_THAT(pool->Acquire(32 * 1024),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_HTTP2_SERVER_REQUEST_BODY_MEMORY_EXHAUSTED)));
+
+  buffer->reset();
+  EXPECT_SUCCESS(pool->Acquire(8 * 1024));
+}
+
+TEST(RequestBodyBufferPoolTest, BuffersOutliveThePoolReference) {
+  auto pool = std::make_shared<RequestBodyBufferPool>();
+  auto buffer = pool->Acquire(100);
+  ASSERT_SUCCESS(buffer);
+  pool.reset();
+  (*buffer)->push_back(1);
+  buffer->reset();
+}
+}  // namespace
+}  // namespace google::scp::core::test
@@ -17,8 +17,10 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 
 #include "service_interface.h"
 #include "type_def.h"
@@ -172,5 +174,81 @@ class AsyncExecutorInterface : public ServiceInterface {
       const AsyncOperation& work, Timestamp timestamp,
       TaskCancellationLambda& cancellation_callback,
       AsyncExecutorAffinitySetting affinity) noexcept = 0;
+
+  /**
+   * @brief The overloads below are the same as the ones above, but take the
+   * work as an rvalue so that it, and the context it captured, can be moved
+   * into the task instead of being copied. By default, they copy the work.
+   */
+  virtual ExecutionResult Schedule(AsyncOperation&& work,
+                                   AsyncPriority priority) noexcept {
+    return Schedule(static_cast<const AsyncOperation&>(work), priority);
+  }
+
+  virtual ExecutionResult Schedule(
+      AsyncOperation&& work, AsyncPriority priority,
+      AsyncExecutorAffinitySetting affinity) noexcept {
+    return Schedule(static_cast<const AsyncOperation&>(work), priority,
+                    affinity);
+  }
+
+  virtual ExecutionResult ScheduleFor(AsyncOperation&& work,
+                                      Timestamp timestamp) noexcept {
+    return ScheduleFor(static_cast<const AsyncOperation&>(work), timestamp);
+  }
+
+  virtual ExecutionResult ScheduleFor(
+      AsyncOperation&& work, Timestamp timestamp,
+      AsyncExecutorAffinitySetting affinity) noexcept {
+    return ScheduleFor(static_cast<const AsyncOperation&>(work), timestamp,
+                       affinity);
+  }
+
+  virtual ExecutionResult ScheduleFor(
+      AsyncOperation&& work, Timestamp timestamp,
+      TaskCancellationLambda& cancellation_callback) noexcept {
+    return ScheduleFor(static_cast<const AsyncOperation&>(work), timestamp,
+                       cancellation_callback);
+  }
+
+  virtual ExecutionResult ScheduleFor(
+      AsyncOperation&& work, Timestamp timestamp,
+      TaskCancellationLambda& cancellation_callback,
+      AsyncExecutorAffinitySetting affinity) noexcept {
+    return ScheduleFor(static_cast<const AsyncOperation&>(work), timestamp,
+                       cancellation_callback, affinity);
+  }
+
+  /**
+   * @brief Schedules a batch of tasks with the same priority, spread across
+   * the threads of the executor. The works are moved from, whether they are
+   * admitted or not. By default, they are scheduled one at a time.
+   *
+   * @param works the tasks that need to be scheduled.
+   * @param priority the priority of the tasks.
+   * @return std::vector<ExecutionResult> the result of the admission of each
+   * task, in the order of the works.
+   */
+  virtual std::vector<ExecutionResult> ScheduleBatch(
+      absl::Span<AsyncOperation> works, AsyncPriority priority) noexcept {
+    std::vector<ExecutionResult> results;
+    results.reserve(works.size());
+    for (auto& work : works) {
+      results.push_back(Schedule(std::move(work), priority));
+    }
+    return results;
+  }
+
+  /**
+   * @brief Checks whether an operation with the given priority would be
+   * admitted now, so that the callers can reject a request before doing any
+   * work for it while the executor is overloaded.
+   *
+   * @param priority the priority of the operation.
+   * @return ExecutionResult success if the operation would be admitted.
+   */
+  virtual ExecutionResult CheckAdmission(AsyncPriority priority) noexcept {
+    return SuccessExecutionResult();
+  }
 };
 }  // namespace google::scp::core
@@ -144,6 +144,7 @@ static constexpr TimeDuration kDefaultHttp2ReadTimeoutInSeconds = 60;
 
 // Meter
 inline constexpr absl::string_view kHttp2ServerMeter = "Http2 Server";
+inline constexpr absl::string_view kAsyncExecutorMeter = "Async Executor";
 
 // Metrics
 static constexpr char kServerRequestDurationMetric[] =
@@ -154,6 +155,16 @@ static constexpr char kServerRequestBodySizeMetric[] =
 static constexpr char kServerResponseBodySizeMetric[] =
     "http.server.response.body.size";
 static constexpr char kPbsRequestsMetric[] = "google.scp.pbs.requests";
+static constexpr char kAsyncExecutorQueueSizeMetric[] =
+    "google.scp.async_executor.queue.size";
+static constexpr char kAsyncExecutorQueueSojournTimeMetric[] =
+    "google.scp.async_executor.queue.sojourn_time";
+static constexpr char kAsyncExecutorQueueDepthMetric[] =
+    "google.scp.async_executor.queue.depth";
+static constexpr char kAsyncExecutorTaskQueueWaitTimeMetric[] =
+    "google.scp.async_executor.task.queue_wait_time";
+static constexpr char kAsyncExecutorTaskRunTimeMetric[] =
+    "google.scp.async_executor.task.run_time";
 
 // Labels
 inline constexpr absl::string_view kPbsAuthDomainLabel = "pbs.auth_domain";
@@ -161,6 +172,10 @@ inline constexpr absl::string_view kPbsClaimedIdentityLabel =
     "pbs.claimed_identity";
 inline constexpr absl::string_view kScpHttpRequestClientVersionLabel =
     "scp.http.request.client_version";
+static constexpr char kAsyncExecutorNameLabel[] = "scp.async_executor.name";
+static constexpr char kAsyncExecutorPoolLabel[] = "scp.async_executor.pool";
+static constexpr char kAsyncExecutorQuantileLabel[] =
+    "scp.async_executor.quantile";
 
 // Default Value
 inline constexpr absl::string_view kUnknownValue = "unknown";
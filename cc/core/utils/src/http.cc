@@ -15,6 +15,8 @@
  */
 #include "http.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <regex>
 #include <string>
@@ -115,4 +117,14 @@ std::string HttpMethodToString(HttpMethod method) {
   return "UNKNOWN";
 }
 
+size_t BytesBufferGenerator::Read(uint8_t* data, size_t max_length,
+                                  bool& is_last) noexcept {
+  size_t length = std::min(max_length, length_ - offset_);
+  if (length > 0) {
+    std::memcpy(data, bytes_->data() + offset_, length);
+    offset_ += length;
+  }
+  is_last = offset_ == length_;
+  return length;
+}
 }  // namespace google::scp::core::utils
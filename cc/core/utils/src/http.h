@@ -16,7 +16,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "cc/core/interface/http_client_interface.h"
 #include "cc/public/core/interface/execution_result.h"
@@ -140,4 +144,36 @@ std::string GetUserAgentOrUnknownValue(
 
 // Function to convert HttpMethod enum to a string representation
 std::string HttpMethodToString(HttpMethod method);
+
+/**
+ * @brief Reads a BytesBuffer in chunks, for the generator callbacks of
+ * nghttp2 which fill the data frames of a request or a response. The bytes
+ * are shared with the buffer and copied straight into the frames, instead of
+ * being copied into a string first.
+ */
+class BytesBufferGenerator {
+ public:
+  /// @param buffer the buffer whose first length bytes are read.
+  explicit BytesBufferGenerator(const BytesBuffer& buffer)
+      : bytes_(buffer.bytes),
+        length_(bytes_ ? std::min(buffer.length, bytes_->size()) : 0) {}
+
+  /**
+   * @brief Copies the next bytes of the buffer.
+   *
+   * @param data the destination of the bytes.
+   * @param max_length the maximum number of bytes to copy.
+   * @param is_last set to whether the copied bytes are the last ones.
+   * @return size_t the number of bytes copied.
+   */
+  size_t Read(uint8_t* data, size_t max_length, bool& is_last) noexcept;
+
+  /// Returns the number of bytes to be read altogether.
+  size_t GetLength() const noexcept { return length_; }
+
+ private:
+  std::shared_ptr<std::vector<Byte>> bytes_;
+  size_t length_;
+  size_t offset_ = 0;
+};
 }  // namespace google::scp::core::utils
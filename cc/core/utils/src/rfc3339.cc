@@ -0,0 +1,174 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rfc3339.h"
+
+#include <cstdint>
+#include <string_view>
+
+#include "cc/core/utils/src/error_codes.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace google::scp::core::utils {
+namespace {
+
+constexpr int64_t kSecondsPerMinute = 60;
+constexpr int64_t kSecondsPerHour = 60 * kSecondsPerMinute;
+constexpr int64_t kSecondsPerDay = 24 * kSecondsPerHour;
+// 0001-01-01T00:00:00Z and 9999-12-31T23:59:59Z, the range of a protobuf
+// Timestamp.
+constexpr int64_t kMinSeconds = -62135596800;
+constexpr int64_t kMaxSeconds = 253402300799;
+constexpr int kDaysInMonth[13] = {0, 31, 28, 31, 30, 31, 30,
+                                  31, 31, 30, 31, 30, 31};
+
+bool IsDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+bool IsLeapYear(int year) {
+  return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+// Returns the number of days from 1970-01-01 to the given date of the
+// proleptic Gregorian calendar.
+int64_t DaysFromCivil(int64_t year, int month, int day) {
+  year -= month <= 2 ? 1 : 0;
+  const int64_t era = (year >= 0 ? year : year - 399) / 400;
+  const int64_t year_of_era = year - era * 400;
+  const int64_t day_of_year =
+      (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const int64_t day_of_era = year_of_era * 365 + year_of_era / 4 -
+                             year_of_era / 100 + day_of_year;
+  return era * 146097 + day_of_era - 719468;
+}
+
+// Reads the input the way the protobuf parser reads a C string: past its end
+// or at a NUL character, the input looks like a NUL character.
+class Cursor {
+ public:
+  explicit Cursor(std::string_view input) : input_(input) {}
+
+  char Peek() const {
+    return position_ < input_.size() ? input_[position_] : 0;
+  }
+
+  bool Consume(char c) {
+    if (c == 0 || Peek() != c) {
+      return false;
+    }
+    ++position_;
+    return true;
+  }
+
+  // Reads between 1 and max_digits digits, as a number between min_value and
+  // max_value.
+  bool ReadInt(int max_digits, int min_value, int max_value, int& value) {
+    if (!IsDigit(Peek())) {
+      return false;
+    }
+    int result = 0;
+    for (int i = 0; i < max_digits && IsDigit(Peek()); ++i) {
+      result = result * 10 + (input_[position_++] - '0');
+    }
+    if (result < min_value || result > max_value) {
+      return false;
+    }
+    value = result;
+    return true;
+  }
+
+  // Skips a non-empty run of digits.
+  bool SkipDigits() {
+    if (!IsDigit(Peek())) {
+      return false;
+    }
+    while (IsDigit(Peek())) {
+      ++position_;
+    }
+    return true;
+  }
+
+  // Reads a "HH:MM" offset in seconds.
+  bool ReadOffset(int64_t& offset) {
+    int hour;
+    int minute;
+    if (!ReadInt(2, 0, 23, hour) || !Consume(':') ||
+        !ReadInt(2, 0, 59, minute)) {
+      return false;
+    }
+    offset = hour * kSecondsPerHour + minute * kSecondsPerMinute;
+    return true;
+  }
+
+ private:
+  std::string_view input_;
+  size_t position_ = 0;
+};
+
+}  // namespace
+
+ExecutionResultOr<int64_t> ParseRfc3339ToUnixSeconds(
+    std::string_view timestamp) noexcept {
+  Cursor cursor(timestamp);
+  int year;
+  int month;
+  int day;
+  int hour;
+  int minute;
+  int second;
+  if (!cursor.ReadInt(4, 1, 9999, year) || !cursor.Consume('-') ||
+      !cursor.ReadInt(2, 1, 12, month) || !cursor.Consume('-') ||
+      !cursor.ReadInt(2, 1, 31, day) || !cursor.Consume('T') ||
+      !cursor.ReadInt(2, 0, 23, hour) || !cursor.Consume(':') ||
+      !cursor.ReadInt(2, 0, 59, minute) || !cursor.Consume(':') ||
+      !cursor.ReadInt(2, 0, 59, second)) {
+    return FailureExecutionResult(errors::SC_CORE_UTILS_INVALID_INPUT);
+  }
+  const int days_in_month =
+      kDaysInMonth[month] + (month == 2 && IsLeapYear(year) ? 1 : 0);
+  if (day > days_in_month) {
+    return FailureExecutionResult(errors::SC_CORE_UTILS_INVALID_INPUT);
+  }
+
+  if (cursor.Consume('.') && !cursor.SkipDigits()) {
+    return FailureExecutionResult(errors::SC_CORE_UTILS_INVALID_INPUT);
+  }
+
+  int64_t seconds = DaysFromCivil(year, month, day) * kSecondsPerDay +
+                    hour * kSecondsPerHour + minute * kSecondsPerMinute +
+                    second;
+  int64_t offset = 0;
+  if (cursor.Consume('+')) {
+    if (!cursor.ReadOffset(offset)) {
+      return FailureExecutionResult(errors::SC_CORE_UTILS_INVALID_INPUT);
+    }
+    seconds -= offset;
+  } else if (cursor.Consume('-')) {
+    if (!cursor.ReadOffset(offset)) {
+      return FailureExecutionResult(errors::SC_CORE_UTILS_INVALID_INPUT);
+    }
+    seconds += offset;
+  } else if (!cursor.Consume('Z')) {
+    return FailureExecutionResult(errors::SC_CORE_UTILS_INVALID_INPUT);
+  }
+
+  if (cursor.Peek() != 0 || seconds < kMinSeconds || seconds > kMaxSeconds) {
+    return FailureExecutionResult(errors::SC_CORE_UTILS_INVALID_INPUT);
+  }
+  return seconds;
+}
+}  // namespace google::scp::core::utils
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "cc/public/core/interface/execution_result.h"
+
+namespace google::scp::core::utils {
+/**
+ * @brief Parses an RFC 3339 timestamp such as "2019-12-11T07:20:50.52Z" or
+ * "2019-12-11T07:20:50-08:00" into seconds since the Unix epoch. The fraction
+ * of a second is validated and then dropped.
+ *
+ * This accepts the inputs that google::protobuf::util::TimeUtil::FromString
+ * accepts, and returns the same seconds, without building a protobuf
+ * Timestamp. As there, the input ends at its first NUL character. Unlike
+ * there, an offset that moves the time out of the years 0001 to 9999 is an
+ * error rather than a crash.
+ *
+ * @param timestamp The timestamp to parse.
+ * @return ExecutionResultOr<int64_t> The seconds since the Unix epoch, or
+ * SC_CORE_UTILS_INVALID_INPUT.
+ */
+ExecutionResultOr<int64_t> ParseRfc3339ToUnixSeconds(
+    std::string_view timestamp) noexcept;
+}  // namespace google::scp::core::utils
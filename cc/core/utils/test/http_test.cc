@@ -15,6 +15,7 @@
 #include "cc/core/utils/src/http.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <string>
 
 #include "cc/core/utils/src/error_codes.h"
@@ -153,4 +154,45 @@ TEST(HttpTest, EmptyUserAgentString) {
   EXPECT_TRUE(extraction_result.Successful());
   EXPECT_EQ(*extraction_result, kUnknownValue);
 }
+
+TEST(HttpTest, BytesBufferGeneratorReadsTheBufferInChunks) {
+  BytesBuffer buffer(std::string("hello, world"));
+  utils::BytesBufferGenerator generator(buffer);
+  EXPECT_EQ(generator.GetLength(), 12);
+
+  uint8_t data[5];
+  bool is_last = true;
+  EXPECT_EQ(generator.Read(data, sizeof(data), is_last), 5);
+  EXPECT_FALSE(is_last);
+  EXPECT_EQ(std::string(data, data + 5), "hello");
+  EXPECT_EQ(generator.Read(data, sizeof(data), is_last), 5);
+  EXPECT_FALSE(is_last);
+  EXPECT_EQ(generator.Read(data, sizeof(data), is_last), 2);
+  EXPECT_TRUE(is_last);
+  EXPECT_EQ(std::string(data, data + 2), "ld");
+}
+
+TEST(HttpTest, BytesBufferGeneratorOnlyReadsTheLengthOfTheBuffer) {
+  BytesBuffer buffer(std::string("hello, world"));
+  buffer.length = 5;
+  utils::BytesBufferGenerator generator(buffer);
+  EXPECT_EQ(generator.GetLength(), 5);
+
+  uint8_t data[16];
+  bool is_last = false;
+  EXPECT_EQ(generator.Read(data, sizeof(data), is_last), 5);
+  EXPECT_TRUE(is_last);
+}
+
+TEST(HttpTest, BytesBufferGeneratorReadsAnEmptyBuffer) {
+  BytesBuffer buffer;
+  buffer.bytes = nullptr;
+  buffer.length = 0;
+  utils::BytesBufferGenerator generator(buffer);
+
+  uint8_t data[16];
+  bool is_last = false;
+  EXPECT_EQ(generator.Read(data, sizeof(data), is_last), 0);
+  EXPECT_TRUE(is_last);
+}
 }  // namespace google::scp::core
@@ -0,0 +1,57 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include <google/protobuf/timestamp.pb.h>
+#include <google/protobuf/util/time_util.h>
+
+#include "cc/core/utils/src/rfc3339.h"
+
+namespace google::scp::core::utils {
+namespace {
+
+constexpr char kReportingTime[] = "2019-12-11T07:20:50.52Z";
+
+void BM_ParseRfc3339ToUnixSeconds(benchmark::State& state) {
+  std::string reporting_time = kReportingTime;
+
+  for (auto _ : state) {
+    auto seconds = ParseRfc3339ToUnixSeconds(reporting_time);
+    benchmark::DoNotOptimize(seconds);
+  }
+}
+
+void BM_TimeUtilFromString(benchmark::State& state) {
+  std::string reporting_time = kReportingTime;
+
+  for (auto _ : state) {
+    google::protobuf::Timestamp timestamp;
+    bool parsed = google::protobuf::util::TimeUtil::FromString(reporting_time,
+                                                               &timestamp);
+    benchmark::DoNotOptimize(parsed);
+    benchmark::DoNotOptimize(timestamp);
+  }
+}
+
+BENCHMARK(BM_ParseRfc3339ToUnixSeconds);
+BENCHMARK(BM_TimeUtilFromString);
+
+}  // namespace
+}  // namespace google::scp::core::utils
+
+// Run the benchmark.
+BENCHMARK_MAIN();
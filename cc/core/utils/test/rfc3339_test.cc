@@ -0,0 +1,103 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cc/core/utils/src/rfc3339.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/timestamp.pb.h>
+#include <google/protobuf/util/time_util.h>
+
+#include "cc/core/utils/src/error_codes.h"
+#include "cc/public/core/interface/execution_result.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+namespace google::scp::core::utils::test {
+namespace {
+
+using ::google::protobuf::Timestamp;
+using ::google::protobuf::util::TimeUtil;
+using ::google::scp::core::test::IsSuccessfulAndHolds;
+using ::google::scp::core::test::ResultIs;
+
+TEST(Rfc3339Test, ParsesUtcTimestamp) {
+  EXPECT_THAT(ParseRfc3339ToUnixSeconds("1970-01-01T00:00:00Z"),
+              IsSuccessfulAndHolds(0));
+  EXPECT_THAT(ParseRfc3339ToUnixSeconds("2019-12-11T07:20:50Z"),
+              IsSuccessfulAndHolds(1576048850));
+  EXPECT_THAT(ParseRfc3339ToUnixSeconds("2019-12-11T07:20:50.52Z"),
+              IsSuccessfulAndHolds(1576048850));
+}
+
+TEST(Rfc3339Test, ParsesTimestampWithOffset) {
+  EXPECT_THAT(ParseRfc3339ToUnixSeconds("2019-12-11T07:20:50+01:30"),
+              IsSuccessfulAndHolds(1576048850 - 5400));
+  EXPECT_THAT(ParseRfc3339ToUnixSeconds("2019-12-11T07:20:50-08:00"),
+              IsSuccessfulAndHolds(1576048850 + 28800));
+}
+
+TEST(Rfc3339Test, RejectsInvalidTimestamp) {
+  for (const char* timestamp : {
+           "",
+           "2019-12-11",
+           "2019-12-11 07:20:50Z",
+           "2019-12-11T07:20:50",
+           "2019-12-11T07:20:50z",
+           "2019-12-11T07:20:50.Z",
+           "2019-12-11T07:20:50Z ",
+           "2019-13-11T07:20:50Z",
+           "2019-02-29T07:20:50Z",
+           "2019-12-11T24:00:00Z",
+           "2019-12-11T07:20:50+24:00",
+           "9999-12-31T23:59:59-00:01",
+       }) {
+    EXPECT_THAT(ParseRfc3339ToUnixSeconds(timestamp).result(),
+                ResultIs(FailureExecutionResult(
+                    errors::SC_CORE_UTILS_INVALID_INPUT)))
+        << timestamp;
+  }
+}
+
+TEST(Rfc3339Test, MatchesProtobufTimeUtil) {
+  for (const std::string& timestamp : std::vector<std::string>{
+           "0001-01-01T00:00:00Z",
+           "9999-12-31T23:59:59.999999999Z",
+           "1969-12-31T23:59:59Z",
+           "2000-02-29T12:00:00Z",
+           "1900-02-29T12:00:00Z",
+           "2024-02-29T23:59:59.1234567890123Z",
+           "2024-1-2T3:4:5Z",
+           "2024-01-02T03:04:05+1:2",
+           "02024-01-02T03:04:05Z",
+           "2024-01-02T03:04:05.Z",
+           "2024-01-02T03:04:05ZZ",
+           std::string("2024-01-02T03:04:05Z\0garbage", 28),
+       }) {
+    Timestamp expected;
+    if (TimeUtil::FromString(timestamp, &expected)) {
+      EXPECT_THAT(ParseRfc3339ToUnixSeconds(timestamp),
+                  IsSuccessfulAndHolds(expected.seconds()))
+          << timestamp;
+    } else {
+      EXPECT_FALSE(ParseRfc3339ToUnixSeconds(timestamp).Successful())
+          << timestamp;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace google::scp::core::utils::test
@@ -0,0 +1,129 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "cc/pbs/consume_budget/src/gcp/budget_key_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "absl/hash/hash.h"
+
+namespace google::scp::pbs {
+
+using ::google::scp::core::Timestamp;
+
+BudgetKeyCache::BudgetKeyCache(size_t max_entries,
+                               std::chrono::nanoseconds max_age,
+                               size_t shard_count)
+    : max_entries_per_shard_(
+          std::max<size_t>(1, max_entries / std::max<size_t>(1, shard_count))),
+      max_age_(max_age.count() > 0 ? max_age.count() : 0) {
+  shard_count = std::max<size_t>(1, shard_count);
+  shards_.reserve(shard_count);
+  for (size_t i = 0; i < shard_count; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+BudgetKeyCache::Shard& BudgetKeyCache::GetShard(const PbsPrimaryKeyRef& key) {
+  return *shards_[absl::HashOf(key) % shards_.size()];
+}
+
+bool BudgetKeyCache::IsKnownExhausted(const PbsPrimaryKeyRef& key,
+                                      size_t hour, TokenCount token_count,
+                                      Timestamp now) {
+  Shard& shard = GetShard(key);
+  std::unique_lock lock(shard.mutex);
+  auto entry = shard.entries.find(key);
+  if (entry == shard.entries.end()) {
+    return false;
+  }
+  if (now > entry->second.observed_at &&
+      now - entry->second.observed_at > max_age_) {
+    // Budgets may have been returned since, e.g. by another process.
+    shard.lru.erase(entry->second.lru_position);
+    shard.entries.erase(entry);
+    return false;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, entry->second.lru_position);
+  const HourTokenCounts& token_counts = entry->second.token_counts;
+  return hour < token_counts.size() && token_counts[hour] < token_count;
+}
+
+BudgetKeyCache::Observation BudgetKeyCache::StartObservation(
+    Timestamp now) const {
+  return Observation{.sequence = next_observation_.load(), .started_at = now};
+}
+
+void BudgetKeyCache::Update(const PbsPrimaryKeyRef& key,
+                            const HourTokenCounts& token_counts,
+                            Timestamp version, Observation observation) {
+  Shard& shard = GetShard(key);
+  std::unique_lock lock(shard.mutex);
+  if (observation.sequence < shard.invalidated_at) {
+    // The budgets may have been read before a return committed.
+    return;
+  }
+  if (auto entry = shard.entries.find(key); entry != shard.entries.end()) {
+    Entry& cached = entry->second;
+    shard.lru.splice(shard.lru.begin(), shard.lru, cached.lru_position);
+    if (version != kUnknownVersion && version >= cached.version) {
+      cached.token_counts = token_counts;
+      cached.version = std::max(version, cached.version);
+      cached.observed_at = observation.started_at;
+      return;
+    }
+    // An older observation can still tell that more hours are exhausted. The
+    // entry is then as old as the oldest of the two.
+    for (size_t i = 0; i < token_counts.size(); ++i) {
+      cached.token_counts[i] =
+          std::min(cached.token_counts[i], token_counts[i]);
+    }
+    cached.observed_at = std::min(cached.observed_at, observation.started_at);
+    return;
+  }
+
+  if (shard.entries.size() >= max_entries_per_shard_) {
+    shard.entries.erase(shard.lru.back());
+    shard.lru.pop_back();
+  }
+  shard.lru.emplace_front(key);
+  shard.entries.emplace(shard.lru.front(),
+                        Entry{.token_counts = token_counts,
+                              .version = version,
+                              .observed_at = observation.started_at,
+                              .lru_position = shard.lru.begin()});
+}
+
+void BudgetKeyCache::Invalidate(const PbsPrimaryKeyRef& key) {
+  Shard& shard = GetShard(key);
+  std::unique_lock lock(shard.mutex);
+  shard.invalidated_at = next_observation_.fetch_add(1) + 1;
+  if (auto entry = shard.entries.find(key); entry != shard.entries.end()) {
+    shard.lru.erase(entry->second.lru_position);
+    shard.entries.erase(entry);
+  }
+}
+
+size_t BudgetKeyCache::Size() const {
+  size_t size = 0;
+  for (const auto& shard : shards_) {
+    std::unique_lock lock(shard->mutex);
+    size += shard->entries.size();
+  }
+  return size;
+}
+
+}  // namespace google::scp::pbs
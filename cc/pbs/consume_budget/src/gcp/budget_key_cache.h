@@ -0,0 +1,129 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CC_PBS_CONSUME_BUDGET_SRC_GCP_BUDGET_KEY_CACHE_H_
+#define CC_PBS_CONSUME_BUDGET_SRC_GCP_BUDGET_KEY_CACHE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "cc/core/interface/type_def.h"
+#include "cc/pbs/consume_budget/src/gcp/hour_token_counts.h"
+#include "cc/pbs/consume_budget/src/gcp/pbs_primary_key.h"
+#include "cc/pbs/interface/type_def.h"
+
+namespace google::scp::pbs {
+
+// A bounded, in-process cache of the decoded hourly budgets of recently used
+// budget keys.
+//
+// Budgets are consumed by every committed transaction, so an hour that is known
+// to be exhausted stays exhausted until its budget is returned. This lets
+// BudgetConsumptionHelper reject such requests without opening a Spanner
+// transaction. Entries are versioned with the commit timestamp of the
+// transaction that observed them, so that a slower writer cannot replace a
+// newer entry with an older one.
+//
+// Returning budgets is the only way an hour becomes available again. The
+// caller invalidates the returned keys once the return has committed, and
+// every observation that started before the invalidation is then dropped,
+// since it may predate the return. Other processes writing to the same table,
+// e.g. the other replicas of PBS, can return budgets without this cache
+// knowing, so an entry is only trusted for max_age after the read that
+// observed it started, and is dropped once older.
+//
+// The cache is sharded by key and each shard evicts its least recently used
+// entry once it is full. This class is thread-safe.
+class BudgetKeyCache {
+ public:
+  // Version of an entry that was observed outside a committed transaction.
+  static constexpr core::Timestamp kUnknownVersion = 0;
+
+  // Identifies when an observation started, see StartObservation.
+  struct Observation {
+    // Orders the observation with the invalidations.
+    uint64_t sequence = 0;
+    // Steady clock time at which the observation started, in nanoseconds.
+    core::Timestamp started_at = 0;
+  };
+
+  // Entries are trusted for max_age after the observation they come from
+  // started.
+  BudgetKeyCache(size_t max_entries, std::chrono::nanoseconds max_age,
+                 size_t shard_count = kDefaultShardCount);
+
+  // Returns true if the cached budget of the given hour of the key is known
+  // to be lower than token_count as of now, the steady clock time in
+  // nanoseconds. An entry older than max_age is dropped instead.
+  bool IsKnownExhausted(const PbsPrimaryKeyRef& key, size_t hour,
+                        TokenCount token_count, core::Timestamp now);
+
+  // Returns the observation to pass to Update for budgets read from now on,
+  // the steady clock time in nanoseconds.
+  Observation StartObservation(core::Timestamp now) const;
+
+  // Stores the hourly budgets of the key as observed at version by a read that
+  // started at observation. An entry with an older or unknown version never
+  // replaces a newer one, it can only mark more hours as exhausted. The update
+  // is dropped if the key's shard was invalidated after observation started.
+  void Update(const PbsPrimaryKeyRef& key, const HourTokenCounts& token_counts,
+              core::Timestamp version, Observation observation);
+
+  // Removes the key after its budgets were returned. Updates of observations
+  // started before this call are dropped.
+  void Invalidate(const PbsPrimaryKeyRef& key);
+
+  // Returns the number of cached keys.
+  size_t Size() const;
+
+ private:
+  static constexpr size_t kDefaultShardCount = 16;
+
+  struct Entry {
+    HourTokenCounts token_counts;
+    core::Timestamp version = kUnknownVersion;
+    // Start of the oldest observation the token counts come from.
+    core::Timestamp observed_at = 0;
+    // Position of the key in the LRU list of the shard.
+    std::list<PbsPrimaryKey>::iterator lru_position;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    // Most recently used keys first.
+    std::list<PbsPrimaryKey> lru;
+    absl::flat_hash_map<PbsPrimaryKey, Entry, PbsPrimaryKeyHash,
+                        PbsPrimaryKeyEq>
+        entries;
+    // Observations started before this sequence are stale for the shard.
+    uint64_t invalidated_at = 0;
+  };
+
+  Shard& GetShard(const PbsPrimaryKeyRef& key);
+
+  size_t max_entries_per_shard_;
+  core::Timestamp max_age_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<uint64_t> next_observation_{0};
+};
+
+}  // namespace google::scp::pbs
+
+#endif  // CC_PBS_CONSUME_BUDGET_SRC_GCP_BUDGET_KEY_CACHE_H_
@@ -13,7 +13,11 @@
 // limitations under the License.
 #include "cc/pbs/consume_budget/src/gcp/consume_budget.h"
 
+#include <algorithm>
+#include <chrono>
+#include <list>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -22,13 +26,22 @@
 
 #include <nlohmann/json.hpp>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/time/time.h"
+#include "cc/core/common/time_provider/src/time_provider.h"
+#include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/interface/config_provider_interface.h"
 #include "cc/core/interface/configuration_keys.h"
-#include "cc/pbs/budget_key_timeframe_manager/src/budget_key_timeframe_serialization.h"
 #include "cc/pbs/budget_key_timeframe_manager/src/budget_key_timeframe_utils.h"
+#include "cc/pbs/consume_budget/src/gcp/budget_key_cache.h"
 #include "cc/pbs/consume_budget/src/gcp/error_codes.h"
+#include "cc/pbs/consume_budget/src/gcp/hour_token_counts.h"
+#include "cc/pbs/consume_budget/src/gcp/pbs_primary_key.h"
 #include "cc/pbs/interface/configuration_keys.h"
 #include "cc/pbs/interface/consume_budget_interface.h"
 #include "cc/pbs/interface/type_def.h"
@@ -47,16 +60,19 @@ using ::google::scp::core::ConfigProviderInterface;
 using ::google::scp::core::ExecutionResult;
 using ::google::scp::core::ExecutionResultOr;
 using ::google::scp::core::FailureExecutionResult;
-using ::google::scp::core::GetErrorMessage;
+using ::google::scp::core::RetryExecutionResult;
 using ::google::scp::core::kGcpProjectId;
 using ::google::scp::core::kSpannerDatabase;
 using ::google::scp::core::kSpannerEndpointOverride;
 using ::google::scp::core::kSpannerInstance;
 using ::google::scp::core::SuccessExecutionResult;
-using ::google::scp::pbs::budget_key_timeframe_manager::Serialization;
+using ::google::scp::core::Timestamp;
+using ::google::scp::core::common::TimeProvider;
 using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_EXHAUSTED;
 using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_FAIL_TO_COMMIT;
+using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_GROUP_COMMIT_QUEUE_FULL;
 using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_INITIALIZATION_ERROR;
+using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_INVALID_CONFIGURATION;
 using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_PARSING_ERROR;
 namespace spanner = ::google::cloud::spanner;
 
@@ -66,10 +82,17 @@ constexpr absl::string_view kTimeframeSpannerColumnName = "Timeframe";
 constexpr absl::string_view kValueSpannerColumnName = "Value";
 constexpr absl::string_view kValueProtoSpannerColumnName = "ValueProto";
 constexpr absl::string_view kTokenCountJsonField = "TokenCount";
-constexpr size_t kDefaultTokenCountSize = 24;
+constexpr size_t kDefaultTokenCountSize = kHourTokenCountsSize;
 constexpr TokenCount kDefaultPrivacyBudgetCount = 1;
 constexpr int32_t kDefaultLaplaceDpBudgetCount = 6400;
 constexpr int32_t kEmptyBudgetCount = 0;
+// Group commit is disabled by default.
+constexpr size_t kDefaultGroupCommitMaxBatchSize = 1;
+constexpr size_t kDefaultGroupCommitMaxLingerMs = 0;
+constexpr size_t kDefaultGroupCommitMaxPendingCount = 100000;
+// The budget key cache is disabled by default.
+constexpr size_t kDefaultBudgetKeyCacheMaxEntries = 0;
+constexpr size_t kDefaultBudgetKeyCacheMaxAgeMs = 1000;
 
 // Migration phase for ValueProto column.
 // The new ValueProto column is meant to replace the existing Value JSON column.
@@ -99,39 +122,49 @@ constexpr absl::string_view kMigrationPhase4 = "phase_4";
 constexpr std::array<absl::string_view, 4> kMigrationPhases = {
     kMigrationPhase1, kMigrationPhase2, kMigrationPhase3, kMigrationPhase4};
 
-class PbsPrimaryKey {
- public:
-  PbsPrimaryKey(const std::string& budget_key, std::string timeframe)
-      : budget_key_(budget_key), timeframe_(timeframe) {}
-
-  const std::string& budget_key() const { return budget_key_; }
-
-  const std::string& timeframe() const { return timeframe_; }
-
-  template <typename H>
-  friend H AbslHashValue(H h, const PbsPrimaryKey& c) {
-    return H::combine(std::move(h), c.budget_key_, c.timeframe_);
+// Decodes the legacy TokenCount string, i.e. 24 space separated integers, in
+// place without splitting it.
+bool DecodeLegacyTokenCounts(absl::string_view serialized_token_count,
+                             HourTokenCounts& token_counts) {
+  for (size_t i = 0; i < token_counts.size(); ++i) {
+    const size_t separator = serialized_token_count.find(' ');
+    const bool is_last_token = i + 1 == token_counts.size();
+    if (is_last_token != (separator == absl::string_view::npos)) {
+      return false;
+    }
+    int32_t value;
+    if (!absl::SimpleAtoi(serialized_token_count.substr(0, separator),
+                          &value)) {
+      return false;
+    }
+    token_counts[i] = value;
+    if (!is_last_token) {
+      serialized_token_count.remove_prefix(separator + 1);
+    }
   }
+  return true;
+}
 
-  friend bool operator==(const PbsPrimaryKey& p1, const PbsPrimaryKey& p2) {
-    return p1.budget_key_ == p2.budget_key_ && p1.timeframe_ == p2.timeframe_;
+// Encodes the token counts as the legacy Value column, e.g.
+// {"TokenCount":"1 1 0 ... 1"}, without building a JSON object.
+std::string EncodeLegacyTokenCountJson(const HourTokenCounts& token_counts) {
+  std::string json;
+  // 2 characters per token in the common case of single digit counts.
+  json.reserve(kTokenCountJsonField.size() + 2 * token_counts.size() + 8);
+  absl::StrAppend(&json, R"({")", kTokenCountJsonField, R"(":")");
+  for (size_t i = 0; i < token_counts.size(); ++i) {
+    if (i > 0) {
+      json.push_back(' ');
+    }
+    absl::StrAppend(&json, static_cast<int32_t>(token_counts[i]));
   }
-
- private:
-  std::string budget_key_;
-
-  // Number of days since epoch. The type of this field is a std::string instead
-  // of a TimeGroup or int to prevent expansive back and forth conversion
-  // between int and string
-  std::string timeframe_;
-};
+  json.append(R"("})");
+  return json;
+}
 
 class PbsBudgetKeyMutation {
  public:
-  void ResetTokenCount() {
-    token_count_ = std::vector<TokenCount>(kDefaultTokenCountSize);
-    token_count_.assign(kDefaultTokenCountSize, kDefaultPrivacyBudgetCount);
-  }
+  void ResetTokenCount() { token_count_.fill(kDefaultPrivacyBudgetCount); }
 
   std::tuple<cloud::Status, ExecutionResult> ResetFromSpannerValue(
       const spanner::Json& spanner_json) {
@@ -154,16 +187,18 @@ class PbsBudgetKeyMutation {
           FailureExecutionResult(SC_CONSUME_BUDGET_PARSING_ERROR));
     }
 
-    token_count_.clear();
-    if (auto execution_result = Serialization::DeserializeHourTokensInTimeGroup(
-            json_value[std::string(kTokenCountJsonField)], token_count_);
-        !execution_result.Successful()) {
+    const nlohmann::json& serialized_token_count =
+        json_value[std::string(kTokenCountJsonField)];
+    if (!serialized_token_count.is_string() ||
+        !DecodeLegacyTokenCounts(
+            serialized_token_count.get_ref<const std::string&>(),
+            token_count_)) {
       return std::make_tuple(
           cloud::Status(
               cloud::StatusCode::kInvalidArgument,
               absl::StrCat(
                   "Unable to DeserializeHourTokensInTimeGroup. Json value: ",
-                  std::string(json_value[std::string(kTokenCountJsonField)]))),
+                  serialized_token_count.dump())),
           FailureExecutionResult(SC_CONSUME_BUDGET_PARSING_ERROR));
     }
     return std::make_tuple(cloud::Status(), SuccessExecutionResult());
@@ -190,8 +225,6 @@ class PbsBudgetKeyMutation {
           FailureExecutionResult(SC_CONSUME_BUDGET_PARSING_ERROR));
     }
 
-    token_count_.clear();
-    token_count_.resize(kDefaultTokenCountSize);
     for (size_t i = 0; i < kDefaultTokenCountSize; ++i) {
       const int32_t budget = dp_budgets.budgets(i);
       if (budget != kEmptyBudgetCount &&
@@ -215,15 +248,14 @@ class PbsBudgetKeyMutation {
   std::tuple<cloud::Status, ExecutionResult, privacy_sandbox_pbs::BudgetValue>
   ToBudgetValue() const {
     privacy_sandbox_pbs::BudgetValue budget_value;
-    budget_value.mutable_laplace_dp_budgets()->mutable_budgets()->Reserve(
-        kDefaultTokenCountSize);
-
-    privacy_sandbox_pbs::BudgetValue::LaplaceDpBudgets* dp_budgets =
-        budget_value.mutable_laplace_dp_budgets();
-    for (const auto& token_count : token_count_) {
-      dp_budgets->add_budgets(token_count == kDefaultPrivacyBudgetCount
-                                  ? kDefaultLaplaceDpBudgetCount
-                                  : kEmptyBudgetCount);
+    google::protobuf::RepeatedField<int32_t>* dp_budgets =
+        budget_value.mutable_laplace_dp_budgets()->mutable_budgets();
+    dp_budgets->Resize(kDefaultTokenCountSize, kEmptyBudgetCount);
+    int32_t* dp_budget = dp_budgets->mutable_data();
+    for (TokenCount token_count : token_count_) {
+      *dp_budget++ = token_count == kDefaultPrivacyBudgetCount
+                         ? kDefaultLaplaceDpBudgetCount
+                         : kEmptyBudgetCount;
     }
     return std::make_tuple(cloud::Status(), SuccessExecutionResult(),
                            budget_value);
@@ -231,26 +263,12 @@ class PbsBudgetKeyMutation {
 
   std::tuple<cloud::Status, ExecutionResult, spanner::Json> ToSpannerJson()
       const {
-    std::string serialized_token_count;
-    if (auto execution_result = Serialization::SerializeHourTokensInTimeGroup(
-            token_count_, serialized_token_count);
-        !execution_result.Successful()) {
-      return std::make_tuple(
-          cloud::Status(
-              cloud::StatusCode::kInvalidArgument,
-              absl::StrCat(
-                  "Unable to SerializeHourTokensInTimeGroup. message: ",
-                  GetErrorMessage(execution_result.status_code))),
-          FailureExecutionResult(SC_CONSUME_BUDGET_PARSING_ERROR),
-          spanner::Json());
-    }
-
-    nlohmann::json json_value;
-    json_value[std::string(kTokenCountJsonField)] = serialized_token_count;
     return std::make_tuple(cloud::Status(), SuccessExecutionResult(),
-                           spanner::Json(json_value.dump()));
+                           spanner::Json(EncodeLegacyTokenCountJson(token_count_)));
   }
 
+  const HourTokenCounts& GetTokenCounts() const { return token_count_; }
+
   int32_t GetTokenCount(size_t hour) const { return token_count_[hour]; }
 
   void SetTokenCount(size_t hour, int32_t count) { token_count_[hour] = count; }
@@ -263,18 +281,40 @@ class PbsBudgetKeyMutation {
   // Whether mutation is a Spanner insert mutation or Spanner update mutation
   bool is_insertion_ = false;
 
-  // A vector with 24 integers, each represents an hour in a given day.
-  std::vector<TokenCount> token_count_;
+  // 24 integers, each represents an hour in a given day.
+  HourTokenCounts token_count_ = {};
 };
 
-spanner::KeySet CreateSpannerKeySet(
+PbsPrimaryKeyRef MakePbsPrimaryKey(const ConsumeBudgetMetadata& metadata) {
+  // GetTimeGroup returns the number of days since epoch
+  return PbsPrimaryKeyRef(
+      metadata.budget_key_name,
+      budget_key_timeframe_manager::Utils::GetTimeGroup(metadata.time_bucket));
+}
+
+std::vector<PbsPrimaryKeyRef> MakePbsPrimaryKeys(
     const std::vector<ConsumeBudgetMetadata>& budgets_metadata) {
-  spanner::KeySet spanner_key_set;
+  std::vector<PbsPrimaryKeyRef> primary_keys;
+  primary_keys.reserve(budgets_metadata.size());
   for (const ConsumeBudgetMetadata& metadata : budgets_metadata) {
-    spanner_key_set.AddKey(spanner::MakeKey(
-        *metadata.budget_key_name,
-        absl::StrCat(budget_key_timeframe_manager::Utils::GetTimeGroup(
-            metadata.time_bucket))));
+    primary_keys.push_back(MakePbsPrimaryKey(metadata));
+  }
+  return primary_keys;
+}
+
+spanner::KeySet CreateSpannerKeySet(
+    const std::vector<AsyncContext<ConsumeBudgetsRequest,
+                                   ConsumeBudgetsResponse>>&
+        consume_budgets_contexts) {
+  spanner::KeySet spanner_key_set;
+  for (const auto& consume_budgets_context : consume_budgets_contexts) {
+    for (const ConsumeBudgetMetadata& metadata :
+         consume_budgets_context.request->budgets) {
+      PbsPrimaryKeyRef primary_key = MakePbsPrimaryKey(metadata);
+      spanner_key_set.AddKey(
+          spanner::MakeKey(std::string(primary_key.budget_key()),
+                           primary_key.timeframe()));
+    }
   }
   return spanner_key_set;
 }
@@ -285,7 +325,9 @@ template <typename TokenMetadataType>
 std::tuple<cloud::Status, ExecutionResult> ReadPrivacyBudgetsForKeys(
     cloud::spanner::Client client, cloud::spanner::Transaction txn,
     const std::string& table_name, const cloud::spanner::KeySet& key_set,
-    absl::flat_hash_map<PbsPrimaryKey, PbsBudgetKeyMutation>& pbs_mutations) {
+    const absl::flat_hash_set<PbsPrimaryKeyRef>& requested_keys,
+    absl::flat_hash_map<PbsPrimaryKeyRef, PbsBudgetKeyMutation>& pbs_mutations,
+    absl::flat_hash_set<PbsPrimaryKeyRef>& unparsable_keys) {
   std::vector<std::string> columns = {std::string(kBudgetKeySpannerColumnName),
                                       std::string(kTimeframeSpannerColumnName)};
 
@@ -304,8 +346,13 @@ std::tuple<cloud::Status, ExecutionResult> ReadPrivacyBudgetsForKeys(
   spanner::RowStream returned_rows =
       client.Read(std::move(txn), table_name, std::move(key_set), columns);
 
+  std::tuple<cloud::Status, ExecutionResult> first_failure =
+      std::make_tuple(cloud::Status(), SuccessExecutionResult());
+
   for (const auto& row : cloud::spanner::StreamOf<RowType>(returned_rows)) {
     if (!row) {
+      // The read itself failed, which affects every key.
+      unparsable_keys.clear();
       return std::make_tuple(
           cloud::Status(cloud::StatusCode::kInvalidArgument,
                         absl::StrFormat(
@@ -317,8 +364,19 @@ std::tuple<cloud::Status, ExecutionResult> ReadPrivacyBudgetsForKeys(
       continue;
     }
 
-    PbsBudgetKeyMutation& pbs_mutation =
-        pbs_mutations[PbsPrimaryKey{std::get<0>(*row), std::get<1>(*row)}];
+    // The keys of the maps refer to the budget key names of the requests
+    // rather than to the row, which does not outlive this loop.
+    TimeGroup time_group = 0;
+    auto requested_key =
+        absl::SimpleAtoi(std::get<1>(*row), &time_group)
+            ? requested_keys.find(
+                  PbsPrimaryKeyRef(std::get<0>(*row), time_group))
+            : requested_keys.end();
+    if (requested_key == requested_keys.end()) {
+      continue;
+    }
+    const PbsPrimaryKeyRef& primary_key = *requested_key;
+    PbsBudgetKeyMutation& pbs_mutation = pbs_mutations[primary_key];
 
     std::tuple<cloud::Status, ExecutionResult> result;
     if constexpr (std::is_same_v<TokenMetadataTypeBaseT, spanner::Json>) {
@@ -328,24 +386,27 @@ std::tuple<cloud::Status, ExecutionResult> ReadPrivacyBudgetsForKeys(
           privacy_sandbox_pbs::BudgetValue(std::get<2>(*row)));
     }
     if (!std::get<1>(result)) {
-      return result;
+      // Keep reading so that a malformed row only fails the requests that
+      // touch it. The first parsing failure is reported to the caller.
+      pbs_mutations.erase(primary_key);
+      unparsable_keys.insert(primary_key);
+      if (std::get<1>(first_failure)) {
+        first_failure = result;
+      }
     }
   }
-  return std::make_tuple(cloud::Status(), SuccessExecutionResult());
+  return first_failure;
 }
 
 std::tuple<cloud::Status, ExecutionResult, std::vector<size_t>>
 UpdatePbsMutationsToConsumeBudgetsOrNotifyBudgetExhausted(
     const std::vector<ConsumeBudgetMetadata>& budgets_metadata,
-    absl::flat_hash_map<PbsPrimaryKey, PbsBudgetKeyMutation>& pbs_mutations) {
+    absl::flat_hash_map<PbsPrimaryKeyRef, PbsBudgetKeyMutation>&
+        pbs_mutations) {
   std::vector<size_t> budget_exhausted_indices;
   for (size_t i = 0; i < budgets_metadata.size(); ++i) {
     const ConsumeBudgetMetadata& metadata = budgets_metadata[i];
-    // GetTimeGroup returns the number of days since epoch
-    PbsPrimaryKey primary_key{
-        *metadata.budget_key_name,
-        absl::StrCat(budget_key_timeframe_manager::Utils::GetTimeGroup(
-            metadata.time_bucket))};
+    PbsPrimaryKeyRef primary_key = MakePbsPrimaryKey(metadata);
 
     auto [pbs_mutation, inserted] =
         pbs_mutations.insert({primary_key, PbsBudgetKeyMutation()});
@@ -381,8 +442,38 @@ UpdatePbsMutationsToConsumeBudgetsOrNotifyBudgetExhausted(
                          budget_exhausted_indices);
 }
 
+// Returns the budgets of budgets_metadata to the stored budgets, without going
+// beyond the initial budget of an hour. Budgets that are not stored have never
+// been consumed and are left untouched.
+void UpdatePbsMutationsToReturnBudgets(
+    const std::vector<ConsumeBudgetMetadata>& budgets_metadata,
+    const absl::flat_hash_map<PbsPrimaryKeyRef, PbsBudgetKeyMutation>&
+        stored_budgets,
+    absl::flat_hash_map<PbsPrimaryKeyRef, PbsBudgetKeyMutation>&
+        pbs_mutations) {
+  for (const ConsumeBudgetMetadata& metadata : budgets_metadata) {
+    PbsPrimaryKeyRef primary_key = MakePbsPrimaryKey(metadata);
+    auto stored_budget = stored_budgets.find(primary_key);
+    if (stored_budget == stored_budgets.end()) {
+      continue;
+    }
+    PbsBudgetKeyMutation& pbs_mutation =
+        pbs_mutations.try_emplace(primary_key, stored_budget->second)
+            .first->second;
+
+    TimeBucket hours_of_the_day =
+        budget_key_timeframe_manager::Utils::GetTimeBucket(
+            metadata.time_bucket);
+    pbs_mutation.SetTokenCount(
+        hours_of_the_day,
+        std::min<int32_t>(pbs_mutation.GetTokenCount(hours_of_the_day) +
+                              metadata.token_count,
+                          kDefaultPrivacyBudgetCount));
+  }
+}
+
 std::tuple<cloud::Status, ExecutionResult> CreateSpannerMutations(
-    const absl::flat_hash_map<PbsPrimaryKey, PbsBudgetKeyMutation>&
+    const absl::flat_hash_map<PbsPrimaryKeyRef, PbsBudgetKeyMutation>&
         pbs_mutations,
     absl::string_view table_name, bool enable_write_to_value_column,
     bool enable_write_to_value_proto_column, spanner::Mutations& mutations) {
@@ -405,8 +496,9 @@ std::tuple<cloud::Status, ExecutionResult> CreateSpannerMutations(
   bool has_update = false;
 
   for (const auto& [pbs_key, pbs_mutation] : pbs_mutations) {
-    std::vector<spanner::Value> values = {spanner::Value(pbs_key.budget_key()),
-                                          spanner::Value(pbs_key.timeframe())};
+    std::vector<spanner::Value> values = {
+        spanner::Value(std::string(pbs_key.budget_key())),
+        spanner::Value(pbs_key.timeframe())};
 
     if (enable_write_to_value_column) {
       auto [status, execution_result, json] = pbs_mutation.ToSpannerJson();
@@ -440,35 +532,91 @@ std::tuple<cloud::Status, ExecutionResult> CreateSpannerMutations(
   }
   return std::make_tuple(cloud::Status(), SuccessExecutionResult());
 }
+
+std::vector<size_t> GetKnownExhaustedIndices(
+    BudgetKeyCache& budget_key_cache,
+    const std::vector<ConsumeBudgetMetadata>& budgets_metadata) {
+  const Timestamp now =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  std::vector<size_t> budget_exhausted_indices;
+  for (size_t i = 0; i < budgets_metadata.size(); ++i) {
+    const ConsumeBudgetMetadata& metadata = budgets_metadata[i];
+    if (budget_key_cache.IsKnownExhausted(
+            MakePbsPrimaryKey(metadata),
+            budget_key_timeframe_manager::Utils::GetTimeBucket(
+                metadata.time_bucket),
+            metadata.token_count, now)) {
+      budget_exhausted_indices.push_back(i);
+    }
+  }
+  return budget_exhausted_indices;
+}
+
+// Stores the budgets observed by the latest transaction attempt in the cache.
+// Budgets of a committed transaction are versioned with its commit timestamp.
+// Budgets read by a transaction that did not commit are still valid
+// observations of which hours are exhausted.
+void UpdateBudgetKeyCache(
+    BudgetKeyCache& budget_key_cache, BudgetKeyCache::Observation observation,
+    const cloud::StatusOr<spanner::CommitResult>& commit_result,
+    const absl::flat_hash_map<PbsPrimaryKeyRef, PbsBudgetKeyMutation>&
+        stored_budgets,
+    const absl::flat_hash_map<PbsPrimaryKeyRef, PbsBudgetKeyMutation>&
+        pbs_mutations) {
+  Timestamp version = BudgetKeyCache::kUnknownVersion;
+  if (commit_result) {
+    if (auto commit_time = commit_result->commit_timestamp.get<absl::Time>();
+        commit_time) {
+      version = absl::ToUnixNanos(*commit_time);
+    }
+    for (const auto& [pbs_key, pbs_mutation] : pbs_mutations) {
+      budget_key_cache.Update(pbs_key, pbs_mutation.GetTokenCounts(), version,
+                              observation);
+    }
+  }
+  for (const auto& [pbs_key, stored_budget] : stored_budgets) {
+    if (!commit_result || !pbs_mutations.contains(pbs_key)) {
+      budget_key_cache.Update(pbs_key, stored_budget.GetTokenCounts(), version,
+                              observation);
+    }
+  }
+}
 }  // namespace
 
 BudgetConsumptionHelper::BudgetConsumptionHelper(
     ConfigProviderInterface* config_provider,
     AsyncExecutorInterface* async_executor,
     AsyncExecutorInterface* io_async_executor,
-    std::shared_ptr<spanner::Connection> spanner_connection)
+    std::shared_ptr<spanner::Connection> spanner_connection,
+    std::string table_name)
     : config_provider_(config_provider),
       async_executor_(async_executor),
       io_async_executor_(io_async_executor),
-      spanner_connection_(std::move(spanner_connection)) {}
+      spanner_connection_(std::move(spanner_connection)),
+      table_name_(std::move(table_name)) {}
 
 ExecutionResultOr<std::shared_ptr<cloud::spanner::Connection>>
 BudgetConsumptionHelper::MakeSpannerConnectionForProd(
     ConfigProviderInterface& config_provider) {
-  std::string project;
-  if (auto execution_result = config_provider.Get(kGcpProjectId, project);
+  std::string database;
+  if (auto execution_result = config_provider.Get(kSpannerDatabase, database);
       !execution_result.Successful()) {
     return execution_result;
   }
+  return MakeSpannerConnectionForProd(config_provider, database);
+}
 
-  std::string instance;
-  if (auto execution_result = config_provider.Get(kSpannerInstance, instance);
+ExecutionResultOr<std::shared_ptr<cloud::spanner::Connection>>
+BudgetConsumptionHelper::MakeSpannerConnectionForProd(
+    ConfigProviderInterface& config_provider, const std::string& database) {
+  std::string project;
+  if (auto execution_result = config_provider.Get(kGcpProjectId, project);
       !execution_result.Successful()) {
     return execution_result;
   }
 
-  std::string database;
-  if (auto execution_result = config_provider.Get(kSpannerDatabase, database);
+  std::string instance;
+  if (auto execution_result = config_provider.Get(kSpannerInstance, instance);
       !execution_result.Successful()) {
     return execution_result;
   }
@@ -490,10 +638,12 @@ ExecutionResult BudgetConsumptionHelper::Init() noexcept {
   if (!spanner_connection_) {
     return FailureExecutionResult(SC_CONSUME_BUDGET_INITIALIZATION_ERROR);
   }
-  if (auto execution_result =
-          config_provider_->Get(kBudgetKeyTableName, table_name_);
-      execution_result != SuccessExecutionResult()) {
-    return execution_result;
+  if (table_name_.empty()) {
+    if (auto execution_result =
+            config_provider_->Get(kBudgetKeyTableName, table_name_);
+        execution_result != SuccessExecutionResult()) {
+      return execution_result;
+    }
   }
 
   std::string pbs_value_column_migration_phase = std::string(kMigrationPhase1);
@@ -518,6 +668,55 @@ ExecutionResult BudgetConsumptionHelper::Init() noexcept {
       pbs_value_column_migration_phase == kMigrationPhase1 ||
       pbs_value_column_migration_phase == kMigrationPhase2;
 
+  size_t group_commit_max_batch_size = kDefaultGroupCommitMaxBatchSize;
+  config_provider_->Get(kBudgetConsumptionGroupCommitMaxBatchSize,
+                        group_commit_max_batch_size);
+  if (group_commit_max_batch_size == 0) {
+    return FailureExecutionResult(SC_CONSUME_BUDGET_INVALID_CONFIGURATION);
+  }
+  group_commit_max_batch_size_ = group_commit_max_batch_size;
+
+  size_t group_commit_max_linger_ms = kDefaultGroupCommitMaxLingerMs;
+  config_provider_->Get(kBudgetConsumptionGroupCommitMaxLingerMs,
+                        group_commit_max_linger_ms);
+  group_commit_max_linger_ =
+      std::chrono::milliseconds(group_commit_max_linger_ms);
+
+  // The pending contexts are bounded like the queue of the io executor that
+  // flushes them, unless configured otherwise.
+  size_t group_commit_max_pending_count = kDefaultGroupCommitMaxPendingCount;
+  config_provider_->Get(kIOAsyncExecutorQueueSize,
+                        group_commit_max_pending_count);
+  config_provider_->Get(kBudgetConsumptionGroupCommitMaxPendingCount,
+                        group_commit_max_pending_count);
+  if (group_commit_max_pending_count == 0) {
+    return FailureExecutionResult(SC_CONSUME_BUDGET_INVALID_CONFIGURATION);
+  }
+  group_commit_max_pending_count_ = group_commit_max_pending_count;
+
+  size_t budget_key_cache_max_entries = kDefaultBudgetKeyCacheMaxEntries;
+  config_provider_->Get(kBudgetConsumptionCacheMaxEntries,
+                        budget_key_cache_max_entries);
+  // With several budget tables, the budgets of a request consumed in some of
+  // them are returned when the others fail. The caches of the other replicas
+  // cannot observe the returns, so the cache is only used with a single table.
+  std::list<std::string> budget_key_table_shards;
+  config_provider_->Get(kBudgetKeyTableShards, budget_key_table_shards);
+  if (budget_key_cache_max_entries > 0 && !budget_key_table_shards.empty()) {
+    SCP_INFO(kComponentName, google::scp::core::common::kZeroUuid,
+             "The budget key cache is disabled since the budget keys are "
+             "sharded across tables.");
+    budget_key_cache_max_entries = 0;
+  }
+  size_t budget_key_cache_max_age_ms = kDefaultBudgetKeyCacheMaxAgeMs;
+  config_provider_->Get(kBudgetConsumptionCacheMaxAgeMs,
+                        budget_key_cache_max_age_ms);
+  if (budget_key_cache_max_entries > 0) {
+    budget_key_cache_ = std::make_unique<BudgetKeyCache>(
+        budget_key_cache_max_entries,
+        std::chrono::milliseconds(budget_key_cache_max_age_ms));
+  }
+
   return SuccessExecutionResult();
 }
 
@@ -534,9 +733,25 @@ ExecutionResult BudgetConsumptionHelper::ConsumeBudgets(
         consume_budgets_context) {
   // TODO: Check that request is not empty.
   // Return invalid argument
+  if (budget_key_cache_) {
+    // The cache only knows about a subset of the keys, so only the indices of
+    // the budgets known to be exhausted are reported.
+    if (std::vector<size_t> budget_exhausted_indices = GetKnownExhaustedIndices(
+            *budget_key_cache_, consume_budgets_context.request->budgets);
+        !budget_exhausted_indices.empty()) {
+      return FinishWithKnownExhaustedBudgets(
+          std::move(consume_budgets_context),
+          std::move(budget_exhausted_indices));
+    }
+  }
+
+  if (group_commit_max_batch_size_ > 1) {
+    return EnqueueForGroupCommit(std::move(consume_budgets_context));
+  }
+
   if (auto schedule_result = io_async_executor_->Schedule(
           [this, consume_budgets_context]() {
-            ConsumeBudgetsSyncAndFinishContext(consume_budgets_context);
+            ConsumeBudgetsSyncAndFinishContexts({consume_budgets_context});
           },
           google::scp::core::AsyncPriority::Normal);
       !schedule_result.Successful()) {
@@ -547,57 +762,314 @@ ExecutionResult BudgetConsumptionHelper::ConsumeBudgets(
   return SuccessExecutionResult();
 }
 
-void BudgetConsumptionHelper::ConsumeBudgetsSyncAndFinishContext(
+ExecutionResult BudgetConsumptionHelper::ReturnBudgets(
     AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
         consume_budgets_context) {
-  consume_budgets_context.result = ConsumeBudgetsSync(consume_budgets_context);
-  if (!async_executor_->Schedule(
-          [consume_budgets_context]() mutable {
-            consume_budgets_context.Finish();
+  if (auto schedule_result = io_async_executor_->Schedule(
+          [this, consume_budgets_context]() mutable {
+            ReturnBudgetsSync(consume_budgets_context);
+            if (!async_executor_->Schedule(
+                    [consume_budgets_context]() mutable {
+                      consume_budgets_context.Finish();
+                    },
+                    google::scp::core::AsyncPriority::Normal)) {
+              consume_budgets_context.Finish();
+            }
           },
-          google::scp::core::AsyncPriority::Normal)) {
-    consume_budgets_context.Finish();
+          google::scp::core::AsyncPriority::Normal);
+      !schedule_result.Successful()) {
+    // Nothing was returned, the caller decides how to compensate.
+    return schedule_result;
   }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult BudgetConsumptionHelper::FinishWithKnownExhaustedBudgets(
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
+        consume_budgets_context,
+    std::vector<size_t> budget_exhausted_indices) {
+  consume_budgets_context.response->budget_exhausted_indices =
+      std::move(budget_exhausted_indices);
+  consume_budgets_context.result =
+      FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED);
+  SCP_WARNING_CONTEXT(
+      kComponentName, consume_budgets_context,
+      absl::StrFormat("ConsumeBudgets failed without reaching the database. "
+                      "%d budgets are known to be exhausted.",
+                      consume_budgets_context.response
+                          ->budget_exhausted_indices.size()));
+  return async_executor_->Schedule(
+      [consume_budgets_context]() mutable { consume_budgets_context.Finish(); },
+      google::scp::core::AsyncPriority::Normal);
 }
 
-ExecutionResult BudgetConsumptionHelper::ConsumeBudgetsSync(
-    const AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&
+ExecutionResult BudgetConsumptionHelper::EnqueueForGroupCommit(
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
         consume_budgets_context) {
+  std::vector<PbsPrimaryKeyRef> keys =
+      MakePbsPrimaryKeys(consume_budgets_context.request->budgets);
+
+  std::unique_lock lock(group_commit_mutex_);
+  if (group_commit_pending_count_ >= group_commit_max_pending_count_) {
+    return RetryExecutionResult(SC_CONSUME_BUDGET_GROUP_COMMIT_QUEUE_FULL);
+  }
+
+  // A context sharing a budget key with a queued context is carried forward
+  // to a later batch, since both would otherwise consume from the same
+  // snapshot of the row.
+  uint64_t batch = group_commit_first_batch_;
+  for (const PbsPrimaryKeyRef& key : keys) {
+    if (auto last_batch = group_commit_last_batch_of_key_.find(key);
+        last_batch != group_commit_last_batch_of_key_.end()) {
+      batch = std::max(batch, last_batch->second + 1);
+    }
+  }
+  while (batch - group_commit_first_batch_ < group_commit_batches_.size() &&
+         group_commit_batches_[batch - group_commit_first_batch_].size() >=
+             group_commit_max_batch_size_) {
+    ++batch;
+  }
+  if (batch - group_commit_first_batch_ >= group_commit_batches_.size()) {
+    group_commit_batches_.resize(batch - group_commit_first_batch_ + 1);
+  }
+  auto& batch_contexts =
+      group_commit_batches_[batch - group_commit_first_batch_];
+  batch_contexts.push_back(std::move(consume_budgets_context));
+  ++group_commit_pending_count_;
+  // The previous last batches of the keys, to undo the insertion.
+  std::vector<std::optional<uint64_t>> previous_last_batches;
+  previous_last_batches.reserve(keys.size());
+  for (const PbsPrimaryKeyRef& key : keys) {
+    auto [last_batch, inserted] =
+        group_commit_last_batch_of_key_.try_emplace(PbsPrimaryKey(key), batch);
+    previous_last_batches.push_back(
+        inserted ? std::nullopt : std::make_optional(last_batch->second));
+    last_batch->second = batch;
+  }
+
+  const bool is_first_batch_full =
+      group_commit_batches_.front().size() >= group_commit_max_batch_size_;
+  if (group_commit_flush_scheduled_) {
+    // A full batch does not need to wait for the pending flush to linger. If
+    // the early flush cannot be scheduled, the pending flush picks it up.
+    if (batch_contexts.size() == group_commit_max_batch_size_) {
+      ScheduleGroupCommitFlush();
+    }
+    return SuccessExecutionResult();
+  }
+
+  ExecutionResult schedule_result;
+  if (is_first_batch_full || group_commit_max_linger_.count() == 0) {
+    schedule_result = ScheduleGroupCommitFlush();
+  } else {
+    Timestamp flush_timestamp =
+        TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() +
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            group_commit_max_linger_)
+            .count();
+    // ScheduleFor runs on the urgent pool, which must not be blocked by the
+    // Spanner commit, so the flush itself is scheduled as a normal task.
+    schedule_result = io_async_executor_->ScheduleFor(
+        [this]() {
+          if (!ScheduleGroupCommitFlush().Successful()) {
+            FlushGroupCommitQueue();
+          }
+        },
+        flush_timestamp);
+  }
+
+  if (!schedule_result.Successful()) {
+    // Returns the execution result to the caller without calling FinishContext,
+    // since the async task is not scheduled successfully
+    // In reverse order, since a key may appear more than once.
+    for (size_t i = keys.size(); i-- > 0;) {
+      if (previous_last_batches[i]) {
+        group_commit_last_batch_of_key_.find(keys[i])->second =
+            *previous_last_batches[i];
+      } else {
+        group_commit_last_batch_of_key_.erase(keys[i]);
+      }
+    }
+    batch_contexts.pop_back();
+    --group_commit_pending_count_;
+    if (batch_contexts.empty() &&
+        batch - group_commit_first_batch_ + 1 == group_commit_batches_.size()) {
+      group_commit_batches_.pop_back();
+    }
+    return schedule_result;
+  }
+  group_commit_flush_scheduled_ = true;
+  return SuccessExecutionResult();
+}
+
+ExecutionResult BudgetConsumptionHelper::ScheduleGroupCommitFlush() {
+  return io_async_executor_->Schedule([this]() { FlushGroupCommitQueue(); },
+                                      google::scp::core::AsyncPriority::Normal);
+}
+
+void BudgetConsumptionHelper::FlushGroupCommitQueue() {
+  while (true) {
+    std::vector<AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>>
+        batch;
+    bool flush_rescheduled = true;
+    {
+      std::unique_lock lock(group_commit_mutex_);
+      if (!group_commit_batches_.empty()) {
+        batch = std::move(group_commit_batches_.front());
+        group_commit_batches_.pop_front();
+        for (const auto& consume_budgets_context : batch) {
+          for (const ConsumeBudgetMetadata& metadata :
+               consume_budgets_context.request->budgets) {
+            if (auto last_batch = group_commit_last_batch_of_key_.find(
+                    MakePbsPrimaryKey(metadata));
+                last_batch != group_commit_last_batch_of_key_.end() &&
+                last_batch->second == group_commit_first_batch_) {
+              group_commit_last_batch_of_key_.erase(last_batch);
+            }
+          }
+        }
+        ++group_commit_first_batch_;
+        group_commit_pending_count_ -= batch.size();
+      }
+
+      group_commit_flush_scheduled_ = false;
+      if (!group_commit_batches_.empty()) {
+        flush_rescheduled = ScheduleGroupCommitFlush().Successful();
+        group_commit_flush_scheduled_ = flush_rescheduled;
+      }
+    }
+
+    if (!batch.empty()) {
+      ConsumeBudgetsSyncAndFinishContexts(std::move(batch));
+    }
+    // Keep draining on this thread if no other flush could be scheduled, so
+    // that no context is left behind in the queue.
+    if (flush_rescheduled) {
+      return;
+    }
+  }
+}
+
+void BudgetConsumptionHelper::ConsumeBudgetsSyncAndFinishContexts(
+    std::vector<AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>>
+        consume_budgets_contexts) {
+  ConsumeBudgetsSync(consume_budgets_contexts);
+  for (auto& consume_budgets_context : consume_budgets_contexts) {
+    if (!async_executor_->Schedule(
+            [consume_budgets_context]() mutable {
+              consume_budgets_context.Finish();
+            },
+            google::scp::core::AsyncPriority::Normal)) {
+      consume_budgets_context.Finish();
+    }
+  }
+}
+
+void BudgetConsumptionHelper::ConsumeBudgetsSync(
+    std::vector<AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>>&
+        consume_budgets_contexts) {
+  const size_t contexts_count = consume_budgets_contexts.size();
   spanner::Client client(spanner_connection_);
-  ExecutionResult captured_execution_result = SuccessExecutionResult();
-  std::vector<size_t> captured_budget_exhausted_indices;
+  // The outcome of each context in the latest transaction attempt.
+  std::vector<cloud::Status> captured_statuses(contexts_count);
+  std::vector<ExecutionResult> captured_execution_results(
+      contexts_count, SuccessExecutionResult());
+  std::vector<std::vector<size_t>> captured_budget_exhausted_indices(
+      contexts_count);
+  // Budgets read and written by the latest transaction attempt.
+  absl::flat_hash_map<PbsPrimaryKeyRef, PbsBudgetKeyMutation> stored_budgets;
+  absl::flat_hash_map<PbsPrimaryKeyRef, PbsBudgetKeyMutation> pbs_mutations;
+  absl::flat_hash_set<PbsPrimaryKeyRef> requested_keys;
+  for (const auto& consume_budgets_context : consume_budgets_contexts) {
+    for (const ConsumeBudgetMetadata& metadata :
+         consume_budgets_context.request->budgets) {
+      requested_keys.insert(MakePbsPrimaryKey(metadata));
+    }
+  }
+  const BudgetKeyCache::Observation observation =
+      budget_key_cache_
+          ? budget_key_cache_->StartObservation(
+                TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks())
+          : BudgetKeyCache::Observation{};
   auto commit_result = client.Commit(
       [&](spanner::Transaction txn) -> cloud::StatusOr<spanner::Mutations> {
-        spanner::KeySet spanner_key_set =
-            CreateSpannerKeySet(consume_budgets_context.request->budgets);
+        captured_statuses.assign(contexts_count, cloud::Status());
+        captured_execution_results.assign(contexts_count,
+                                          SuccessExecutionResult());
+        captured_budget_exhausted_indices.assign(contexts_count, {});
 
-        absl::flat_hash_map<PbsPrimaryKey, PbsBudgetKeyMutation> pbs_mutations;
+        spanner::KeySet spanner_key_set =
+            CreateSpannerKeySet(consume_budgets_contexts);
+
+        stored_budgets.clear();
+        pbs_mutations.clear();
+        absl::flat_hash_set<PbsPrimaryKeyRef> unparsable_keys;
+        auto [read_status, read_execution_result] =
+            enable_read_truth_from_value_column_
+                ? ReadPrivacyBudgetsForKeys<spanner::Json>(
+                      client, txn, table_name_, spanner_key_set,
+                      requested_keys, stored_budgets, unparsable_keys)
+                : ReadPrivacyBudgetsForKeys<privacy_sandbox_pbs::BudgetValue>(
+                      client, txn, table_name_, spanner_key_set,
+                      requested_keys, stored_budgets, unparsable_keys);
+        if (!read_status.ok() && unparsable_keys.empty()) {
+          captured_statuses.assign(contexts_count, read_status);
+          captured_execution_results.assign(contexts_count,
+                                            read_execution_result);
+          return read_status;
+        }
 
-        if (enable_read_truth_from_value_column_) {
-          if (auto [status, execution_result] =
-                  ReadPrivacyBudgetsForKeys<spanner::Json>(
-                      client, txn, table_name_, spanner_key_set, pbs_mutations);
-              !status.ok()) {
-            captured_execution_result = execution_result;
-            return status;
+        // Each context consumes its budgets in isolation so that a context
+        // without enough budget does not fail the rest of the batch.
+        cloud::Status first_failure_status;
+        size_t successful_contexts_count = 0;
+        for (size_t i = 0; i < contexts_count; ++i) {
+          const std::vector<ConsumeBudgetMetadata>& budgets_metadata =
+              consume_budgets_contexts[i].request->budgets;
+          absl::flat_hash_map<PbsPrimaryKeyRef, PbsBudgetKeyMutation>
+              context_mutations;
+          bool has_unparsable_key = false;
+          for (const PbsPrimaryKeyRef& primary_key :
+               MakePbsPrimaryKeys(budgets_metadata)) {
+            if (unparsable_keys.contains(primary_key)) {
+              has_unparsable_key = true;
+              break;
+            }
+            if (auto stored_budget = stored_budgets.find(primary_key);
+                stored_budget != stored_budgets.end()) {
+              context_mutations.insert(*stored_budget);
+            }
+          }
+          if (has_unparsable_key) {
+            captured_statuses[i] = read_status;
+            captured_execution_results[i] = read_execution_result;
+            if (first_failure_status.ok()) {
+              first_failure_status = read_status;
+            }
+            continue;
           }
-        } else {
-          if (auto [status, execution_result] =
-                  ReadPrivacyBudgetsForKeys<privacy_sandbox_pbs::BudgetValue>(
-                      client, txn, table_name_, spanner_key_set, pbs_mutations);
+
+          if (auto [status, execution_result, budget_exhausted_indices] =
+                  UpdatePbsMutationsToConsumeBudgetsOrNotifyBudgetExhausted(
+                      budgets_metadata, context_mutations);
               !status.ok()) {
-            captured_execution_result = execution_result;
-            return status;
+            captured_statuses[i] = status;
+            captured_execution_results[i] = execution_result;
+            captured_budget_exhausted_indices[i] =
+                std::move(budget_exhausted_indices);
+            if (first_failure_status.ok()) {
+              first_failure_status = status;
+            }
+            continue;
           }
+          pbs_mutations.insert(std::make_move_iterator(context_mutations.begin()),
+                               std::make_move_iterator(context_mutations.end()));
+          ++successful_contexts_count;
         }
 
-        if (auto [status, execution_result, budget_exhausted_indices] =
-                UpdatePbsMutationsToConsumeBudgetsOrNotifyBudgetExhausted(
-                    consume_budgets_context.request->budgets, pbs_mutations);
-            !status.ok()) {
-          captured_execution_result = execution_result;
-          captured_budget_exhausted_indices = budget_exhausted_indices;
-          return status;
+        // Nothing to write, the transaction is rolled back.
+        if (successful_contexts_count == 0) {
+          return first_failure_status;
         }
 
         spanner::Mutations mutations;
@@ -605,16 +1077,35 @@ ExecutionResult BudgetConsumptionHelper::ConsumeBudgetsSync(
                 pbs_mutations, table_name_, enable_write_to_value_column_,
                 enable_write_to_value_proto_column_, mutations);
             !status.ok()) {
-          captured_execution_result = execution_result;
+          for (size_t i = 0; i < contexts_count; ++i) {
+            if (captured_execution_results[i].Successful()) {
+              captured_statuses[i] = status;
+              captured_execution_results[i] = execution_result;
+            }
+          }
           return status;
         }
         return mutations;
       });
 
-  if (!commit_result) {
+  if (budget_key_cache_) {
+    UpdateBudgetKeyCache(*budget_key_cache_, observation, commit_result,
+                         stored_budgets, pbs_mutations);
+  }
+
+  for (size_t i = 0; i < contexts_count; ++i) {
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&
+        consume_budgets_context = consume_budgets_contexts[i];
+    const ExecutionResult& captured_execution_result =
+        captured_execution_results[i];
+    if (commit_result && captured_execution_result.Successful()) {
+      consume_budgets_context.result = SuccessExecutionResult();
+      continue;
+    }
+
     if (captured_execution_result.status_code == SC_CONSUME_BUDGET_EXHAUSTED) {
       consume_budgets_context.response->budget_exhausted_indices =
-          captured_budget_exhausted_indices;
+          captured_budget_exhausted_indices[i];
     }
 
     // If the error status is coming from PBS's application logics, the
@@ -626,24 +1117,99 @@ ExecutionResult BudgetConsumptionHelper::ConsumeBudgetsSync(
         !captured_execution_result.Successful()
             ? captured_execution_result
             : FailureExecutionResult(SC_CONSUME_BUDGET_FAIL_TO_COMMIT);
+    const cloud::Status& final_status = !captured_statuses[i].ok()
+                                            ? captured_statuses[i]
+                                            : commit_result.status();
     if (captured_execution_result.status_code == SC_CONSUME_BUDGET_EXHAUSTED) {
       SCP_WARNING_CONTEXT(
           kComponentName, consume_budgets_context,
           absl::StrFormat("ConsumeBudgets failed. Error code %d, message: %s, "
                           "final_execution_result: %s",
-                          commit_result.status().code(),
-                          commit_result.status().message(),
+                          final_status.code(), final_status.message(),
                           google::scp::core::errors::GetErrorMessage(
                               final_execution_result.status_code)));
     } else {
       SCP_ERROR_CONTEXT(
           kComponentName, consume_budgets_context, final_execution_result,
           absl::StrFormat("ConsumeBudgets failed. Error code %d, message: %s",
-                          commit_result.status().code(),
-                          commit_result.status().message()));
+                          final_status.code(), final_status.message()));
     }
-    return final_execution_result;
+    consume_budgets_context.result = final_execution_result;
   }
-  return SuccessExecutionResult();
+}
+
+void BudgetConsumptionHelper::ReturnBudgetsSync(
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&
+        consume_budgets_context) {
+  spanner::Client client(spanner_connection_);
+  std::vector<AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>>
+      consume_budgets_contexts = {consume_budgets_context};
+  ExecutionResult captured_execution_result = SuccessExecutionResult();
+  absl::flat_hash_map<PbsPrimaryKeyRef, PbsBudgetKeyMutation> stored_budgets;
+  absl::flat_hash_map<PbsPrimaryKeyRef, PbsBudgetKeyMutation> pbs_mutations;
+  absl::flat_hash_set<PbsPrimaryKeyRef> requested_keys;
+  for (const ConsumeBudgetMetadata& metadata :
+       consume_budgets_context.request->budgets) {
+    requested_keys.insert(MakePbsPrimaryKey(metadata));
+  }
+  auto commit_result = client.Commit(
+      [&](spanner::Transaction txn) -> cloud::StatusOr<spanner::Mutations> {
+        captured_execution_result = SuccessExecutionResult();
+        stored_budgets.clear();
+        pbs_mutations.clear();
+        absl::flat_hash_set<PbsPrimaryKeyRef> unparsable_keys;
+        auto [read_status, read_execution_result] =
+            enable_read_truth_from_value_column_
+                ? ReadPrivacyBudgetsForKeys<spanner::Json>(
+                      client, txn, table_name_,
+                      CreateSpannerKeySet(consume_budgets_contexts),
+                      requested_keys, stored_budgets, unparsable_keys)
+                : ReadPrivacyBudgetsForKeys<privacy_sandbox_pbs::BudgetValue>(
+                      client, txn, table_name_,
+                      CreateSpannerKeySet(consume_budgets_contexts),
+                      requested_keys, stored_budgets, unparsable_keys);
+        if (!read_status.ok()) {
+          captured_execution_result = read_execution_result;
+          return read_status;
+        }
+
+        UpdatePbsMutationsToReturnBudgets(
+            consume_budgets_context.request->budgets, stored_budgets,
+            pbs_mutations);
+        spanner::Mutations mutations;
+        if (auto [status, execution_result] = CreateSpannerMutations(
+                pbs_mutations, table_name_, enable_write_to_value_column_,
+                enable_write_to_value_proto_column_, mutations);
+            !status.ok()) {
+          captured_execution_result = execution_result;
+          return status;
+        }
+        return mutations;
+      });
+
+  if (budget_key_cache_) {
+    // Budgets read by consumptions that raced with this return may be lower
+    // than the returned ones, so the keys are dropped instead of updated. This
+    // is also done if the commit failed, since its outcome may be unknown.
+    // The caches of the other replicas are not reached, which is why the
+    // cache is disabled when budgets are returned, i.e. with sharded tables.
+    for (const PbsPrimaryKeyRef& primary_key : requested_keys) {
+      budget_key_cache_->Invalidate(primary_key);
+    }
+  }
+
+  if (commit_result) {
+    consume_budgets_context.result = SuccessExecutionResult();
+    return;
+  }
+  consume_budgets_context.result =
+      !captured_execution_result.Successful()
+          ? captured_execution_result
+          : FailureExecutionResult(SC_CONSUME_BUDGET_FAIL_TO_COMMIT);
+  SCP_ERROR_CONTEXT(
+      kComponentName, consume_budgets_context, consume_budgets_context.result,
+      absl::StrFormat("ReturnBudgets failed. Error code %d, message: %s",
+                      commit_result.status().code(),
+                      commit_result.status().message()));
 }
 }  // namespace google::scp::pbs
@@ -14,11 +14,19 @@
 #ifndef CC_PBS_CONSUME_BUDGET_SRC_GCP_CONSUME_BUDGET_H_
 #define CC_PBS_CONSUME_BUDGET_SRC_GCP_CONSUME_BUDGET_H_
 
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/config_provider_interface.h"
+#include "cc/pbs/consume_budget/src/gcp/budget_key_cache.h"
+#include "cc/pbs/consume_budget/src/gcp/pbs_primary_key.h"
 #include "cc/pbs/interface/consume_budget_interface.h"
 #include "cc/public/core/interface/execution_result.h"
 #include "google/cloud/spanner/connection.h"
@@ -29,11 +37,14 @@ namespace google::scp::pbs {
 // keys by writing to GCP Spanner.
 class BudgetConsumptionHelper : public BudgetConsumptionHelperInterface {
  public:
+  // The budgets are stored in table_name, or in the table configured by
+  // kBudgetKeyTableName if table_name is empty.
   BudgetConsumptionHelper(
       google::scp::core::ConfigProviderInterface* config_provider,
       google::scp::core::AsyncExecutorInterface* async_executor,
       google::scp::core::AsyncExecutorInterface* io_async_executor,
-      std::shared_ptr<cloud::spanner::Connection> spanner_connection);
+      std::shared_ptr<cloud::spanner::Connection> spanner_connection,
+      std::string table_name = "");
 
   google::scp::core::ExecutionResult Init() noexcept override;
 
@@ -48,20 +59,75 @@ class BudgetConsumptionHelper : public BudgetConsumptionHelperInterface {
                                       ConsumeBudgetsResponse>
           consume_budgets_context) override;
 
+  // Returns the budgets of consume_budgets_context, which were consumed by a
+  // successful ConsumeBudgets call with the same request. This compensates a
+  // consumption that must be undone. Budgets are never returned beyond their
+  // initial value. Only the budget key cache of this process is invalidated,
+  // so the cache must be disabled if other processes consume the same
+  // budgets.
+  google::scp::core::ExecutionResult ReturnBudgets(
+      google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                      ConsumeBudgetsResponse>
+          consume_budgets_context);
+
   static google::scp::core::ExecutionResultOr<
       std::shared_ptr<cloud::spanner::Connection>>
   MakeSpannerConnectionForProd(
       google::scp::core::ConfigProviderInterface& config_provider);
 
+  // Same as above, for the given database of the configured Spanner instance.
+  static google::scp::core::ExecutionResultOr<
+      std::shared_ptr<cloud::spanner::Connection>>
+  MakeSpannerConnectionForProd(
+      google::scp::core::ConfigProviderInterface& config_provider,
+      const std::string& database);
+
  private:
-  void ConsumeBudgetsSyncAndFinishContext(
+  // Fails the context with the given exhausted indices without reaching the
+  // database.
+  google::scp::core::ExecutionResult FinishWithKnownExhaustedBudgets(
+      google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                      ConsumeBudgetsResponse>
+          consume_budgets_context,
+      std::vector<size_t> budget_exhausted_indices);
+
+  // Queues the context in the first pending group commit batch that has room
+  // for it and is after every batch sharing a budget key with it. The first
+  // batch is flushed either when it reaches group_commit_max_batch_size_ or
+  // when group_commit_max_linger_ has elapsed since the first context was
+  // queued. Fails with a retry result if group_commit_max_pending_count_
+  // contexts are already queued.
+  google::scp::core::ExecutionResult EnqueueForGroupCommit(
       google::scp::core::AsyncContext<ConsumeBudgetsRequest,
                                       ConsumeBudgetsResponse>
           consume_budgets_context);
 
-  google::scp::core::ExecutionResult ConsumeBudgetsSync(
-      const google::scp::core::AsyncContext<ConsumeBudgetsRequest,
-                                            ConsumeBudgetsResponse>&
+  // Schedules FlushGroupCommitQueue on io_async_executor_.
+  google::scp::core::ExecutionResult ScheduleGroupCommitFlush();
+
+  // Dequeues the first pending batch and consumes it in a single Spanner
+  // transaction.
+  void FlushGroupCommitQueue();
+
+  void ConsumeBudgetsSyncAndFinishContexts(
+      std::vector<google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                                  ConsumeBudgetsResponse>>
+          consume_budgets_contexts);
+
+  // Consumes the budgets of all the given contexts in one Spanner transaction
+  // and stores the per-context outcome in each context's result and response.
+  // The contexts must not share any budget key with each other. A context
+  // that fails (e.g. because of exhausted budget) does not fail the others.
+  void ConsumeBudgetsSync(
+      std::vector<google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                                  ConsumeBudgetsResponse>>&
+          consume_budgets_contexts);
+
+  // Returns the budgets of the context in one Spanner transaction and stores
+  // the outcome in the context's result.
+  void ReturnBudgetsSync(
+      google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                      ConsumeBudgetsResponse>&
           consume_budgets_context);
 
   google::scp::core::ConfigProviderInterface* config_provider_;
@@ -75,6 +141,33 @@ class BudgetConsumptionHelper : public BudgetConsumptionHelperInterface {
   bool enable_write_to_value_column_ = false;
   bool enable_write_to_value_proto_column_ = false;
   bool enable_read_truth_from_value_column_ = true;
+
+  // Group commit parameters. A batch size of 1 disables group commit and each
+  // ConsumeBudgets call runs in its own Spanner transaction.
+  size_t group_commit_max_batch_size_ = 1;
+  std::chrono::milliseconds group_commit_max_linger_{0};
+  size_t group_commit_max_pending_count_ = 0;
+
+  // Contexts waiting for a group commit, in batches of contexts with pairwise
+  // disjoint budget keys. The batches are flushed in order.
+  std::deque<std::vector<google::scp::core::AsyncContext<
+      ConsumeBudgetsRequest, ConsumeBudgetsResponse>>>
+      group_commit_batches_;
+  // The sequence number of the front of group_commit_batches_.
+  uint64_t group_commit_first_batch_ = 0;
+  // The sequence number of the last pending batch of each queued budget key.
+  absl::flat_hash_map<PbsPrimaryKey, uint64_t, PbsPrimaryKeyHash,
+                      PbsPrimaryKeyEq>
+      group_commit_last_batch_of_key_;
+  // The number of contexts in group_commit_batches_.
+  size_t group_commit_pending_count_ = 0;
+  // Whether a flush of group_commit_batches_ is already scheduled.
+  bool group_commit_flush_scheduled_ = false;
+  std::mutex group_commit_mutex_;
+
+  // Cache of recently used budget keys, used to reject requests on budgets
+  // known to be exhausted. Null if the cache is disabled.
+  std::unique_ptr<BudgetKeyCache> budget_key_cache_;
 };
 
 }  // namespace google::scp::pbs
@@ -39,6 +39,16 @@ DEFINE_ERROR_CODE(SC_CONSUME_BUDGET_EXHAUSTED, SC_PBS_CONSUME_BUDGET, 0x0004,
                   "Failed to consume budget because budget is exhausted.",
                   google::scp::core::errors::HttpStatusCode::CONFLICT)
 
+DEFINE_ERROR_CODE(
+    SC_CONSUME_BUDGET_INVALID_CONFIGURATION, SC_PBS_CONSUME_BUDGET, 0x0005,
+    "Invalid BudgetConsumptionHelper configuration.",
+    google::scp::core::errors::HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(
+    SC_CONSUME_BUDGET_GROUP_COMMIT_QUEUE_FULL, SC_PBS_CONSUME_BUDGET, 0x0006,
+    "Too many budget consumptions are waiting for a group commit.",
+    google::scp::core::errors::HttpStatusCode::SERVICE_UNAVAILABLE)
+
 }  // namespace google::scp::pbs::errors
 
 #endif  // CC_PBS_CONSUME_BUDGET_SRC_GCP_ERROR_CODES_H_
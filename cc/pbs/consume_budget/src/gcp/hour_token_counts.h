@@ -0,0 +1,34 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CC_PBS_CONSUME_BUDGET_SRC_GCP_HOUR_TOKEN_COUNTS_H_
+#define CC_PBS_CONSUME_BUDGET_SRC_GCP_HOUR_TOKEN_COUNTS_H_
+
+#include <array>
+#include <cstddef>
+
+#include "cc/core/interface/type_def.h"
+#include "cc/pbs/interface/type_def.h"
+
+namespace google::scp::pbs {
+
+inline constexpr size_t kHourTokenCountsSize = 24;
+
+// Tokens available in each hour of a day of a budget key. The counts are
+// stored inline, so budget keys can be copied and checked for exhaustion
+// without any heap allocation.
+using HourTokenCounts = std::array<TokenCount, kHourTokenCountsSize>;
+
+}  // namespace google::scp::pbs
+
+#endif  // CC_PBS_CONSUME_BUDGET_SRC_GCP_HOUR_TOKEN_COUNTS_H_
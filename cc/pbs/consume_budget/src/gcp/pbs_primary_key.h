@@ -0,0 +1,119 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CC_PBS_CONSUME_BUDGET_SRC_GCP_PBS_PRIMARY_KEY_H_
+#define CC_PBS_CONSUME_BUDGET_SRC_GCP_PBS_PRIMARY_KEY_H_
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/hash/hash.h"
+#include "absl/strings/str_cat.h"
+#include "cc/core/interface/type_def.h"
+#include "cc/pbs/interface/type_def.h"
+
+namespace google::scp::pbs {
+
+// Primary key of a row in the budget key table that does not own its budget
+// key. The budget key usually is the budget_key_name of a
+// ConsumeBudgetMetadata, which must outlive the PbsPrimaryKeyRef.
+class PbsPrimaryKeyRef {
+ public:
+  PbsPrimaryKeyRef(std::string_view budget_key, TimeGroup time_group)
+      : budget_key_(budget_key), time_group_(time_group) {}
+
+  std::string_view budget_key() const { return budget_key_; }
+
+  TimeGroup time_group() const { return time_group_; }
+
+  // Value of the timeframe column.
+  std::string timeframe() const { return absl::StrCat(time_group_); }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const PbsPrimaryKeyRef& c) {
+    return H::combine(std::move(h), c.budget_key_, c.time_group_);
+  }
+
+  friend bool operator==(const PbsPrimaryKeyRef& p1,
+                         const PbsPrimaryKeyRef& p2) {
+    return p1.budget_key_ == p2.budget_key_ &&
+           p1.time_group_ == p2.time_group_;
+  }
+
+ private:
+  std::string_view budget_key_;
+
+  // Number of days since epoch, which is the timeframe column in decimal.
+  TimeGroup time_group_;
+};
+
+// Primary key of a row in the budget key table.
+class PbsPrimaryKey {
+ public:
+  PbsPrimaryKey(std::string budget_key, TimeGroup time_group)
+      : budget_key_(std::move(budget_key)), time_group_(time_group) {}
+
+  explicit PbsPrimaryKey(const PbsPrimaryKeyRef& key)
+      : budget_key_(key.budget_key()), time_group_(key.time_group()) {}
+
+  const std::string& budget_key() const { return budget_key_; }
+
+  TimeGroup time_group() const { return time_group_; }
+
+  // Value of the timeframe column.
+  std::string timeframe() const { return absl::StrCat(time_group_); }
+
+  // Hashes to the same value as the equivalent PbsPrimaryKeyRef.
+  template <typename H>
+  friend H AbslHashValue(H h, const PbsPrimaryKey& c) {
+    return H::combine(std::move(h), std::string_view(c.budget_key_),
+                      c.time_group_);
+  }
+
+  friend bool operator==(const PbsPrimaryKey& p1, const PbsPrimaryKey& p2) {
+    return p1.budget_key_ == p2.budget_key_ &&
+           p1.time_group_ == p2.time_group_;
+  }
+
+ private:
+  std::string budget_key_;
+
+  // Number of days since epoch, which is the timeframe column in decimal.
+  TimeGroup time_group_;
+};
+
+// Hash and equality functors of containers of PbsPrimaryKey that can be
+// looked up with a PbsPrimaryKeyRef, without copying its budget key.
+struct PbsPrimaryKeyHash {
+  using is_transparent = void;
+
+  template <typename Key>
+  size_t operator()(const Key& key) const {
+    return absl::HashOf(key);
+  }
+};
+
+struct PbsPrimaryKeyEq {
+  using is_transparent = void;
+
+  template <typename Key1, typename Key2>
+  bool operator()(const Key1& key1, const Key2& key2) const {
+    return key1.budget_key() == key2.budget_key() &&
+           key1.time_group() == key2.time_group();
+  }
+};
+
+}  // namespace google::scp::pbs
+
+#endif  // CC_PBS_CONSUME_BUDGET_SRC_GCP_PBS_PRIMARY_KEY_H_
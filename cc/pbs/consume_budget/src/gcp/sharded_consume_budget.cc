@@ -0,0 +1,269 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "cc/pbs/consume_budget/src/gcp/sharded_consume_budget.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+#include "cc/core/common/global_logger/src/global_logger.h"
+#include "cc/pbs/consume_budget/src/gcp/error_codes.h"
+#include "cc/pbs/interface/consume_budget_interface.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace google::scp::pbs {
+namespace {
+
+using ::google::scp::core::AsyncContext;
+using ::google::scp::core::ExecutionResult;
+using ::google::scp::core::SuccessExecutionResult;
+using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_EXHAUSTED;
+
+constexpr std::string_view kComponentName = "ShardedBudgetConsumptionHelper";
+
+// Parameters of the 64-bit FNV-1a hash. Unlike absl::Hash, it does not depend
+// on the binary, which the placement of budget keys must not.
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+}  // namespace
+
+// A request whose budgets are consumed on several shards.
+struct ShardedBudgetConsumptionHelper::ShardedConsumption {
+  // The budgets of the request stored in one shard.
+  struct ShardRequest {
+    size_t shard_index = 0;
+    // Indices of the budgets in the request, in the order of request->budgets.
+    std::vector<size_t> budget_indices;
+    // The budget key names of the budgets refer to the storage of the original
+    // request, which is kept alive by ShardedConsumption::context.
+    std::shared_ptr<ConsumeBudgetsRequest> request;
+    std::shared_ptr<ConsumeBudgetsResponse> response;
+    ExecutionResult result;
+  };
+
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
+  std::vector<ShardRequest> shard_requests;
+  // The number of shard operations, consumptions and then returns, that are
+  // not done yet.
+  std::atomic<size_t> pending_count = 0;
+};
+
+ShardedBudgetConsumptionHelper::ShardedBudgetConsumptionHelper(
+    std::vector<std::unique_ptr<BudgetConsumptionHelper>> shards)
+    : shards_(std::move(shards)) {}
+
+ExecutionResult ShardedBudgetConsumptionHelper::Init() noexcept {
+  for (auto& shard : shards_) {
+    RETURN_IF_FAILURE(shard->Init());
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult ShardedBudgetConsumptionHelper::Run() noexcept {
+  for (auto& shard : shards_) {
+    RETURN_IF_FAILURE(shard->Run());
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult ShardedBudgetConsumptionHelper::Stop() noexcept {
+  for (auto& shard : shards_) {
+    RETURN_IF_FAILURE(shard->Stop());
+  }
+  return SuccessExecutionResult();
+}
+
+size_t ShardedBudgetConsumptionHelper::GetShardIndex(
+    std::string_view budget_key_name, size_t shard_count) {
+  uint64_t hash = kFnvOffsetBasis;
+  for (char c : budget_key_name) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * kFnvPrime;
+  }
+  return hash % shard_count;
+}
+
+ExecutionResult ShardedBudgetConsumptionHelper::ConsumeBudgets(
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
+        consume_budgets_context) {
+  const std::vector<ConsumeBudgetMetadata>& budgets =
+      consume_budgets_context.request->budgets;
+  if (shards_.size() == 1 || budgets.empty()) {
+    return shards_.front()->ConsumeBudgets(std::move(consume_budgets_context));
+  }
+
+  std::vector<std::vector<size_t>> budget_indices_per_shard(shards_.size());
+  for (size_t i = 0; i < budgets.size(); ++i) {
+    budget_indices_per_shard[GetShardIndex(budgets[i].budget_key_name,
+                                           shards_.size())]
+        .push_back(i);
+  }
+
+  auto consumption = std::make_shared<ShardedConsumption>();
+  for (size_t shard_index = 0; shard_index < shards_.size(); ++shard_index) {
+    std::vector<size_t>& budget_indices = budget_indices_per_shard[shard_index];
+    if (budget_indices.empty()) {
+      continue;
+    }
+    if (budget_indices.size() == budgets.size()) {
+      // All the budgets are stored in this shard.
+      return shards_[shard_index]->ConsumeBudgets(
+          std::move(consume_budgets_context));
+    }
+
+    ShardedConsumption::ShardRequest& shard_request =
+        consumption->shard_requests.emplace_back();
+    shard_request.shard_index = shard_index;
+    shard_request.request = std::make_shared<ConsumeBudgetsRequest>();
+    shard_request.request->budgets.reserve(budget_indices.size());
+    for (size_t i : budget_indices) {
+      shard_request.request->budgets.push_back(budgets[i]);
+    }
+    shard_request.response = std::make_shared<ConsumeBudgetsResponse>();
+    shard_request.budget_indices = std::move(budget_indices);
+  }
+  consumption->context = consume_budgets_context;
+
+  // The extra pending operation is released once every shard is called, so
+  // that the request does not complete while shards are still being called.
+  const size_t shard_requests_count = consumption->shard_requests.size();
+  consumption->pending_count = shard_requests_count + 1;
+  size_t scheduled_count = 0;
+  ExecutionResult first_schedule_failure = SuccessExecutionResult();
+  for (size_t i = 0; i < shard_requests_count; ++i) {
+    ShardedConsumption::ShardRequest& shard_request =
+        consumption->shard_requests[i];
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> shard_context(
+        shard_request.request,
+        [this, consumption, i](
+            AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&
+                shard_context) {
+          consumption->shard_requests[i].result = shard_context.result;
+          if (consumption->pending_count.fetch_sub(
+                  1, std::memory_order_acq_rel) == 1) {
+            OnShardConsumptionDone(consumption);
+          }
+        },
+        consume_budgets_context);
+    shard_context.response = shard_request.response;
+    if (auto execution_result =
+            shards_[shard_request.shard_index]->ConsumeBudgets(shard_context);
+        !execution_result.Successful()) {
+      // The shard does not call the callback, so its budgets count as not
+      // consumed.
+      shard_request.result = execution_result;
+      consumption->pending_count.fetch_sub(1, std::memory_order_acq_rel);
+      if (first_schedule_failure.Successful()) {
+        first_schedule_failure = execution_result;
+      }
+      continue;
+    }
+    ++scheduled_count;
+  }
+
+  if (scheduled_count == 0) {
+    // Returns the execution result to the caller without calling FinishContext,
+    // since no shard consumes any budget.
+    return first_schedule_failure;
+  }
+  if (consumption->pending_count.fetch_sub(1, std::memory_order_acq_rel) ==
+      1) {
+    OnShardConsumptionDone(consumption);
+  }
+  return SuccessExecutionResult();
+}
+
+void ShardedBudgetConsumptionHelper::OnShardConsumptionDone(
+    std::shared_ptr<ShardedConsumption> consumption) {
+  // Budget exhaustion takes precedence over other failures, since retrying the
+  // request would not succeed either.
+  ExecutionResult result = SuccessExecutionResult();
+  std::vector<size_t> budget_exhausted_indices;
+  size_t consumed_shards_count = 0;
+  for (const auto& shard_request : consumption->shard_requests) {
+    if (shard_request.result.Successful()) {
+      ++consumed_shards_count;
+      continue;
+    }
+    if (shard_request.result.status_code == SC_CONSUME_BUDGET_EXHAUSTED) {
+      for (size_t i : shard_request.response->budget_exhausted_indices) {
+        budget_exhausted_indices.push_back(shard_request.budget_indices[i]);
+      }
+    }
+    if (result.Successful() ||
+        shard_request.result.status_code == SC_CONSUME_BUDGET_EXHAUSTED) {
+      result = shard_request.result;
+    }
+  }
+
+  consumption->context.result = result;
+  if (result.Successful()) {
+    consumption->context.Finish();
+    return;
+  }
+  std::sort(budget_exhausted_indices.begin(), budget_exhausted_indices.end());
+  consumption->context.response->budget_exhausted_indices =
+      std::move(budget_exhausted_indices);
+
+  // Returns the budgets consumed by the other shards, with the same extra
+  // pending operation as above.
+  consumption->pending_count = consumed_shards_count + 1;
+  for (const auto& shard_request : consumption->shard_requests) {
+    if (!shard_request.result.Successful()) {
+      continue;
+    }
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> return_context(
+        shard_request.request,
+        [this, consumption](
+            AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&
+                return_context) {
+          if (!return_context.result.Successful()) {
+            SCP_ERROR_CONTEXT(
+                kComponentName, return_context, return_context.result,
+                absl::StrFormat("Failed to return %d budgets of a request that "
+                                "failed on another shard.",
+                                return_context.request->budgets.size()));
+          }
+          OnShardReturnDone(consumption);
+        },
+        consumption->context);
+    return_context.response = std::make_shared<ConsumeBudgetsResponse>();
+    if (auto execution_result =
+            shards_[shard_request.shard_index]->ReturnBudgets(return_context);
+        !execution_result.Successful()) {
+      SCP_ERROR_CONTEXT(
+          kComponentName, return_context, execution_result,
+          absl::StrFormat("Failed to return %d budgets of a request that "
+                          "failed on another shard.",
+                          shard_request.request->budgets.size()));
+      OnShardReturnDone(consumption);
+    }
+  }
+  OnShardReturnDone(consumption);
+}
+
+void ShardedBudgetConsumptionHelper::OnShardReturnDone(
+    std::shared_ptr<ShardedConsumption> consumption) {
+  if (consumption->pending_count.fetch_sub(1, std::memory_order_acq_rel) ==
+      1) {
+    consumption->context.Finish();
+  }
+}
+
+}  // namespace google::scp::pbs
@@ -0,0 +1,85 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CC_PBS_CONSUME_BUDGET_SRC_GCP_SHARDED_CONSUME_BUDGET_H_
+#define CC_PBS_CONSUME_BUDGET_SRC_GCP_SHARDED_CONSUME_BUDGET_H_
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "cc/core/interface/async_context.h"
+#include "cc/pbs/consume_budget/src/gcp/consume_budget.h"
+#include "cc/pbs/interface/consume_budget_interface.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace google::scp::pbs {
+
+// A helper class to consume privacy budgets stored across several budget
+// tables, each one possibly in its own Spanner database.
+//
+// A budget key is always stored in the shard given by GetShardIndex. The
+// budgets of a request that spans several shards are consumed by one
+// BudgetConsumptionHelper per shard, in parallel. If any of them fails, the
+// budgets consumed by the others are returned with ReturnBudgets before the
+// request completes, so that a request only succeeds if it consumed all of its
+// budgets.
+//
+// Unlike a single Spanner transaction, this is not atomic:
+// - Between the commit of a shard and the return of its budgets, concurrent
+//   requests, on any replica, see these budgets as consumed and may be
+//   rejected as exhausted. The budgets are never consumed twice.
+// - If the process stops in that window, or a return fails, the budgets of the
+//   committed shards stay consumed and are lost for good.
+// The budget key caches of the shards are disabled, since a return is not seen
+// by the caches of the other replicas.
+class ShardedBudgetConsumptionHelper : public BudgetConsumptionHelperInterface {
+ public:
+  explicit ShardedBudgetConsumptionHelper(
+      std::vector<std::unique_ptr<BudgetConsumptionHelper>> shards);
+
+  google::scp::core::ExecutionResult Init() noexcept override;
+
+  google::scp::core::ExecutionResult Run() noexcept override;
+
+  google::scp::core::ExecutionResult Stop() noexcept override;
+
+  // Consumes privacy budgets for the given list of privacy budget keys in
+  // consume_budget_context.
+  google::scp::core::ExecutionResult ConsumeBudgets(
+      google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                      ConsumeBudgetsResponse>
+          consume_budgets_context) override;
+
+  // Returns the shard of budget_key_name among shard_count shards. The shard
+  // of a budget key only depends on its name, so that all of its timeframes
+  // are stored in the same table, and never changes across binaries.
+  static size_t GetShardIndex(std::string_view budget_key_name,
+                              size_t shard_count);
+
+ private:
+  struct ShardedConsumption;
+
+  // Completes the sharded consumption once all of its shards are done,
+  // returning the budgets of the successful shards if any shard failed.
+  void OnShardConsumptionDone(std::shared_ptr<ShardedConsumption> consumption);
+
+  // Finishes the sharded consumption once all of its budgets are returned.
+  void OnShardReturnDone(std::shared_ptr<ShardedConsumption> consumption);
+
+  std::vector<std::unique_ptr<BudgetConsumptionHelper>> shards_;
+};
+
+}  // namespace google::scp::pbs
+
+#endif  // CC_PBS_CONSUME_BUDGET_SRC_GCP_SHARDED_CONSUME_BUDGET_H_
@@ -0,0 +1,502 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "cc/pbs/consume_budget/src/local/budget_write_ahead_log.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/crc/crc32c.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "cc/core/common/global_logger/src/global_logger.h"
+#include "cc/core/common/uuid/src/uuid.h"
+#include "cc/pbs/consume_budget/src/local/error_codes.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace google::scp::pbs {
+namespace {
+
+using ::google::scp::core::ExecutionResult;
+using ::google::scp::core::ExecutionResultOr;
+using ::google::scp::core::FailureExecutionResult;
+using ::google::scp::core::SuccessExecutionResult;
+using ::google::scp::core::common::kZeroUuid;
+using ::google::scp::pbs::errors::SC_LOCAL_CONSUME_BUDGET_WAL_CORRUPTED;
+using ::google::scp::pbs::errors::SC_LOCAL_CONSUME_BUDGET_WAL_NOT_RUNNING;
+using ::google::scp::pbs::errors::SC_LOCAL_CONSUME_BUDGET_WAL_OPEN_ERROR;
+using ::google::scp::pbs::errors::SC_LOCAL_CONSUME_BUDGET_WAL_WRITE_ERROR;
+
+constexpr absl::string_view kComponentName = "BudgetWriteAheadLog";
+constexpr absl::string_view kSegmentFilePrefix = "budget_wal.";
+constexpr absl::string_view kSnapshotFileName = "budget_snapshot";
+constexpr absl::string_view kTemporarySnapshotFileName = "budget_snapshot.tmp";
+constexpr uint32_t kSnapshotMagic = 0x50425353;
+// Size of the buffer after which a snapshot being written is flushed to disk.
+constexpr size_t kSnapshotWriteBufferBytes = 1 << 20;
+
+// Records are framed as [payload size][crc32c of payload][payload] and the
+// payload is [key size][key][timeframe size][timeframe][hour count][hours].
+// Integers are stored in host byte order since the files never leave the host.
+template <typename T>
+void AppendInteger(T value, std::string& output) {
+  output.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ConsumeInteger(absl::string_view& input, T& value) {
+  if (input.size() < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(&value, input.data(), sizeof(T));
+  input.remove_prefix(sizeof(T));
+  return true;
+}
+
+bool ConsumeBytes(absl::string_view& input, size_t size,
+                  absl::string_view& bytes) {
+  if (input.size() < size) {
+    return false;
+  }
+  bytes = input.substr(0, size);
+  input.remove_prefix(size);
+  return true;
+}
+
+void SerializeRecord(const BudgetRecord& record, std::string& output) {
+  std::string payload;
+  AppendInteger<uint32_t>(record.budget_key.size(), payload);
+  payload.append(record.budget_key);
+  AppendInteger<uint32_t>(record.timeframe.size(), payload);
+  payload.append(record.timeframe);
+  AppendInteger<uint32_t>(record.token_counts.size(), payload);
+  payload.append(reinterpret_cast<const char*>(record.token_counts.data()),
+                 record.token_counts.size() * sizeof(TokenCount));
+
+  AppendInteger<uint32_t>(payload.size(), output);
+  AppendInteger<uint32_t>(static_cast<uint32_t>(absl::ComputeCrc32c(payload)),
+                          output);
+  output.append(payload);
+}
+
+// Parses the record at the front of input. Returns false if the record is
+// truncated or does not match its checksum.
+bool ParseRecord(absl::string_view& input, BudgetRecord& record) {
+  uint32_t payload_size = 0;
+  uint32_t checksum = 0;
+  absl::string_view payload;
+  if (!ConsumeInteger(input, payload_size) ||
+      !ConsumeInteger(input, checksum) ||
+      !ConsumeBytes(input, payload_size, payload) ||
+      static_cast<uint32_t>(absl::ComputeCrc32c(payload)) != checksum) {
+    return false;
+  }
+
+  uint32_t size = 0;
+  absl::string_view bytes;
+  if (!ConsumeInteger(payload, size) || !ConsumeBytes(payload, size, bytes)) {
+    return false;
+  }
+  record.budget_key = std::string(bytes);
+  if (!ConsumeInteger(payload, size) || !ConsumeBytes(payload, size, bytes)) {
+    return false;
+  }
+  record.timeframe = std::string(bytes);
+  if (!ConsumeInteger(payload, size) || size != record.token_counts.size() ||
+      !ConsumeBytes(payload, size * sizeof(TokenCount), bytes) ||
+      !payload.empty()) {
+    return false;
+  }
+  std::memcpy(record.token_counts.data(), bytes.data(), bytes.size());
+  return true;
+}
+
+bool ReadFile(const std::string& path, std::string& contents) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  std::stringstream stream;
+  stream << file.rdbuf();
+  contents = std::move(stream).str();
+  return !file.bad();
+}
+
+bool WriteAll(int fd, absl::string_view data) {
+  while (!data.empty()) {
+    ssize_t written = ::write(fd, data.data(), data.size());
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data.remove_prefix(written);
+  }
+  return true;
+}
+
+// Makes the creation, deletion and renaming of files in the directory durable.
+bool SyncDirectory(const std::string& directory) {
+  int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  bool synced = ::fsync(fd) == 0;
+  ::close(fd);
+  return synced;
+}
+
+}  // namespace
+
+BudgetWriteAheadLog::BudgetWriteAheadLog(std::string directory,
+                                         uint64_t compaction_threshold_bytes,
+                                         SnapshotProvider snapshot_provider)
+    : directory_(std::move(directory)),
+      compaction_threshold_bytes_(compaction_threshold_bytes),
+      snapshot_provider_(std::move(snapshot_provider)) {}
+
+BudgetWriteAheadLog::~BudgetWriteAheadLog() {
+  Stop();
+  if (segment_fd_ >= 0) {
+    ::close(segment_fd_);
+  }
+}
+
+std::string BudgetWriteAheadLog::SegmentPath(uint64_t segment_id) const {
+  return absl::StrCat(directory_, "/", kSegmentFilePrefix, segment_id);
+}
+
+std::string BudgetWriteAheadLog::SnapshotPath() const {
+  return absl::StrCat(directory_, "/", kSnapshotFileName);
+}
+
+ExecutionResultOr<std::vector<uint64_t>> BudgetWriteAheadLog::ListSegments()
+    const {
+  std::vector<uint64_t> segment_ids;
+  std::error_code error;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(directory_, error)) {
+    std::string file_name = entry.path().filename().string();
+    uint64_t segment_id = 0;
+    if (absl::string_view(file_name).starts_with(kSegmentFilePrefix) &&
+        absl::SimpleAtoi(
+            absl::string_view(file_name).substr(kSegmentFilePrefix.size()),
+            &segment_id)) {
+      segment_ids.push_back(segment_id);
+    }
+  }
+  if (error) {
+    return FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_OPEN_ERROR);
+  }
+  std::sort(segment_ids.begin(), segment_ids.end());
+  return segment_ids;
+}
+
+ExecutionResult BudgetWriteAheadLog::Recover(const RecordVisitor& visitor) {
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+  if (error) {
+    SCP_ERROR(kComponentName, kZeroUuid,
+              FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_OPEN_ERROR),
+              "Failed to create directory %s: %s", directory_.c_str(),
+              error.message().c_str());
+    return FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_OPEN_ERROR);
+  }
+
+  // Segments older than the snapshot are leftovers of an interrupted
+  // compaction.
+  uint64_t first_segment_id = 0;
+  std::string contents;
+  if (std::filesystem::exists(SnapshotPath(), error)) {
+    if (!ReadFile(SnapshotPath(), contents)) {
+      return FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_OPEN_ERROR);
+    }
+    absl::string_view input = contents;
+    uint32_t magic = 0;
+    if (!ConsumeInteger(input, magic) || magic != kSnapshotMagic ||
+        !ConsumeInteger(input, first_segment_id)) {
+      return FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_CORRUPTED);
+    }
+    // Snapshots are only made visible once fully written, so unlike segments
+    // they cannot have a torn record.
+    BudgetRecord record;
+    while (!input.empty()) {
+      if (!ParseRecord(input, record)) {
+        return FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_CORRUPTED);
+      }
+      visitor(record);
+    }
+  }
+
+  auto segment_ids = ListSegments();
+  RETURN_IF_FAILURE(segment_ids.result());
+  for (uint64_t segment_id : *segment_ids) {
+    if (segment_id < first_segment_id) {
+      std::filesystem::remove(SegmentPath(segment_id), error);
+      continue;
+    }
+    if (!ReadFile(SegmentPath(segment_id), contents)) {
+      return FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_OPEN_ERROR);
+    }
+    absl::string_view input = contents;
+    BudgetRecord record;
+    while (!input.empty()) {
+      if (!ParseRecord(input, record)) {
+        // Nothing after a torn record was acknowledged as durable.
+        SCP_WARNING(kComponentName, kZeroUuid,
+                    "Ignoring %d trailing bytes of torn segment %s.",
+                    input.size(), SegmentPath(segment_id).c_str());
+        break;
+      }
+      visitor(record);
+    }
+  }
+
+  // Appends always go to a new segment, so that a torn record is never
+  // followed by valid ones within a segment.
+  uint64_t next_segment_id = first_segment_id;
+  if (!segment_ids->empty()) {
+    next_segment_id = std::max(next_segment_id, segment_ids->back() + 1);
+  }
+  return OpenSegment(next_segment_id);
+}
+
+ExecutionResult BudgetWriteAheadLog::OpenSegment(uint64_t segment_id) {
+  int fd = ::open(SegmentPath(segment_id).c_str(),
+                  O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+  if (fd < 0 || !SyncDirectory(directory_)) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    auto execution_result =
+        FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_OPEN_ERROR);
+    SCP_ERROR(kComponentName, kZeroUuid, execution_result,
+              "Failed to open segment %s: %s",
+              SegmentPath(segment_id).c_str(), std::strerror(errno));
+    return execution_result;
+  }
+  if (segment_fd_ >= 0) {
+    ::close(segment_fd_);
+  }
+  segment_fd_ = fd;
+  segment_id_ = segment_id;
+  segment_size_bytes_ = 0;
+  return SuccessExecutionResult();
+}
+
+ExecutionResult BudgetWriteAheadLog::Run() {
+  if (segment_fd_ < 0) {
+    return FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_NOT_RUNNING);
+  }
+  std::unique_lock lock(mutex_);
+  running_ = true;
+  stopping_ = false;
+  flusher_thread_ = std::make_unique<std::thread>([this]() { FlushLoop(); });
+  compaction_thread_ =
+      std::make_unique<std::thread>([this]() { CompactionLoop(); });
+  return SuccessExecutionResult();
+}
+
+ExecutionResult BudgetWriteAheadLog::Stop() {
+  {
+    std::unique_lock lock(mutex_);
+    if (!running_) {
+      return SuccessExecutionResult();
+    }
+    running_ = false;
+    stopping_ = true;
+  }
+  flush_condition_.notify_all();
+  compaction_condition_.notify_all();
+  flusher_thread_->join();
+  compaction_thread_->join();
+  flusher_thread_.reset();
+  compaction_thread_.reset();
+  return SuccessExecutionResult();
+}
+
+ExecutionResult BudgetWriteAheadLog::Append(
+    const std::vector<BudgetRecord>& records, AppendCallback callback) {
+  std::string buffer;
+  for (const BudgetRecord& record : records) {
+    SerializeRecord(record, buffer);
+  }
+
+  {
+    std::unique_lock lock(mutex_);
+    if (!running_) {
+      return FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_NOT_RUNNING);
+    }
+    pending_buffer_.append(buffer);
+    pending_callbacks_.push_back(std::move(callback));
+  }
+  flush_condition_.notify_one();
+  return SuccessExecutionResult();
+}
+
+void BudgetWriteAheadLog::FlushLoop() {
+  while (true) {
+    std::string buffer;
+    std::vector<AppendCallback> callbacks;
+    {
+      std::unique_lock lock(mutex_);
+      flush_condition_.wait(lock, [this]() {
+        return !pending_callbacks_.empty() || stopping_;
+      });
+      if (pending_callbacks_.empty()) {
+        return;
+      }
+      // Everything appended while the previous batch was being synced goes
+      // out with a single fdatasync.
+      buffer.swap(pending_buffer_);
+      callbacks.swap(pending_callbacks_);
+    }
+
+    ExecutionResult execution_result = WriteToSegment(buffer);
+    if (execution_result.Successful() &&
+        segment_size_bytes_ >= compaction_threshold_bytes_) {
+      RotateSegmentAndRequestCompaction();
+    }
+    for (AppendCallback& callback : callbacks) {
+      callback(execution_result);
+    }
+  }
+}
+
+ExecutionResult BudgetWriteAheadLog::WriteToSegment(const std::string& buffer) {
+  {
+    std::unique_lock lock(mutex_);
+    if (failed_) {
+      return FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_WRITE_ERROR);
+    }
+  }
+  if (buffer.empty()) {
+    return SuccessExecutionResult();
+  }
+  if (!WriteAll(segment_fd_, buffer) || ::fdatasync(segment_fd_) != 0) {
+    auto execution_result =
+        FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_WRITE_ERROR);
+    SCP_ERROR(kComponentName, kZeroUuid, execution_result,
+              "Failed to write segment %s: %s",
+              SegmentPath(segment_id_).c_str(), std::strerror(errno));
+    // Whether the failed write reached the disk is unknown, and the kernel
+    // may drop the dirty pages, so no later write can be trusted either.
+    std::unique_lock lock(mutex_);
+    failed_ = true;
+    return execution_result;
+  }
+  segment_size_bytes_ += buffer.size();
+  return SuccessExecutionResult();
+}
+
+void BudgetWriteAheadLog::RotateSegmentAndRequestCompaction() {
+  {
+    std::unique_lock lock(mutex_);
+    if (compaction_in_progress_) {
+      // The active segment keeps growing until the running compaction is done.
+      return;
+    }
+  }
+  if (!OpenSegment(segment_id_ + 1).Successful()) {
+    return;
+  }
+  {
+    std::unique_lock lock(mutex_);
+    compaction_in_progress_ = true;
+    compaction_requested_ = true;
+    compaction_first_segment_id_ = segment_id_;
+  }
+  compaction_condition_.notify_one();
+}
+
+void BudgetWriteAheadLog::CompactionLoop() {
+  while (true) {
+    uint64_t first_segment_id = 0;
+    {
+      std::unique_lock lock(mutex_);
+      compaction_condition_.wait(
+          lock, [this]() { return compaction_requested_ || stopping_; });
+      if (!compaction_requested_) {
+        return;
+      }
+      compaction_requested_ = false;
+      first_segment_id = compaction_first_segment_id_;
+    }
+
+    if (auto execution_result = Compact(first_segment_id);
+        !execution_result.Successful()) {
+      // The segments are kept and the next rotation retries.
+      SCP_ERROR(kComponentName, kZeroUuid, execution_result,
+                "Failed to compact the budget write-ahead log.");
+    }
+
+    std::unique_lock lock(mutex_);
+    compaction_in_progress_ = false;
+  }
+}
+
+ExecutionResult BudgetWriteAheadLog::Compact(uint64_t first_segment_id) {
+  std::string temporary_path =
+      absl::StrCat(directory_, "/", kTemporarySnapshotFileName);
+  int fd = ::open(temporary_path.c_str(),
+                  O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_WRITE_ERROR);
+  }
+
+  // Rows are read after the rotation, so the snapshot contains every record
+  // of the segments it replaces. It may also contain some records of the newer
+  // segments, which replay over it to the same rows.
+  std::string buffer;
+  AppendInteger<uint32_t>(kSnapshotMagic, buffer);
+  AppendInteger<uint64_t>(first_segment_id, buffer);
+  bool written = true;
+  snapshot_provider_([&](const BudgetRecord& record) {
+    SerializeRecord(record, buffer);
+    if (written && buffer.size() >= kSnapshotWriteBufferBytes) {
+      written = WriteAll(fd, buffer);
+      buffer.clear();
+    }
+  });
+  written = written && WriteAll(fd, buffer) && ::fdatasync(fd) == 0;
+  ::close(fd);
+  if (!written ||
+      std::rename(temporary_path.c_str(), SnapshotPath().c_str()) != 0 ||
+      !SyncDirectory(directory_)) {
+    return FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_WRITE_ERROR);
+  }
+
+  auto segment_ids = ListSegments();
+  RETURN_IF_FAILURE(segment_ids.result());
+  std::error_code error;
+  for (uint64_t segment_id : *segment_ids) {
+    if (segment_id < first_segment_id) {
+      std::filesystem::remove(SegmentPath(segment_id), error);
+    }
+  }
+  return SuccessExecutionResult();
+}
+
+}  // namespace google::scp::pbs
@@ -0,0 +1,144 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CC_PBS_CONSUME_BUDGET_SRC_LOCAL_BUDGET_WRITE_AHEAD_LOG_H_
+#define CC_PBS_CONSUME_BUDGET_SRC_LOCAL_BUDGET_WRITE_AHEAD_LOG_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cc/core/interface/type_def.h"
+#include "cc/pbs/consume_budget/src/gcp/hour_token_counts.h"
+#include "cc/pbs/interface/type_def.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace google::scp::pbs {
+
+// A budget key row as persisted by BudgetWriteAheadLog. A record holds the full
+// hourly budgets of the key rather than a delta, so replaying a record more
+// than once is harmless.
+struct BudgetRecord {
+  std::string budget_key;
+  std::string timeframe;
+  HourTokenCounts token_counts;
+};
+
+// An append-only log of budget records backed by files in a local directory.
+//
+// Appends are buffered and written by a single flusher thread, which issues
+// one fdatasync for all the records appended while the previous fdatasync was
+// in progress. Once the active log segment grows past the compaction
+// threshold, the flusher starts a new segment and a compaction thread writes a
+// snapshot of the whole table, after which the segments it covers are deleted.
+//
+// Recovery loads the latest snapshot and replays the remaining segments in
+// order. A torn record at the end of a segment, left by a crash in the middle
+// of a write, ends the replay of that segment.
+class BudgetWriteAheadLog {
+ public:
+  // Called with the outcome of an append once it is durable or has failed.
+  using AppendCallback = std::function<void(core::ExecutionResult)>;
+  using RecordVisitor = std::function<void(const BudgetRecord&)>;
+  // Calls the visitor once for every row of the table. Used to write
+  // snapshots, it can run concurrently with appends.
+  using SnapshotProvider = std::function<void(const RecordVisitor&)>;
+
+  BudgetWriteAheadLog(std::string directory,
+                      uint64_t compaction_threshold_bytes,
+                      SnapshotProvider snapshot_provider);
+
+  ~BudgetWriteAheadLog();
+
+  // Calls the visitor for every record of the snapshot and the log segments in
+  // the directory, in the order in which they were appended. Must be called
+  // before Run.
+  core::ExecutionResult Recover(const RecordVisitor& visitor);
+
+  core::ExecutionResult Run();
+
+  // Flushes the pending appends and stops the background threads.
+  core::ExecutionResult Stop();
+
+  // Appends the records to the log. The callback is called on the flusher
+  // thread once the records, and all the records appended before them, are
+  // durable. An empty list of records can be used to wait for the durability
+  // of the previous appends.
+  //
+  // Callers that need records of the same key to be replayed in the order in
+  // which they were applied must serialize their appends.
+  core::ExecutionResult Append(const std::vector<BudgetRecord>& records,
+                               AppendCallback callback);
+
+ private:
+  std::string SegmentPath(uint64_t segment_id) const;
+
+  std::string SnapshotPath() const;
+
+  // Returns the ids of the log segments in the directory, in increasing order.
+  core::ExecutionResultOr<std::vector<uint64_t>> ListSegments() const;
+
+  core::ExecutionResult OpenSegment(uint64_t segment_id);
+
+  void FlushLoop();
+
+  // Writes the buffer to the active segment and syncs it.
+  core::ExecutionResult WriteToSegment(const std::string& buffer);
+
+  // Starts a new segment and requests a snapshot covering the previous ones.
+  // Called by the flusher thread only.
+  void RotateSegmentAndRequestCompaction();
+
+  void CompactionLoop();
+
+  // Writes a snapshot of the table from which replay starts at
+  // first_segment_id, then deletes the segments it covers.
+  core::ExecutionResult Compact(uint64_t first_segment_id);
+
+  const std::string directory_;
+  const uint64_t compaction_threshold_bytes_;
+  const SnapshotProvider snapshot_provider_;
+
+  // Active segment, only accessed by the flusher thread once running.
+  int segment_fd_ = -1;
+  uint64_t segment_id_ = 0;
+  uint64_t segment_size_bytes_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable flush_condition_;
+  std::condition_variable compaction_condition_;
+  // Serialized records waiting for the flusher thread, and their callbacks.
+  std::string pending_buffer_;
+  std::vector<AppendCallback> pending_callbacks_;
+  bool running_ = false;
+  bool stopping_ = false;
+  // A failed write leaves the log in an unknown state, after which every
+  // append fails.
+  bool failed_ = false;
+  bool compaction_in_progress_ = false;
+  // Segment from which the requested snapshot must be replayed.
+  uint64_t compaction_first_segment_id_ = 0;
+  bool compaction_requested_ = false;
+
+  std::unique_ptr<std::thread> flusher_thread_;
+  std::unique_ptr<std::thread> compaction_thread_;
+};
+
+}  // namespace google::scp::pbs
+
+#endif  // CC_PBS_CONSUME_BUDGET_SRC_LOCAL_BUDGET_WRITE_AHEAD_LOG_H_
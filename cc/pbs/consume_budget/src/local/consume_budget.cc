@@ -0,0 +1,269 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "cc/pbs/consume_budget/src/local/consume_budget.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/strings/numbers.h"
+#include "cc/core/interface/config_provider_interface.h"
+#include "cc/pbs/budget_key_timeframe_manager/src/budget_key_timeframe_utils.h"
+#include "cc/pbs/consume_budget/src/gcp/error_codes.h"
+#include "cc/pbs/consume_budget/src/local/error_codes.h"
+#include "cc/pbs/interface/configuration_keys.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace google::scp::pbs {
+namespace {
+
+using ::google::scp::core::AsyncContext;
+using ::google::scp::core::AsyncExecutorInterface;
+using ::google::scp::core::ConfigProviderInterface;
+using ::google::scp::core::ExecutionResult;
+using ::google::scp::core::FailureExecutionResult;
+using ::google::scp::core::SuccessExecutionResult;
+using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_EXHAUSTED;
+using ::google::scp::pbs::errors::
+    SC_LOCAL_CONSUME_BUDGET_INVALID_CONFIGURATION;
+
+constexpr TokenCount kDefaultPrivacyBudgetCount = 1;
+constexpr size_t kDefaultShardCount = 16;
+constexpr size_t kDefaultCompactionThresholdBytes = 64 << 20;
+
+PbsPrimaryKeyRef MakePbsPrimaryKey(const ConsumeBudgetMetadata& metadata) {
+  // GetTimeGroup returns the number of days since epoch
+  return PbsPrimaryKeyRef(
+      metadata.budget_key_name,
+      budget_key_timeframe_manager::Utils::GetTimeGroup(metadata.time_bucket));
+}
+
+}  // namespace
+
+LocalBudgetConsumptionHelper::LocalBudgetConsumptionHelper(
+    ConfigProviderInterface* config_provider,
+    AsyncExecutorInterface* async_executor)
+    : config_provider_(config_provider), async_executor_(async_executor) {}
+
+ExecutionResult LocalBudgetConsumptionHelper::Init() noexcept {
+  size_t shard_count = kDefaultShardCount;
+  config_provider_->Get(kLocalBudgetStorageShardCount, shard_count);
+  if (shard_count == 0) {
+    return FailureExecutionResult(
+        SC_LOCAL_CONSUME_BUDGET_INVALID_CONFIGURATION);
+  }
+  shards_.clear();
+  for (size_t i = 0; i < shard_count; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+
+  std::string directory;
+  config_provider_->Get(kLocalBudgetStorageDirectory, directory);
+  if (directory.empty()) {
+    return SuccessExecutionResult();
+  }
+
+  size_t compaction_threshold_bytes = kDefaultCompactionThresholdBytes;
+  config_provider_->Get(kLocalBudgetStorageCompactionThresholdBytes,
+                        compaction_threshold_bytes);
+  write_ahead_log_ = std::make_unique<BudgetWriteAheadLog>(
+      std::move(directory), compaction_threshold_bytes,
+      [this](const BudgetWriteAheadLog::RecordVisitor& visitor) {
+        VisitRecords(visitor);
+      });
+  return write_ahead_log_->Recover(
+      [this](const BudgetRecord& record) { ApplyRecord(record); });
+}
+
+ExecutionResult LocalBudgetConsumptionHelper::Run() noexcept {
+  if (write_ahead_log_) {
+    return write_ahead_log_->Run();
+  }
+  return SuccessExecutionResult();
+}
+
+ExecutionResult LocalBudgetConsumptionHelper::Stop() noexcept {
+  if (write_ahead_log_) {
+    return write_ahead_log_->Stop();
+  }
+  return SuccessExecutionResult();
+}
+
+size_t LocalBudgetConsumptionHelper::GetShardIndex(
+    const PbsPrimaryKeyRef& key) const {
+  return absl::HashOf(key) % shards_.size();
+}
+
+void LocalBudgetConsumptionHelper::ApplyRecord(const BudgetRecord& record) {
+  TimeGroup time_group = 0;
+  if (!absl::SimpleAtoi(record.timeframe, &time_group)) {
+    return;
+  }
+  PbsPrimaryKeyRef key(record.budget_key, time_group);
+  std::unique_lock lock(shards_[GetShardIndex(key)]->mutex);
+  StoreBudgets(key, record.token_counts);
+}
+
+void LocalBudgetConsumptionHelper::StoreBudgets(
+    const PbsPrimaryKeyRef& key, const HourTokenCounts& token_counts) {
+  Shard& shard = *shards_[GetShardIndex(key)];
+  if (auto stored_budget = shard.budgets.find(key);
+      stored_budget != shard.budgets.end()) {
+    stored_budget->second = token_counts;
+  } else {
+    shard.budgets.emplace(PbsPrimaryKey(key), token_counts);
+  }
+}
+
+void LocalBudgetConsumptionHelper::VisitRecords(
+    const BudgetWriteAheadLog::RecordVisitor& visitor) {
+  for (const auto& shard : shards_) {
+    std::unique_lock lock(shard->mutex);
+    for (const auto& [key, token_counts] : shard->budgets) {
+      visitor(BudgetRecord{.budget_key = key.budget_key(),
+                           .timeframe = key.timeframe(),
+                           .token_counts = token_counts});
+    }
+  }
+}
+
+void LocalBudgetConsumptionHelper::FinishContext(
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
+        consume_budgets_context) {
+  if (!async_executor_->Schedule(
+          [consume_budgets_context]() mutable {
+            consume_budgets_context.Finish();
+          },
+          google::scp::core::AsyncPriority::Normal)) {
+    consume_budgets_context.Finish();
+  }
+}
+
+ExecutionResult LocalBudgetConsumptionHelper::ConsumeBudgets(
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
+        consume_budgets_context) {
+  const std::vector<ConsumeBudgetMetadata>& budgets_metadata =
+      consume_budgets_context.request->budgets;
+  std::vector<PbsPrimaryKeyRef> primary_keys;
+  std::vector<size_t> shard_indices;
+  primary_keys.reserve(budgets_metadata.size());
+  shard_indices.reserve(budgets_metadata.size());
+  for (const ConsumeBudgetMetadata& metadata : budgets_metadata) {
+    primary_keys.push_back(MakePbsPrimaryKey(metadata));
+    shard_indices.push_back(GetShardIndex(primary_keys.back()));
+  }
+
+  // Shards are locked in increasing order so that concurrent requests cannot
+  // deadlock, and stay locked until the request is appended to the log and
+  // applied, so that the log holds the records of a key in the order in which
+  // they were applied.
+  std::vector<size_t> locked_shard_indices = shard_indices;
+  std::sort(locked_shard_indices.begin(), locked_shard_indices.end());
+  locked_shard_indices.erase(
+      std::unique(locked_shard_indices.begin(), locked_shard_indices.end()),
+      locked_shard_indices.end());
+  std::vector<std::unique_lock<std::mutex>> locks;
+  locks.reserve(locked_shard_indices.size());
+  for (size_t shard_index : locked_shard_indices) {
+    locks.emplace_back(shards_[shard_index]->mutex);
+  }
+
+  // Budgets are consumed on copies of the stored ones, which are only written
+  // back if none of the budgets is exhausted and the log accepted them.
+  absl::flat_hash_map<PbsPrimaryKeyRef, HourTokenCounts> updated_budgets;
+  std::vector<size_t> budget_exhausted_indices;
+  for (size_t i = 0; i < budgets_metadata.size(); ++i) {
+    auto [updated_budget, inserted] =
+        updated_budgets.try_emplace(primary_keys[i]);
+    if (inserted) {
+      const auto& stored_budgets = shards_[shard_indices[i]]->budgets;
+      if (auto stored_budget = stored_budgets.find(primary_keys[i]);
+          stored_budget != stored_budgets.end()) {
+        updated_budget->second = stored_budget->second;
+      } else {
+        updated_budget->second.fill(kDefaultPrivacyBudgetCount);
+      }
+    }
+
+    TimeBucket hours_of_the_day =
+        budget_key_timeframe_manager::Utils::GetTimeBucket(
+            budgets_metadata[i].time_bucket);
+    TokenCount& token_count = updated_budget->second[hours_of_the_day];
+    if (token_count < budgets_metadata[i].token_count) {
+      budget_exhausted_indices.push_back(i);
+      continue;
+    }
+    token_count -= budgets_metadata[i].token_count;
+  }
+
+  const bool consumed = budget_exhausted_indices.empty();
+  if (consumed) {
+    consume_budgets_context.result = SuccessExecutionResult();
+  } else {
+    consume_budgets_context.response->budget_exhausted_indices =
+        std::move(budget_exhausted_indices);
+    consume_budgets_context.result =
+        FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED);
+  }
+
+  if (write_ahead_log_) {
+    std::vector<BudgetRecord> records;
+    if (consumed) {
+      records.reserve(updated_budgets.size());
+      for (const auto& [primary_key, token_counts] : updated_budgets) {
+        records.push_back(
+            BudgetRecord{.budget_key = std::string(primary_key.budget_key()),
+                         .timeframe = primary_key.timeframe(),
+                         .token_counts = token_counts});
+      }
+    }
+
+    // The response is only sent once the log is durable up to this request,
+    // so an exhausted result also waits for the consumptions it observed. The
+    // requests reading budgets applied before they are durable are thus only
+    // answered once these are. If a write fails, every later append fails
+    // too, and the consumption stays applied in memory, which can only make
+    // less budget available.
+    if (auto execution_result = write_ahead_log_->Append(
+            records, [this, consume_budgets_context](
+                         ExecutionResult execution_result) mutable {
+              if (!execution_result.Successful() &&
+                  consume_budgets_context.result.Successful()) {
+                consume_budgets_context.result = execution_result;
+              }
+              FinishContext(std::move(consume_budgets_context));
+            });
+        !execution_result.Successful()) {
+      // Nothing was applied, and the context is not finished.
+      return execution_result;
+    }
+  }
+
+  if (consumed) {
+    for (const auto& [primary_key, token_counts] : updated_budgets) {
+      StoreBudgets(primary_key, token_counts);
+    }
+  }
+  locks.clear();
+
+  if (!write_ahead_log_) {
+    FinishContext(std::move(consume_budgets_context));
+  }
+  return SuccessExecutionResult();
+}
+
+}  // namespace google::scp::pbs
@@ -0,0 +1,98 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CC_PBS_CONSUME_BUDGET_SRC_LOCAL_CONSUME_BUDGET_H_
+#define CC_PBS_CONSUME_BUDGET_SRC_LOCAL_CONSUME_BUDGET_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "cc/core/interface/async_context.h"
+#include "cc/core/interface/async_executor_interface.h"
+#include "cc/core/interface/config_provider_interface.h"
+#include "cc/pbs/consume_budget/src/gcp/hour_token_counts.h"
+#include "cc/pbs/consume_budget/src/gcp/pbs_primary_key.h"
+#include "cc/pbs/consume_budget/src/local/budget_write_ahead_log.h"
+#include "cc/pbs/interface/consume_budget_interface.h"
+#include "cc/pbs/interface/type_def.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace google::scp::pbs {
+
+// A helper class to consume privacy budgets for a given list of privacy budget
+// keys from an embedded store, without any database.
+//
+// Budgets are kept in a sharded in-memory table. If a storage directory is
+// configured, every consumption is appended to a BudgetWriteAheadLog before it
+// is applied to the table, is acknowledged once durable, and the table is
+// recovered from the log on Init. Like the Spanner backed helper, a request
+// either consumes all of its budgets or none of them.
+class LocalBudgetConsumptionHelper : public BudgetConsumptionHelperInterface {
+ public:
+  LocalBudgetConsumptionHelper(
+      google::scp::core::ConfigProviderInterface* config_provider,
+      google::scp::core::AsyncExecutorInterface* async_executor);
+
+  google::scp::core::ExecutionResult Init() noexcept override;
+
+  google::scp::core::ExecutionResult Run() noexcept override;
+
+  google::scp::core::ExecutionResult Stop() noexcept override;
+
+  // Consumes privacy budgets for the given list of privacy budget keys in
+  // consume_budget_context.
+  google::scp::core::ExecutionResult ConsumeBudgets(
+      google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                      ConsumeBudgetsResponse>
+          consume_budgets_context) override;
+
+ private:
+  struct Shard {
+    std::mutex mutex;
+    absl::flat_hash_map<PbsPrimaryKey, HourTokenCounts, PbsPrimaryKeyHash,
+                        PbsPrimaryKeyEq>
+        budgets;
+  };
+
+  size_t GetShardIndex(const PbsPrimaryKeyRef& key) const;
+
+  // Stores the budgets in the table, replacing any previous budgets of the
+  // key. The shard of the key must be locked.
+  void StoreBudgets(const PbsPrimaryKeyRef& key,
+                    const HourTokenCounts& token_counts);
+
+  // Stores the record in the table, replacing any previous budgets of its key.
+  void ApplyRecord(const BudgetRecord& record);
+
+  // Calls the visitor for every row of the table, one shard at a time.
+  void VisitRecords(const BudgetWriteAheadLog::RecordVisitor& visitor);
+
+  // Schedules the completion of the context on async_executor_.
+  void FinishContext(google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                                     ConsumeBudgetsResponse>
+                         consume_budgets_context);
+
+  google::scp::core::ConfigProviderInterface* config_provider_;
+  google::scp::core::AsyncExecutorInterface* async_executor_;
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  // Null if the budgets are only kept in memory.
+  std::unique_ptr<BudgetWriteAheadLog> write_ahead_log_;
+};
+
+}  // namespace google::scp::pbs
+
+#endif  // CC_PBS_CONSUME_BUDGET_SRC_LOCAL_CONSUME_BUDGET_H_
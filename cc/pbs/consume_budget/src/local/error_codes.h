@@ -0,0 +1,49 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CC_PBS_CONSUME_BUDGET_SRC_LOCAL_ERROR_CODES_H_
+#define CC_PBS_CONSUME_BUDGET_SRC_LOCAL_ERROR_CODES_H_
+
+#include "cc/core/interface/errors.h"
+
+namespace google::scp::pbs::errors {
+REGISTER_COMPONENT_CODE(SC_PBS_LOCAL_CONSUME_BUDGET, 0x0158)
+
+DEFINE_ERROR_CODE(
+    SC_LOCAL_CONSUME_BUDGET_INVALID_CONFIGURATION, SC_PBS_LOCAL_CONSUME_BUDGET,
+    0x0001, "Invalid LocalBudgetConsumptionHelper configuration.",
+    google::scp::core::errors::HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(
+    SC_LOCAL_CONSUME_BUDGET_WAL_OPEN_ERROR, SC_PBS_LOCAL_CONSUME_BUDGET,
+    0x0002, "Failed to open the budget write-ahead log.",
+    google::scp::core::errors::HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(
+    SC_LOCAL_CONSUME_BUDGET_WAL_CORRUPTED, SC_PBS_LOCAL_CONSUME_BUDGET, 0x0003,
+    "The budget snapshot is corrupted.",
+    google::scp::core::errors::HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(
+    SC_LOCAL_CONSUME_BUDGET_WAL_WRITE_ERROR, SC_PBS_LOCAL_CONSUME_BUDGET,
+    0x0004, "Failed to persist to the budget write-ahead log.",
+    google::scp::core::errors::HttpStatusCode::INTERNAL_SERVER_ERROR)
+
+DEFINE_ERROR_CODE(
+    SC_LOCAL_CONSUME_BUDGET_WAL_NOT_RUNNING, SC_PBS_LOCAL_CONSUME_BUDGET,
+    0x0005, "The budget write-ahead log is not running.",
+    google::scp::core::errors::HttpStatusCode::SERVICE_UNAVAILABLE)
+
+}  // namespace google::scp::pbs::errors
+
+#endif  // CC_PBS_CONSUME_BUDGET_SRC_LOCAL_ERROR_CODES_H_
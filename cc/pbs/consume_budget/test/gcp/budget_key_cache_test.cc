@@ -0,0 +1,166 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "cc/pbs/consume_budget/src/gcp/budget_key_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include "cc/pbs/consume_budget/src/gcp/hour_token_counts.h"
+#include "cc/pbs/consume_budget/src/gcp/pbs_primary_key.h"
+#include "cc/pbs/interface/type_def.h"
+
+namespace google::scp::pbs {
+namespace {
+
+constexpr std::chrono::nanoseconds kMaxAge = std::chrono::seconds(1);
+// Steady clock time of the observations and lookups, in nanoseconds.
+constexpr core::Timestamp kNow = 1000000000;
+
+HourTokenCounts FullBudgets() {
+  HourTokenCounts budgets;
+  budgets.fill(1);
+  return budgets;
+}
+
+TEST(BudgetKeyCacheTest, UnknownKeyIsNotExhausted) {
+  BudgetKeyCache cache(/*max_entries=*/10, kMaxAge);
+  EXPECT_FALSE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 1, 1, kNow));
+}
+
+TEST(BudgetKeyCacheTest, ExhaustedHourIsKnown) {
+  BudgetKeyCache cache(/*max_entries=*/10, kMaxAge);
+  HourTokenCounts budgets = FullBudgets();
+  budgets[1] = 0;
+  cache.Update(PbsPrimaryKeyRef("key", 0), budgets, /*version=*/10,
+               cache.StartObservation(kNow));
+
+  EXPECT_TRUE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 1, 1, kNow));
+  EXPECT_FALSE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 1, 0, kNow));
+  EXPECT_FALSE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 2, 1, kNow));
+  EXPECT_FALSE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 1), 1, 1, kNow));
+}
+
+TEST(BudgetKeyCacheTest, NewerVersionReplacesEntry) {
+  BudgetKeyCache cache(/*max_entries=*/10, kMaxAge);
+  cache.Update(PbsPrimaryKeyRef("key", 0), FullBudgets(), /*version=*/10,
+               cache.StartObservation(kNow));
+
+  HourTokenCounts budgets = FullBudgets();
+  budgets[3] = 0;
+  cache.Update(PbsPrimaryKeyRef("key", 0), budgets, /*version=*/20,
+               cache.StartObservation(kNow));
+
+  EXPECT_TRUE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 3, 1, kNow));
+}
+
+TEST(BudgetKeyCacheTest, OlderVersionOnlyAddsExhaustedHours) {
+  BudgetKeyCache cache(/*max_entries=*/10, kMaxAge);
+  HourTokenCounts newer_budgets = FullBudgets();
+  newer_budgets[3] = 0;
+  cache.Update(PbsPrimaryKeyRef("key", 0), newer_budgets, /*version=*/20,
+               cache.StartObservation(kNow));
+
+  HourTokenCounts older_budgets = FullBudgets();
+  older_budgets[5] = 0;
+  cache.Update(PbsPrimaryKeyRef("key", 0), older_budgets, /*version=*/10,
+               cache.StartObservation(kNow));
+  cache.Update(PbsPrimaryKeyRef("key", 0), FullBudgets(),
+               BudgetKeyCache::kUnknownVersion, cache.StartObservation(kNow));
+
+  EXPECT_TRUE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 3, 1, kNow));
+  EXPECT_TRUE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 5, 1, kNow));
+}
+
+TEST(BudgetKeyCacheTest, InvalidatedKeyIsNotExhausted) {
+  BudgetKeyCache cache(/*max_entries=*/10, kMaxAge);
+  HourTokenCounts budgets = FullBudgets();
+  budgets[1] = 0;
+  cache.Update(PbsPrimaryKeyRef("key", 0), budgets, /*version=*/10,
+               cache.StartObservation(kNow));
+  cache.Invalidate(PbsPrimaryKeyRef("key", 0));
+
+  EXPECT_EQ(cache.Size(), 0);
+  EXPECT_FALSE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 1, 1, kNow));
+}
+
+TEST(BudgetKeyCacheTest, ObservationStartedBeforeInvalidationIsDropped) {
+  BudgetKeyCache cache(/*max_entries=*/10, kMaxAge);
+  HourTokenCounts budgets = FullBudgets();
+  budgets[1] = 0;
+  BudgetKeyCache::Observation stale_observation = cache.StartObservation(kNow);
+  cache.Invalidate(PbsPrimaryKeyRef("key", 0));
+  cache.Update(PbsPrimaryKeyRef("key", 0), budgets,
+               BudgetKeyCache::kUnknownVersion, stale_observation);
+  cache.Update(PbsPrimaryKeyRef("key", 0), budgets, /*version=*/10,
+               stale_observation);
+
+  EXPECT_FALSE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 1, 1, kNow));
+
+  cache.Update(PbsPrimaryKeyRef("key", 0), budgets,
+               BudgetKeyCache::kUnknownVersion, cache.StartObservation(kNow));
+  EXPECT_TRUE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 1, 1, kNow));
+}
+
+TEST(BudgetKeyCacheTest, EvictsLeastRecentlyUsedKey) {
+  BudgetKeyCache cache(/*max_entries=*/2, kMaxAge, /*shard_count=*/1);
+  HourTokenCounts budgets = FullBudgets();
+  budgets[0] = 0;
+  cache.Update(PbsPrimaryKeyRef("key1", 0), budgets, /*version=*/1,
+               cache.StartObservation(kNow));
+  cache.Update(PbsPrimaryKeyRef("key2", 0), budgets, /*version=*/1,
+               cache.StartObservation(kNow));
+  // Touching key1 makes key2 the least recently used key.
+  EXPECT_TRUE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key1", 0), 0, 1, kNow));
+  cache.Update(PbsPrimaryKeyRef("key3", 0), budgets, /*version=*/1,
+               cache.StartObservation(kNow));
+
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_TRUE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key1", 0), 0, 1, kNow));
+  EXPECT_FALSE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key2", 0), 0, 1, kNow));
+  EXPECT_TRUE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key3", 0), 0, 1, kNow));
+}
+
+TEST(BudgetKeyCacheTest, EntryOlderThanMaxAgeIsDropped) {
+  BudgetKeyCache cache(/*max_entries=*/10, kMaxAge);
+  HourTokenCounts budgets = FullBudgets();
+  budgets[1] = 0;
+  cache.Update(PbsPrimaryKeyRef("key", 0), budgets, /*version=*/10,
+               cache.StartObservation(kNow));
+
+  const core::Timestamp max_age = kMaxAge.count();
+  EXPECT_TRUE(
+      cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 1, 1, kNow + max_age));
+  EXPECT_FALSE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 1, 1,
+                                      kNow + max_age + 1));
+  EXPECT_EQ(cache.Size(), 0);
+}
+
+TEST(BudgetKeyCacheTest, MergedEntryIsAsOldAsItsOldestObservation) {
+  BudgetKeyCache cache(/*max_entries=*/10, kMaxAge);
+  HourTokenCounts newer_budgets = FullBudgets();
+  newer_budgets[3] = 0;
+  cache.Update(PbsPrimaryKeyRef("key", 0), newer_budgets, /*version=*/20,
+               cache.StartObservation(kNow));
+  HourTokenCounts older_budgets = FullBudgets();
+  older_budgets[5] = 0;
+  cache.Update(PbsPrimaryKeyRef("key", 0), older_budgets, /*version=*/10,
+               cache.StartObservation(kNow - 1));
+
+  EXPECT_FALSE(cache.IsKnownExhausted(PbsPrimaryKeyRef("key", 0), 3, 1,
+                                      kNow + kMaxAge.count()));
+}
+}  // namespace
+}  // namespace google::scp::pbs
@@ -46,13 +46,16 @@ using ::google::scp::core::AsyncExecutor;
 using ::google::scp::core::AsyncExecutorInterface;
 using ::google::scp::core::ExecutionResult;
 using ::google::scp::core::FailureExecutionResult;
+using ::google::scp::core::RetryExecutionResult;
 using ::google::scp::core::SuccessExecutionResult;
 using ::google::scp::core::config_provider::mock::MockConfigProvider;
 using ::google::scp::core::errors::SC_ASYNC_EXECUTOR_NOT_RUNNING;
 using ::google::scp::core::test::ResultIs;
 using ::google::scp::pbs::kBudgetKeyTableName;
 using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_EXHAUSTED;
+using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_GROUP_COMMIT_QUEUE_FULL;
 using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_INITIALIZATION_ERROR;
+using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_INVALID_CONFIGURATION;
 using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_PARSING_ERROR;
 using ::testing::_;
 using ::testing::AllOf;
@@ -86,6 +89,10 @@ constexpr int32_t kEmptyBudgetCount = 0;
 constexpr size_t kDefaultTokenCountSize = 24;
 constexpr absl::string_view kTableName = "fake-table-name";
 constexpr absl::string_view kFakeKeyName = "fake-key-name";
+constexpr absl::string_view kOtherFakeKeyName = "other-fake-key-name";
+constexpr size_t kGroupCommitMaxBatchSize = 2;
+constexpr size_t kGroupCommitMaxLingerMs = 100;
+constexpr size_t kBudgetKeyCacheMaxEntries = 100;
 
 constexpr absl::string_view kBudgetKeyTableMetadataPhase1 = R"pb(
   row_type: {
@@ -226,9 +233,14 @@ class BudgetConsumptionHelperWithLifecycleTest
     BudgetConsumptionHelperTest::SetUp();
     mock_config_provider_->Set(kBudgetKeyTableName, std::string(kTableName));
     mock_config_provider_->Set(kValueProtoMigrationPhase, GetMigrationPhase());
+    SetAdditionalConfigs();
     ASSERT_SUCCESS(InitAndRunComponents());
   }
 
+  // Sets configurations of the helper on top of the table name and migration
+  // phase before it is initialized.
+  virtual void SetAdditionalConfigs() {}
+
   void TearDown() override {
     BudgetConsumptionHelperTest::TearDown();
     ASSERT_SUCCESS(StopComponents());
@@ -270,9 +282,10 @@ class BudgetConsumptionHelperWithLifecycleTest
   }
 
   std::vector<spanner::Value> GetTableValues(
-      absl::Span<const int64_t> token_count) {
+      absl::Span<const int64_t> token_count,
+      absl::string_view key_name = kFakeKeyName) {
     std::vector<spanner::Value> values = {
-        spanner::Value(std::string(kFakeKeyName)),
+        spanner::Value(std::string(key_name)),
         spanner::Value("0"),
     };
 
@@ -322,9 +335,10 @@ class BudgetConsumptionHelperWithLifecycleTest
   }
 
   std::vector<std::pair<std::string, spanner::Value>> GetRowPairsForNextRow(
-      absl::Span<const int64_t> token_count) {
+      absl::Span<const int64_t> token_count,
+      absl::string_view key_name = kFakeKeyName) {
     std::vector<std::string> columns = GetTableColumns();
-    std::vector<spanner::Value> values = GetTableValues(token_count);
+    std::vector<spanner::Value> values = GetTableValues(token_count, key_name);
     EXPECT_EQ(columns.size(), values.size());
 
     std::vector<std::pair<std::string, spanner::Value>> zipped_vector;
@@ -378,7 +392,7 @@ TEST_P(BudgetConsumptionHelperWithLifecycleTest,
   AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
   context.request = std::make_shared<ConsumeBudgetsRequest>();
   ConsumeBudgetMetadata consume_budget_metadata{
-      .budget_key_name = std::make_shared<std::string>(kFakeKeyName),
+      .budget_key_name = kFakeKeyName,
       .token_count = 1,
       .time_bucket = 3601000000000};
   context.request->budgets.push_back(consume_budget_metadata);
@@ -423,7 +437,7 @@ TEST_P(BudgetConsumptionHelperWithLifecycleTest,
   AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
   context.request = std::make_shared<ConsumeBudgetsRequest>();
   ConsumeBudgetMetadata consume_budget_metadata{
-      .budget_key_name = std::make_shared<std::string>(kFakeKeyName),
+      .budget_key_name = kFakeKeyName,
       .token_count = 1,
       .time_bucket = 3601000000000};
   context.request->budgets.push_back(consume_budget_metadata);
@@ -475,7 +489,7 @@ TEST_P(BudgetConsumptionHelperWithLifecycleTest, ConsumeBudgetsWithoutBudget) {
   AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
   context.request = std::make_shared<ConsumeBudgetsRequest>();
   ConsumeBudgetMetadata consume_budget_metadata{
-      .budget_key_name = std::make_shared<std::string>(kFakeKeyName),
+      .budget_key_name = kFakeKeyName,
       .token_count = 1,
       .time_bucket = 3601000000000};
   context.request->budgets.push_back(consume_budget_metadata);
@@ -527,7 +541,7 @@ TEST_P(BudgetConsumptionHelperWithLifecycleTest,
   AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
   context.request = std::make_shared<ConsumeBudgetsRequest>();
   ConsumeBudgetMetadata consume_budget_metadata{
-      .budget_key_name = std::make_shared<std::string>(kFakeKeyName),
+      .budget_key_name = kFakeKeyName,
       .token_count = 1,
       .time_bucket = 3601000000000};
   context.request->budgets.push_back(consume_budget_metadata);
@@ -579,7 +593,7 @@ TEST_P(BudgetConsumptionHelperWithLifecycleTest,
   AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
   context.request = std::make_shared<ConsumeBudgetsRequest>();
   ConsumeBudgetMetadata consume_budget_metadata{
-      .budget_key_name = std::make_shared<std::string>(kFakeKeyName),
+      .budget_key_name = kFakeKeyName,
       .token_count = 1,
       .time_bucket = 3601000000000};
   context.request->budgets.push_back(consume_budget_metadata);
@@ -632,7 +646,7 @@ TEST_P(BudgetConsumptionHelperWithLifecycleTest,
   AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
   context.request = std::make_shared<ConsumeBudgetsRequest>();
   ConsumeBudgetMetadata consume_budget_metadata{
-      .budget_key_name = std::make_shared<std::string>(kFakeKeyName),
+      .budget_key_name = kFakeKeyName,
       .token_count = 1,
       .time_bucket = 3601000000000};
   context.request->budgets.push_back(consume_budget_metadata);
@@ -686,7 +700,7 @@ TEST_P(BudgetConsumptionHelperWithLifecycleTest,
   AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
   context.request = std::make_shared<ConsumeBudgetsRequest>();
   ConsumeBudgetMetadata consume_budget_metadata{
-      .budget_key_name = std::make_shared<std::string>(kFakeKeyName),
+      .budget_key_name = kFakeKeyName,
       .token_count = 1,
       .time_bucket = 3601000000000};
   context.request->budgets.push_back(consume_budget_metadata);
@@ -740,7 +754,7 @@ TEST_P(BudgetConsumptionHelperWithLifecycleTest,
   AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
   context.request = std::make_shared<ConsumeBudgetsRequest>();
   ConsumeBudgetMetadata consume_budget_metadata{
-      .budget_key_name = std::make_shared<std::string>(kFakeKeyName),
+      .budget_key_name = kFakeKeyName,
       .token_count = 1,
       .time_bucket = 3601000000000};
   context.request->budgets.push_back(consume_budget_metadata);
@@ -798,7 +812,7 @@ TEST_P(BudgetConsumptionHelperWithLifecycleTest,
   AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
   context.request = std::make_shared<ConsumeBudgetsRequest>();
   ConsumeBudgetMetadata consume_budget_metadata{
-      .budget_key_name = std::make_shared<std::string>(kFakeKeyName),
+      .budget_key_name = kFakeKeyName,
       .token_count = 1,
       .time_bucket = 3601000000000};
   context.request->budgets.push_back(consume_budget_metadata);
@@ -822,5 +836,460 @@ TEST_P(BudgetConsumptionHelperWithLifecycleTest,
       ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_PARSING_ERROR)));
   EXPECT_THAT(result_context.response->budget_exhausted_indices, IsEmpty());
 }
+
+class BudgetConsumptionHelperGroupCommitTest
+    : public BudgetConsumptionHelperWithLifecycleTest {
+ protected:
+  void SetAdditionalConfigs() override {
+    mock_config_provider_->SetInt(kBudgetConsumptionGroupCommitMaxBatchSize,
+                                  kGroupCommitMaxBatchSize);
+    mock_config_provider_->SetInt(kBudgetConsumptionGroupCommitMaxLingerMs,
+                                  kGroupCommitMaxLingerMs);
+  }
+
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> MakeContext(
+      absl::string_view key_name, absl::Notification& notification,
+      AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&
+          result_context) {
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
+    context.request = std::make_shared<ConsumeBudgetsRequest>();
+    context.request->budgets.push_back(ConsumeBudgetMetadata{
+        .budget_key_name = context.request->budget_key_names.Add({key_name}),
+        .token_count = 1,
+        .time_bucket = 3601000000000});
+    context.response = std::make_shared<ConsumeBudgetsResponse>();
+    context.callback = [notification = &notification,
+                        result_context = &result_context](
+                           AsyncContext<ConsumeBudgetsRequest,
+                                        ConsumeBudgetsResponse>& context) {
+      *result_context = context;
+      notification->Notify();
+    };
+    return context;
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(BudgetConsumptionHelperGroupCommitTest,
+                         BudgetConsumptionHelperGroupCommitTest,
+                         Values(kMigrationPhase1, kMigrationPhase2,
+                                kMigrationPhase3, kMigrationPhase4));
+
+TEST_F(BudgetConsumptionHelperTest, ZeroGroupCommitBatchSizeShouldFail) {
+  mock_config_provider_->Set(kBudgetKeyTableName, std::string(kTableName));
+  mock_config_provider_->SetInt(kBudgetConsumptionGroupCommitMaxBatchSize, 0);
+  EXPECT_THAT(budget_consumption_helper_->Init(),
+              ResultIs(FailureExecutionResult(
+                  SC_CONSUME_BUDGET_INVALID_CONFIGURATION)));
+}
+
+TEST_P(BudgetConsumptionHelperGroupCommitTest,
+       ConcurrentConsumeBudgetsShareOneTransaction) {
+  std::unique_ptr<spanner_mocks::MockResultSetSource> source =
+      CreatePbsMockResultSetSource(GetMigrationPhase());
+
+  std::vector<int64_t> token_count = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                                      1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+  EXPECT_CALL(*source, NextRow())
+      .WillOnce(
+          Return(spanner_mocks::MakeRow(GetRowPairsForNextRow(token_count))))
+      .WillRepeatedly(Return(spanner::Row()));
+
+  spanner::KeySet expected_key_set;
+  expected_key_set.AddKey(spanner::MakeKey(std::string(kFakeKeyName), "0"));
+  expected_key_set.AddKey(
+      spanner::MakeKey(std::string(kOtherFakeKeyName), "0"));
+  EXPECT_CALL(
+      *mock_connection_,
+      Read(AllOf(
+          Field(&spanner::Connection::ReadParams::keys, Eq(expected_key_set)),
+          Field(&spanner::Connection::ReadParams::table, Eq(kTableName)))))
+      .WillOnce(Return(spanner::RowStream(std::move(source))));
+
+  token_count[1] = 0;  // Consuming budget for the concerned hour
+  spanner::Mutation expected_update =
+      cloud::spanner::UpdateMutationBuilder(std::string(kTableName),
+                                            GetTableColumns())
+          .AddRow(GetTableValues(token_count))
+          .Build();
+  spanner::Mutation expected_insert =
+      cloud::spanner::InsertMutationBuilder(std::string(kTableName),
+                                            GetTableColumns())
+          .AddRow(GetTableValues(token_count, kOtherFakeKeyName))
+          .Build();
+  EXPECT_CALL(*mock_connection_,
+              Commit(FieldsAre(
+                  _, UnorderedElementsAre(expected_update, expected_insert),
+                  _)))
+      .WillOnce(Return(spanner::CommitResult{}));
+
+  absl::Notification notification;
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> result_context;
+  absl::Notification other_notification;
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
+      other_result_context;
+  EXPECT_SUCCESS(budget_consumption_helper_->ConsumeBudgets(
+      MakeContext(kFakeKeyName, notification, result_context)));
+  EXPECT_SUCCESS(budget_consumption_helper_->ConsumeBudgets(MakeContext(
+      kOtherFakeKeyName, other_notification, other_result_context)));
+  notification.WaitForNotification();
+  other_notification.WaitForNotification();
+
+  EXPECT_SUCCESS(result_context.result);
+  EXPECT_THAT(result_context.response->budget_exhausted_indices, IsEmpty());
+  EXPECT_SUCCESS(other_result_context.result);
+  EXPECT_THAT(other_result_context.response->budget_exhausted_indices,
+              IsEmpty());
+}
+
+TEST_P(BudgetConsumptionHelperGroupCommitTest,
+       ExhaustedBudgetDoesNotFailBatchMates) {
+  std::unique_ptr<spanner_mocks::MockResultSetSource> source =
+      CreatePbsMockResultSetSource(GetMigrationPhase());
+
+  EXPECT_CALL(*source, NextRow())
+      .WillOnce(Return(spanner_mocks::MakeRow(
+          GetRowPairsForNextRow({1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                                 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}))))
+      .WillRepeatedly(Return(spanner::Row()));
+
+  spanner::KeySet expected_key_set;
+  expected_key_set.AddKey(spanner::MakeKey(std::string(kFakeKeyName), "0"));
+  expected_key_set.AddKey(
+      spanner::MakeKey(std::string(kOtherFakeKeyName), "0"));
+  EXPECT_CALL(
+      *mock_connection_,
+      Read(AllOf(
+          Field(&spanner::Connection::ReadParams::keys, Eq(expected_key_set)),
+          Field(&spanner::Connection::ReadParams::table, Eq(kTableName)))))
+      .WillOnce(Return(spanner::RowStream(std::move(source))));
+
+  std::vector<int64_t> token_count = {1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                                      1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+  spanner::Mutation expected_insert =
+      cloud::spanner::InsertMutationBuilder(std::string(kTableName),
+                                            GetTableColumns())
+          .AddRow(GetTableValues(token_count, kOtherFakeKeyName))
+          .Build();
+  EXPECT_CALL(*mock_connection_,
+              Commit(FieldsAre(_, UnorderedElementsAre(expected_insert), _)))
+      .WillOnce(Return(spanner::CommitResult{}));
+
+  absl::Notification notification;
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> result_context;
+  absl::Notification other_notification;
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
+      other_result_context;
+  EXPECT_SUCCESS(budget_consumption_helper_->ConsumeBudgets(
+      MakeContext(kFakeKeyName, notification, result_context)));
+  EXPECT_SUCCESS(budget_consumption_helper_->ConsumeBudgets(MakeContext(
+      kOtherFakeKeyName, other_notification, other_result_context)));
+  notification.WaitForNotification();
+  other_notification.WaitForNotification();
+
+  EXPECT_THAT(result_context.result,
+              ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  EXPECT_THAT(result_context.response->budget_exhausted_indices,
+              ElementsAre(0));
+  EXPECT_SUCCESS(other_result_context.result);
+  EXPECT_THAT(other_result_context.response->budget_exhausted_indices,
+              IsEmpty());
+}
+
+TEST_P(BudgetConsumptionHelperGroupCommitTest,
+       ConsumeBudgetsOnSameKeyRunInSeparateTransactions) {
+  auto make_source = [&](const std::vector<int64_t>& token_count) {
+    std::unique_ptr<spanner_mocks::MockResultSetSource> source =
+        CreatePbsMockResultSetSource(GetMigrationPhase());
+    EXPECT_CALL(*source, NextRow())
+        .WillOnce(
+            Return(spanner_mocks::MakeRow(GetRowPairsForNextRow(token_count))))
+        .WillRepeatedly(Return(spanner::Row()));
+    return spanner::RowStream(std::move(source));
+  };
+  std::vector<int64_t> full_token_count(kDefaultTokenCountSize, 1);
+  std::vector<int64_t> exhausted_token_count = full_token_count;
+  exhausted_token_count[1] = 0;
+
+  spanner::KeySet expected_key_set;
+  expected_key_set.AddKey(spanner::MakeKey(std::string(kFakeKeyName), "0"));
+  EXPECT_CALL(
+      *mock_connection_,
+      Read(AllOf(
+          Field(&spanner::Connection::ReadParams::keys, Eq(expected_key_set)),
+          Field(&spanner::Connection::ReadParams::table, Eq(kTableName)))))
+      .WillOnce(Return(ByMove(make_source(full_token_count))))
+      .WillOnce(Return(ByMove(make_source(exhausted_token_count))));
+  spanner::Mutation expected_update =
+      cloud::spanner::UpdateMutationBuilder(std::string(kTableName),
+                                            GetTableColumns())
+          .AddRow(GetTableValues(exhausted_token_count))
+          .Build();
+  EXPECT_CALL(*mock_connection_,
+              Commit(FieldsAre(_, UnorderedElementsAre(expected_update), _)))
+      .WillOnce(Return(spanner::CommitResult{}));
+  EXPECT_CALL(*mock_connection_, Rollback).Times(1);
+
+  absl::Notification notification;
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> result_context;
+  absl::Notification other_notification;
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
+      other_result_context;
+  EXPECT_SUCCESS(budget_consumption_helper_->ConsumeBudgets(
+      MakeContext(kFakeKeyName, notification, result_context)));
+  EXPECT_SUCCESS(budget_consumption_helper_->ConsumeBudgets(
+      MakeContext(kFakeKeyName, other_notification, other_result_context)));
+  notification.WaitForNotification();
+  other_notification.WaitForNotification();
+
+  // Only one of the two consumptions gets the budget.
+  EXPECT_NE(result_context.result.Successful(),
+            other_result_context.result.Successful());
+}
+
+class BudgetConsumptionHelperFullGroupCommitTest
+    : public BudgetConsumptionHelperGroupCommitTest {
+ protected:
+  void SetAdditionalConfigs() override {
+    BudgetConsumptionHelperGroupCommitTest::SetAdditionalConfigs();
+    mock_config_provider_->SetInt(kBudgetConsumptionGroupCommitMaxPendingCount,
+                                  1);
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(BudgetConsumptionHelperFullGroupCommitTest,
+                         BudgetConsumptionHelperFullGroupCommitTest,
+                         Values(kMigrationPhase1, kMigrationPhase2,
+                                kMigrationPhase3, kMigrationPhase4));
+
+TEST_P(BudgetConsumptionHelperFullGroupCommitTest,
+       ConsumeBudgetsShouldRetryIfTooManyArePending) {
+  std::unique_ptr<spanner_mocks::MockResultSetSource> source =
+      CreatePbsMockResultSetSource(GetMigrationPhase());
+  EXPECT_CALL(*source, NextRow()).WillRepeatedly(Return(spanner::Row()));
+  EXPECT_CALL(*mock_connection_, Read)
+      .WillOnce(Return(ByMove(spanner::RowStream(std::move(source)))));
+  EXPECT_CALL(*mock_connection_, Commit)
+      .WillOnce(Return(spanner::CommitResult{}));
+
+  absl::Notification notification;
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> result_context;
+  absl::Notification other_notification;
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
+      other_result_context;
+  EXPECT_SUCCESS(budget_consumption_helper_->ConsumeBudgets(
+      MakeContext(kFakeKeyName, notification, result_context)));
+  // The first consumption lingers for its batch to fill up.
+  EXPECT_THAT(budget_consumption_helper_->ConsumeBudgets(MakeContext(
+                  kOtherFakeKeyName, other_notification, other_result_context)),
+              ResultIs(RetryExecutionResult(
+                  SC_CONSUME_BUDGET_GROUP_COMMIT_QUEUE_FULL)));
+  notification.WaitForNotification();
+
+  EXPECT_SUCCESS(result_context.result);
+}
+
+class BudgetConsumptionHelperWithCacheTest
+    : public BudgetConsumptionHelperWithLifecycleTest {
+ protected:
+  void SetAdditionalConfigs() override {
+    mock_config_provider_->SetInt(kBudgetConsumptionCacheMaxEntries,
+                                  kBudgetKeyCacheMaxEntries);
+  }
+
+  // Returns the rows of a read of kFakeKeyName with the given budgets.
+  spanner::RowStream MakeRowStream(const std::vector<int64_t>& token_count) {
+    std::unique_ptr<spanner_mocks::MockResultSetSource> source =
+        CreatePbsMockResultSetSource(GetMigrationPhase());
+    EXPECT_CALL(*source, NextRow())
+        .WillOnce(
+            Return(spanner_mocks::MakeRow(GetRowPairsForNextRow(token_count))))
+        .WillRepeatedly(Return(spanner::Row()));
+    return spanner::RowStream(std::move(source));
+  }
+
+  // Consumes, or returns, one token of kFakeKeyName with the helper.
+  ExecutionResult ConsumeOrReturnBudget(BudgetConsumptionHelper& helper,
+                                        bool return_budgets) {
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
+    context.request = std::make_shared<ConsumeBudgetsRequest>();
+    context.request->budgets.push_back(ConsumeBudgetMetadata{
+        .budget_key_name = kFakeKeyName,
+        .token_count = 1,
+        .time_bucket = 3601000000000});
+    context.response = std::make_shared<ConsumeBudgetsResponse>();
+
+    absl::Notification notification;
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> result_context;
+    context.callback = [&](AsyncContext<ConsumeBudgetsRequest,
+                                        ConsumeBudgetsResponse>& context) {
+      result_context = context;
+      notification.Notify();
+    };
+    EXPECT_SUCCESS(return_budgets ? helper.ReturnBudgets(context)
+                                  : helper.ConsumeBudgets(context));
+    notification.WaitForNotification();
+    return result_context.result;
+  }
+
+  // Expects a consumption rejected by the database, a return of its budget,
+  // then a consumption reaching the database again.
+  void ExpectConsumptionReturnAndConsumption() {
+    std::vector<int64_t> exhausted_token_count = {
+        1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+    std::vector<int64_t> full_token_count(kDefaultTokenCountSize, 1);
+    EXPECT_CALL(*mock_connection_, Read)
+        .WillOnce(Return(ByMove(MakeRowStream(exhausted_token_count))))
+        .WillOnce(Return(ByMove(MakeRowStream(exhausted_token_count))))
+        .WillOnce(Return(ByMove(MakeRowStream(full_token_count))));
+    spanner::Mutation expected_return =
+        cloud::spanner::UpdateMutationBuilder(std::string(kTableName),
+                                              GetTableColumns())
+            .AddRow(GetTableValues(full_token_count))
+            .Build();
+    spanner::Mutation expected_consumption =
+        cloud::spanner::UpdateMutationBuilder(std::string(kTableName),
+                                              GetTableColumns())
+            .AddRow(GetTableValues(exhausted_token_count))
+            .Build();
+    EXPECT_CALL(*mock_connection_,
+                Commit(FieldsAre(_, UnorderedElementsAre(expected_return), _)))
+        .WillOnce(Return(spanner::CommitResult{}));
+    EXPECT_CALL(
+        *mock_connection_,
+        Commit(FieldsAre(_, UnorderedElementsAre(expected_consumption), _)))
+        .WillOnce(Return(spanner::CommitResult{}));
+    EXPECT_CALL(*mock_connection_, Rollback).Times(1);
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(BudgetConsumptionHelperWithCacheTest,
+                         BudgetConsumptionHelperWithCacheTest,
+                         Values(kMigrationPhase1, kMigrationPhase2,
+                                kMigrationPhase3, kMigrationPhase4));
+
+TEST_P(BudgetConsumptionHelperWithCacheTest,
+       KnownExhaustedBudgetShouldFailWithoutTransaction) {
+  std::unique_ptr<spanner_mocks::MockResultSetSource> source =
+      CreatePbsMockResultSetSource(GetMigrationPhase());
+
+  EXPECT_CALL(*source, NextRow())
+      .WillOnce(Return(spanner_mocks::MakeRow(
+          GetRowPairsForNextRow({1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                                 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}))))
+      .WillRepeatedly(Return(spanner::Row()));
+
+  // Only the first request reaches the database.
+  EXPECT_CALL(*mock_connection_, Read)
+      .WillOnce(Return(ByMove(spanner::RowStream(std::move(source)))));
+  EXPECT_CALL(*mock_connection_, Commit).Times(0);
+  EXPECT_CALL(*mock_connection_, Rollback).Times(1);
+
+  for (int i = 0; i < 2; ++i) {
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
+    context.request = std::make_shared<ConsumeBudgetsRequest>();
+    context.request->budgets.push_back(ConsumeBudgetMetadata{
+        .budget_key_name = kFakeKeyName,
+        .token_count = 1,
+        .time_bucket = 3601000000000});
+    context.response = std::make_shared<ConsumeBudgetsResponse>();
+
+    absl::Notification notification;
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> result_context;
+    context.callback = [&](AsyncContext<ConsumeBudgetsRequest,
+                                        ConsumeBudgetsResponse>& context) {
+      result_context = context;
+      notification.Notify();
+    };
+    EXPECT_SUCCESS(budget_consumption_helper_->ConsumeBudgets(context));
+    notification.WaitForNotification();
+
+    EXPECT_THAT(result_context.result,
+                ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+    EXPECT_THAT(result_context.response->budget_exhausted_indices,
+                ElementsAre(0));
+  }
+}
+
+TEST_P(BudgetConsumptionHelperWithCacheTest,
+       ReturnedBudgetShouldNotBeKnownExhausted) {
+  ExpectConsumptionReturnAndConsumption();
+
+  EXPECT_THAT(ConsumeOrReturnBudget(*budget_consumption_helper_,
+                                    /*return_budgets=*/false),
+              ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  EXPECT_SUCCESS(ConsumeOrReturnBudget(*budget_consumption_helper_,
+                                       /*return_budgets=*/true));
+  EXPECT_SUCCESS(ConsumeOrReturnBudget(*budget_consumption_helper_,
+                                       /*return_budgets=*/false));
+}
+
+class BudgetConsumptionHelperWithCacheAndShardsTest
+    : public BudgetConsumptionHelperWithCacheTest {
+ protected:
+  void SetAdditionalConfigs() override {
+    BudgetConsumptionHelperWithCacheTest::SetAdditionalConfigs();
+    mock_config_provider_->SetStringList(kBudgetKeyTableShards,
+                                         {std::string(kTableName)});
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(BudgetConsumptionHelperWithCacheAndShardsTest,
+                         BudgetConsumptionHelperWithCacheAndShardsTest,
+                         Values(kMigrationPhase1, kMigrationPhase2,
+                                kMigrationPhase3, kMigrationPhase4));
+
+TEST_P(BudgetConsumptionHelperWithCacheAndShardsTest,
+       BudgetReturnedByAnotherReplicaShouldNotBeKnownExhausted) {
+  BudgetConsumptionHelper other_replica(
+      mock_config_provider_.get(), async_executor_.get(),
+      io_async_executor_.get(), mock_connection_);
+  ASSERT_SUCCESS(other_replica.Init());
+  ASSERT_SUCCESS(other_replica.Run());
+  ExpectConsumptionReturnAndConsumption();
+
+  EXPECT_THAT(ConsumeOrReturnBudget(*budget_consumption_helper_,
+                                    /*return_budgets=*/false),
+              ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  EXPECT_SUCCESS(ConsumeOrReturnBudget(other_replica, /*return_budgets=*/true));
+  // The budget key cache is disabled with sharded tables, so the consumption
+  // reaches the database instead of being rejected from the cache.
+  EXPECT_SUCCESS(ConsumeOrReturnBudget(*budget_consumption_helper_,
+                                       /*return_budgets=*/false));
+  EXPECT_SUCCESS(other_replica.Stop());
+}
+
+class BudgetConsumptionHelperWithExpiredCacheTest
+    : public BudgetConsumptionHelperWithCacheTest {
+ protected:
+  void SetAdditionalConfigs() override {
+    BudgetConsumptionHelperWithCacheTest::SetAdditionalConfigs();
+    mock_config_provider_->SetInt(kBudgetConsumptionCacheMaxAgeMs, 0);
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(BudgetConsumptionHelperWithExpiredCacheTest,
+                         BudgetConsumptionHelperWithExpiredCacheTest,
+                         Values(kMigrationPhase1, kMigrationPhase2,
+                                kMigrationPhase3, kMigrationPhase4));
+
+TEST_P(BudgetConsumptionHelperWithExpiredCacheTest,
+       BudgetReturnedByAnotherReplicaShouldNotBeKnownExhaustedOnceExpired) {
+  BudgetConsumptionHelper other_replica(
+      mock_config_provider_.get(), async_executor_.get(),
+      io_async_executor_.get(), mock_connection_);
+  ASSERT_SUCCESS(other_replica.Init());
+  ASSERT_SUCCESS(other_replica.Run());
+  ExpectConsumptionReturnAndConsumption();
+
+  EXPECT_THAT(ConsumeOrReturnBudget(*budget_consumption_helper_,
+                                    /*return_budgets=*/false),
+              ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  EXPECT_SUCCESS(ConsumeOrReturnBudget(other_replica, /*return_budgets=*/true));
+  // The return only invalidated the cache of the other replica, but the entry
+  // of this one is older than its max age.
+  EXPECT_SUCCESS(ConsumeOrReturnBudget(*budget_consumption_helper_,
+                                       /*return_budgets=*/false));
+  EXPECT_SUCCESS(other_replica.Stop());
+}
 }  // namespace
 }  // namespace google::scp::pbs
@@ -0,0 +1,468 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "cc/pbs/consume_budget/src/gcp/sharded_consume_budget.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/notification.h"
+#include "cc/core/async_executor/src/async_executor.h"
+#include "cc/core/config_provider/mock/mock_config_provider.h"
+#include "cc/pbs/consume_budget/src/gcp/consume_budget.h"
+#include "cc/pbs/consume_budget/src/gcp/error_codes.h"
+#include "cc/pbs/interface/configuration_keys.h"
+#include "cc/pbs/interface/consume_budget_interface.h"
+#include "cc/pbs/proto/storage/budget_value.pb.h"
+#include "cc/public/core/interface/execution_result.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/spanner/mocks/row.h"
+#include "google/protobuf/text_format.h"
+
+namespace google::scp::pbs {
+namespace {
+
+using ::google::protobuf::TextFormat;
+using ::google::scp::core::AsyncContext;
+using ::google::scp::core::AsyncExecutor;
+using ::google::scp::core::AsyncExecutorInterface;
+using ::google::scp::core::FailureExecutionResult;
+using ::google::scp::core::config_provider::mock::MockConfigProvider;
+using ::google::scp::core::test::ResultIs;
+using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_EXHAUSTED;
+using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_FAIL_TO_COMMIT;
+using ::testing::_;
+using ::testing::ByMove;
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::FieldsAre;
+using ::testing::IsEmpty;
+using ::testing::Return;
+using ::testing::UnorderedElementsAre;
+namespace spanner = ::google::cloud::spanner;
+namespace spanner_mocks = ::google::cloud::spanner_mocks;
+
+constexpr size_t kThreadCount = 5;
+constexpr size_t kQueueSize = 100;
+constexpr size_t kShardCount = 2;
+constexpr int32_t kDefaultLaplaceDpBudgetCount = 6400;
+constexpr int32_t kEmptyBudgetCount = 0;
+constexpr absl::string_view kMigrationPhase4 = "phase_4";
+// Stored in the first shard of two.
+constexpr absl::string_view kFakeKeyName = "fake-key-name";
+// Stored in the second shard of two.
+constexpr absl::string_view kOtherFakeKeyName = "other-fake-key-name";
+// 1970-01-01T01:00:01Z, in the second hour of timeframe "0".
+constexpr uint64_t kTimeBucket = 3601000000000;
+
+constexpr absl::string_view kBudgetKeyTableMetadataPhase4 = R"pb(
+  row_type: {
+    fields: {
+      name: "Budget_Key",
+      type: { code: STRING }
+    }
+    fields: {
+      name: "Timeframe",
+      type: { code: STRING }
+    }
+    fields: {
+      name: "ValueProto",
+      type: { code: PROTO }
+    }
+  })pb";
+
+std::string TableName(size_t shard_index) {
+  return "fake-table-name-" + std::to_string(shard_index);
+}
+
+privacy_sandbox_pbs::BudgetValue MakeBudgetValue(
+    const std::vector<int32_t>& token_counts) {
+  privacy_sandbox_pbs::BudgetValue budget_value;
+  for (int32_t token_count : token_counts) {
+    budget_value.mutable_laplace_dp_budgets()->add_budgets(
+        token_count > 0 ? kDefaultLaplaceDpBudgetCount : kEmptyBudgetCount);
+  }
+  return budget_value;
+}
+
+// Returns the token counts of a day where the budget of the hour of
+// kTimeBucket is exhausted if hour_is_exhausted.
+std::vector<int32_t> MakeTokenCounts(bool hour_is_exhausted) {
+  std::vector<int32_t> token_counts(24, 1);
+  token_counts[1] = hour_is_exhausted ? 0 : 1;
+  return token_counts;
+}
+
+// Returns a Spanner read of the given rows of budget keys and token counts.
+spanner::RowStream MakeRowStream(
+    const std::vector<std::pair<std::string, std::vector<int32_t>>>& rows) {
+  auto source = std::make_unique<spanner_mocks::MockResultSetSource>();
+  google::spanner::v1::ResultSetMetadata metadata;
+  EXPECT_TRUE(
+      TextFormat::ParseFromString(kBudgetKeyTableMetadataPhase4, &metadata));
+  EXPECT_CALL(*source, Metadata()).WillRepeatedly(Return(metadata));
+  auto& next_row = EXPECT_CALL(*source, NextRow());
+  for (const auto& [budget_key, token_counts] : rows) {
+    next_row.WillOnce(Return(spanner_mocks::MakeRow({
+        {"Budget_Key", spanner::Value(budget_key)},
+        {"Timeframe", spanner::Value("0")},
+        {"ValueProto",
+         spanner::Value(spanner::ProtoMessage<privacy_sandbox_pbs::BudgetValue>(
+             MakeBudgetValue(token_counts)))},
+    })));
+  }
+  next_row.WillRepeatedly(Return(spanner::Row()));
+  return spanner::RowStream(std::move(source));
+}
+
+spanner::Mutation MakeMutation(bool is_insertion, size_t shard_index,
+                               absl::string_view budget_key,
+                               const std::vector<int32_t>& token_counts) {
+  std::vector<std::string> columns = {"Budget_Key", "Timeframe", "ValueProto"};
+  std::vector<spanner::Value> values = {
+      spanner::Value(std::string(budget_key)),
+      spanner::Value("0"),
+      spanner::Value(spanner::ProtoMessage<privacy_sandbox_pbs::BudgetValue>(
+          MakeBudgetValue(token_counts))),
+  };
+  if (is_insertion) {
+    return spanner::InsertMutationBuilder(TableName(shard_index), columns)
+        .AddRow(values)
+        .Build();
+  }
+  return spanner::UpdateMutationBuilder(TableName(shard_index), columns)
+      .AddRow(values)
+      .Build();
+}
+
+class ShardedBudgetConsumptionHelperTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    async_executor_ = std::make_unique<AsyncExecutor>(kThreadCount, kQueueSize);
+    io_async_executor_ =
+        std::make_unique<AsyncExecutor>(kThreadCount, kQueueSize);
+    mock_config_provider_ = std::make_unique<MockConfigProvider>();
+    mock_config_provider_->Set(kValueProtoMigrationPhase,
+                               std::string(kMigrationPhase4));
+
+    std::vector<std::unique_ptr<BudgetConsumptionHelper>> shards;
+    for (size_t i = 0; i < kShardCount; ++i) {
+      mock_connections_.push_back(
+          std::make_shared<spanner_mocks::MockConnection>());
+      shards.push_back(std::make_unique<BudgetConsumptionHelper>(
+          mock_config_provider_.get(), async_executor_.get(),
+          io_async_executor_.get(), mock_connections_.back(), TableName(i)));
+    }
+    budget_consumption_helper_ =
+        std::make_unique<ShardedBudgetConsumptionHelper>(std::move(shards));
+
+    ASSERT_SUCCESS(async_executor_->Init());
+    ASSERT_SUCCESS(io_async_executor_->Init());
+    ASSERT_SUCCESS(mock_config_provider_->Init());
+    ASSERT_SUCCESS(budget_consumption_helper_->Init());
+    ASSERT_SUCCESS(async_executor_->Run());
+    ASSERT_SUCCESS(io_async_executor_->Run());
+    ASSERT_SUCCESS(mock_config_provider_->Run());
+    ASSERT_SUCCESS(budget_consumption_helper_->Run());
+  }
+
+  void TearDown() override {
+    ASSERT_SUCCESS(budget_consumption_helper_->Stop());
+    ASSERT_SUCCESS(mock_config_provider_->Stop());
+    ASSERT_SUCCESS(io_async_executor_->Stop());
+    ASSERT_SUCCESS(async_executor_->Stop());
+  }
+
+  // Consumes one token of the hour of kTimeBucket for each of the budget keys
+  // and waits for the result.
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> ConsumeBudgets(
+      const std::vector<absl::string_view>& budget_keys) {
+    return ConsumeBudgets(*budget_consumption_helper_, budget_keys);
+  }
+
+  // Same as above, with the given helper.
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> ConsumeBudgets(
+      BudgetConsumptionHelperInterface& budget_consumption_helper,
+      const std::vector<absl::string_view>& budget_keys) {
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
+    context.request = std::make_shared<ConsumeBudgetsRequest>();
+    for (absl::string_view budget_key : budget_keys) {
+      context.request->budgets.push_back(ConsumeBudgetMetadata{
+          .budget_key_name =
+              context.request->budget_key_names.Add({budget_key}),
+          .token_count = 1,
+          .time_bucket = kTimeBucket});
+    }
+    context.response = std::make_shared<ConsumeBudgetsResponse>();
+
+    absl::Notification notification;
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> result_context;
+    context.callback = [&](AsyncContext<ConsumeBudgetsRequest,
+                                        ConsumeBudgetsResponse>& context) {
+      result_context = context;
+      notification.Notify();
+    };
+    EXPECT_SUCCESS(budget_consumption_helper.ConsumeBudgets(context));
+    notification.WaitForNotification();
+    return result_context;
+  }
+
+  std::vector<std::shared_ptr<spanner_mocks::MockConnection>> mock_connections_;
+  std::unique_ptr<AsyncExecutorInterface> async_executor_;
+  std::unique_ptr<AsyncExecutorInterface> io_async_executor_;
+  std::unique_ptr<MockConfigProvider> mock_config_provider_;
+  std::unique_ptr<ShardedBudgetConsumptionHelper> budget_consumption_helper_;
+};
+
+TEST(ShardedBudgetConsumptionHelperShardIndexTest, ShardIndexIsStable) {
+  EXPECT_EQ(ShardedBudgetConsumptionHelper::GetShardIndex(kFakeKeyName, 2), 0);
+  EXPECT_EQ(
+      ShardedBudgetConsumptionHelper::GetShardIndex(kOtherFakeKeyName, 2), 1);
+  EXPECT_EQ(ShardedBudgetConsumptionHelper::GetShardIndex(kFakeKeyName, 7), 3);
+  EXPECT_EQ(
+      ShardedBudgetConsumptionHelper::GetShardIndex(kOtherFakeKeyName, 7), 0);
+  EXPECT_EQ(ShardedBudgetConsumptionHelper::GetShardIndex("", 7), 2);
+}
+
+TEST_F(ShardedBudgetConsumptionHelperTest, ConsumeBudgetsOnOneShard) {
+  EXPECT_CALL(
+      *mock_connections_[1],
+      Read(Field(&spanner::Connection::ReadParams::table, TableName(1))))
+      .WillOnce(Return(ByMove(MakeRowStream({}))));
+  EXPECT_CALL(*mock_connections_[1],
+              Commit(FieldsAre(_,
+                               UnorderedElementsAre(MakeMutation(
+                                   /*is_insertion=*/true, 1, kOtherFakeKeyName,
+                                   MakeTokenCounts(true))),
+                               _)))
+      .WillOnce(Return(spanner::CommitResult{}));
+  EXPECT_CALL(*mock_connections_[0], Read).Times(0);
+
+  auto result_context = ConsumeBudgets({kOtherFakeKeyName});
+
+  EXPECT_SUCCESS(result_context.result);
+  EXPECT_THAT(result_context.response->budget_exhausted_indices, IsEmpty());
+}
+
+TEST_F(ShardedBudgetConsumptionHelperTest, ConsumeBudgetsOnAllShards) {
+  for (size_t i = 0; i < kShardCount; ++i) {
+    absl::string_view budget_key = i == 0 ? kFakeKeyName : kOtherFakeKeyName;
+    EXPECT_CALL(*mock_connections_[i],
+                Read(Field(&spanner::Connection::ReadParams::table,
+                           TableName(i))))
+        .WillOnce(Return(ByMove(MakeRowStream(
+            {{std::string(budget_key), MakeTokenCounts(false)}}))));
+    EXPECT_CALL(
+        *mock_connections_[i],
+        Commit(FieldsAre(_,
+                         UnorderedElementsAre(MakeMutation(
+                             /*is_insertion=*/false, i, budget_key,
+                             MakeTokenCounts(true))),
+                         _)))
+        .WillOnce(Return(spanner::CommitResult{}));
+  }
+
+  auto result_context = ConsumeBudgets({kFakeKeyName, kOtherFakeKeyName});
+
+  EXPECT_SUCCESS(result_context.result);
+  EXPECT_THAT(result_context.response->budget_exhausted_indices, IsEmpty());
+}
+
+TEST_F(ShardedBudgetConsumptionHelperTest,
+       ConsumeBudgetsReturnsBudgetsOfOtherShardsIfOneShardIsExhausted) {
+  // The first shard consumes its budget, which is then returned.
+  EXPECT_CALL(*mock_connections_[0], Read)
+      .WillOnce(Return(ByMove(MakeRowStream(
+          {{std::string(kFakeKeyName), MakeTokenCounts(false)}}))))
+      .WillOnce(Return(ByMove(MakeRowStream(
+          {{std::string(kFakeKeyName), MakeTokenCounts(true)}}))));
+  {
+    testing::InSequence sequence;
+    EXPECT_CALL(*mock_connections_[0],
+                Commit(FieldsAre(_,
+                                 UnorderedElementsAre(MakeMutation(
+                                     /*is_insertion=*/false, 0, kFakeKeyName,
+                                     MakeTokenCounts(true))),
+                                 _)))
+        .WillOnce(Return(spanner::CommitResult{}));
+    EXPECT_CALL(*mock_connections_[0],
+                Commit(FieldsAre(_,
+                                 UnorderedElementsAre(MakeMutation(
+                                     /*is_insertion=*/false, 0, kFakeKeyName,
+                                     MakeTokenCounts(false))),
+                                 _)))
+        .WillOnce(Return(spanner::CommitResult{}));
+  }
+
+  // The budget of the second shard is exhausted.
+  EXPECT_CALL(*mock_connections_[1], Read)
+      .WillOnce(Return(ByMove(MakeRowStream(
+          {{std::string(kOtherFakeKeyName), MakeTokenCounts(true)}}))));
+  EXPECT_CALL(*mock_connections_[1], Commit).Times(0);
+  EXPECT_CALL(*mock_connections_[1], Rollback).Times(1);
+
+  auto result_context = ConsumeBudgets({kFakeKeyName, kOtherFakeKeyName});
+
+  EXPECT_THAT(result_context.result,
+              ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  EXPECT_THAT(result_context.response->budget_exhausted_indices,
+              ElementsAre(1));
+}
+
+TEST_F(ShardedBudgetConsumptionHelperTest,
+       ConsumeBudgetsReturnsBudgetsOfOtherShardsIfOneShardFailsToCommit) {
+  // The first shard consumes its budget, which is then returned.
+  EXPECT_CALL(*mock_connections_[0], Read)
+      .WillOnce(Return(ByMove(MakeRowStream(
+          {{std::string(kFakeKeyName), MakeTokenCounts(false)}}))))
+      .WillOnce(Return(ByMove(MakeRowStream(
+          {{std::string(kFakeKeyName), MakeTokenCounts(true)}}))));
+  {
+    testing::InSequence sequence;
+    EXPECT_CALL(*mock_connections_[0],
+                Commit(FieldsAre(_,
+                                 UnorderedElementsAre(MakeMutation(
+                                     /*is_insertion=*/false, 0, kFakeKeyName,
+                                     MakeTokenCounts(true))),
+                                 _)))
+        .WillOnce(Return(spanner::CommitResult{}));
+    EXPECT_CALL(*mock_connections_[0],
+                Commit(FieldsAre(_,
+                                 UnorderedElementsAre(MakeMutation(
+                                     /*is_insertion=*/false, 0, kFakeKeyName,
+                                     MakeTokenCounts(false))),
+                                 _)))
+        .WillOnce(Return(spanner::CommitResult{}));
+  }
+
+  // The second shard has enough budget but fails to commit.
+  EXPECT_CALL(*mock_connections_[1], Read)
+      .WillOnce(Return(ByMove(MakeRowStream(
+          {{std::string(kOtherFakeKeyName), MakeTokenCounts(false)}}))));
+  EXPECT_CALL(*mock_connections_[1], Commit)
+      .WillOnce(Return(cloud::Status(cloud::StatusCode::kPermissionDenied,
+                                     "Commit is not allowed.")));
+
+  auto result_context = ConsumeBudgets({kFakeKeyName, kOtherFakeKeyName});
+
+  EXPECT_THAT(
+      result_context.result,
+      ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_FAIL_TO_COMMIT)));
+  EXPECT_THAT(result_context.response->budget_exhausted_indices, IsEmpty());
+}
+
+TEST_F(ShardedBudgetConsumptionHelperTest,
+       ConsumeBudgetsFinishesIfBudgetsCannotBeReturned) {
+  // The first shard consumes its budget, but fails to return it.
+  EXPECT_CALL(*mock_connections_[0], Read)
+      .WillOnce(Return(ByMove(MakeRowStream(
+          {{std::string(kFakeKeyName), MakeTokenCounts(false)}}))))
+      .WillOnce(Return(ByMove(MakeRowStream(
+          {{std::string(kFakeKeyName), MakeTokenCounts(true)}}))));
+  {
+    testing::InSequence sequence;
+    EXPECT_CALL(*mock_connections_[0],
+                Commit(FieldsAre(_,
+                                 UnorderedElementsAre(MakeMutation(
+                                     /*is_insertion=*/false, 0, kFakeKeyName,
+                                     MakeTokenCounts(true))),
+                                 _)))
+        .WillOnce(Return(spanner::CommitResult{}));
+    EXPECT_CALL(*mock_connections_[0],
+                Commit(FieldsAre(_,
+                                 UnorderedElementsAre(MakeMutation(
+                                     /*is_insertion=*/false, 0, kFakeKeyName,
+                                     MakeTokenCounts(false))),
+                                 _)))
+        .WillOnce(Return(cloud::Status(cloud::StatusCode::kPermissionDenied,
+                                       "Commit is not allowed.")));
+  }
+
+  // The budget of the second shard is exhausted.
+  EXPECT_CALL(*mock_connections_[1], Read)
+      .WillOnce(Return(ByMove(MakeRowStream(
+          {{std::string(kOtherFakeKeyName), MakeTokenCounts(true)}}))));
+  EXPECT_CALL(*mock_connections_[1], Commit).Times(0);
+  EXPECT_CALL(*mock_connections_[1], Rollback).Times(1);
+
+  auto result_context = ConsumeBudgets({kFakeKeyName, kOtherFakeKeyName});
+
+  // The request still reports the failure of the second shard.
+  EXPECT_THAT(result_context.result,
+              ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  EXPECT_THAT(result_context.response->budget_exhausted_indices,
+              ElementsAre(1));
+}
+
+TEST_F(ShardedBudgetConsumptionHelperTest,
+       ConsumeBudgetsFinishesIfReturnOfBudgetsCannotBeScheduled) {
+  // The first shard has its own io executor, which is stopped once the shard
+  // has consumed its budget, so that the return cannot be scheduled.
+  AsyncExecutor first_shard_io_async_executor(kThreadCount, kQueueSize);
+  ASSERT_SUCCESS(first_shard_io_async_executor.Init());
+  ASSERT_SUCCESS(first_shard_io_async_executor.Run());
+  std::vector<std::unique_ptr<BudgetConsumptionHelper>> shards;
+  shards.push_back(std::make_unique<BudgetConsumptionHelper>(
+      mock_config_provider_.get(), async_executor_.get(),
+      &first_shard_io_async_executor, mock_connections_[0], TableName(0)));
+  shards.push_back(std::make_unique<BudgetConsumptionHelper>(
+      mock_config_provider_.get(), async_executor_.get(),
+      io_async_executor_.get(), mock_connections_[1], TableName(1)));
+  ShardedBudgetConsumptionHelper budget_consumption_helper(std::move(shards));
+  ASSERT_SUCCESS(budget_consumption_helper.Init());
+  ASSERT_SUCCESS(budget_consumption_helper.Run());
+
+  absl::Notification first_shard_consumed;
+  EXPECT_CALL(*mock_connections_[0], Read)
+      .WillOnce(Return(ByMove(MakeRowStream(
+          {{std::string(kFakeKeyName), MakeTokenCounts(false)}}))));
+  EXPECT_CALL(*mock_connections_[0],
+              Commit(FieldsAre(_,
+                               UnorderedElementsAre(MakeMutation(
+                                   /*is_insertion=*/false, 0, kFakeKeyName,
+                                   MakeTokenCounts(true))),
+                               _)))
+      .WillOnce([&first_shard_consumed](const auto&) {
+        first_shard_consumed.Notify();
+        return spanner::CommitResult{};
+      });
+
+  // The budget of the second shard is exhausted.
+  EXPECT_CALL(*mock_connections_[1], Read)
+      .WillOnce([&](const auto&) {
+        first_shard_consumed.WaitForNotification();
+        EXPECT_SUCCESS(first_shard_io_async_executor.Stop());
+        return MakeRowStream(
+            {{std::string(kOtherFakeKeyName), MakeTokenCounts(true)}});
+      });
+  EXPECT_CALL(*mock_connections_[1], Commit).Times(0);
+  EXPECT_CALL(*mock_connections_[1], Rollback).Times(1);
+
+  auto result_context = ConsumeBudgets(budget_consumption_helper,
+                                       {kFakeKeyName, kOtherFakeKeyName});
+
+  EXPECT_THAT(result_context.result,
+              ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  EXPECT_THAT(result_context.response->budget_exhausted_indices,
+              ElementsAre(1));
+  EXPECT_SUCCESS(budget_consumption_helper.Stop());
+}
+
+}  // namespace
+}  // namespace google::scp::pbs
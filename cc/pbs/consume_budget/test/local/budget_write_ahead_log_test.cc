@@ -0,0 +1,173 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "cc/pbs/consume_budget/src/local/budget_write_ahead_log.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "absl/synchronization/notification.h"
+#include "cc/pbs/consume_budget/src/local/error_codes.h"
+#include "cc/public/core/interface/execution_result.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+namespace google::scp::pbs {
+namespace {
+
+using ::google::scp::core::ExecutionResult;
+using ::google::scp::core::FailureExecutionResult;
+using ::google::scp::core::test::ResultIs;
+using ::google::scp::pbs::errors::SC_LOCAL_CONSUME_BUDGET_WAL_CORRUPTED;
+using ::google::scp::pbs::errors::SC_LOCAL_CONSUME_BUDGET_WAL_NOT_RUNNING;
+using ::testing::ElementsAre;
+using ::testing::Field;
+
+constexpr uint64_t kNoCompaction = UINT64_MAX;
+
+HourTokenCounts MakeTokenCounts(TokenCount token_count) {
+  HourTokenCounts token_counts;
+  token_counts.fill(token_count);
+  return token_counts;
+}
+
+BudgetRecord MakeRecord(absl::string_view budget_key, TokenCount token_count) {
+  return BudgetRecord{.budget_key = std::string(budget_key),
+                      .timeframe = "1",
+                      .token_counts = MakeTokenCounts(token_count)};
+}
+
+class BudgetWriteAheadLogTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ =
+        std::string(testing::TempDir()) + "/" +
+        testing::UnitTest::GetInstance()->current_test_info()->name();
+    std::filesystem::remove_all(directory_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  // Appends the records and waits for them to be durable.
+  ExecutionResult AppendAndWait(BudgetWriteAheadLog& log,
+                                const std::vector<BudgetRecord>& records) {
+    absl::Notification notification;
+    ExecutionResult append_result;
+    RETURN_IF_FAILURE(log.Append(records, [&](ExecutionResult result) {
+      append_result = result;
+      notification.Notify();
+    }));
+    notification.WaitForNotification();
+    return append_result;
+  }
+
+  std::vector<BudgetRecord> Recover(BudgetWriteAheadLog& log) {
+    std::vector<BudgetRecord> records;
+    EXPECT_SUCCESS(log.Recover(
+        [&](const BudgetRecord& record) { records.push_back(record); }));
+    return records;
+  }
+
+  std::string directory_;
+};
+
+TEST_F(BudgetWriteAheadLogTest, AppendBeforeRunShouldFail) {
+  BudgetWriteAheadLog log(directory_, kNoCompaction, nullptr);
+  EXPECT_THAT(log.Append({MakeRecord("key", 1)}, [](ExecutionResult) {}),
+              ResultIs(FailureExecutionResult(
+                  SC_LOCAL_CONSUME_BUDGET_WAL_NOT_RUNNING)));
+}
+
+TEST_F(BudgetWriteAheadLogTest, RecordsAreReplayedInOrder) {
+  {
+    BudgetWriteAheadLog log(directory_, kNoCompaction, nullptr);
+    Recover(log);
+    ASSERT_SUCCESS(log.Run());
+    ASSERT_SUCCESS(AppendAndWait(log, {MakeRecord("key", 1)}));
+    ASSERT_SUCCESS(
+        AppendAndWait(log, {MakeRecord("key", 0), MakeRecord("other", 1)}));
+    ASSERT_SUCCESS(log.Stop());
+  }
+
+  BudgetWriteAheadLog log(directory_, kNoCompaction, nullptr);
+  EXPECT_THAT(Recover(log),
+              ElementsAre(
+                  Field(&BudgetRecord::token_counts, MakeTokenCounts(1)),
+                  Field(&BudgetRecord::token_counts, MakeTokenCounts(0)),
+                  Field(&BudgetRecord::budget_key, "other")));
+}
+
+TEST_F(BudgetWriteAheadLogTest, TornRecordEndsReplayOfSegment) {
+  {
+    BudgetWriteAheadLog log(directory_, kNoCompaction, nullptr);
+    Recover(log);
+    ASSERT_SUCCESS(log.Run());
+    ASSERT_SUCCESS(AppendAndWait(log, {MakeRecord("key", 1)}));
+    ASSERT_SUCCESS(AppendAndWait(log, {MakeRecord("other", 1)}));
+    ASSERT_SUCCESS(log.Stop());
+  }
+  std::string segment_path = directory_ + "/budget_wal.0";
+  std::filesystem::resize_file(segment_path,
+                               std::filesystem::file_size(segment_path) - 1);
+
+  BudgetWriteAheadLog log(directory_, kNoCompaction, nullptr);
+  EXPECT_THAT(Recover(log),
+              ElementsAre(Field(&BudgetRecord::budget_key, "key")));
+}
+
+TEST_F(BudgetWriteAheadLogTest, CompactionReplacesSegmentsWithSnapshot) {
+  std::vector<BudgetRecord> table = {MakeRecord("key", 0)};
+  absl::Notification compacted;
+  {
+    BudgetWriteAheadLog log(
+        directory_, /*compaction_threshold_bytes=*/1,
+        [&](const BudgetWriteAheadLog::RecordVisitor& visitor) {
+          for (const BudgetRecord& record : table) {
+            visitor(record);
+          }
+          compacted.Notify();
+        });
+    Recover(log);
+    ASSERT_SUCCESS(log.Run());
+    ASSERT_SUCCESS(AppendAndWait(log, {MakeRecord("key", 0)}));
+    compacted.WaitForNotification();
+    ASSERT_SUCCESS(log.Stop());
+  }
+  EXPECT_TRUE(std::filesystem::exists(directory_ + "/budget_snapshot"));
+  EXPECT_FALSE(std::filesystem::exists(directory_ + "/budget_wal.0"));
+
+  BudgetWriteAheadLog log(directory_, kNoCompaction, nullptr);
+  EXPECT_THAT(Recover(log),
+              ElementsAre(Field(&BudgetRecord::budget_key, "key")));
+}
+
+TEST_F(BudgetWriteAheadLogTest, CorruptedSnapshotShouldFail) {
+  std::filesystem::create_directories(directory_);
+  {
+    std::ofstream snapshot(directory_ + "/budget_snapshot");
+    snapshot << "not a snapshot";
+  }
+
+  BudgetWriteAheadLog log(directory_, kNoCompaction, nullptr);
+  EXPECT_THAT(
+      log.Recover([](const BudgetRecord&) {}),
+      ResultIs(FailureExecutionResult(SC_LOCAL_CONSUME_BUDGET_WAL_CORRUPTED)));
+}
+
+}  // namespace
+}  // namespace google::scp::pbs
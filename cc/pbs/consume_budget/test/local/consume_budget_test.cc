@@ -0,0 +1,242 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "cc/pbs/consume_budget/src/local/consume_budget.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/notification.h"
+#include "cc/core/async_executor/src/async_executor.h"
+#include "cc/core/config_provider/mock/mock_config_provider.h"
+#include "cc/pbs/consume_budget/src/gcp/error_codes.h"
+#include "cc/pbs/consume_budget/src/local/error_codes.h"
+#include "cc/pbs/interface/configuration_keys.h"
+#include "cc/pbs/interface/consume_budget_interface.h"
+#include "cc/pbs/interface/front_end_service_interface.h"
+#include "cc/public/core/interface/execution_result.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+namespace google::scp::pbs {
+namespace {
+
+using ::google::scp::core::AsyncContext;
+using ::google::scp::core::AsyncExecutor;
+using ::google::scp::core::ExecutionResult;
+using ::google::scp::core::FailureExecutionResult;
+using ::google::scp::core::SuccessExecutionResult;
+using ::google::scp::core::config_provider::mock::MockConfigProvider;
+using ::google::scp::core::test::ResultIs;
+using ::google::scp::pbs::errors::SC_CONSUME_BUDGET_EXHAUSTED;
+using ::google::scp::pbs::errors::
+    SC_LOCAL_CONSUME_BUDGET_INVALID_CONFIGURATION;
+using ::google::scp::pbs::errors::SC_LOCAL_CONSUME_BUDGET_WAL_NOT_RUNNING;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+constexpr size_t kThreadCount = 2;
+constexpr size_t kQueueSize = 1000;
+constexpr absl::string_view kFakeKeyName = "fake_key";
+constexpr absl::string_view kOtherFakeKeyName = "other_fake_key";
+// 1 hour after epoch.
+constexpr TimeBucket kTimeBucket = 3600000000000;
+
+ConsumeBudgetMetadata MakeBudget(absl::string_view key_name,
+                                 TimeBucket time_bucket = kTimeBucket) {
+  return ConsumeBudgetMetadata{
+      .budget_key_name = key_name,
+      .token_count = 1,
+      .time_bucket = time_bucket};
+}
+
+class LocalBudgetConsumptionHelperTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    async_executor_ = std::make_unique<AsyncExecutor>(kThreadCount, kQueueSize);
+    ASSERT_SUCCESS(async_executor_->Init());
+    ASSERT_SUCCESS(async_executor_->Run());
+    mock_config_provider_ = std::make_unique<MockConfigProvider>();
+    storage_directory_ =
+        std::string(testing::TempDir()) + "/" +
+        testing::UnitTest::GetInstance()->current_test_info()->name();
+    std::filesystem::remove_all(storage_directory_);
+  }
+
+  void TearDown() override {
+    if (helper_) {
+      EXPECT_SUCCESS(helper_->Stop());
+    }
+    EXPECT_SUCCESS(async_executor_->Stop());
+    std::filesystem::remove_all(storage_directory_);
+  }
+
+  ExecutionResult StartHelper() {
+    if (helper_) {
+      RETURN_IF_FAILURE(helper_->Stop());
+    }
+    helper_ = std::make_unique<LocalBudgetConsumptionHelper>(
+        mock_config_provider_.get(), async_executor_.get());
+    RETURN_IF_FAILURE(helper_->Init());
+    return helper_->Run();
+  }
+
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> ConsumeBudgets(
+      std::vector<ConsumeBudgetMetadata> budgets) {
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
+    context.request = std::make_shared<ConsumeBudgetsRequest>();
+    context.request->budgets = std::move(budgets);
+    // The budgets may refer to temporary names.
+    for (ConsumeBudgetMetadata& budget : context.request->budgets) {
+      budget.budget_key_name =
+          context.request->budget_key_names.Add({budget.budget_key_name});
+    }
+    context.response = std::make_shared<ConsumeBudgetsResponse>();
+
+    absl::Notification notification;
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> result_context;
+    context.callback = [&](AsyncContext<ConsumeBudgetsRequest,
+                                        ConsumeBudgetsResponse>& context) {
+      result_context = context;
+      notification.Notify();
+    };
+    EXPECT_SUCCESS(helper_->ConsumeBudgets(context));
+    notification.WaitForNotification();
+    return result_context;
+  }
+
+  std::unique_ptr<AsyncExecutor> async_executor_;
+  std::unique_ptr<MockConfigProvider> mock_config_provider_;
+  std::unique_ptr<LocalBudgetConsumptionHelper> helper_;
+  std::string storage_directory_;
+};
+
+TEST_F(LocalBudgetConsumptionHelperTest, ZeroShardCountShouldFail) {
+  mock_config_provider_->SetInt(kLocalBudgetStorageShardCount, 0);
+  helper_ = std::make_unique<LocalBudgetConsumptionHelper>(
+      mock_config_provider_.get(), async_executor_.get());
+  EXPECT_THAT(helper_->Init(),
+              ResultIs(FailureExecutionResult(
+                  SC_LOCAL_CONSUME_BUDGET_INVALID_CONFIGURATION)));
+  helper_.reset();
+}
+
+TEST_F(LocalBudgetConsumptionHelperTest, ConsumeBudgetUntilExhausted) {
+  ASSERT_SUCCESS(StartHelper());
+
+  auto result_context = ConsumeBudgets({MakeBudget(kFakeKeyName)});
+  EXPECT_SUCCESS(result_context.result);
+  EXPECT_THAT(result_context.response->budget_exhausted_indices, IsEmpty());
+
+  result_context = ConsumeBudgets({MakeBudget(kFakeKeyName)});
+  EXPECT_THAT(result_context.result,
+              ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  EXPECT_THAT(result_context.response->budget_exhausted_indices,
+              ElementsAre(0));
+
+  // Other hours of the same key are not affected.
+  EXPECT_SUCCESS(
+      ConsumeBudgets({MakeBudget(kFakeKeyName, 2 * kTimeBucket)}).result);
+}
+
+TEST_F(LocalBudgetConsumptionHelperTest, ExhaustedBudgetFailsWholeRequest) {
+  ASSERT_SUCCESS(StartHelper());
+  ASSERT_SUCCESS(ConsumeBudgets({MakeBudget(kOtherFakeKeyName)}).result);
+
+  auto result_context = ConsumeBudgets(
+      {MakeBudget(kFakeKeyName), MakeBudget(kOtherFakeKeyName)});
+  EXPECT_THAT(result_context.result,
+              ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  EXPECT_THAT(result_context.response->budget_exhausted_indices,
+              ElementsAre(1));
+
+  // Nothing was consumed by the failed request.
+  EXPECT_SUCCESS(ConsumeBudgets({MakeBudget(kFakeKeyName)}).result);
+}
+
+TEST_F(LocalBudgetConsumptionHelperTest, DuplicateBudgetInRequestIsExhausted) {
+  ASSERT_SUCCESS(StartHelper());
+
+  auto result_context =
+      ConsumeBudgets({MakeBudget(kFakeKeyName), MakeBudget(kFakeKeyName)});
+  EXPECT_THAT(result_context.result,
+              ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  EXPECT_THAT(result_context.response->budget_exhausted_indices,
+              ElementsAre(1));
+}
+
+TEST_F(LocalBudgetConsumptionHelperTest, BudgetsAreRecoveredFromStorage) {
+  mock_config_provider_->Set(kLocalBudgetStorageDirectory, storage_directory_);
+  ASSERT_SUCCESS(StartHelper());
+  ASSERT_SUCCESS(ConsumeBudgets({MakeBudget(kFakeKeyName)}).result);
+
+  ASSERT_SUCCESS(StartHelper());
+  EXPECT_THAT(ConsumeBudgets({MakeBudget(kFakeKeyName)}).result,
+              ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  EXPECT_SUCCESS(ConsumeBudgets({MakeBudget(kOtherFakeKeyName)}).result);
+}
+
+TEST_F(LocalBudgetConsumptionHelperTest,
+       FailedAppendToStorageConsumesNothing) {
+  mock_config_provider_->Set(kLocalBudgetStorageDirectory, storage_directory_);
+  helper_ = std::make_unique<LocalBudgetConsumptionHelper>(
+      mock_config_provider_.get(), async_executor_.get());
+  ASSERT_SUCCESS(helper_->Init());
+
+  // The log only accepts appends once running.
+  AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse> context;
+  context.request = std::make_shared<ConsumeBudgetsRequest>();
+  context.request->budgets = {MakeBudget(kFakeKeyName)};
+  context.response = std::make_shared<ConsumeBudgetsResponse>();
+  bool finished = false;
+  context.callback =
+      [&](AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&) {
+        finished = true;
+      };
+  EXPECT_THAT(helper_->ConsumeBudgets(context),
+              ResultIs(FailureExecutionResult(
+                  SC_LOCAL_CONSUME_BUDGET_WAL_NOT_RUNNING)));
+  EXPECT_FALSE(finished);
+
+  ASSERT_SUCCESS(helper_->Run());
+  EXPECT_SUCCESS(ConsumeBudgets({MakeBudget(kFakeKeyName)}).result);
+}
+
+TEST_F(LocalBudgetConsumptionHelperTest, BudgetsAreRecoveredAfterCompaction) {
+  mock_config_provider_->Set(kLocalBudgetStorageDirectory, storage_directory_);
+  // Every flush rotates the log and triggers a compaction.
+  mock_config_provider_->SetInt(kLocalBudgetStorageCompactionThresholdBytes,
+                                1);
+  ASSERT_SUCCESS(StartHelper());
+  constexpr int kKeyCount = 20;
+  for (int i = 0; i < kKeyCount; ++i) {
+    ASSERT_SUCCESS(
+        ConsumeBudgets({MakeBudget(absl::StrCat(kFakeKeyName, i))}).result);
+  }
+
+  ASSERT_SUCCESS(StartHelper());
+  EXPECT_TRUE(std::filesystem::exists(storage_directory_ + "/budget_snapshot"));
+  for (int i = 0; i < kKeyCount; ++i) {
+    EXPECT_THAT(
+        ConsumeBudgets({MakeBudget(absl::StrCat(kFakeKeyName, i))}).result,
+        ResultIs(FailureExecutionResult(SC_CONSUME_BUDGET_EXHAUSTED)));
+  }
+}
+
+}  // namespace
+}  // namespace google::scp::pbs
@@ -72,6 +72,7 @@ constexpr char kFrontEndService[] = "FrontEndServiceV2";
 constexpr char kTransactionLastExecutionTimestampHeader[] =
     "x-gscp-transaction-last-execution-timestamp";
 constexpr char kFakeLastExecutionTimestamp[] = "1234";
+constexpr size_t kDefaultReportingOriginSiteCacheMaxEntries = 10000;
 
 // Considering an estimated load of 75 keys per transaction with a standard
 // deviation of 20.
@@ -137,6 +138,21 @@ FrontEndServiceV2::FrontEndServiceV2(
   MetricInit();
 }
 
+FrontEndServiceV2::~FrontEndServiceV2() {
+  if (reporting_origin_site_cache_hits_instrument_) {
+    reporting_origin_site_cache_hits_instrument_->RemoveCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &FrontEndServiceV2::ObserveReportingOriginSiteCacheHitsCallback),
+        this);
+  }
+  if (reporting_origin_site_cache_misses_instrument_) {
+    reporting_origin_site_cache_misses_instrument_->RemoveCallback(
+        reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+            &FrontEndServiceV2::ObserveReportingOriginSiteCacheMissesCallback),
+        this);
+  }
+}
+
 void FrontEndServiceV2::MetricInit() noexcept {
   if (!metric_router_) {
     return;
@@ -219,6 +235,59 @@ void FrontEndServiceV2::MetricInit() noexcept {
               }));
 }
 
+void FrontEndServiceV2::ReportingOriginSiteCacheMetricInit() noexcept {
+  if (!metric_router_ || !reporting_origin_site_cache_ ||
+      reporting_origin_site_cache_hits_instrument_) {
+    return;
+  }
+
+  reporting_origin_site_cache_hits_instrument_ =
+      metric_router_->GetOrCreateObservableInstrument(
+          kReportingOriginSiteCacheHits,
+          [&]() -> std::shared_ptr<
+                    opentelemetry::metrics::ObservableInstrument> {
+            return meter_->CreateInt64ObservableCounter(
+                kReportingOriginSiteCacheHits,
+                "Number of reporting origin sites found in the cache");
+          });
+  reporting_origin_site_cache_misses_instrument_ =
+      metric_router_->GetOrCreateObservableInstrument(
+          kReportingOriginSiteCacheMisses,
+          [&]() -> std::shared_ptr<
+                    opentelemetry::metrics::ObservableInstrument> {
+            return meter_->CreateInt64ObservableCounter(
+                kReportingOriginSiteCacheMisses,
+                "Number of reporting origin sites not found in the cache");
+          });
+
+  reporting_origin_site_cache_hits_instrument_->AddCallback(
+      reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+          &FrontEndServiceV2::ObserveReportingOriginSiteCacheHitsCallback),
+      this);
+  reporting_origin_site_cache_misses_instrument_->AddCallback(
+      reinterpret_cast<opentelemetry::metrics::ObservableCallbackPtr>(
+          &FrontEndServiceV2::ObserveReportingOriginSiteCacheMissesCallback),
+      this);
+}
+
+void FrontEndServiceV2::ObserveReportingOriginSiteCacheHitsCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    FrontEndServiceV2* self_ptr) {
+  auto observer = std::get<
+      std::shared_ptr<opentelemetry::metrics::ObserverResultT<int64_t>>>(
+      observer_result);
+  observer->Observe(self_ptr->reporting_origin_site_cache_->HitCount());
+}
+
+void FrontEndServiceV2::ObserveReportingOriginSiteCacheMissesCallback(
+    opentelemetry::metrics::ObserverResult observer_result,
+    FrontEndServiceV2* self_ptr) {
+  auto observer = std::get<
+      std::shared_ptr<opentelemetry::metrics::ObserverResultT<int64_t>>>(
+      observer_result);
+  observer->Observe(self_ptr->reporting_origin_site_cache_->MissCount());
+}
+
 ExecutionResult FrontEndServiceV2::Init() noexcept {
   ExecutionResult execution_result =
       config_provider_->Get(kRemotePrivacyBudgetServiceClaimedIdentity,
@@ -290,6 +359,17 @@ ExecutionResult FrontEndServiceV2::Init() noexcept {
     return failure_execution_result;
   }
 
+  size_t reporting_origin_site_cache_max_entries =
+      kDefaultReportingOriginSiteCacheMaxEntries;
+  config_provider_->Get(kReportingOriginSiteCacheMaxEntries,
+                        reporting_origin_site_cache_max_entries);
+  if (reporting_origin_site_cache_max_entries > 0 &&
+      !reporting_origin_site_cache_) {
+    reporting_origin_site_cache_ = std::make_unique<ReportingOriginSiteCache>(
+        reporting_origin_site_cache_max_entries);
+    ReportingOriginSiteCacheMetricInit();
+  }
+
   return SuccessExecutionResult();
 }
 
@@ -348,19 +428,9 @@ ExecutionResult FrontEndServiceV2::PrepareTransaction(
       FrontEndUtils::GetReportingOriginMetricLabel(
           http_context.request, remote_coordinator_claimed_identity_);
 
-  absl::flat_hash_map<absl::string_view, std::string> labels = {
-      {kMetricLabelTransactionPhase, kMetricLabelPrepareTransaction},
-      {kMetricLabelKeyReportingOrigin, reporting_origin_metric_label},
-      {core::kPbsClaimedIdentityLabel,
-       core::utils::GetClaimedIdentityOrUnknownValue(http_context)},
-      {core::kScpHttpRequestClientVersionLabel,
-       core::utils::GetUserAgentOrUnknownValue(http_context)}};
-
-  if (std::string* auth_domain =
-          http_context.request->auth_context.authorized_domain.get();
-      auth_domain != nullptr) {
-    labels.try_emplace(core::kPbsAuthDomainLabel, *auth_domain);
-  }
+  std::shared_ptr<const core::OtelMetricLabelsCache::Labels> labels =
+      GetPrepareTransactionMetricLabels(http_context,
+                                        reporting_origin_metric_label);
 
   ExecutionResultOr<std::string> transaction_id =
       ExtractTransactionId(http_context);
@@ -368,18 +438,18 @@ ExecutionResult FrontEndServiceV2::PrepareTransaction(
     return transaction_id.result();
   }
 
+  // The callback is set by ConsumeBudgetsAndFinish when the context is awaited.
   AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
-      consume_budget_context(
-          std::make_shared<ConsumeBudgetsRequest>(),
-          std::bind_front(&FrontEndServiceV2::OnConsumeBudgetCallback, this,
-                          http_context, *transaction_id),
-          http_context);
+      consume_budget_context(std::make_shared<ConsumeBudgetsRequest>(),
+                             /*callback=*/nullptr, http_context);
   consume_budget_context.response = std::make_shared<ConsumeBudgetsResponse>();
   auto transaction_origin = ObtainTransactionOrigin(http_context);
   if (auto execution_result = ParseBeginTransactionRequestBody(
           *http_context.request->auth_context.authorized_domain,
           *transaction_origin, http_context.request->body,
-          consume_budget_context.request->budgets);
+          consume_budget_context.request->budget_key_names,
+          consume_budget_context.request->budgets,
+          reporting_origin_site_cache_.get());
       !execution_result.Successful()) {
     return execution_result;
   }
@@ -387,7 +457,7 @@ ExecutionResult FrontEndServiceV2::PrepareTransaction(
   if (keys_per_transaction_count_) {
     opentelemetry::context::Context context;
     keys_per_transaction_count_->Record(
-        consume_budget_context.request->budgets.size(), labels, context);
+        consume_budget_context.request->budgets.size(), *labels, context);
   }
   if (consume_budget_context.request->budgets.size() == 0) {
     return FailureExecutionResult(
@@ -413,48 +483,72 @@ ExecutionResult FrontEndServiceV2::PrepareTransaction(
                           "Bucket: %llu Token "
                           "Count: %d",
                           transaction_id->c_str(),
-                          consume_budget_metadata.budget_key_name->c_str(),
+                          consume_budget_metadata.budget_key_name,
                           consume_budget_metadata.time_bucket,
                           consume_budget_metadata.token_count),
           transaction_id->c_str(),
-          consume_budget_metadata.budget_key_name->c_str(),
+          std::string(consume_budget_metadata.budget_key_name).c_str(),
           consume_budget_metadata.time_bucket,
           consume_budget_metadata.token_count);
     }
   }
 
-  // ConsumeBudget call failed. Note this is an async function which schedules
-  // to consume the budgets and returns immediately
-  if (auto execution_result =
-          budget_consumption_helper_->ConsumeBudgets(consume_budget_context);
-      !execution_result.Successful()) {
-    return execution_result;
-  }
+  // The task owns the contexts from here on and finishes the HTTP context.
+  ConsumeBudgetsAndFinish(http_context, *std::move(transaction_id),
+                          std::move(consume_budget_context), std::move(labels))
+      .Detach();
   return SuccessExecutionResult();
 }
 
-void FrontEndServiceV2::OnConsumeBudgetCallback(
+std::shared_ptr<const core::OtelMetricLabelsCache::Labels>
+FrontEndServiceV2::GetPrepareTransactionMetricLabels(
+    const AsyncContext<HttpRequest, HttpResponse>& http_context,
+    const std::string& reporting_origin_metric_label) {
+  auto find_header = [&](const char* name) -> const std::string* {
+    if (!http_context.request->headers) {
+      return nullptr;
+    }
+    auto it = http_context.request->headers->find(name);
+    return it == http_context.request->headers->end() ? nullptr : &it->second;
+  };
+  const std::string* auth_domain =
+      http_context.request->auth_context.authorized_domain.get();
+
+  // The key holds the raw values the labels are derived from, so that a cache
+  // hit neither copies the labels nor parses the user agent.
+  std::string key;
+  core::OtelMetricLabelsCache::AppendToKey(&reporting_origin_metric_label, key);
+  core::OtelMetricLabelsCache::AppendToKey(
+      find_header(core::kClaimedIdentityHeader), key);
+  core::OtelMetricLabelsCache::AppendToKey(find_header(core::kUserAgentHeader),
+                                           key);
+  core::OtelMetricLabelsCache::AppendToKey(auth_domain, key);
+
+  return otel_metric_labels_cache_.GetOrBuild(key, [&]() {
+    core::OtelMetricLabelsCache::Labels labels = {
+        {kMetricLabelTransactionPhase, kMetricLabelPrepareTransaction},
+        {kMetricLabelKeyReportingOrigin, reporting_origin_metric_label},
+        {core::kPbsClaimedIdentityLabel,
+         core::utils::GetClaimedIdentityOrUnknownValue(http_context)},
+        {core::kScpHttpRequestClientVersionLabel,
+         core::utils::GetUserAgentOrUnknownValue(http_context)}};
+
+    if (auth_domain != nullptr) {
+      labels.try_emplace(core::kPbsAuthDomainLabel, *auth_domain);
+    }
+    return labels;
+  });
+}
+
+core::Task<> FrontEndServiceV2::ConsumeBudgetsAndFinish(
     AsyncContext<HttpRequest, HttpResponse> http_context,
     std::string transaction_id,
-    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&
-        consume_budget_context) {
-  const std::string reporting_origin_metric_label =
-      FrontEndUtils::GetReportingOriginMetricLabel(
-          http_context.request, remote_coordinator_claimed_identity_);
-
-  absl::flat_hash_map<absl::string_view, std::string> labels = {
-      {kMetricLabelTransactionPhase, kMetricLabelPrepareTransaction},
-      {kMetricLabelKeyReportingOrigin, reporting_origin_metric_label},
-      {core::kPbsClaimedIdentityLabel,
-       core::utils::GetClaimedIdentityOrUnknownValue(http_context)},
-      {core::kScpHttpRequestClientVersionLabel,
-       core::utils::GetUserAgentOrUnknownValue(http_context)}};
-
-  if (std::string* auth_domain =
-          http_context.request->auth_context.authorized_domain.get();
-      auth_domain != nullptr) {
-    labels.try_emplace(core::kPbsAuthDomainLabel, *auth_domain);
-  }
+    AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
+        consume_budget_context,
+    std::shared_ptr<const core::OtelMetricLabelsCache::Labels> labels) {
+  // A failure to start the consumption is the result of the context.
+  co_await AwaitConsumeBudgets(*budget_consumption_helper_,
+                               consume_budget_context);
 
   if (!consume_budget_context.result.Successful()) {
     if (consume_budget_context.result.status_code ==
@@ -488,7 +582,7 @@ void FrontEndServiceV2::OnConsumeBudgetCallback(
       // Count number of budgets exhausted.
       if (budgets_exhausted_) {
         opentelemetry::context::Context context;
-        budgets_exhausted_->Record(budget_exhausted_indices.size(), labels,
+        budgets_exhausted_->Record(budget_exhausted_indices.size(), *labels,
                                    context);
       }
     } else {
@@ -501,13 +595,13 @@ void FrontEndServiceV2::OnConsumeBudgetCallback(
 
     http_context.result = consume_budget_context.result;
     http_context.Finish();
-    return;
+    co_return;
   }
   // Consumed all the budgets successfully.
   if (successful_budget_consumed_counter_) {
     opentelemetry::context::Context context;
     successful_budget_consumed_counter_->Record(
-        consume_budget_context.request->budgets.size(), labels, context);
+        consume_budget_context.request->budgets.size(), *labels, context);
   }
 
   InsertBackwardCompatibleHeaders(http_context);
@@ -18,7 +18,8 @@
 #include <memory>
 #include <string>
 
-#include "absl/container/flat_hash_map.h"
+#include "cc/core/common/coroutine/src/task.h"
+#include "cc/core/http2_server/src/otel_metric_labels_cache.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/async_executor_interface.h"
 #include "cc/core/interface/config_provider_interface.h"
@@ -26,6 +27,7 @@
 #include "cc/core/interface/http_types.h"
 #include "cc/core/interface/type_def.h"
 #include "cc/core/telemetry/src/metric/metric_router.h"
+#include "cc/pbs/front_end_service/src/reporting_origin_site_cache.h"
 #include "cc/pbs/interface/consume_budget_interface.h"
 #include "cc/pbs/interface/front_end_service_interface.h"
 #include "cc/public/core/interface/execution_result.h"
@@ -45,6 +47,8 @@ class FrontEndServiceV2 : public FrontEndServiceInterface {
       BudgetConsumptionHelperInterface* budget_consumption_helper,
       core::MetricRouter* metric_router = nullptr);
 
+  ~FrontEndServiceV2() override;
+
   core::ExecutionResult Init() noexcept override;
   core::ExecutionResult Run() noexcept override;
   core::ExecutionResult Stop() noexcept override;
@@ -87,11 +91,22 @@ class FrontEndServiceV2 : public FrontEndServiceInterface {
       core::AsyncContext<core::HttpRequest, core::HttpResponse>&
           http_context) noexcept;
 
-  void OnConsumeBudgetCallback(
+  // Consumes the budgets of a prepared transaction and finishes the HTTP
+  // context with the outcome.
+  core::Task<> ConsumeBudgetsAndFinish(
       core::AsyncContext<core::HttpRequest, core::HttpResponse> http_context,
       std::string transaction_id,
-      core::AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>&
-          consume_budget_context);
+      core::AsyncContext<ConsumeBudgetsRequest, ConsumeBudgetsResponse>
+          consume_budget_context,
+      std::shared_ptr<const core::OtelMetricLabelsCache::Labels> labels);
+
+  // Returns the labels of the metrics of a prepare transaction request whose
+  // reporting origin has the given metric label.
+  std::shared_ptr<const core::OtelMetricLabelsCache::Labels>
+  GetPrepareTransactionMetricLabels(
+      const core::AsyncContext<core::HttpRequest, core::HttpResponse>&
+          http_context,
+      const std::string& reporting_origin_metric_label);
 
   // Returns 404 to maintain compatibility with the client code.
   core::ExecutionResult GetTransactionStatus(
@@ -114,6 +129,18 @@ class FrontEndServiceV2 : public FrontEndServiceInterface {
   // Initializes the metrics.
   void MetricInit() noexcept;
 
+  // Initializes the metrics of reporting_origin_site_cache_.
+  void ReportingOriginSiteCacheMetricInit() noexcept;
+
+  // Callbacks to be used with the OTel ObservableInstruments of the hits and
+  // misses of reporting_origin_site_cache_.
+  static void ObserveReportingOriginSiteCacheHitsCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      FrontEndServiceV2* self_ptr);
+  static void ObserveReportingOriginSiteCacheMissesCallback(
+      opentelemetry::metrics::ObserverResult observer_result,
+      FrontEndServiceV2* self_ptr);
+
   // An instance to the http server.
   std::shared_ptr<core::HttpServerInterface> http_server_;
 
@@ -130,6 +157,13 @@ class FrontEndServiceV2 : public FrontEndServiceInterface {
 
   BudgetConsumptionHelperInterface* budget_consumption_helper_;
 
+  // Memo of the sites of reporting origins. Null if the cache is disabled.
+  std::unique_ptr<ReportingOriginSiteCache> reporting_origin_site_cache_;
+
+  // The label sets of the metrics, shared by the requests with the same
+  // labels.
+  core::OtelMetricLabelsCache otel_metric_labels_cache_;
+
   // An instance of metric router which will provide APIs to create metrics.
   core::MetricRouter* metric_router_;
 
@@ -149,6 +183,13 @@ class FrontEndServiceV2 : public FrontEndServiceInterface {
   // OpenTelemetry Instrument for measuring the number of budgets exhausted
   std::shared_ptr<opentelemetry::metrics::Histogram<uint64_t>>
       budgets_exhausted_;
+
+  // OpenTelemetry Instruments for the hits and misses of
+  // reporting_origin_site_cache_.
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      reporting_origin_site_cache_hits_instrument_;
+  std::shared_ptr<opentelemetry::metrics::ObservableInstrument>
+      reporting_origin_site_cache_misses_instrument_;
 };
 
 }  // namespace google::scp::pbs
@@ -18,14 +18,18 @@
 
 #include <libpsl.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
 
-#include <google/protobuf/timestamp.pb.h>
-#include <google/protobuf/util/time_util.h>
 #include <nlohmann/json.hpp>
 
 #include "absl/container/flat_hash_set.h"
@@ -35,8 +39,11 @@
 #include "cc/core/common/global_logger/src/global_logger.h"
 #include "cc/core/common/uuid/src/uuid.h"
 #include "cc/core/interface/type_def.h"
+#include "cc/core/utils/src/rfc3339.h"
 #include "cc/pbs/budget_key_timeframe_manager/src/budget_key_timeframe_utils.h"
 #include "cc/pbs/front_end_service/src/error_codes.h"
+#include "cc/pbs/front_end_service/src/reporting_origin_site_cache.h"
+#include "cc/pbs/interface/budget_key_name_arena.h"
 #include "cc/pbs/interface/front_end_service_interface.h"
 #include "cc/pbs/interface/type_def.h"
 #include "cc/public/core/interface/execution_result.h"
@@ -53,24 +60,520 @@ constexpr char kVersion2[] = "2.0";
 constexpr char kHttpPrefix[] = "http://";
 constexpr char kHttpsPrefix[] = "https://";
 
-core::ExecutionResultOr<TimeBucket> ReportingTimeToTimeBucket(
-    const std::string& reporting_time) {
-  google::protobuf::Timestamp reporting_timestamp;
-  if (!google::protobuf::util::TimeUtil::FromString(reporting_time,
-                                                    &reporting_timestamp)) {
+// A reporting time of a budget key, as the timestamp consumed by the budget and
+// the time group and time bucket derived from it.
+struct ReportingTime {
+  core::Timestamp timestamp = 0;
+  TimeGroup time_group = 0;
+  TimeBucket time_bucket = 0;
+};
+
+core::ExecutionResultOr<ReportingTime> ParseReportingTime(
+    std::string_view reporting_time) {
+  auto seconds_since_epoch =
+      core::utils::ParseRfc3339ToUnixSeconds(reporting_time);
+  if (!seconds_since_epoch.Successful() || *seconds_since_epoch < 0) {
     return core::FailureExecutionResult(
         core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST);
   }
 
-  if (reporting_timestamp.seconds() < 0) {
+  core::Timestamp timestamp = static_cast<uint64_t>(
+      std::chrono::nanoseconds(std::chrono::seconds(*seconds_since_epoch))
+          .count());
+  return ReportingTime{
+      .timestamp = timestamp,
+      .time_group =
+          budget_key_timeframe_manager::Utils::GetTimeGroup(timestamp),
+      .time_bucket =
+          budget_key_timeframe_manager::Utils::GetTimeBucket(timestamp),
+  };
+}
+
+// Remembers the last few reporting times parsed for a request. The budget keys
+// of a request tend to share a handful of reporting times, so most of them are
+// not parsed again. The reporting times must outlive the memo.
+class ReportingTimeMemo {
+ public:
+  core::ExecutionResultOr<ReportingTime> Parse(
+      std::string_view reporting_time) {
+    for (size_t i = 0; i < size_; ++i) {
+      if (entries_[i].reporting_time == reporting_time) {
+        return entries_[i].parsed;
+      }
+    }
+    auto parsed = ParseReportingTime(reporting_time);
+    if (parsed.Successful()) {
+      entries_[next_] = {reporting_time, *parsed};
+      next_ = (next_ + 1) % kMaxEntries;
+      size_ = std::min(size_ + 1, kMaxEntries);
+    }
+    return parsed;
+  }
+
+ private:
+  static constexpr size_t kMaxEntries = 8;
+
+  struct Entry {
+    std::string_view reporting_time;
+    ReportingTime parsed;
+  };
+
+  std::array<Entry, kMaxEntries> entries_;
+  size_t size_ = 0;
+  // The entry to overwrite next, the oldest one once the memo is full.
+  size_t next_ = 0;
+};
+
+// The state of a scalar field of a request body entry.
+enum class FieldState { kMissing, kInvalid, kValid };
+
+// A budget key of a request, i.e. an element of "t" in V1 or of "keys" in V2.
+struct ParsedBudgetKey {
+  // Elements that are not JSON objects are kept (and rejected on validation)
+  // to preserve the order in which errors are reported.
+  bool is_object = false;
+  FieldState key_state = FieldState::kMissing;
+  FieldState token_state = FieldState::kMissing;
+  FieldState reporting_time_state = FieldState::kMissing;
+  std::string key;
+  TokenCount token = 0;
+  std::string reporting_time;
+};
+
+// An element of "data" in a V2 request. Its budget keys are the range
+// [keys_begin, keys_end) of BeginTransactionRequestSaxHandler::keys().
+struct ParsedDataElement {
+  bool is_object = false;
+  bool has_keys = false;
+  // Whether "keys" is a JSON object rather than an array.
+  bool keys_malformed = false;
+  FieldState reporting_origin_state = FieldState::kMissing;
+  std::string reporting_origin;
+  size_t keys_begin = 0;
+  size_t keys_end = 0;
+};
+
+// Collects the fields of a begin transaction request body in a single pass of
+// the nlohmann SAX parser, without building a JSON document. Unknown fields are
+// skipped and, as with the JSON document, the last occurrence of a repeated
+// field wins. The fields are validated only after the whole body is parsed so
+// that a syntax error takes precedence over any other error.
+class BeginTransactionRequestSaxHandler final
+    : public nlohmann::json_sax<nlohmann::json> {
+ public:
+  enum class Version { kMissing, kUnsupported, kV1, kV2 };
+
+  BeginTransactionRequestSaxHandler() { frames_.reserve(kMaxFrameDepth); }
+
+  bool null() override { return OnScalar(ScalarType::kNull); }
+
+  bool boolean(bool value) override {
+    number_value_ = static_cast<TokenCount>(value);
+    return OnScalar(ScalarType::kNumber);
+  }
+
+  bool number_integer(number_integer_t value) override {
+    number_value_ = static_cast<TokenCount>(value);
+    return OnScalar(ScalarType::kNumber);
+  }
+
+  bool number_unsigned(number_unsigned_t value) override {
+    number_value_ = static_cast<TokenCount>(value);
+    return OnScalar(ScalarType::kNumber);
+  }
+
+  bool number_float(number_float_t value, const string_t&) override {
+    number_value_ = static_cast<TokenCount>(value);
+    return OnScalar(ScalarType::kNumber);
+  }
+
+  bool string(string_t& value) override {
+    string_value_ = &value;
+    return OnScalar(ScalarType::kString);
+  }
+
+  bool binary(binary_t&) override { return OnScalar(ScalarType::kOther); }
+
+  bool start_object(std::size_t) override {
+    if (skip_depth_ > 0) {
+      ++skip_depth_;
+      return true;
+    }
+    Slot slot = CurrentSlot();
+    switch (slot) {
+      case Slot::kRoot:
+        frames_.push_back(Frame::kRoot);
+        return true;
+      case Slot::kBudgetKey:
+        current_budget_key_ = &CurrentBudgetKeyList().emplace_back();
+        current_budget_key_->is_object = true;
+        frames_.push_back(Frame::kBudgetKey);
+        return true;
+      case Slot::kDataElement: {
+        ParsedDataElement& data_element = data_.emplace_back();
+        data_element.is_object = true;
+        data_element.keys_begin = keys_.size();
+        frames_.push_back(Frame::kDataElement);
+        return true;
+      }
+      case Slot::kV1Keys:
+        ResetV1Keys();
+        v1_keys_malformed_ = true;
+        break;
+      case Slot::kData:
+        ResetData();
+        data_malformed_ = true;
+        break;
+      case Slot::kKeys:
+        ResetKeys(data_.back());
+        data_.back().keys_malformed = true;
+        break;
+      default:
+        MarkInvalid(slot);
+        break;
+    }
+    skip_depth_ = 1;
+    return true;
+  }
+
+  bool key(string_t& key) override {
+    if (skip_depth_ > 0) {
+      return true;
+    }
+    switch (frames_.back()) {
+      case Frame::kRoot:
+        pending_slot_ = key == "v"      ? Slot::kVersion
+                        : key == "t"    ? Slot::kV1Keys
+                        : key == "data" ? Slot::kData
+                                        : Slot::kIgnored;
+        break;
+      case Frame::kDataElement:
+        pending_slot_ = key == "reporting_origin" ? Slot::kReportingOrigin
+                        : key == "keys"           ? Slot::kKeys
+                                                  : Slot::kIgnored;
+        break;
+      case Frame::kBudgetKey:
+        pending_slot_ = key == "key"              ? Slot::kKey
+                        : key == "token"          ? Slot::kToken
+                        : key == "reporting_time" ? Slot::kReportingTime
+                                                  : Slot::kIgnored;
+        break;
+      default:
+        pending_slot_ = Slot::kIgnored;
+        break;
+    }
+    return true;
+  }
+
+  bool end_object() override { return EndContainer(); }
+
+  bool start_array(std::size_t) override {
+    if (skip_depth_ > 0) {
+      ++skip_depth_;
+      return true;
+    }
+    Slot slot = CurrentSlot();
+    switch (slot) {
+      case Slot::kV1Keys:
+        ResetV1Keys();
+        frames_.push_back(Frame::kV1KeyList);
+        return true;
+      case Slot::kData:
+        ResetData();
+        frames_.push_back(Frame::kDataList);
+        return true;
+      case Slot::kKeys:
+        ResetKeys(data_.back());
+        frames_.push_back(Frame::kKeyList);
+        return true;
+      case Slot::kBudgetKey:
+        CurrentBudgetKeyList().emplace_back();
+        break;
+      case Slot::kDataElement:
+        data_.emplace_back().keys_begin = keys_.size();
+        break;
+      default:
+        MarkInvalid(slot);
+        break;
+    }
+    skip_depth_ = 1;
+    return true;
+  }
+
+  bool end_array() override { return EndContainer(); }
+
+  bool parse_error(std::size_t, const std::string&,
+                   const nlohmann::detail::exception&) override {
+    return false;
+  }
+
+  Version version() const { return version_; }
+
+  bool has_v1_keys() const { return has_v1_keys_; }
+
+  bool v1_keys_malformed() const { return v1_keys_malformed_; }
+
+  const std::vector<ParsedBudgetKey>& v1_keys() const { return v1_keys_; }
+
+  bool has_data() const { return has_data_; }
+
+  bool data_malformed() const { return data_malformed_; }
+
+  const std::vector<ParsedDataElement>& data() const { return data_; }
+
+  const std::vector<ParsedBudgetKey>& keys() const { return keys_; }
+
+ private:
+  // The JSON containers of interest, i.e. the root object, "t", "data", an
+  // element of "data", "keys" and a budget key.
+  enum class Frame {
+    kRoot,
+    kV1KeyList,
+    kDataList,
+    kDataElement,
+    kKeyList,
+    kBudgetKey
+  };
+
+  // What the next JSON value is parsed as.
+  enum class Slot {
+    kIgnored,
+    kRoot,
+    kVersion,
+    kV1Keys,
+    kData,
+    kDataElement,
+    kReportingOrigin,
+    kKeys,
+    kBudgetKey,
+    kKey,
+    kToken,
+    kReportingTime
+  };
+
+  enum class ScalarType { kNull, kNumber, kString, kOther };
+
+  static constexpr size_t kMaxFrameDepth = 5;
+
+  Slot CurrentSlot() const {
+    if (frames_.empty()) {
+      return Slot::kRoot;
+    }
+    switch (frames_.back()) {
+      case Frame::kV1KeyList:
+      case Frame::kKeyList:
+        return Slot::kBudgetKey;
+      case Frame::kDataList:
+        return Slot::kDataElement;
+      default:
+        return pending_slot_;
+    }
+  }
+
+  // Must only be called when the innermost container is a budget key list.
+  std::vector<ParsedBudgetKey>& CurrentBudgetKeyList() {
+    return frames_.back() == Frame::kV1KeyList ? v1_keys_ : keys_;
+  }
+
+  void ResetV1Keys() {
+    has_v1_keys_ = true;
+    v1_keys_malformed_ = false;
+    v1_keys_.clear();
+  }
+
+  void ResetData() {
+    has_data_ = true;
+    data_malformed_ = false;
+    data_.clear();
+    keys_.clear();
+  }
+
+  // The keys of data_element are always the last ones of keys_ because the
+  // element is the one being parsed.
+  void ResetKeys(ParsedDataElement& data_element) {
+    data_element.has_keys = true;
+    data_element.keys_malformed = false;
+    keys_.erase(keys_.begin() + data_element.keys_begin, keys_.end());
+  }
+
+  void SetStringField(ScalarType type, FieldState& state, std::string& field) {
+    if (type != ScalarType::kString) {
+      state = FieldState::kInvalid;
+      return;
+    }
+    state = FieldState::kValid;
+    field = std::move(*string_value_);
+  }
+
+  void MarkInvalid(Slot slot) {
+    switch (slot) {
+      case Slot::kVersion:
+        version_ = Version::kUnsupported;
+        break;
+      case Slot::kReportingOrigin:
+        data_.back().reporting_origin_state = FieldState::kInvalid;
+        break;
+      case Slot::kKey:
+        current_budget_key_->key_state = FieldState::kInvalid;
+        break;
+      case Slot::kToken:
+        current_budget_key_->token_state = FieldState::kInvalid;
+        break;
+      case Slot::kReportingTime:
+        current_budget_key_->reporting_time_state = FieldState::kInvalid;
+        break;
+      default:
+        break;
+    }
+  }
+
+  // Iterating over a JSON null yields no element and iterating over any other
+  // scalar yields the scalar itself, which is why a scalar "t", "data" or
+  // "keys" is recorded as a single element that is not an object.
+  bool OnScalar(ScalarType type) {
+    if (skip_depth_ > 0) {
+      return true;
+    }
+    Slot slot = CurrentSlot();
+    switch (slot) {
+      case Slot::kVersion:
+        if (type != ScalarType::kString) {
+          version_ = Version::kUnsupported;
+        } else if (*string_value_ == kVersion1) {
+          version_ = Version::kV1;
+        } else if (*string_value_ == kVersion2) {
+          version_ = Version::kV2;
+        } else {
+          version_ = Version::kUnsupported;
+        }
+        break;
+      case Slot::kV1Keys:
+        ResetV1Keys();
+        if (type != ScalarType::kNull) {
+          v1_keys_.emplace_back();
+        }
+        break;
+      case Slot::kData:
+        ResetData();
+        if (type != ScalarType::kNull) {
+          data_.emplace_back().keys_begin = keys_.size();
+        }
+        break;
+      case Slot::kKeys:
+        ResetKeys(data_.back());
+        if (type != ScalarType::kNull) {
+          keys_.emplace_back();
+        }
+        break;
+      case Slot::kBudgetKey:
+        CurrentBudgetKeyList().emplace_back();
+        break;
+      case Slot::kDataElement:
+        data_.emplace_back().keys_begin = keys_.size();
+        break;
+      case Slot::kReportingOrigin:
+        SetStringField(type, data_.back().reporting_origin_state,
+                       data_.back().reporting_origin);
+        break;
+      case Slot::kKey:
+        SetStringField(type, current_budget_key_->key_state,
+                       current_budget_key_->key);
+        break;
+      case Slot::kToken:
+        if (type == ScalarType::kNumber) {
+          current_budget_key_->token_state = FieldState::kValid;
+          current_budget_key_->token = number_value_;
+        } else {
+          current_budget_key_->token_state = FieldState::kInvalid;
+        }
+        break;
+      case Slot::kReportingTime:
+        SetStringField(type, current_budget_key_->reporting_time_state,
+                       current_budget_key_->reporting_time);
+        break;
+      default:
+        break;
+    }
+    return true;
+  }
+
+  bool EndContainer() {
+    if (skip_depth_ > 0) {
+      --skip_depth_;
+      return true;
+    }
+    if (frames_.back() == Frame::kDataElement) {
+      data_.back().keys_end = keys_.size();
+    }
+    frames_.pop_back();
+    return true;
+  }
+
+  std::vector<Frame> frames_;
+  Slot pending_slot_ = Slot::kIgnored;
+  // Nesting depth inside a JSON value that is being skipped.
+  size_t skip_depth_ = 0;
+  // The last scalar value reported by the parser.
+  TokenCount number_value_ = 0;
+  std::string* string_value_ = nullptr;
+  // The budget key being parsed. Budget keys are only appended to a list while
+  // none of its elements is being parsed, so the pointer stays valid.
+  ParsedBudgetKey* current_budget_key_ = nullptr;
+
+  Version version_ = Version::kMissing;
+  bool has_v1_keys_ = false;
+  bool v1_keys_malformed_ = false;
+  std::vector<ParsedBudgetKey> v1_keys_;
+  bool has_data_ = false;
+  bool data_malformed_ = false;
+  std::vector<ParsedDataElement> data_;
+  // The budget keys of all the elements of data_, in order.
+  std::vector<ParsedBudgetKey> keys_;
+};
+
+// Budgets already seen in a request, identified by their budget key name, time
+// group and time bucket.
+using VisitedBudgets =
+    absl::flat_hash_set<std::tuple<std::string_view, TimeGroup, TimeBucket>>;
+
+// Validates budget_key and appends the corresponding ConsumeBudgetMetadata to
+// consume_budget_metadata_list. The budget key name is prefixed by origin and
+// stored in budget_key_names.
+core::ExecutionResult AppendConsumeBudgetMetadata(
+    std::string_view origin, const ParsedBudgetKey& budget_key,
+    BudgetKeyNameArena& budget_key_names, ReportingTimeMemo& reporting_times,
+    VisitedBudgets& visited,
+    std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list) {
+  if (!budget_key.is_object || budget_key.key_state != FieldState::kValid ||
+      budget_key.token_state != FieldState::kValid ||
+      budget_key.reporting_time_state != FieldState::kValid) {
+    return core::FailureExecutionResult(
+        core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
+  }
+
+  auto reporting_time = reporting_times.Parse(budget_key.reporting_time);
+  if (!reporting_time.Successful()) {
+    return reporting_time.result();
+  }
+
+  std::string_view budget_key_name =
+      budget_key_names.Add({origin, "/", budget_key.key});
+
+  // TODO: This is a temporary solution to prevent transaction
+  // commands belong to the same reporting hour to execute within the
+  // same transaction. The proper solution is to move this logic to
+  // the transaction commands.
+  if (!visited
+           .emplace(budget_key_name, reporting_time->time_group,
+                    reporting_time->time_bucket)
+           .second) {
     return core::FailureExecutionResult(
         core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST);
   }
 
-  uint64_t seconds_since_epoch = reporting_timestamp.seconds();
-  std::chrono::nanoseconds reporting_time_nanoseconds =
-      std::chrono::seconds(seconds_since_epoch);
-  return static_cast<uint64_t>(reporting_time_nanoseconds.count());
+  consume_budget_metadata_list.emplace_back(ConsumeBudgetMetadata{
+      budget_key_name, budget_key.token, reporting_time->timestamp});
+  return core::SuccessExecutionResult();
 }
 
 // V1 Request Example:
@@ -86,82 +589,34 @@ core::ExecutionResultOr<TimeBucket> ReportingTimeToTimeBucket(
 //   ]
 // }
 core::ExecutionResult ParseBeginTransactionRequestBodyV1(
-    const std::string& transaction_origin,
-    const core::BytesBuffer& request_body,
-    std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list) noexcept {
-  try {
-    auto transaction_request = nlohmann::json::parse(
-        request_body.bytes->begin(), request_body.bytes->end());
-
-    /// The body format of the begin transaction request is:
-    /// {v: "1.0", t: [{ key: '', token: '', reporting_time: ''}, ....]}
-    if (transaction_request.find("v") == transaction_request.end() ||
-        transaction_request.find("t") == transaction_request.end()) {
-      return core::FailureExecutionResult(
-          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
-    }
-
-    if (transaction_request["v"] != "1.0") {
-      return core::FailureExecutionResult(
-          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
-    }
-
-    std::unordered_set<std::string> visited;
-    for (auto it = transaction_request["t"].begin();
-         it != transaction_request["t"].end(); ++it) {
-      auto consume_budget_transaction_key = it.value();
-      ConsumeBudgetMetadata consume_budget_metadata;
-
-      if (consume_budget_transaction_key.count("key") == 0 ||
-          consume_budget_transaction_key.count("token") == 0 ||
-          consume_budget_transaction_key.count("reporting_time") == 0) {
-        return core::FailureExecutionResult(
-            core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
-      }
-
-      consume_budget_metadata.budget_key_name =
-          std::make_shared<std::string>(absl::StrCat(
-              transaction_origin, "/",
-              consume_budget_transaction_key.at("key").get<std::string>()));
-      consume_budget_metadata.token_count =
-          consume_budget_transaction_key["token"].get<TokenCount>();
-
-      auto reporting_time =
-          consume_budget_transaction_key["reporting_time"].get<std::string>();
-      auto time_bucket_or = ReportingTimeToTimeBucket(reporting_time);
-      if (!time_bucket_or.Successful()) {
-        return time_bucket_or.result();
-      }
-      consume_budget_metadata.time_bucket = *time_bucket_or;
-
-      // TODO: This is a temporary solution to prevent transaction
-      // commands belong to the same reporting hour to execute within the
-      // same transaction. The proper solution is to move this logic to
-      // the transaction commands.
-      auto time_group = budget_key_timeframe_manager::Utils::GetTimeGroup(
-          consume_budget_metadata.time_bucket);
-      auto time_bucket = budget_key_timeframe_manager::Utils::GetTimeBucket(
-          consume_budget_metadata.time_bucket);
-
-      auto visited_str = *consume_budget_metadata.budget_key_name + "_" +
-                         std::to_string(time_group) + "_" +
-                         std::to_string(time_bucket);
-
-      if (visited.find(visited_str) != visited.end()) {
-        return core::FailureExecutionResult(
-            core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST);
-      }
-
-      visited.emplace(visited_str);
-      consume_budget_metadata_list.push_back(consume_budget_metadata);
-    }
-  }
-
-  catch (...) {
+    const BeginTransactionRequestSaxHandler& transaction_request,
+    const std::string& transaction_origin, BudgetKeyNameArena& budget_key_names,
+    std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list) {
+  if (!transaction_request.has_v1_keys() ||
+      transaction_request.v1_keys_malformed()) {
     return core::FailureExecutionResult(
         core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
   }
 
+  const auto& budget_keys = transaction_request.v1_keys();
+  consume_budget_metadata_list.reserve(budget_keys.size());
+  size_t budget_key_names_size = 0;
+  for (const ParsedBudgetKey& budget_key : budget_keys) {
+    budget_key_names_size +=
+        transaction_origin.size() + 1 + budget_key.key.size();
+  }
+  budget_key_names.Reserve(budget_key_names_size);
+  ReportingTimeMemo reporting_times;
+  VisitedBudgets visited;
+  visited.reserve(budget_keys.size());
+  for (const ParsedBudgetKey& budget_key : budget_keys) {
+    if (auto execution_result = AppendConsumeBudgetMetadata(
+            transaction_origin, budget_key, budget_key_names, reporting_times,
+            visited, consume_budget_metadata_list);
+        !execution_result.Successful()) {
+      return execution_result;
+    }
+  }
   return core::SuccessExecutionResult();
 }
 
@@ -180,26 +635,29 @@ core::ExecutionResult ParseBeginTransactionRequestBodyV1(
 //   ]
 // }
 core::ExecutionResult ParseBeginTransactionRequestBodyV2(
-    const nlohmann::json& transaction_request,
-    const std::string& authorized_domain,
-    std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list) {
-  auto transaction_request_data_it = transaction_request.find("data");
-  if (transaction_request_data_it == transaction_request.end()) {
+    const BeginTransactionRequestSaxHandler& transaction_request,
+    const std::string& authorized_domain, BudgetKeyNameArena& budget_key_names,
+    std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list,
+    ReportingOriginSiteCache* reporting_origin_site_cache) {
+  if (!transaction_request.has_data() || transaction_request.data_malformed()) {
     return core::FailureExecutionResult(
         core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
   }
 
-  consume_budget_metadata_list.clear();
+  const auto& budget_keys = transaction_request.keys();
   size_t consume_budget_metadata_list_size = 0;
-  for (auto it = transaction_request_data_it->begin();
-       it != transaction_request_data_it->end(); ++it) {
-    auto keys_it = it->find("keys");
-    if (keys_it == it->end()) {
+  size_t budget_key_names_size = 0;
+  for (const ParsedDataElement& data_element : transaction_request.data()) {
+    if (!data_element.is_object || !data_element.has_keys ||
+        data_element.keys_malformed) {
       return core::FailureExecutionResult(
           core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
     }
-    for (auto key_it = keys_it->begin(); key_it != keys_it->end(); ++key_it) {
-      ++consume_budget_metadata_list_size;
+    consume_budget_metadata_list_size +=
+        data_element.keys_end - data_element.keys_begin;
+    for (size_t i = data_element.keys_begin; i < data_element.keys_end; ++i) {
+      budget_key_names_size += data_element.reporting_origin.size() + 1 +
+                               budget_keys[i].key.size();
     }
   }
 
@@ -209,31 +667,28 @@ core::ExecutionResult ParseBeginTransactionRequestBodyV2(
   }
 
   consume_budget_metadata_list.reserve(consume_budget_metadata_list_size);
-
-  absl::flat_hash_set<std::string> visited;
-  absl::flat_hash_set<std::string> visited_reporting_origin;
-  for (auto it = transaction_request_data_it->begin();
-       it != transaction_request_data_it->end(); ++it) {
-    auto reporting_origin_it = it->find("reporting_origin");
-    auto keys_it = it->find("keys");
-
-    if (reporting_origin_it == it->end() || keys_it == it->end()) {
-      consume_budget_metadata_list.clear();
+  budget_key_names.Reserve(budget_key_names_size);
+
+  ReportingTimeMemo reporting_times;
+  VisitedBudgets visited;
+  visited.reserve(consume_budget_metadata_list_size);
+  absl::flat_hash_set<std::string_view> visited_reporting_origin;
+  for (const ParsedDataElement& data_element : transaction_request.data()) {
+    if (data_element.reporting_origin_state != FieldState::kValid) {
       return core::FailureExecutionResult(
           core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
     }
-    const std::string& reporting_origin =
-        reporting_origin_it->get<std::string>();
+    const std::string& reporting_origin = data_element.reporting_origin;
     if (reporting_origin.empty()) {
-      consume_budget_metadata_list.clear();
       return core::FailureExecutionResult(
           core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
     }
 
     ExecutionResultOr<std::string> site =
-        TransformReportingOriginToSite(reporting_origin);
+        reporting_origin_site_cache != nullptr
+            ? reporting_origin_site_cache->GetSite(reporting_origin)
+            : TransformReportingOriginToSite(reporting_origin);
     if (!site.Successful()) {
-      consume_budget_metadata_list.clear();
       return core::FailureExecutionResult(
           core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
     }
@@ -245,140 +700,101 @@ core::ExecutionResult ParseBeginTransactionRequestBodyV2(
               "The provided reporting origin does not belong to the authorized "
               "domain. reporting_origin: %s; authorized_domain: %s",
               *site, authorized_domain));
-      consume_budget_metadata_list.clear();
       return core::FailureExecutionResult(
           core::errors::
               SC_PBS_FRONT_END_SERVICE_REPORTING_ORIGIN_NOT_BELONG_TO_SITE);
     }
 
-    if (visited_reporting_origin.find(reporting_origin) !=
-        visited_reporting_origin.end()) {
+    if (!visited_reporting_origin.emplace(reporting_origin).second) {
       return core::FailureExecutionResult(
           core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST);
     }
-    visited_reporting_origin.emplace(reporting_origin);
-
-    for (auto key_it = keys_it->begin(); key_it != keys_it->end(); ++key_it) {
-      auto k_it = key_it->find("key");
-      auto token_it = key_it->find("token");
-      auto reporting_time_it = key_it->find("reporting_time");
-
-      if (k_it == key_it->end() || token_it == key_it->end() ||
-          reporting_time_it == key_it->end()) {
-        consume_budget_metadata_list.clear();
-        return core::FailureExecutionResult(
-            core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
-      }
 
-      auto budget_key_name = std::make_shared<std::string>(
-          absl::StrCat(reporting_origin, "/", k_it->get<std::string>()));
-      TokenCount token_count = token_it->get<TokenCount>();
-      const std::string& reporting_time = reporting_time_it->get<std::string>();
-      auto reporting_timestamp = ReportingTimeToTimeBucket(reporting_time);
-      if (!reporting_timestamp.Successful()) {
-        return reporting_timestamp.result();
+    for (size_t i = data_element.keys_begin; i < data_element.keys_end; ++i) {
+      if (auto execution_result = AppendConsumeBudgetMetadata(
+              reporting_origin, budget_keys[i], budget_key_names,
+              reporting_times, visited, consume_budget_metadata_list);
+          !execution_result.Successful()) {
+        return execution_result;
       }
-
-      TimeGroup time_group = budget_key_timeframe_manager::Utils::GetTimeGroup(
-          *reporting_timestamp);
-      TimeBucket time_bucket =
-          budget_key_timeframe_manager::Utils::GetTimeBucket(
-              *reporting_timestamp);
-      std::string visited_key =
-          absl::StrCat(*budget_key_name, "_", time_group, "_", time_bucket);
-      if (visited.find(visited_key) != visited.end()) {
-        return core::FailureExecutionResult(
-            core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST);
-      }
-      visited.emplace(visited_key);
-
-      consume_budget_metadata_list.emplace_back(ConsumeBudgetMetadata{
-          budget_key_name, token_count, *reporting_timestamp});
     }
   }
 
   return core::SuccessExecutionResult();
 }
 
-}  // namespace
-
-core::ExecutionResult ParseBeginTransactionRequestBody(
-    const std::string& authorized_domain, const core::BytesBuffer& request_body,
-    std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list) noexcept {
+// The request body is parsed once into a BeginTransactionRequestSaxHandler and
+// then validated. consume_budget_metadata_list is left empty on failure.
+core::ExecutionResult ParseBeginTransactionRequestBodyInternal(
+    const std::string& authorized_domain, const std::string& transaction_origin,
+    const core::BytesBuffer& request_body, BudgetKeyNameArena& budget_key_names,
+    std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list,
+    ReportingOriginSiteCache* reporting_origin_site_cache) noexcept {
+  consume_budget_metadata_list.clear();
   try {
-    nlohmann::json transaction_request = nlohmann::json::parse(
-        request_body.bytes->begin(), request_body.bytes->end(),
-        /*parser_callback_t=*/nullptr,
-        /*allow_exceptions=*/false);
-    if (transaction_request.is_discarded()) {
+    if (!request_body.bytes) {
       return core::FailureExecutionResult(
           core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
     }
-    if (transaction_request.find("v") == transaction_request.end()) {
-      return core::FailureExecutionResult(
-          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
-    }
-    if (transaction_request["v"] != kVersion1 &&
-        transaction_request["v"] != kVersion2) {
+
+    BeginTransactionRequestSaxHandler transaction_request;
+    if (!nlohmann::json::sax_parse(request_body.bytes->begin(),
+                                   request_body.bytes->end(),
+                                   &transaction_request)) {
       return core::FailureExecutionResult(
           core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
     }
 
-    if (transaction_request["v"] == kVersion1) {
-      return ParseBeginTransactionRequestBodyV1(authorized_domain, request_body,
-                                                consume_budget_metadata_list);
+    core::ExecutionResult execution_result = core::FailureExecutionResult(
+        core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
+    switch (transaction_request.version()) {
+      case BeginTransactionRequestSaxHandler::Version::kV1:
+        execution_result = ParseBeginTransactionRequestBodyV1(
+            transaction_request, transaction_origin, budget_key_names,
+            consume_budget_metadata_list);
+        break;
+      case BeginTransactionRequestSaxHandler::Version::kV2:
+        execution_result = ParseBeginTransactionRequestBodyV2(
+            transaction_request, authorized_domain, budget_key_names,
+            consume_budget_metadata_list, reporting_origin_site_cache);
+        break;
+      default:
+        break;
     }
-
-    // transaction_request["v"] == "2.0"
-    return ParseBeginTransactionRequestBodyV2(
-        transaction_request, authorized_domain, consume_budget_metadata_list);
+    if (!execution_result.Successful()) {
+      consume_budget_metadata_list.clear();
+    }
+    return execution_result;
   } catch (const std::exception& exception) {
     SCP_INFO(kFrontEndUtils, core::common::kZeroUuid,
              absl::StrCat("ParseBeginTransactionRequestBody failed ",
                           exception.what()));
+    consume_budget_metadata_list.clear();
     return core::FailureExecutionResult(
         core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
   }
 }
 
+}  // namespace
+
 core::ExecutionResult ParseBeginTransactionRequestBody(
-    const std::string& authorized_domain, const std::string& transaction_origin,
-    const core::BytesBuffer& request_body,
+    const std::string& authorized_domain, const core::BytesBuffer& request_body,
+    BudgetKeyNameArena& budget_key_names,
     std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list) noexcept {
-  try {
-    nlohmann::json transaction_request = nlohmann::json::parse(
-        request_body.bytes->begin(), request_body.bytes->end(),
-        /*parser_callback_t=*/nullptr,
-        /*allow_exceptions=*/false);
-    if (transaction_request.is_discarded()) {
-      return core::FailureExecutionResult(
-          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
-    }
-    if (transaction_request.find("v") == transaction_request.end()) {
-      return core::FailureExecutionResult(
-          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
-    }
-    if (transaction_request["v"] != kVersion1 &&
-        transaction_request["v"] != kVersion2) {
-      return core::FailureExecutionResult(
-          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
-    }
-
-    if (transaction_request["v"] == kVersion1) {
-      return ParseBeginTransactionRequestBodyV1(
-          transaction_origin, request_body, consume_budget_metadata_list);
-    }
+  return ParseBeginTransactionRequestBodyInternal(
+      authorized_domain, /*transaction_origin=*/authorized_domain, request_body,
+      budget_key_names, consume_budget_metadata_list,
+      /*reporting_origin_site_cache=*/nullptr);
+}
 
-    // transaction_request["v"] == "2.0"
-    return ParseBeginTransactionRequestBodyV2(
-        transaction_request, authorized_domain, consume_budget_metadata_list);
-  } catch (const std::exception& exception) {
-    SCP_INFO(kFrontEndUtils, core::common::kZeroUuid,
-             absl::StrCat("ParseBeginTransactionRequestBody failed ",
-                          exception.what()));
-    return core::FailureExecutionResult(
-        core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
-  }
+core::ExecutionResult ParseBeginTransactionRequestBody(
+    const std::string& authorized_domain, const std::string& transaction_origin,
+    const core::BytesBuffer& request_body, BudgetKeyNameArena& budget_key_names,
+    std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list,
+    ReportingOriginSiteCache* reporting_origin_site_cache) noexcept {
+  return ParseBeginTransactionRequestBodyInternal(
+      authorized_domain, transaction_origin, request_body, budget_key_names,
+      consume_budget_metadata_list, reporting_origin_site_cache);
 }
 
 core::ExecutionResultOr<std::string> TransformReportingOriginToSite(
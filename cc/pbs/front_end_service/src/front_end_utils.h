@@ -29,6 +29,8 @@
 #include "cc/core/interface/http_types.h"
 #include "cc/core/interface/type_def.h"
 #include "cc/pbs/front_end_service/src/error_codes.h"
+#include "cc/pbs/front_end_service/src/reporting_origin_site_cache.h"
+#include "cc/pbs/interface/budget_key_name_arena.h"
 #include "cc/pbs/interface/front_end_service_interface.h"
 #include "cc/pbs/interface/type_def.h"
 #include "cc/public/core/interface/execution_result.h"
@@ -36,14 +38,21 @@
 
 namespace google::scp::pbs {
 
+// Parses the budgets to consume from request_body into
+// consume_budget_metadata_list. The budget key names are stored in
+// budget_key_names, which must outlive consume_budget_metadata_list. The sites
+// of reporting origins are looked up in reporting_origin_site_cache if it is
+// not null.
 core::ExecutionResult ParseBeginTransactionRequestBody(
     const std::string& authorized_domain, const core::BytesBuffer& request_body,
+    BudgetKeyNameArena& budget_key_names,
     std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list) noexcept;
 
 core::ExecutionResult ParseBeginTransactionRequestBody(
     const std::string& authorized_domain, const std::string& transaction_origin,
-    const core::BytesBuffer& request_body,
-    std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list) noexcept;
+    const core::BytesBuffer& request_body, BudgetKeyNameArena& budget_key_names,
+    std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list,
+    ReportingOriginSiteCache* reporting_origin_site_cache = nullptr) noexcept;
 
 core::ExecutionResultOr<std::string> TransformReportingOriginToSite(
     const std::string& reporting_origin);
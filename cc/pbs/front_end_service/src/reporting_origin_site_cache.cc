@@ -0,0 +1,90 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cc/pbs/front_end_service/src/reporting_origin_site_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "absl/hash/hash.h"
+#include "cc/pbs/front_end_service/src/front_end_utils.h"
+
+namespace google::scp::pbs {
+
+using ::google::scp::core::ExecutionResultOr;
+
+ReportingOriginSiteCache::ReportingOriginSiteCache(size_t max_entries,
+                                                   size_t shard_count)
+    : max_entries_per_shard_(
+          std::max<size_t>(1, max_entries / std::max<size_t>(1, shard_count))) {
+  shard_count = std::max<size_t>(1, shard_count);
+  shards_.reserve(shard_count);
+  for (size_t i = 0; i < shard_count; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+ReportingOriginSiteCache::Shard& ReportingOriginSiteCache::GetShard(
+    std::string_view reporting_origin) {
+  return *shards_[absl::HashOf(reporting_origin) % shards_.size()];
+}
+
+ExecutionResultOr<std::string> ReportingOriginSiteCache::GetSite(
+    std::string_view reporting_origin) {
+  Shard& shard = GetShard(reporting_origin);
+  {
+    std::unique_lock lock(shard.mutex);
+    if (auto entry = shard.entries.find(reporting_origin);
+        entry != shard.entries.end()) {
+      shard.lru.splice(shard.lru.begin(), shard.lru,
+                       entry->second.lru_position);
+      hit_count_.fetch_add(1, std::memory_order_relaxed);
+      return entry->second.site;
+    }
+  }
+
+  // The site is resolved without holding the lock. Concurrent misses on the
+  // same origin resolve the same site, and only the first one is stored.
+  miss_count_.fetch_add(1, std::memory_order_relaxed);
+  std::string origin(reporting_origin);
+  ExecutionResultOr<std::string> site = TransformReportingOriginToSite(origin);
+
+  std::unique_lock lock(shard.mutex);
+  if (shard.entries.contains(origin)) {
+    return site;
+  }
+  if (shard.entries.size() >= max_entries_per_shard_) {
+    shard.entries.erase(shard.lru.back());
+    shard.lru.pop_back();
+  }
+  shard.lru.push_front(std::move(origin));
+  shard.entries.emplace(
+      shard.lru.front(),
+      Entry{.site = site, .lru_position = shard.lru.begin()});
+  return site;
+}
+
+size_t ReportingOriginSiteCache::Size() const {
+  size_t size = 0;
+  for (const auto& shard : shards_) {
+    std::unique_lock lock(shard->mutex);
+    size += shard->entries.size();
+  }
+  return size;
+}
+
+}  // namespace google::scp::pbs
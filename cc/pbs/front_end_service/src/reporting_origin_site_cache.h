@@ -0,0 +1,88 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CC_PBS_FRONT_END_SERVICE_SRC_REPORTING_ORIGIN_SITE_CACHE_H_
+#define CC_PBS_FRONT_END_SERVICE_SRC_REPORTING_ORIGIN_SITE_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "cc/public/core/interface/execution_result.h"
+
+namespace google::scp::pbs {
+
+// A bounded, in-process memo of TransformReportingOriginToSite.
+//
+// The number of distinct reporting origins is small compared to the number of
+// requests, so most lookups avoid the public suffix list. Failures are cached
+// as well, since an invalid origin stays invalid.
+//
+// The cache is sharded by origin and each shard evicts its least recently used
+// entry once it is full. This class is thread-safe.
+class ReportingOriginSiteCache {
+ public:
+  explicit ReportingOriginSiteCache(size_t max_entries,
+                                    size_t shard_count = kDefaultShardCount);
+
+  // Returns the result of TransformReportingOriginToSite(reporting_origin).
+  core::ExecutionResultOr<std::string> GetSite(
+      std::string_view reporting_origin);
+
+  // Returns the number of cached origins.
+  size_t Size() const;
+
+  // Returns the number of lookups that were answered from the cache.
+  uint64_t HitCount() const {
+    return hit_count_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the number of lookups that resolved the site of the origin.
+  uint64_t MissCount() const {
+    return miss_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kDefaultShardCount = 16;
+
+  struct Entry {
+    core::ExecutionResultOr<std::string> site;
+    // Position of the origin in the LRU list of the shard.
+    std::list<std::string>::iterator lru_position;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    // Most recently used origins first.
+    std::list<std::string> lru;
+    absl::flat_hash_map<std::string, Entry> entries;
+  };
+
+  Shard& GetShard(std::string_view reporting_origin);
+
+  size_t max_entries_per_shard_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<uint64_t> hit_count_ = 0;
+  std::atomic<uint64_t> miss_count_ = 0;
+};
+
+}  // namespace google::scp::pbs
+
+#endif  // CC_PBS_FRONT_END_SERVICE_SRC_REPORTING_ORIGIN_SITE_CACHE_H_
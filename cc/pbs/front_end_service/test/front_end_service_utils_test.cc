@@ -91,23 +91,24 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionV2RequestSuccess) {
 
   BytesBuffer bytes_buffer(begin_transaction_body);
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   auto execution_result = ParseBeginTransactionRequestBody(
       kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
-      consume_budget_metadata_list);
+      budget_key_names, consume_budget_metadata_list);
   EXPECT_SUCCESS(execution_result);
   EXPECT_EQ(consume_budget_metadata_list.size(), 4);
 
   auto it = consume_budget_metadata_list.begin();
-  EXPECT_EQ(*it->budget_key_name, "http://a.fake.com/123");
+  EXPECT_EQ(it->budget_key_name, "http://a.fake.com/123");
   EXPECT_EQ(it->token_count, 1);
   EXPECT_EQ(it->time_bucket, 1576048850000000000);
   ++it;
-  EXPECT_EQ(*it->budget_key_name, "http://a.fake.com/124");
+  EXPECT_EQ(it->budget_key_name, "http://a.fake.com/124");
   EXPECT_EQ(it->token_count, 1);
   EXPECT_EQ(it->time_bucket, 1576048850000000000);
   ++it;
-  EXPECT_EQ(*it->budget_key_name, "http://b.fake.com/456");
+  EXPECT_EQ(it->budget_key_name, "http://b.fake.com/456");
   EXPECT_EQ(it->token_count, 2);
   EXPECT_EQ(it->time_bucket, 1576135250000000000);
 }
@@ -137,10 +138,11 @@ TEST(ParseBeginTransactionTest, V2RequestWithUnauthorizedReportingOrigin) {
 
   BytesBuffer bytes_buffer(begin_transaction_body);
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   auto execution_result = ParseBeginTransactionRequestBody(
       kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
-      consume_budget_metadata_list);
+      budget_key_names, consume_budget_metadata_list);
   EXPECT_THAT(
       execution_result,
       ResultIs(FailureExecutionResult(
@@ -156,10 +158,11 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionV2RequestWithoutData) {
 
   BytesBuffer bytes_buffer(begin_transaction_body);
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   auto execution_result = ParseBeginTransactionRequestBody(
       kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
-      consume_budget_metadata_list);
+      budget_key_names, consume_budget_metadata_list);
   EXPECT_THAT(
       execution_result,
       ResultIs(FailureExecutionResult(
@@ -173,10 +176,11 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionV2RequestInvalidJson) {
 
   BytesBuffer bytes_buffer(begin_transaction_body);
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   auto execution_result = ParseBeginTransactionRequestBody(
       kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
-      consume_budget_metadata_list);
+      budget_key_names, consume_budget_metadata_list);
   EXPECT_THAT(
       execution_result,
       ResultIs(FailureExecutionResult(
@@ -208,10 +212,11 @@ TEST(ParseBeginTransactionTest,
 
   BytesBuffer bytes_buffer(begin_transaction_body);
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   auto execution_result = ParseBeginTransactionRequestBody(
       kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
-      consume_budget_metadata_list);
+      budget_key_names, consume_budget_metadata_list);
   EXPECT_THAT(
       execution_result,
       ResultIs(FailureExecutionResult(
@@ -238,10 +243,11 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionV2RequestWithoutKeys) {
 
   BytesBuffer bytes_buffer(begin_transaction_body);
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   auto execution_result = ParseBeginTransactionRequestBody(
       kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
-      consume_budget_metadata_list);
+      budget_key_names, consume_budget_metadata_list);
   EXPECT_THAT(
       execution_result,
       ResultIs(FailureExecutionResult(
@@ -274,10 +280,11 @@ TEST(ParseBeginTransactionTest,
 
   BytesBuffer bytes_buffer(begin_transaction_body);
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   auto execution_result = ParseBeginTransactionRequestBody(
       kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
-      consume_budget_metadata_list);
+      budget_key_names, consume_budget_metadata_list);
   EXPECT_THAT(execution_result,
               ResultIs(FailureExecutionResult(
                   core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST)));
@@ -307,10 +314,11 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionV2RequestWithoutKey) {
 
   BytesBuffer bytes_buffer(begin_transaction_body);
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   auto execution_result = ParseBeginTransactionRequestBody(
       kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
-      consume_budget_metadata_list);
+      budget_key_names, consume_budget_metadata_list);
   EXPECT_THAT(
       execution_result,
       ResultIs(FailureExecutionResult(
@@ -341,10 +349,11 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionV2RequestWithoutToken) {
 
   BytesBuffer bytes_buffer(begin_transaction_body);
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   auto execution_result = ParseBeginTransactionRequestBody(
       kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
-      consume_budget_metadata_list);
+      budget_key_names, consume_budget_metadata_list);
   EXPECT_THAT(
       execution_result,
       ResultIs(FailureExecutionResult(
@@ -376,10 +385,11 @@ TEST(ParseBeginTransactionTest,
 
   BytesBuffer bytes_buffer(begin_transaction_body);
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   auto execution_result = ParseBeginTransactionRequestBody(
       kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
-      consume_budget_metadata_list);
+      budget_key_names, consume_budget_metadata_list);
   EXPECT_THAT(
       execution_result,
       ResultIs(FailureExecutionResult(
@@ -412,10 +422,11 @@ TEST(ParseBeginTransactionTest,
 
   BytesBuffer bytes_buffer(begin_transaction_body);
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   auto execution_result = ParseBeginTransactionRequestBody(
       kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
-      consume_budget_metadata_list);
+      budget_key_names, consume_budget_metadata_list);
   EXPECT_THAT(execution_result,
               ResultIs(FailureExecutionResult(
                   core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST)));
@@ -446,33 +457,131 @@ TEST(ParseBeginTransactionTest,
 
   BytesBuffer bytes_buffer(begin_transaction_body);
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
   auto execution_result = ParseBeginTransactionRequestBody(
       kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
-      consume_budget_metadata_list);
+      budget_key_names, consume_budget_metadata_list);
   EXPECT_THAT(execution_result,
               ResultIs(FailureExecutionResult(
                   core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST)));
 }
 
+TEST(ParseBeginTransactionTest,
+     ParseBeginTransactionV2RequestWithVersionAfterData) {
+  std::string begin_transaction_body = R"({
+    "data": [
+      {
+        "keys": [
+          {
+            "reporting_time": "2019-12-11T07:20:50.52Z",
+            "token": 3,
+            "key": "123"
+          }
+        ],
+        "reporting_origin": "http://a.fake.com"
+      }
+    ],
+    "v": "2.0"
+  })";
+
+  BytesBuffer bytes_buffer(begin_transaction_body);
+
+  BudgetKeyNameArena budget_key_names;
+  std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
+  auto execution_result = ParseBeginTransactionRequestBody(
+      kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
+      budget_key_names, consume_budget_metadata_list);
+  EXPECT_SUCCESS(execution_result);
+  ASSERT_EQ(consume_budget_metadata_list.size(), 1);
+  EXPECT_EQ(consume_budget_metadata_list[0].budget_key_name,
+            "http://a.fake.com/123");
+  EXPECT_EQ(consume_budget_metadata_list[0].token_count, 3);
+  EXPECT_EQ(consume_budget_metadata_list[0].time_bucket, 1576048850000000000);
+}
+
+TEST(ParseBeginTransactionTest,
+     ParseBeginTransactionV2RequestInvalidJsonAfterEqualsBudgetKey) {
+  std::string begin_transaction_body = R"({
+    "v": "2.0",
+    "data": [
+      {
+        "reporting_origin": "http://a.fake.com",
+        "keys": [
+          {
+            "key": "123",
+            "token": 1,
+            "reporting_time": "2019-12-11T07:20:50.52Z"
+          },
+          {
+            "key": "123",
+            "token": 1,
+            "reporting_time": "2019-12-11T07:20:51.53Z"
+          }
+        ]
+      }
+    ],
+  })";
+
+  BytesBuffer bytes_buffer(begin_transaction_body);
+
+  BudgetKeyNameArena budget_key_names;
+  std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
+  auto execution_result = ParseBeginTransactionRequestBody(
+      kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
+      budget_key_names, consume_budget_metadata_list);
+  EXPECT_THAT(
+      execution_result,
+      ResultIs(FailureExecutionResult(
+          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY)));
+  EXPECT_TRUE(consume_budget_metadata_list.empty());
+}
+
+TEST(ParseBeginTransactionTest, ParseBeginTransactionV1RequestWithObjectKeys) {
+  std::string begin_transaction_body = R"({
+    "v": "1.0",
+    "t": {
+      "first": {
+        "key": "123",
+        "token": 1,
+        "reporting_time": "2019-12-11T07:20:50.52Z"
+      }
+    }
+  })";
+
+  BytesBuffer bytes_buffer(begin_transaction_body);
+
+  BudgetKeyNameArena budget_key_names;
+  std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
+  auto execution_result = ParseBeginTransactionRequestBody(
+      kAuthorizedDomain, kTransactionOriginWithoutSubdomain, bytes_buffer,
+      budget_key_names, consume_budget_metadata_list);
+  EXPECT_THAT(
+      execution_result,
+      ResultIs(FailureExecutionResult(
+          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY)));
+}
+
 TEST(ParseBeginTransactionTest, ParseBeginTransactionInvalidBuffer) {
   BytesBuffer bytes_buffer;
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             FailureExecutionResult(
                 core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY));
 }
 
 TEST(ParseBeginTransactionTest, ParseBeginTransactionInvalidBuffer1) {
   BytesBuffer bytes_buffer(120);
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             FailureExecutionResult(
                 core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY));
 }
@@ -485,11 +594,12 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionInvalidBuffer2) {
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             FailureExecutionResult(
                 core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY));
 }
@@ -502,11 +612,12 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionInvalidBuffer3) {
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             FailureExecutionResult(
                 core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY));
 }
@@ -519,11 +630,12 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionInvalidBuffer4) {
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             FailureExecutionResult(
                 core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY));
 }
@@ -536,11 +648,12 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionInvalidBuffer5) {
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             FailureExecutionResult(
                 core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY));
 }
@@ -553,11 +666,12 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionInvalidBuffer6) {
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             FailureExecutionResult(
                 core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY));
 }
@@ -570,11 +684,12 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionInvalidBuffer7) {
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             SuccessExecutionResult());
 }
 
@@ -587,11 +702,12 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionInvalidBuffer8) {
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             FailureExecutionResult(
                 core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY));
 }
@@ -606,11 +722,12 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionInvalidBuffer9) {
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             FailureExecutionResult(
                 core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY));
 }
@@ -625,11 +742,12 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionInvalidBuffer10) {
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             FailureExecutionResult(
                 core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY));
 }
@@ -646,21 +764,22 @@ TEST(ParseBeginTransactionTest, ParseBeginTransactionValidBuffer) {
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             SuccessExecutionResult());
 
   EXPECT_EQ(consume_budget_metadata_list.size(), 2);
   auto it = consume_budget_metadata_list.begin();
-  EXPECT_EQ(*it->budget_key_name,
+  EXPECT_EQ(it->budget_key_name,
             absl::StrCat(kTransactionOriginWithSubdomain, "/test_key"));
   EXPECT_EQ(it->token_count, 10);
   EXPECT_EQ(it->time_bucket, 1639329650000000000);
   ++it;
-  EXPECT_EQ(*it->budget_key_name,
+  EXPECT_EQ(it->budget_key_name,
             absl::StrCat(kTransactionOriginWithSubdomain, "/test_key_2"));
   EXPECT_EQ(it->token_count, 23);
   EXPECT_EQ(it->time_bucket, 1576135250000000000);
@@ -679,21 +798,22 @@ TEST(ParseBeginTransactionTest,
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             SuccessExecutionResult());
 
   EXPECT_EQ(consume_budget_metadata_list.size(), 2);
   auto it = consume_budget_metadata_list.begin();
-  EXPECT_EQ(*it->budget_key_name,
+  EXPECT_EQ(it->budget_key_name,
             absl::StrCat(kTransactionOriginWithSubdomain, "/test_key"));
   EXPECT_EQ(it->token_count, 10);
   EXPECT_EQ(it->time_bucket, 1639329650000000000);
   ++it;
-  EXPECT_EQ(*it->budget_key_name,
+  EXPECT_EQ(it->budget_key_name,
             absl::StrCat(kTransactionOriginWithSubdomain, "/test_key"));
   EXPECT_EQ(it->token_count, 23);
   EXPECT_EQ(it->time_bucket, 1639332000000000000);
@@ -712,11 +832,12 @@ TEST(ParseBeginTransactionTest,
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             FailureExecutionResult(
                 core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST));
 }
@@ -734,11 +855,12 @@ TEST(ParseBeginTransactionTest,
   bytes_buffer.capacity = begin_transaction_body.length();
   bytes_buffer.length = begin_transaction_body.length();
 
+  BudgetKeyNameArena budget_key_names;
   std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
 
   EXPECT_EQ(ParseBeginTransactionRequestBody(
                 kAuthorizedDomain, kTransactionOriginWithSubdomain,
-                bytes_buffer, consume_budget_metadata_list),
+                bytes_buffer, budget_key_names, consume_budget_metadata_list),
             FailureExecutionResult(
                 core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST));
 }
@@ -471,7 +471,7 @@ TEST(FrontEndServiceV2Test, TestPrepareTransaction) {
 
   ASSERT_EQ(captured_consume_budgets_context.request->budgets.size(), 2);
   EXPECT_EQ(
-      *captured_consume_budgets_context.request->budgets[0].budget_key_name,
+      captured_consume_budgets_context.request->budgets[0].budget_key_name,
       "https://fake.com/test_key");
   EXPECT_EQ(captured_consume_budgets_context.request->budgets[0].token_count,
             10);
@@ -479,7 +479,7 @@ TEST(FrontEndServiceV2Test, TestPrepareTransaction) {
             1570864850000000000);
 
   EXPECT_EQ(
-      *captured_consume_budgets_context.request->budgets[1].budget_key_name,
+      captured_consume_budgets_context.request->budgets[1].budget_key_name,
       "https://fake.com/test_key_2");
   EXPECT_EQ(captured_consume_budgets_context.request->budgets[1].token_count,
             23);
@@ -0,0 +1,175 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <google/protobuf/timestamp.pb.h>
+#include <google/protobuf/util/time_util.h>
+#include <nlohmann/json.hpp>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "cc/core/interface/type_def.h"
+#include "cc/pbs/budget_key_timeframe_manager/src/budget_key_timeframe_utils.h"
+#include "cc/pbs/front_end_service/src/front_end_utils.h"
+#include "cc/pbs/interface/budget_key_name_arena.h"
+#include "cc/pbs/interface/type_def.h"
+
+namespace google::scp::pbs {
+namespace {
+
+constexpr char kAuthorizedDomain[] = "https://fake.com";
+constexpr int kReportingOriginCount = 8;
+
+// Builds a V2 request body with budget_key_count distinct keys spread over
+// kReportingOriginCount reporting origins.
+std::string MakeV2RequestBody(int budget_key_count) {
+  std::string body = R"({"v":"2.0","data":[)";
+  for (int origin = 0; origin < kReportingOriginCount; ++origin) {
+    absl::StrAppend(&body, origin == 0 ? "" : ",",
+                    R"({"reporting_origin":"https://origin)", origin,
+                    R"(.fake.com","keys":[)");
+    for (int i = origin; i < budget_key_count; i += kReportingOriginCount) {
+      absl::StrAppend(
+          &body, i == origin ? "" : ",",
+          absl::StrFormat(R"({"key":"budget_key_%d","token":1,)"
+                          R"("reporting_time":"2019-12-11T%02d:20:50.52Z"})",
+                          i, i % 24));
+    }
+    absl::StrAppend(&body, "]}");
+  }
+  absl::StrAppend(&body, "]}");
+  return body;
+}
+
+// The parsing path that ParseBeginTransactionRequestBody replaced, kept as a
+// baseline: the body is parsed into a JSON document that is walked twice.
+core::ExecutionResult ParseV2RequestBodyWithJsonDocument(
+    const core::BytesBuffer& request_body, BudgetKeyNameArena& budget_key_names,
+    std::vector<ConsumeBudgetMetadata>& consume_budget_metadata_list) {
+  nlohmann::json transaction_request =
+      nlohmann::json::parse(request_body.bytes->begin(),
+                            request_body.bytes->end(), nullptr, false);
+  if (transaction_request.is_discarded() ||
+      transaction_request["v"] != "2.0") {
+    return core::FailureExecutionResult(
+        core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
+  }
+  const nlohmann::json& data = transaction_request["data"];
+  size_t consume_budget_metadata_list_size = 0;
+  for (const auto& data_element : data) {
+    consume_budget_metadata_list_size += data_element["keys"].size();
+  }
+  consume_budget_metadata_list.clear();
+  consume_budget_metadata_list.reserve(consume_budget_metadata_list_size);
+
+  absl::flat_hash_set<std::string> visited;
+  for (const auto& data_element : data) {
+    const std::string& reporting_origin =
+        data_element["reporting_origin"].get<std::string>();
+    auto site = TransformReportingOriginToSite(reporting_origin);
+    if (!site.Successful() || *site != kAuthorizedDomain) {
+      return core::FailureExecutionResult(
+          core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST_BODY);
+    }
+    for (const auto& key : data_element["keys"]) {
+      std::string_view budget_key_name = budget_key_names.Add(
+          {reporting_origin, "/", key["key"].get<std::string>()});
+      google::protobuf::Timestamp reporting_timestamp;
+      if (!google::protobuf::util::TimeUtil::FromString(
+              key["reporting_time"].get<std::string>(),
+              &reporting_timestamp)) {
+        return core::FailureExecutionResult(
+            core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST);
+      }
+      TimeBucket time_bucket = static_cast<uint64_t>(
+          std::chrono::nanoseconds(
+              std::chrono::seconds(reporting_timestamp.seconds()))
+              .count());
+      if (!visited
+               .emplace(absl::StrCat(
+                   budget_key_name, "_",
+                   budget_key_timeframe_manager::Utils::GetTimeGroup(
+                       time_bucket),
+                   "_",
+                   budget_key_timeframe_manager::Utils::GetTimeBucket(
+                       time_bucket)))
+               .second) {
+        return core::FailureExecutionResult(
+            core::errors::SC_PBS_FRONT_END_SERVICE_INVALID_REQUEST);
+      }
+      consume_budget_metadata_list.emplace_back(ConsumeBudgetMetadata{
+          budget_key_name, key["token"].get<TokenCount>(),
+          time_bucket});
+    }
+  }
+  return core::SuccessExecutionResult();
+}
+
+void BM_ParseBeginTransactionRequestBody(benchmark::State& state) {
+  core::BytesBuffer request_body(MakeV2RequestBody(state.range(0)));
+  std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
+  for (auto _ : state) {
+    BudgetKeyNameArena budget_key_names;
+    auto execution_result = ParseBeginTransactionRequestBody(
+        kAuthorizedDomain, kAuthorizedDomain, request_body, budget_key_names,
+        consume_budget_metadata_list);
+    if (!execution_result.Successful()) {
+      state.SkipWithError("Failed to parse the request body.");
+      break;
+    }
+    benchmark::DoNotOptimize(consume_budget_metadata_list);
+  }
+  state.SetBytesProcessed(state.iterations() * request_body.length);
+  state.counters["body_bytes"] = request_body.length;
+}
+
+void BM_ParseBeginTransactionRequestBodyWithJsonDocument(
+    benchmark::State& state) {
+  core::BytesBuffer request_body(MakeV2RequestBody(state.range(0)));
+  std::vector<ConsumeBudgetMetadata> consume_budget_metadata_list;
+  for (auto _ : state) {
+    BudgetKeyNameArena budget_key_names;
+    auto execution_result = ParseV2RequestBodyWithJsonDocument(
+        request_body, budget_key_names, consume_budget_metadata_list);
+    if (!execution_result.Successful()) {
+      state.SkipWithError("Failed to parse the request body.");
+      break;
+    }
+    benchmark::DoNotOptimize(consume_budget_metadata_list);
+  }
+  state.SetBytesProcessed(state.iterations() * request_body.length);
+  state.counters["body_bytes"] = request_body.length;
+}
+
+// Up to 65536 budget keys, i.e. bodies of about 6 MB.
+BENCHMARK(BM_ParseBeginTransactionRequestBody)
+    ->RangeMultiplier(8)
+    ->Range(1 << 7, 1 << 16);
+BENCHMARK(BM_ParseBeginTransactionRequestBodyWithJsonDocument)
+    ->RangeMultiplier(8)
+    ->Range(1 << 7, 1 << 16);
+
+}  // namespace
+}  // namespace google::scp::pbs
+
+// Run the benchmark.
+BENCHMARK_MAIN();
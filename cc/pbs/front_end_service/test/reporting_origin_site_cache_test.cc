@@ -0,0 +1,76 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cc/pbs/front_end_service/src/reporting_origin_site_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "cc/pbs/front_end_service/src/error_codes.h"
+#include "cc/public/core/interface/execution_result.h"
+#include "cc/public/core/test/interface/execution_result_matchers.h"
+
+namespace google::scp::pbs {
+namespace {
+
+using ::google::scp::core::FailureExecutionResult;
+using ::google::scp::core::errors::
+    SC_PBS_FRONT_END_SERVICE_INVALID_REPORTING_ORIGIN;
+using ::google::scp::core::test::IsSuccessfulAndHolds;
+using ::google::scp::core::test::ResultIs;
+
+TEST(ReportingOriginSiteCacheTest, ReturnsSiteOfOrigin) {
+  ReportingOriginSiteCache cache(/*max_entries=*/10);
+  EXPECT_THAT(cache.GetSite("http://a.fake.com:8080/path"),
+              IsSuccessfulAndHolds("https://fake.com"));
+  EXPECT_EQ(cache.HitCount(), 0);
+  EXPECT_EQ(cache.MissCount(), 1);
+
+  EXPECT_THAT(cache.GetSite("http://a.fake.com:8080/path"),
+              IsSuccessfulAndHolds("https://fake.com"));
+  EXPECT_EQ(cache.HitCount(), 1);
+  EXPECT_EQ(cache.MissCount(), 1);
+  EXPECT_EQ(cache.Size(), 1);
+}
+
+TEST(ReportingOriginSiteCacheTest, CachesInvalidOrigin) {
+  ReportingOriginSiteCache cache(/*max_entries=*/10);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(cache.GetSite("******").result(),
+                ResultIs(FailureExecutionResult(
+                    SC_PBS_FRONT_END_SERVICE_INVALID_REPORTING_ORIGIN)));
+  }
+  EXPECT_EQ(cache.HitCount(), 1);
+  EXPECT_EQ(cache.MissCount(), 1);
+}
+
+TEST(ReportingOriginSiteCacheTest, EvictsLeastRecentlyUsedOrigin) {
+  ReportingOriginSiteCache cache(/*max_entries=*/2, /*shard_count=*/1);
+  ASSERT_SUCCESS(cache.GetSite("https://a.fake.com").result());
+  ASSERT_SUCCESS(cache.GetSite("https://b.fake.com").result());
+  ASSERT_SUCCESS(cache.GetSite("https://a.fake.com").result());
+  ASSERT_SUCCESS(cache.GetSite("https://c.fake.com").result());
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_EQ(cache.MissCount(), 3);
+
+  // b.fake.com was evicted, a.fake.com was not.
+  ASSERT_SUCCESS(cache.GetSite("https://a.fake.com").result());
+  EXPECT_EQ(cache.MissCount(), 3);
+  ASSERT_SUCCESS(cache.GetSite("https://b.fake.com").result());
+  EXPECT_EQ(cache.MissCount(), 4);
+}
+
+}  // namespace
+}  // namespace google::scp::pbs
@@ -0,0 +1,95 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef CC_PBS_INTERFACE_BUDGET_KEY_NAME_ARENA_H_
+#define CC_PBS_INTERFACE_BUDGET_KEY_NAME_ARENA_H_
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace google::scp::pbs {
+
+// Stores the budget key names of a request in a few contiguous blocks instead
+// of one allocation per name. The returned names keep their address for the
+// lifetime of the arena, even if the arena is moved. This class is not
+// thread-safe.
+class BudgetKeyNameArena {
+ public:
+  BudgetKeyNameArena() = default;
+
+  BudgetKeyNameArena(BudgetKeyNameArena&& other) noexcept
+      : blocks_(std::move(other.blocks_)),
+        next_(std::exchange(other.next_, nullptr)),
+        remaining_(std::exchange(other.remaining_, 0)) {}
+
+  BudgetKeyNameArena& operator=(BudgetKeyNameArena&& other) noexcept {
+    blocks_ = std::move(other.blocks_);
+    next_ = std::exchange(other.next_, nullptr);
+    remaining_ = std::exchange(other.remaining_, 0);
+    return *this;
+  }
+
+  BudgetKeyNameArena(const BudgetKeyNameArena&) = delete;
+  BudgetKeyNameArena& operator=(const BudgetKeyNameArena&) = delete;
+
+  // Makes sure that names of up to size bytes in total can be added without
+  // allocating.
+  void Reserve(size_t size) {
+    if (remaining_ < size) {
+      AddBlock(size);
+    }
+  }
+
+  // Stores the concatenation of pieces and returns it.
+  std::string_view Add(std::initializer_list<std::string_view> pieces) {
+    size_t size = 0;
+    for (std::string_view piece : pieces) {
+      size += piece.size();
+    }
+    if (remaining_ < size) {
+      AddBlock(std::max(size, kMinBlockSize));
+    }
+    char* name = next_;
+    for (std::string_view piece : pieces) {
+      if (!piece.empty()) {
+        std::memcpy(next_, piece.data(), piece.size());
+        next_ += piece.size();
+      }
+    }
+    remaining_ -= size;
+    return std::string_view(name, size);
+  }
+
+ private:
+  static constexpr size_t kMinBlockSize = 4096;
+
+  void AddBlock(size_t size) {
+    blocks_.push_back(std::unique_ptr<char[]>(new char[size]));
+    next_ = blocks_.back().get();
+    remaining_ = size;
+  }
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  // Free space of the last block.
+  char* next_ = nullptr;
+  size_t remaining_ = 0;
+};
+
+}  // namespace google::scp::pbs
+
+#endif  // CC_PBS_INTERFACE_BUDGET_KEY_NAME_ARENA_H_
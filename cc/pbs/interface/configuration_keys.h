@@ -120,6 +120,11 @@ static constexpr char kHttp2ServerPrivateKeyFilePath[] =
 static constexpr char kHttp2ServerCertificateFilePath[] =
     "google_scp_pbs_http2_server_certificate_file_path";
 
+// The memory the request bodies in flight on the HTTP2 server may take
+// altogether. Optional, and unbounded if 0.
+static constexpr char kHttp2ServerRequestBodyMemoryBudgetInBytes[] =
+    "google_scp_pbs_http2_server_request_body_memory_budget_in_bytes";
+
 static constexpr char kPBSJournalCheckpointingIntervalInSeconds[] =
     "google_scp_pbs_journal_checkpointing_interval_in_seconds";
 static constexpr char
@@ -127,6 +132,45 @@ static constexpr char
         "google_scp_pbs_journal_checkpointing_max_entries_to_process_in_each_"
         "run";
 
+// CPU placement
+// When enabled, the physical cores the process may run on are split between
+// the threads of the HTTP2 server, the async executor and the IO async
+// executor in proportion to their shares, which must be positive. Only the
+// threads are placed: the memory of the queues and task pools is not allocated
+// on the NUMA node of the threads using it.
+static constexpr char kPBSCpuPlacementEnabled[] =
+    "google_scp_pbs_cpu_placement_enabled";
+static constexpr char kPBSCpuPlacementHttp2ServerShare[] =
+    "google_scp_pbs_cpu_placement_http2_server_share";
+static constexpr char kPBSCpuPlacementAsyncExecutorShare[] =
+    "google_scp_pbs_cpu_placement_async_executor_share";
+static constexpr char kPBSCpuPlacementIOAsyncExecutorShare[] =
+    "google_scp_pbs_cpu_placement_io_async_executor_share";
+
+// Admission control
+// When enabled, the requests are rejected with a 503 once the tasks of the
+// async executors keep waiting more than the target sojourn time for a whole
+// interval, until they wait less again.
+static constexpr char kPBSAdmissionControlEnabled[] =
+    "google_scp_pbs_admission_control_enabled";
+static constexpr char kPBSAdmissionControlTargetSojournTimeInMilliseconds[] =
+    "google_scp_pbs_admission_control_target_sojourn_time_in_milliseconds";
+static constexpr char kPBSAdmissionControlIntervalInMilliseconds[] =
+    "google_scp_pbs_admission_control_interval_in_milliseconds";
+
+// Elastic IO async executor
+// When the max threads count is above the threads count, the normal and high
+// priority tasks of the IO async executor, e.g. the blocking database calls,
+// run on a pool which adds threads while all of its threads have been blocked
+// for the blocked threshold, and lets the extra threads exit once idle for the
+// idle timeout.
+static constexpr char kPBSIOAsyncExecutorMaxThreadsCount[] =
+    "google_scp_pbs_io_async_executor_max_threads_count";
+static constexpr char kPBSIOAsyncExecutorBlockedThresholdInMilliseconds[] =
+    "google_scp_pbs_io_async_executor_blocked_threshold_in_milliseconds";
+static constexpr char kPBSIOAsyncExecutorIdleTimeoutInSeconds[] =
+    "google_scp_pbs_io_async_executor_idle_timeout_in_seconds";
+
 // Health service
 static constexpr char kPBSHealthServiceEnableMemoryAndStorageCheck[] =
     "google_scp_pbs_health_service_enable_mem_and_storage_check";
@@ -150,4 +194,50 @@ static constexpr char kContainerType[] = "google_scp_pbs_container_type";
 // Migration phase for ValueProto column.
 static constexpr char kValueProtoMigrationPhase[] =
     "google_scp_pbs_value_proto_migration_phase";
+
+// Group commit of concurrent budget consumptions. A max batch size of 1
+// disables group commit.
+static constexpr char kBudgetConsumptionGroupCommitMaxBatchSize[] =
+    "google_scp_pbs_budget_consumption_group_commit_max_batch_size";
+static constexpr char kBudgetConsumptionGroupCommitMaxLingerMs[] =
+    "google_scp_pbs_budget_consumption_group_commit_max_linger_ms";
+// Maximum number of budget consumptions waiting for a group commit. Defaults
+// to google_scp_pbs_io_async_executor_queue_size.
+static constexpr char kBudgetConsumptionGroupCommitMaxPendingCount[] =
+    "google_scp_pbs_budget_consumption_group_commit_max_pending_count";
+
+// Budget tables across which budget keys are sharded, as a list of
+// "<table>" or "<database>/<table>" entries. A table without a database is in
+// google_scp_spanner_database_name. A budget key is placed by a hash of its
+// name and the index of the table in the list, so tables can neither be
+// reordered nor added without migrating the budgets. If unset, all budget keys
+// are in google_scp_pbs_budget_key_table_name.
+static constexpr char kBudgetKeyTableShards[] =
+    "google_scp_pbs_budget_key_table_shards";
+
+// Maximum number of budget keys cached by the budget consumption helper. A
+// value of 0, the default, disables the cache. The cache is also disabled if
+// google_scp_pbs_budget_key_table_shards is set.
+static constexpr char kBudgetConsumptionCacheMaxEntries[] =
+    "google_scp_pbs_budget_consumption_cache_max_entries";
+// How long a budget key known to be exhausted is trusted for, since the other
+// replicas may return its budget meanwhile. Defaults to 1000.
+static constexpr char kBudgetConsumptionCacheMaxAgeMs[] =
+    "google_scp_pbs_budget_consumption_cache_max_age_ms";
+
+// Maximum number of reporting origins whose site is cached by the front end
+// service. A value of 0 disables the cache.
+static constexpr char kReportingOriginSiteCacheMaxEntries[] =
+    "google_scp_pbs_reporting_origin_site_cache_max_entries";
+
+// Embedded budget storage used by the local dependency factory instead of
+// Spanner. Budgets are only kept in memory if no directory is set.
+static constexpr char kLocalBudgetStorageEnabled[] =
+    "google_scp_pbs_local_budget_storage_enabled";
+static constexpr char kLocalBudgetStorageDirectory[] =
+    "google_scp_pbs_local_budget_storage_directory";
+static constexpr char kLocalBudgetStorageShardCount[] =
+    "google_scp_pbs_local_budget_storage_shard_count";
+static constexpr char kLocalBudgetStorageCompactionThresholdBytes[] =
+    "google_scp_pbs_local_budget_storage_compaction_threshold_bytes";
 }  // namespace google::scp::pbs
@@ -17,8 +17,10 @@
 
 #include <vector>
 
+#include "cc/core/common/coroutine/src/awaitables.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/service_interface.h"
+#include "cc/pbs/interface/budget_key_name_arena.h"
 #include "cc/pbs/interface/front_end_service_interface.h"
 #include "cc/public/core/interface/execution_result.h"
 
@@ -26,6 +28,8 @@ namespace google::scp::pbs {
 
 struct ConsumeBudgetsRequest {
   std::vector<ConsumeBudgetMetadata> budgets;
+  // Storage of the budget key names of budgets.
+  BudgetKeyNameArena budget_key_names;
 };
 
 struct ConsumeBudgetsResponse {
@@ -43,6 +47,22 @@ class BudgetConsumptionHelperInterface
                                       ConsumeBudgetsResponse>
           consume_budgets_context) = 0;
 };
+
+// Awaits BudgetConsumptionHelperInterface::ConsumeBudgets in a coroutine. The
+// context must outlive the awaiting.
+inline auto AwaitConsumeBudgets(
+    BudgetConsumptionHelperInterface& budget_consumption_helper,
+    google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                    ConsumeBudgetsResponse>&
+        consume_budgets_context) noexcept {
+  return google::scp::core::AwaitAsyncContext(
+      consume_budgets_context,
+      [&budget_consumption_helper](
+          google::scp::core::AsyncContext<ConsumeBudgetsRequest,
+                                          ConsumeBudgetsResponse>& context) {
+        return budget_consumption_helper.ConsumeBudgets(context);
+      });
+}
 }  // namespace google::scp::pbs
 
 #endif  // CC_PBS_INTERFACE_CONSUME_BUDGET_INTERFACE_H_
@@ -19,6 +19,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "cc/core/common/uuid/src/uuid.h"
@@ -31,8 +32,9 @@ namespace google::scp::pbs {
 
 /// Represents metadata collection for a consume budget operation.
 struct ConsumeBudgetMetadata {
-  /// The budget key name.
-  std::shared_ptr<BudgetKeyName> budget_key_name;
+  /// The budget key name. It is not owned and usually refers to the
+  /// budget_key_names of the ConsumeBudgetsRequest holding this metadata.
+  std::string_view budget_key_name;
   /// The token count to be consumed.
   TokenCount token_count = 0;
   /// The time bucket to consume the token.
@@ -59,6 +59,10 @@ static constexpr char kMetricNameFileSystemStorageUsage[] =
     "google.scp.pbs.health.filesystem_storage_usage";
 inline constexpr absl::string_view kBudgetExhausted =
     "google.scp.pbs.consume_budget.budget_exhausted";
+static constexpr char kReportingOriginSiteCacheHits[] =
+    "google.scp.pbs.frontend.reporting_origin_site_cache_hits";
+static constexpr char kReportingOriginSiteCacheMisses[] =
+    "google.scp.pbs.frontend.reporting_origin_site_cache_misses";
 
 // Metric labels
 static constexpr char kMetricLabelFrontEndService[] = "frontend_service";
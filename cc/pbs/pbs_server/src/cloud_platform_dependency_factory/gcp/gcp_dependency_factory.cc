@@ -14,10 +14,15 @@
 
 #include "gcp_dependency_factory.h"
 
+#include <list>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
 #include "cc/core/authorization_proxy/src/authorization_proxy.h"
 #include "cc/core/common/global_logger/src/global_logger.h"
 #include "cc/core/common/uuid/src/uuid.h"
@@ -31,6 +36,8 @@
 #include "cc/core/telemetry/src/metric/otlp_grpc_authed_metric_exporter.h"
 #include "cc/pbs/authorization/src/gcp/gcp_http_request_response_auth_interceptor.h"
 #include "cc/pbs/consume_budget/src/gcp/consume_budget.h"
+#include "cc/pbs/consume_budget/src/gcp/error_codes.h"
+#include "cc/pbs/consume_budget/src/gcp/sharded_consume_budget.h"
 #include "cc/pbs/interface/configuration_keys.h"
 #include "google/cloud/monitoring/v3/metric_client.h"
 #include "google/cloud/opentelemetry/monitoring_exporter.h"
@@ -182,17 +189,61 @@ std::unique_ptr<pbs::BudgetConsumptionHelperInterface>
 GcpDependencyFactory::ConstructBudgetConsumptionHelper(
     google::scp::core::AsyncExecutorInterface* async_executor,
     google::scp::core::AsyncExecutorInterface* io_async_executor) noexcept {
-  google::scp::core::ExecutionResultOr<
-      std::shared_ptr<cloud::spanner::Connection>>
-      spanner_connection =
+  std::list<std::string> budget_key_table_shards;
+  if (!config_provider_->Get(kBudgetKeyTableShards, budget_key_table_shards)
+           .Successful() ||
+      budget_key_table_shards.empty()) {
+    google::scp::core::ExecutionResultOr<
+        std::shared_ptr<cloud::spanner::Connection>>
+        spanner_connection =
+            BudgetConsumptionHelper::MakeSpannerConnectionForProd(
+                *config_provider_);
+    if (!spanner_connection.result().Successful()) {
+      return nullptr;
+    }
+    return std::make_unique<pbs::BudgetConsumptionHelper>(
+        config_provider_.get(), async_executor, io_async_executor,
+        std::move(*spanner_connection));
+  }
+
+  std::string default_database;
+  config_provider_->Get(core::kSpannerDatabase, default_database);
+  // The tables of a database share its connection.
+  std::unordered_map<std::string, std::shared_ptr<cloud::spanner::Connection>>
+      spanner_connections;
+  std::vector<std::unique_ptr<BudgetConsumptionHelper>> shards;
+  for (const std::string& budget_key_table_shard : budget_key_table_shards) {
+    std::vector<std::string> database_and_table =
+        absl::StrSplit(budget_key_table_shard, absl::MaxSplits('/', 1));
+    const std::string& database = database_and_table.size() == 2
+                                      ? database_and_table.front()
+                                      : default_database;
+    const std::string& table_name = database_and_table.back();
+    if (database.empty() || table_name.empty()) {
+      SCP_ERROR(kGcpDependencyProvider, kZeroUuid,
+                core::FailureExecutionResult(
+                    errors::SC_CONSUME_BUDGET_INVALID_CONFIGURATION),
+                absl::StrFormat("Invalid budget key table shard: %s",
+                                budget_key_table_shard));
+      return nullptr;
+    }
+
+    std::shared_ptr<cloud::spanner::Connection>& spanner_connection =
+        spanner_connections[database];
+    if (!spanner_connection) {
+      auto database_connection =
           BudgetConsumptionHelper::MakeSpannerConnectionForProd(
-              *config_provider_);
-  if (!spanner_connection.result().Successful()) {
-    return nullptr;
+              *config_provider_, database);
+      if (!database_connection.result().Successful()) {
+        return nullptr;
+      }
+      spanner_connection = std::move(*database_connection);
+    }
+    shards.push_back(std::make_unique<BudgetConsumptionHelper>(
+        config_provider_.get(), async_executor, io_async_executor,
+        spanner_connection, table_name));
   }
-  return std::make_unique<pbs::BudgetConsumptionHelper>(
-      config_provider_.get(), async_executor, io_async_executor,
-      std::move(*spanner_connection));
+  return std::make_unique<ShardedBudgetConsumptionHelper>(std::move(shards));
 }
 
 std::unique_ptr<core::MetricRouter>
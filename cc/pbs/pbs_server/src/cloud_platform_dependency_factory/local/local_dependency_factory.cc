@@ -20,6 +20,7 @@
 #include "cc/core/interface/configuration_keys.h"
 #include "cc/core/telemetry/mock/in_memory_metric_exporter.h"
 #include "cc/pbs/consume_budget/src/gcp/consume_budget.h"
+#include "cc/pbs/consume_budget/src/local/consume_budget.h"
 #include "cc/pbs/interface/configuration_keys.h"
 #include "cc/pbs/pbs_server/src/cloud_platform_dependency_factory/local/local_authorization_proxy.h"
 #include "opentelemetry/sdk/metrics/push_metric_exporter.h"
@@ -72,6 +73,14 @@ std::unique_ptr<pbs::BudgetConsumptionHelperInterface>
 LocalDependencyFactory::ConstructBudgetConsumptionHelper(
     core::AsyncExecutorInterface* async_executor,
     core::AsyncExecutorInterface* io_async_executor) noexcept {
+  bool is_local_budget_storage_enabled = false;
+  config_provider_->Get(kLocalBudgetStorageEnabled,
+                        is_local_budget_storage_enabled);
+  if (is_local_budget_storage_enabled) {
+    return std::make_unique<LocalBudgetConsumptionHelper>(
+        config_provider_.get(), async_executor);
+  }
+
   google::scp::core::ExecutionResultOr<
       std::shared_ptr<cloud::spanner::Connection>>
       spanner_connection =
@@ -56,4 +56,8 @@ DEFINE_ERROR_CODE(SC_PBS_SERVICE_INITIALIZATION_ERROR, SC_PBS_SERVICE, 0x0008,
                   "The PBS service cannot be initialized.",
                   HttpStatusCode::INTERNAL_SERVER_ERROR)
 
+DEFINE_ERROR_CODE(SC_PBS_INVALID_CPU_PLACEMENT_SHARE, SC_PBS_SERVICE, 0x0009,
+                  "The CPU placement shares must all be positive.",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR)
+
 }  // namespace google::scp::core::errors
@@ -68,10 +68,33 @@ struct PBSInstanceConfig {
   bool http2_server_use_tls = false;
   std::shared_ptr<std::string> http2_server_private_key_file_path;
   std::shared_ptr<std::string> http2_server_certificate_file_path;
+  // The memory budget of the request bodies, unbounded if 0.
+  size_t http2_server_request_body_memory_budget_bytes = 0;
 
   std::shared_ptr<std::string> partition_lease_table_name;
   std::chrono::seconds partition_lease_duration_in_seconds =
       std::chrono::seconds(kDefaultLeaseDurationInSeconds);
+
+  // Placement of the threads on the physical cores.
+  bool cpu_placement_enabled = false;
+  size_t cpu_placement_http2_server_share = 1;
+  size_t cpu_placement_async_executor_share = 2;
+  size_t cpu_placement_io_async_executor_share = 1;
+
+  // Admission control of the normal priority tasks of the async executors.
+  bool admission_control_enabled = false;
+  std::chrono::milliseconds admission_control_target_sojourn_time =
+      std::chrono::milliseconds(5);
+  std::chrono::milliseconds admission_control_interval =
+      std::chrono::milliseconds(100);
+
+  // Elastic sizing of the IO async executor, enabled when the max thread pool
+  // size is above io_async_executor_thread_pool_size.
+  size_t io_async_executor_max_thread_pool_size = 0;
+  std::chrono::milliseconds io_async_executor_blocked_threshold =
+      std::chrono::milliseconds(50);
+  std::chrono::seconds io_async_executor_idle_timeout =
+      std::chrono::seconds(30);
 };
 
 /**
@@ -229,6 +252,11 @@ GetPBSInstanceConfigFromConfigProvider(
     }
   }
 
+  // The memory budget of the request bodies is optional.
+  config_provider->Get(
+      kHttp2ServerRequestBodyMemoryBudgetInBytes,
+      pbs_instance_config.http2_server_request_body_memory_budget_bytes);
+
   // Lease related configurations
   // Partition Lease
   std::string partition_lease_table_name;
@@ -256,6 +284,73 @@ GetPBSInstanceConfigFromConfigProvider(
   pbs_instance_config.partition_lease_duration_in_seconds =
       std::chrono::seconds(configured_partition_lease_duration_in_seconds);
 
+  // The placement is optional, and the shares keep their default values if
+  // they are not configured.
+  if (config_provider
+          ->Get(kPBSCpuPlacementEnabled,
+                pbs_instance_config.cpu_placement_enabled)
+          .Successful() &&
+      pbs_instance_config.cpu_placement_enabled) {
+    config_provider->Get(kPBSCpuPlacementHttp2ServerShare,
+                         pbs_instance_config.cpu_placement_http2_server_share);
+    config_provider->Get(
+        kPBSCpuPlacementAsyncExecutorShare,
+        pbs_instance_config.cpu_placement_async_executor_share);
+    config_provider->Get(
+        kPBSCpuPlacementIOAsyncExecutorShare,
+        pbs_instance_config.cpu_placement_io_async_executor_share);
+    // A pool without cores would be pinned to the cores of the other pools.
+    if (pbs_instance_config.cpu_placement_http2_server_share == 0 ||
+        pbs_instance_config.cpu_placement_async_executor_share == 0 ||
+        pbs_instance_config.cpu_placement_io_async_executor_share == 0) {
+      return core::FailureExecutionResult(
+          core::errors::SC_PBS_INVALID_CPU_PLACEMENT_SHARE);
+    }
+  }
+
+  // The admission control is optional as well.
+  if (config_provider
+          ->Get(kPBSAdmissionControlEnabled,
+                pbs_instance_config.admission_control_enabled)
+          .Successful() &&
+      pbs_instance_config.admission_control_enabled) {
+    core::TimeDuration target_sojourn_time_in_milliseconds =
+        pbs_instance_config.admission_control_target_sojourn_time.count();
+    config_provider->Get(kPBSAdmissionControlTargetSojournTimeInMilliseconds,
+                         target_sojourn_time_in_milliseconds);
+    pbs_instance_config.admission_control_target_sojourn_time =
+        std::chrono::milliseconds(target_sojourn_time_in_milliseconds);
+
+    core::TimeDuration interval_in_milliseconds =
+        pbs_instance_config.admission_control_interval.count();
+    config_provider->Get(kPBSAdmissionControlIntervalInMilliseconds,
+                         interval_in_milliseconds);
+    pbs_instance_config.admission_control_interval =
+        std::chrono::milliseconds(interval_in_milliseconds);
+  }
+
+  // The elastic sizing of the IO async executor is optional as well.
+  if (config_provider
+          ->Get(kPBSIOAsyncExecutorMaxThreadsCount,
+                pbs_instance_config.io_async_executor_max_thread_pool_size)
+          .Successful() &&
+      pbs_instance_config.io_async_executor_max_thread_pool_size >
+          pbs_instance_config.io_async_executor_thread_pool_size) {
+    core::TimeDuration blocked_threshold_in_milliseconds =
+        pbs_instance_config.io_async_executor_blocked_threshold.count();
+    config_provider->Get(kPBSIOAsyncExecutorBlockedThresholdInMilliseconds,
+                         blocked_threshold_in_milliseconds);
+    pbs_instance_config.io_async_executor_blocked_threshold =
+        std::chrono::milliseconds(blocked_threshold_in_milliseconds);
+
+    core::TimeDuration idle_timeout_in_seconds =
+        pbs_instance_config.io_async_executor_idle_timeout.count();
+    config_provider->Get(kPBSIOAsyncExecutorIdleTimeoutInSeconds,
+                         idle_timeout_in_seconds);
+    pbs_instance_config.io_async_executor_idle_timeout =
+        std::chrono::seconds(idle_timeout_in_seconds);
+  }
+
   return pbs_instance_config;
 }
 }  // namespace google::scp::pbs
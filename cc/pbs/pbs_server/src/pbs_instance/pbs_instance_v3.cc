@@ -14,11 +14,14 @@
 
 #include "cc/pbs/pbs_server/src/pbs_instance/pbs_instance_v3.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "cc/core/async_executor/src/async_executor.h"
+#include "cc/core/async_executor/src/cpu_topology.h"
 #include "cc/core/authorization_proxy/src/pass_thru_authorization_proxy.h"
 #include "cc/core/common/global_logger/src/global_logger.h"
 #include "cc/core/config_provider/src/config_provider.h"
@@ -35,19 +38,35 @@
 
 namespace google::scp::pbs {
 
+using ::google::scp::core::AdmissionControlOptions;
 using ::google::scp::core::AsyncExecutor;
+using ::google::scp::core::AsyncExecutorOptions;
 using ::google::scp::core::ConfigProviderInterface;
+using ::google::scp::core::CpuTopology;
 using ::google::scp::core::ExecutionResult;
 using ::google::scp::core::FailureExecutionResult;
 using ::google::scp::core::Http2Server;
 using ::google::scp::core::HttpClient;
 using ::google::scp::core::PassThruAuthorizationProxy;
 using ::google::scp::core::SuccessExecutionResult;
+using ::google::scp::core::TaskLoadBalancingScheme;
 using ::google::scp::core::common::kZeroUuid;
 using ::google::scp::core::errors::SC_PBS_SERVICE_INITIALIZATION_ERROR;
 using ::google::scp::pbs::FrontEndServiceV2;
 using ::google::scp::pbs::HealthService;
 
+namespace {
+// The order of the thread pools in the CPU partitions.
+constexpr size_t kHttp2ServerCpuPartition = 0;
+constexpr size_t kAsyncExecutorCpuPartition = 1;
+constexpr size_t kIOAsyncExecutorCpuPartition = 2;
+constexpr size_t kCpuPartitionCount = 3;
+
+// The names of the async executors in their metrics.
+constexpr char kAsyncExecutorName[] = "cpu";
+constexpr char kIOAsyncExecutorName[] = "io";
+}  // namespace
+
 PBSInstanceV3::PBSInstanceV3(
     std::shared_ptr<core::ConfigProviderInterface> config_provider,
     std::unique_ptr<CloudPlatformDependencyFactoryInterface>
@@ -88,13 +107,72 @@ ExecutionResult PBSInstanceV3::CreateComponents() noexcept {
         cloud_platform_dependency_factory_->ConstructMetricRouter();
   }
 
+  // Split the cores between the thread pools. Without a placement, the threads
+  // of each pool are pinned starting from the first CPU.
+  std::vector<std::vector<size_t>> cpu_partitions(kCpuPartitionCount);
+  if (pbs_instance_config_.cpu_placement_enabled) {
+    auto cpu_topology = CpuTopology::LoadForCurrentProcess();
+    if (cpu_topology.Successful()) {
+      cpu_partitions = cpu_topology->Partition(
+          {pbs_instance_config_.cpu_placement_http2_server_share,
+           pbs_instance_config_.cpu_placement_async_executor_share,
+           pbs_instance_config_.cpu_placement_io_async_executor_share});
+      // An empty partition would fall back to the CPUs of the other pools, so
+      // the threads are either all placed or not at all.
+      if (std::any_of(cpu_partitions.begin(), cpu_partitions.end(),
+                      [](const std::vector<size_t>& cpus) {
+                        return cpus.empty();
+                      })) {
+        SCP_WARNING(kPBSInstance, kZeroUuid,
+                    "No CPU is left for a thread pool. Not placing the "
+                    "threads.");
+        cpu_partitions.assign(kCpuPartitionCount, {});
+      }
+    } else {
+      SCP_WARNING(kPBSInstance, kZeroUuid,
+                  "The CPU topology cannot be read. Not placing the threads.");
+    }
+  }
+
+  AdmissionControlOptions admission_control_options;
+  admission_control_options.enabled =
+      pbs_instance_config_.admission_control_enabled;
+  admission_control_options.target_sojourn_time =
+      pbs_instance_config_.admission_control_target_sojourn_time;
+  admission_control_options.interval =
+      pbs_instance_config_.admission_control_interval;
+
   // Construct foundational components.
+  AsyncExecutorOptions async_executor_options;
+  async_executor_options.name = kAsyncExecutorName;
+  async_executor_options.cpu_affinity_numbers =
+      cpu_partitions[kAsyncExecutorCpuPartition];
+  async_executor_options.admission_control = admission_control_options;
   async_executor_ = std::make_shared<AsyncExecutor>(
       pbs_instance_config_.async_executor_thread_pool_size,
-      pbs_instance_config_.async_executor_queue_size);
+      pbs_instance_config_.async_executor_queue_size,
+      /*drop_tasks_on_stop=*/false, TaskLoadBalancingScheme::RoundRobinGlobal,
+      std::move(async_executor_options), metric_router_.get());
+  AsyncExecutorOptions io_async_executor_options;
+  io_async_executor_options.name = kIOAsyncExecutorName;
+  io_async_executor_options.cpu_affinity_numbers =
+      cpu_partitions[kIOAsyncExecutorCpuPartition];
+  io_async_executor_options.admission_control = admission_control_options;
+  // The consumption of the budgets blocks the IO threads on the database.
+  io_async_executor_options.elastic_pool.enabled =
+      pbs_instance_config_.io_async_executor_max_thread_pool_size >
+      pbs_instance_config_.io_async_executor_thread_pool_size;
+  io_async_executor_options.elastic_pool.max_thread_count =
+      pbs_instance_config_.io_async_executor_max_thread_pool_size;
+  io_async_executor_options.elastic_pool.blocked_threshold =
+      pbs_instance_config_.io_async_executor_blocked_threshold;
+  io_async_executor_options.elastic_pool.idle_timeout =
+      pbs_instance_config_.io_async_executor_idle_timeout;
   io_async_executor_ = std::make_shared<AsyncExecutor>(
       pbs_instance_config_.io_async_executor_thread_pool_size,
-      pbs_instance_config_.io_async_executor_queue_size);
+      pbs_instance_config_.io_async_executor_queue_size,
+      /*drop_tasks_on_stop=*/false, TaskLoadBalancingScheme::RoundRobinGlobal,
+      std::move(io_async_executor_options), metric_router_.get());
   http2_client_ = std::make_shared<HttpClient>(
       async_executor_, core::HttpClientOptions(), metric_router_.get());
 
@@ -108,7 +186,10 @@ ExecutionResult PBSInstanceV3::CreateComponents() noexcept {
   core::Http2ServerOptions http2_server_options(
       pbs_instance_config_.http2_server_use_tls,
       pbs_instance_config_.http2_server_private_key_file_path,
-      pbs_instance_config_.http2_server_certificate_file_path);
+      pbs_instance_config_.http2_server_certificate_file_path,
+      core::Http2ServerOptions().retry_strategy_options,
+      cpu_partitions[kHttp2ServerCpuPartition],
+      pbs_instance_config_.http2_server_request_body_memory_budget_bytes);
 
   std::shared_ptr<core::AuthorizationProxyInterface> aws_authorization_proxy =
       cloud_platform_dependency_factory_->ConstructAwsAuthorizationProxyClient(
@@ -272,6 +272,32 @@ TEST_F(PBSInstanceConfiguration, ReadConfigurationReadsAllConfigs) {
             std::chrono::seconds(20));
 }
 
+TEST_F(PBSInstanceConfiguration,
+       ReadConfigurationShouldFailIfCpuPlacementShareIsZero) {
+  auto config_provider = std::make_shared<MockConfigProvider>();
+  config_provider->SetInt(kAsyncExecutorQueueSize, 1);
+  config_provider->SetInt(kAsyncExecutorThreadsCount, 2);
+  config_provider->SetInt(kIOAsyncExecutorQueueSize, 3);
+  config_provider->SetInt(kIOAsyncExecutorThreadsCount, 4);
+  config_provider->SetInt(kTransactionManagerCapacity, 5);
+  config_provider->Set(kJournalServiceBucketName, "bucket");
+  config_provider->Set(kJournalServicePartitionName,
+                       "00000000-0000-0000-0000-000000000000");
+  config_provider->Set(kPrivacyBudgetServiceHostAddress, "0.0.0.0");
+  config_provider->Set(kPrivacyBudgetServiceHostPort, "8000");
+  config_provider->Set(kPrivacyBudgetServiceHealthPort, "8001");
+  config_provider->Set(kPrivacyBudgetServiceExternalExposedHostPort, "80");
+  config_provider->SetInt(kTotalHttp2ServerThreadsCount, 10);
+  config_provider->Set(kPBSPartitionLockTableNameConfigName, "partition_lock");
+  config_provider->Set(kContainerType, kComputeEngine);
+  config_provider->SetBool(kPBSCpuPlacementEnabled, true);
+  config_provider->SetInt(kPBSCpuPlacementIOAsyncExecutorShare, 0);
+
+  EXPECT_THAT(GetPBSInstanceConfigFromConfigProvider(config_provider),
+              ResultIs(FailureExecutionResult(
+                  core::errors::SC_PBS_INVALID_CPU_PLACEMENT_SHARE)));
+}
+
 TEST_F(PBSInstanceConfiguration, ConfigNotSetShouldUseDefaultValue) {
   auto config_provider = std::make_shared<MockConfigProvider>();
   config_provider->SetInt(kAsyncExecutorQueueSize, 1);